@@ -0,0 +1,200 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free
+ * software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is
+ * distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+#include <blendint/core/types.hpp>
+
+namespace BlendInt {
+
+/**
+ * @brief A sequence with a movable gap at the edit position
+ *
+ * Elements are stored in one vector with a gap of unused slots, the
+ * gap is moved to where an element is inserted or erased, so a run of
+ * edits at the same place moves no element but the ones between the
+ * old and the new position. Random access is O(1).
+ *
+ * @ingroup blendint_core
+ */
+template<typename T>
+class GapBuffer
+{
+ public:
+
+  GapBuffer ()
+  : gap_begin_(0), gap_end_(0)
+  {
+  }
+
+  ~GapBuffer ()
+  {
+  }
+
+  inline size_t size () const
+  {
+    return buffer_.size() - (gap_end_ - gap_begin_);
+  }
+
+  inline bool empty () const
+  {
+    return size() == 0;
+  }
+
+  inline const T& operator [] (size_t index) const
+  {
+    DBG_ASSERT(index < size());
+    return buffer_[index < gap_begin_ ? index : (index + gap_end_ - gap_begin_)];
+  }
+
+  inline T& operator [] (size_t index)
+  {
+    DBG_ASSERT(index < size());
+    return buffer_[index < gap_begin_ ? index : (index + gap_end_ - gap_begin_)];
+  }
+
+  void Insert (size_t index, const T& value)
+  {
+    Insert(index, 1, value);
+  }
+
+  /**
+   * @brief Insert count copies of value before index
+   */
+  void Insert (size_t index, size_t count, const T& value)
+  {
+    DBG_ASSERT(index <= size());
+
+    if ((gap_end_ - gap_begin_) < count) {
+      Reserve(std::max(size() + count, buffer_.size() * 2));
+    }
+
+    MoveGap(index);
+
+    std::fill(buffer_.begin() + gap_begin_,
+              buffer_.begin() + gap_begin_ + count,
+              value);
+    gap_begin_ += count;
+  }
+
+  void Erase (size_t index, size_t count = 1)
+  {
+    DBG_ASSERT((index + count) <= size());
+
+    MoveGap(index);
+
+    // release the resources of erased elements
+    std::fill(buffer_.begin() + gap_end_,
+              buffer_.begin() + gap_end_ + count,
+              T());
+    gap_end_ += count;
+  }
+
+  void Clear ()
+  {
+    buffer_.clear();
+    gap_begin_ = 0;
+    gap_end_ = 0;
+  }
+
+  /**
+   * @brief Make room for at least capacity elements
+   */
+  void Reserve (size_t capacity)
+  {
+    if (capacity <= buffer_.size()) return;
+
+    size_t grow = capacity - buffer_.size();
+    size_t tail = buffer_.size() - gap_end_;
+
+    buffer_.resize(capacity);
+
+    // move the new slots before the elements after the gap
+    std::rotate(buffer_.begin() + gap_end_,
+                buffer_.begin() + gap_end_ + tail,
+                buffer_.end());
+    gap_end_ += grow;
+  }
+
+  /**
+   * @brief Move the gap before the element of index
+   *
+   * Elements are swapped across the gap, so a type with a cheap swap
+   * (e.g. String) is never copied.
+   */
+  void MoveGap (size_t index)
+  {
+    DBG_ASSERT(index <= size());
+
+    const size_t gap = gap_end_ - gap_begin_;
+
+    if (index < gap_begin_) {
+      size_t count = gap_begin_ - index;
+      if (count <= gap) {
+        std::swap_ranges(buffer_.begin() + index,
+                         buffer_.begin() + gap_begin_,
+                         buffer_.begin() + gap_end_ - count);
+      } else {
+        std::rotate(buffer_.begin() + index,
+                    buffer_.begin() + gap_begin_,
+                    buffer_.begin() + gap_end_);
+      }
+      gap_begin_ -= count;
+      gap_end_ -= count;
+    } else if (index > gap_begin_) {
+      size_t count = index - gap_begin_;
+      if (count <= gap) {
+        std::swap_ranges(buffer_.begin() + gap_end_,
+                         buffer_.begin() + gap_end_ + count,
+                         buffer_.begin() + gap_begin_);
+      } else {
+        std::rotate(buffer_.begin() + gap_begin_,
+                    buffer_.begin() + gap_end_,
+                    buffer_.begin() + gap_end_ + count);
+      }
+      gap_begin_ += count;
+      gap_end_ += count;
+    }
+  }
+
+  inline size_t capacity () const
+  {
+    return buffer_.size();
+  }
+
+ private:
+
+  std::vector<T> buffer_;
+
+  // the first slot of the gap
+  size_t gap_begin_;
+
+  // the first slot after the gap
+  size_t gap_end_;
+
+};
+
+}
@@ -66,6 +66,14 @@ class String: public std::u32string
 
 };
 
+/**
+ * @brief Swap the contents without copying, used by std algorithms
+ */
+inline void swap (String& a, String& b)
+{
+  a.swap(b);
+}
+
 extern std::string ConvertFromString (const String& src);
 
 }
@@ -0,0 +1,107 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free
+ * software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is
+ * distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+#pragma once
+
+#include <blendint/core/string.hpp>
+#include <blendint/core/gap-buffer.hpp>
+
+namespace BlendInt {
+
+/**
+ * @brief A multi-line text stored as lines in a gap buffer
+ *
+ * An edit only touches the lines it spans, and inserting or removing
+ * lines near the last edit moves no other line, so editing stays
+ * fast in a buffer of many lines. There is always at least one
+ * (maybe empty) line.
+ *
+ * @ingroup blendint_core
+ */
+class TextDocument
+{
+  DISALLOW_COPY_AND_ASSIGN(TextDocument);
+
+ public:
+
+  TextDocument ();
+
+  explicit TextDocument (const String& text);
+
+  ~TextDocument ();
+
+  /**
+   * @brief Replace the whole text, lines are split at '\n'
+   */
+  void SetText (const String& text);
+
+  /**
+   * @brief Get the whole text with lines joined by '\n'
+   */
+  String GetText () const;
+
+  /**
+   * @brief Insert text at a position
+   * @param[in,out] line The line of the position, moved to the end of
+   * the inserted text
+   * @param[in,out] column The column of the position, moved to the end
+   * of the inserted text
+   * @param[in] text The text to insert, may contain '\n'
+   */
+  void Insert (size_t* line, size_t* column, const String& text);
+
+  /**
+   * @brief Erase the text between two positions
+   *
+   * The end position is exclusive, e.g. Erase(i, line_length(i), i +
+   * 1, 0) joins line i and the next one.
+   */
+  void Erase (size_t line,
+              size_t column,
+              size_t end_line,
+              size_t end_column);
+
+  void Clear ();
+
+  inline size_t line_count () const
+  {
+    return lines_.size();
+  }
+
+  inline const String& line (size_t index) const
+  {
+    return lines_[index];
+  }
+
+  inline size_t line_length (size_t index) const
+  {
+    return lines_[index].length();
+  }
+
+ private:
+
+  GapBuffer<String> lines_;
+
+};
+
+}
@@ -0,0 +1,119 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free
+ * software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is
+ * distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <blendint/core/types.hpp>
+
+namespace BlendInt {
+
+class Timer;
+
+/**
+ * @brief A hierarchical timer wheel driving all Timer objects
+ *
+ * Timers are hashed into 4 levels of 64 slots, the slots of level 0
+ * are 1 ms long and each upper level is 64 times coarser, timers are
+ * moved to lower levels as time advances. Start and stop are O(1).
+ *
+ * Deadlines are rounded up to a granularity of 1/8 interval (a power
+ * of 2, at most 64 ms), so timers with similar deadlines fire in the
+ * same tick and the event loop wakes up less often.
+ *
+ * The wheel is not thread safe, timers must be started and stopped in
+ * the UI thread, and their timeout events are fired in Advance() from
+ * the event loop.
+ *
+ * @ingroup blendint_core
+ */
+class TimerWheel
+{
+ public:
+
+  TimerWheel ();
+
+  ~TimerWheel ();
+
+  void Schedule (Timer* timer, unsigned int delay);
+
+  void Cancel (Timer* timer);
+
+  /**
+   * @brief Fire the timers due
+   * @return The number of timeout events fired
+   */
+  int Advance ();
+
+  /**
+   * @brief Milliseconds until the next timer is due
+   * @return -1 if no timer is scheduled
+   */
+  int GetTimeout () const;
+
+  inline unsigned int count () const
+  {
+    return count_;
+  }
+
+  /**
+   * @brief Current time of the wheel in milliseconds
+   */
+  uint64_t GetCurrentTick () const;
+
+ private:
+
+  void Place (Timer* timer);
+
+  void Unlink (Timer* timer);
+
+  void Cascade (int level);
+
+  // round a deadline up to the granularity of the delay
+  static uint64_t RoundUp (uint64_t deadline, unsigned int delay);
+
+  static const int kLevels = 4;
+
+  static const int kSlotBits = 6;
+
+  static const int kSlots = 1 << kSlotBits;
+
+  static const int kSlotMask = kSlots - 1;
+
+  static const unsigned int kMaxGranularity = 64;
+
+  // the head of each slot list
+  Timer* slots_[kLevels][kSlots];
+
+  // the tick processed last
+  uint64_t current_;
+
+  uint64_t start_time_;
+
+  unsigned int count_;
+
+  DISALLOW_COPY_AND_ASSIGN(TimerWheel);
+};
+
+}
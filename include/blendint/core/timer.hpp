@@ -23,24 +23,11 @@
 
 #pragma once
 
-#include <signal.h>
-#include <time.h>
+#include <stdint.h>
 
 #include <blendint/cppevent/event.hpp>
 #include <blendint/core/object.hpp>
-
-/*
-  #ifdef __LINUX__
-  #define BLENDINT_USE_POSIX_TIMER 1
-  #else
-  #define BLENDINT_USE_POSIX_TIMER 0
-  #include <pthread.h>
-  #endif
-*/
-
-// use posix timer cause segment fault in Linux, this is a temporary
-// workaround:
-#define BLENDINT_USE_POSIX_TIMER 0
+#include <blendint/core/timer-wheel.hpp>
 
 namespace BlendInt {
 
@@ -52,6 +39,10 @@ namespace BlendInt {
  * To use it, create a timer and connect the timeout() event to the appropriate event callee,
  * and call Start() to enable the timer.
  *
+ * All timers are driven by one TimerWheel in the event loop, the
+ * timeout event is fired in the UI thread. Start and stop timers in the
+ * UI thread only.
+ *
  * Example code for usage:
  * @code
  Timer* timer = new Timer;
@@ -135,6 +126,14 @@ class Timer: public Object
 
   static uint64_t GetMicroSeconds ();
 
+  /**
+   * @brief Microseconds of a monotonic clock
+   *
+   * Unlike GetMicroSeconds(), which reads the wall clock, this never
+   * jumps, use it to measure durations.
+   */
+  static uint64_t GetMonotonicMicroSeconds ();
+
   static void SaveCurrentTime ();
 
   static void SaveProgramTime ();
@@ -149,13 +148,23 @@ class Timer: public Object
     return kProgramTime;
   }
 
- protected:
+  /**
+   * @brief Fire the timeout events of all timers due
+   * @return The number of timeout events fired
+   *
+   * Called in the event loop.
+   */
+  static int ProcessTimeouts ();
 
-#if BLENDINT_USE_POSIX_TIMER
-  static void ThreadCallback (union sigval sigev_value);
-#else
-  static void *ThreadCallback (void* data);
-#endif
+  /**
+   * @brief Milliseconds until the next timer is due
+   * @return -1 if no timer is running
+   *
+   * Used by the event loop to decide how long to wait for events.
+   */
+  static int GetTimeout ();
+
+ protected:
 
   void set_interval (unsigned int interval)
   {
@@ -164,17 +173,23 @@ class Timer: public Object
 
  private:
 
-#if BLENDINT_USE_POSIX_TIMER
+  friend class TimerWheel;
 
-  void Create ();
+  // the links in a slot of the timer wheel
+  Timer* wheel_prev_;
 
-  timer_t m_id;
+  Timer* wheel_next_;
 
-#else
+  // the position in the timer wheel, -1 if not scheduled
+  int level_;
 
-  pthread_t m_id;	// thread id
+  int slot_;
 
-#endif  // BLENDINT_USE_POSIX_TIMER
+  // the tick of the wheel when this timer should fire
+  uint64_t deadline_;
+
+  // the deadline rounded up to coalesce with other timers
+  uint64_t expires_;
 
   /**
    * @brief the interval time in millisecond
@@ -194,6 +209,8 @@ class Timer: public Object
 
   static uint64_t kProgramTime;
 
+  static TimerWheel kWheel;
+
 };
 
 }
@@ -26,6 +26,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 #ifdef DEBUG
 #include <cassert>
 #endif
@@ -39,6 +41,11 @@ struct Binding;
 
 /**
  * @brief The abstract event binding
+ *
+ * Bindings and tokens are created and destroyed for every connection,
+ * they are allocated from per-thread pools of fixed size blocks instead
+ * of the heap. The free blocks of a thread are handed to the other
+ * threads when it exits.
  */
 struct Binding
 {
@@ -52,6 +59,10 @@ struct Binding
 
   ~Binding ();
 
+  static void* operator new (std::size_t size);
+
+  static void operator delete (void* ptr, std::size_t size);
+
   AbstractTrackable* trackable_object;
   Binding* previous;
   Binding* next;
@@ -73,6 +84,12 @@ struct Token
 
   virtual ~Token ();
 
+  // size is the size of the most derived token as the destructor is
+  // virtual
+  static void* operator new (std::size_t size);
+
+  static void operator delete (void* ptr, std::size_t size);
+
   AbstractTrackable* trackable_object;
   Token* previous;
   Token* next;
@@ -42,22 +42,11 @@ class DelegateToken : public InvokableToken < ParamTypes... >
 
   virtual ~DelegateToken();
 
-  virtual void Invoke(ParamTypes... Args) override;
-
-  const Delegate<void, ParamTypes...>& delegate () const
-  {
-    return delegate_;
-  }
-
- private:
-
-  Delegate<void, ParamTypes...> delegate_;
-
 };
 
 template<typename ... ParamTypes>
 inline DelegateToken<ParamTypes...>::DelegateToken(const Delegate<void, ParamTypes...>& d)
-    : InvokableToken<ParamTypes...>(), delegate_(d)
+    : InvokableToken<ParamTypes...>(d)
 {
 }
 
@@ -66,10 +55,4 @@ DelegateToken<ParamTypes...>::~DelegateToken()
 {
 }
 
-template<typename ... ParamTypes>
-void DelegateToken<ParamTypes...>::Invoke(ParamTypes... Args)
-{
-  delegate_(Args...);
-}
-
 } // namespace CppEvent
@@ -44,8 +44,6 @@ public:
 
   virtual ~EventToken();
 
-  virtual void Invoke(ParamTypes... Args) override;
-
   inline const Event<ParamTypes...>* event () const;
 
 private:
@@ -56,7 +54,10 @@ private:
 template<typename ... ParamTypes>
 inline EventToken<ParamTypes...>::EventToken (Event<
     ParamTypes...>& event)
-    : InvokableToken<ParamTypes...>(), event_(&event)
+    : InvokableToken<ParamTypes...>(
+        Delegate<void, ParamTypes...>::template from_method<Event<ParamTypes...> >(
+            &event, &Event<ParamTypes...>::Invoke)),
+      event_(&event)
 {
 }
 
@@ -65,12 +66,6 @@ EventToken<ParamTypes...>::~EventToken()
 {
 }
 
-template<typename ... ParamTypes>
-void EventToken<ParamTypes...>::Invoke(ParamTypes... Args)
-{
-  event_->Invoke(Args...);
-}
-
 template<typename ... ParamTypes>
 inline const Event<ParamTypes...>* EventToken<ParamTypes...>::event() const
 {
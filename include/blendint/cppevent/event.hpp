@@ -264,7 +264,9 @@ template<typename T>
 void Event<ParamTypes...>::Disconnect (T* obj, void (T::*method) (ParamTypes...))
 {
   DelegateToken<ParamTypes...>* conn = 0;
-  for (Token* p = last_token_; p; p = p->previous) {
+  Token* previous = 0;
+  for (Token* p = last_token_; p; p = previous) {
+    previous = p->previous;
     conn = dynamic_cast<DelegateToken<ParamTypes...>*>(p);
     if (conn && (conn->delegate().template equal<T>(obj, method)))
       delete conn;
@@ -288,7 +290,9 @@ template<typename ... ParamTypes>
 void Event<ParamTypes...>::Disconnect (Event<ParamTypes...>& other)
 {
   EventToken<ParamTypes...>* conn = 0;
-  for (Token* p = last_token_; p; p = p->previous) {
+  Token* previous = 0;
+  for (Token* p = last_token_; p; p = previous) {
+    previous = p->previous;
     conn = dynamic_cast<EventToken<ParamTypes...>*>(p);
     if (conn && (conn->event() == (&other))) delete conn;
   }
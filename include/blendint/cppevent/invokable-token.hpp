@@ -27,24 +27,45 @@
 #pragma once
 
 #include <cppevent/abstract-trackable.hpp>
+#include <cppevent/delegate.hpp>
 
 namespace CppEvent {
 
+/**
+ * @brief A token which calls a delegate
+ *
+ * The delegate is stored in the token so Event::Invoke() calls it
+ * directly instead of through a virtual function.
+ */
 template<typename ... ParamTypes>
 class InvokableToken: public Token
 {
  public:
 
-  inline InvokableToken ();
+  InvokableToken () = delete;
+
+  inline InvokableToken (const Delegate<void, ParamTypes...>& d);
 
   virtual ~InvokableToken ();
 
-  virtual void Invoke (ParamTypes ... Args);
+  inline void Invoke (ParamTypes ... Args) const
+  {
+    delegate_(Args...);
+  }
+
+  const Delegate<void, ParamTypes...>& delegate () const
+  {
+    return delegate_;
+  }
+
+ private:
+
+  Delegate<void, ParamTypes...> delegate_;
 };
 
 template<typename ... ParamTypes>
-inline InvokableToken<ParamTypes...>::InvokableToken ()
-    : Token()
+inline InvokableToken<ParamTypes...>::InvokableToken (const Delegate<void, ParamTypes...>& d)
+    : Token(), delegate_(d)
 {
 }
 
@@ -53,10 +74,4 @@ InvokableToken<ParamTypes...>::~InvokableToken ()
 {
 }
 
-template<typename ... ParamTypes>
-void InvokableToken<ParamTypes...>::Invoke (ParamTypes ... Args)
-{
-  // Override this in sub class
-}
-
 } // namespace CppEvent
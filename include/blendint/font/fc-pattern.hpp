@@ -135,22 +135,22 @@ namespace BlendInt {
 			 * refers to the data stored within the pattern
 			 * directly. Same as all get functions.
 			 */
-			inline FcResult get (const char* object, int id, FcValue* v)
+			inline FcResult get (const char* object, int id, FcValue* v) const
 			{
 				return FcPatternGet(pattern_, object, id, v);
 			}
 
-			inline FcResult get_integer (const char* object, int n, int *i)
+			inline FcResult get_integer (const char* object, int n, int *i) const
 			{
 				return FcPatternGetInteger(pattern_, object, n, i);
 			}
 
-			inline FcResult get_double (const char *object, int n, double *d)
+			inline FcResult get_double (const char *object, int n, double *d) const
 			{
 				return FcPatternGetDouble(pattern_, object, n, d);
 			}
 
-			inline FcResult get_string (const char *object, int n, FcChar8 **s)
+			inline FcResult get_string (const char *object, int n, FcChar8 **s) const
 			{
 				return FcPatternGetString(pattern_, object, n, s);
 			}
@@ -165,10 +165,10 @@ namespace BlendInt {
 				return FcPatternGetCharSet(pattern_, object, n, c);
 			}
 
-//			inline FcResult get (const char *object, int n, FcBool *b)
-//			{
-//				return FcPatternGetBool(pattern_, object, n, b);
-//			}
+			inline FcResult get_bool (const char *object, int n, FcBool *b) const
+			{
+				return FcPatternGetBool(pattern_, object, n, b);
+			}
 
 //			inline FcResult get (const char *object, int n, FT_Face *f)
 //			{
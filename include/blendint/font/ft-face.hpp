@@ -25,6 +25,8 @@
 
 #include <blendint/font/ft-library.hpp>
 
+#include FT_SYNTHESIS_H
+
 namespace BlendInt {
 
 	namespace Ft {
@@ -90,6 +92,25 @@ namespace BlendInt {
 				return FT_Load_Char(face_, char_code, load_flags);
 			}
 
+			/**
+			 * @brief Load and render the glyph of a character
+			 * @param char_code The character
+			 * @param embolden Make the outline heavier before rendering,
+			 * to synthesize a bold weight the face does not have
+			 */
+			inline FT_Error load_rendered_char (FT_ULong char_code, bool embolden) const
+			{
+				if (!embolden) {
+					return FT_Load_Char(face_, char_code, FT_LOAD_RENDER);
+				}
+
+				FT_Error error = FT_Load_Char(face_, char_code, FT_LOAD_DEFAULT);
+				if (error) return error;
+
+				FT_GlyphSlot_Embolden(face_->glyph);
+				return FT_Render_Glyph(face_->glyph, FT_RENDER_MODE_NORMAL);
+			}
+
 			inline FT_Error get_kerning (FT_UInt left_glyph, FT_UInt right_glyph, FT_UInt kern_mode, FT_Vector* akerning)
 			{
 				return FT_Get_Kerning(face_, left_glyph, right_glyph, kern_mode, akerning);
@@ -0,0 +1,177 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free software:
+ * you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is distributed in
+ * the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <blendint/gui/abstract-item-model.hpp>
+
+namespace BlendInt {
+
+/**
+ * @brief Abstract class for list model with random-access rows
+ *
+ * AbstractArrayListModel stores the same node grid as
+ * AbstractListModel, so ModelIndex::GetDownIndex() etc. work as
+ * usual, but it also keeps the first node of each row in blocks of
+ * about kBlockSize rows, indexed by the first row of each block, and
+ * caches the row (relative to the block) and column numbers in nodes:
+ *
+ *  - GetIndex() is O(log n) for the row and O(column) for the column
+ *  - ModelIndex::GetRow() and ModelIndex::GetColumn() are O(1)
+ *  - appending rows is amortized O(1)
+ *  - inserting or removing rows in the middle is O(kBlockSize + n /
+ *    kBlockSize): only the block at the position is renumbered, and
+ *    the first rows of the blocks after it are updated
+ *
+ * Use this as the base class of models which hold a large amount of
+ * rows and are accessed by row number, e.g. in a ListView.
+ *
+ * Only the root index can be used as the parent index, the nodes in
+ * this model have no child.
+ */
+class AbstractArrayListModel: public AbstractItemModel
+{
+public:
+
+  AbstractArrayListModel ();
+
+  virtual ~AbstractArrayListModel ();
+
+  virtual bool InsertColumns (int column, int count, const ModelIndex& parent =
+                                  ModelIndex()) override;
+
+  virtual bool RemoveColumns (int column, int count, const ModelIndex& parent =
+                                  ModelIndex()) override;
+
+  /**
+   * @brief Insert count rows into the model before the given row.
+   * @param row The row before which will be inserted
+   * @param count How many rows will be inserted
+   * @param parent The parent ModelIndex, must be the root index
+   * @return
+   * 	- true if the rows were successfully inserted
+   * 	- false if parent is invalid
+   *
+   * If row is greater than the current row count, the rows are appended.
+   * If the model has no column, a single column with count rows is inserted.
+   */
+  virtual bool InsertRows (int row, int count, const ModelIndex& parent =
+                               ModelIndex()) override;
+
+  virtual bool RemoveRows (int row, int count, const ModelIndex& parent =
+                               ModelIndex()) override;
+
+  virtual ModelIndex GetRootIndex () const override;
+
+  virtual ModelIndex GetIndex (int row, int column, const ModelIndex& parent =
+                                   ModelIndex()) const override;
+
+protected:
+
+  inline const ModelNode* root () const
+  {
+    return root_;
+  }
+
+  inline int row_count () const
+  {
+    return row_count_;
+  }
+
+  inline int column_count () const
+  {
+    return columns_;
+  }
+
+  /**
+   * @brief Remove all rows
+   */
+  void Clear ();
+
+private:
+
+  struct RowBlock
+  {
+    // the row of rows.front() in the model
+    int first;
+
+    // the first node of each row
+    std::vector<ModelNode*> rows;
+  };
+
+  /**
+   * @brief Find the block holding a row
+   *
+   * Returns the last block for row_count_.
+   */
+  size_t FindBlock (int row) const;
+
+  ModelNode* GetRowNode (int row) const;
+
+  /**
+   * @brief Split an oversized block, or merge an undersized one into the
+   * next, and renumber the affected blocks
+   */
+  void BalanceBlock (size_t index);
+
+  /**
+   * @brief Reset the row numbers in a block
+   */
+  void NumberBlock (size_t index);
+
+  /**
+   * @brief Reset the first row of the blocks from the given one
+   */
+  void UpdateFirstRows (size_t index);
+
+  /**
+   * @brief Reset the up/down links of the rows in [first, last]
+   */
+  void LinkRows (int first, int last);
+
+  /**
+   * @brief Renumber and link all rows, after the first column changed
+   */
+  void RelinkAll ();
+
+  ModelNode* CreateRow () const;
+
+  static void NumberColumns (ModelNode* node);
+
+  static void DestroyRow (ModelNode* node);
+
+  static const size_t kBlockSize = 512;
+
+  ModelNode* root_;
+
+  std::vector<RowBlock*> blocks_;
+
+  int row_count_;
+
+  int columns_;
+
+};
+
+}
@@ -235,6 +235,10 @@ class AbstractFrame: public AbstractView
 
   RefPtr<ViewBuffer> view_buffer_;
 
+  // the storage size of the texture RenderToTexture() draws to, saves a
+  // glGetTexLevelParameteriv() in every render
+  Size texture_size_;
+
   CppEvent::Event<AbstractFrame*> destroyed_;
 
   static glm::mat4 kViewMatrix;
@@ -39,7 +39,8 @@ extern inline bool operator == (const ModelIndex& src, const ModelIndex& dst);
 struct ModelNode
 {
   inline ModelNode ()
-      : parent(0), child(0), up(0), down(0), left(0), right(0)
+      : parent(0), child(0), up(0), down(0), left(0), right(0), row(-1),
+        column(-1), row_base(0)
   {
   }
 
@@ -55,6 +56,27 @@ struct ModelNode
   ModelNode* left;
   ModelNode* right;
 
+  /**
+   * @brief The cached row of the node, -1 if not maintained by the model
+   *
+   * Only stored in the first node of a row, ModelIndex::GetRow() will
+   * walk the up pointers if this is -1.
+   */
+  int row;
+
+  /**
+   * @brief The cached column of the node, -1 if not maintained by the model
+   */
+  int column;
+
+  /**
+   * @brief The first row of the block holding the node, or 0
+   *
+   * A model storing rows in blocks keeps the row relative to its block,
+   * so inserting rows only renumbers one block.
+   */
+  const int* row_base;
+
   RefPtr<AbstractForm> data;
 };
 
@@ -60,6 +60,14 @@ class AbstractRoundWidget: public AbstractWidget
     return round_radius_;
   }
 
+  /**
+   * @brief If any corner of the shape is round
+   */
+  inline bool rounded () const
+  {
+    return (round_type() != RoundNone) && (round_radius_ > 0.f);
+  }
+
   inline bool emboss () const
   {
     return widget_flag_ & WidgetEmboss;
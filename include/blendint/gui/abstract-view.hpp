@@ -41,6 +41,7 @@ namespace BlendInt {
 class AbstractWindow;
 class AbstractFrame;
 class ManagedPtr;
+class HitTestGrid;
 struct ColorScheme;
 
 enum ViewType
@@ -294,6 +295,7 @@ protected:
   void set_position (int x, int y)
   {
     position_.reset(x, y);
+    if (super_) super_->subview_grid_dirty_ = true;
   }
 
   /**
@@ -306,6 +308,7 @@ protected:
   void set_position (const Point& pos)
   {
     position_ = pos;
+    if (super_) super_->subview_grid_dirty_ = true;
   }
 
   /**
@@ -319,6 +322,7 @@ protected:
   inline void set_size (int width, int height)
   {
     size_.reset(width, height);
+    if (super_) super_->subview_grid_dirty_ = true;
   }
 
   /**
@@ -331,6 +335,7 @@ protected:
   inline void set_size (const Size& size)
   {
     size_ = size;
+    if (super_) super_->subview_grid_dirty_ = true;
   }
 
   inline AbstractView* first () const
@@ -418,6 +423,18 @@ protected:
 
   AbstractView* GetSubViewAt (int i) const;
 
+  /**
+   * @brief Get the top sub widget containing a point
+   * @param point A point in the coordinates of the sub views, the offset
+   * of this view excluded
+   * @return The sub view, or 0
+   *
+   * Sub views are tested from the last one and the search stops at the
+   * first view which is not a widget. A HitTestGrid is used if there
+   * are many sub views.
+   */
+  AbstractView* GetSubWidgetAt (const Point& point);
+
   AbstractView* PushFrontSubView (AbstractView* view);
 
   AbstractView* InsertSubView (int index, AbstractView* view);
@@ -625,6 +642,11 @@ private:
 
   Size size_;
 
+  // built for hit testing when there are many sub views
+  HitTestGrid* subview_grid_;
+
+  bool subview_grid_dirty_;
+
 #ifdef DEBUG
   std::string name_;
 #endif
@@ -80,9 +80,18 @@ protected:
 
   virtual Response PerformMouseMove (AbstractWindow* context);
 
+  /**
+   * @brief Render the sub widgets to a texture
+   * @param[in] widget
+   * @param[in] context
+   * @param[out] texture
+   * @param[in,out] texture_size The storage size of texture, kept by the
+   * caller so the texture size is not queried in every render
+   */
   static bool RenderSubWidgetsToTexture (AbstractWidget* widget,
                                          AbstractWindow* context,
-                                         GLTexture2D* texture);
+                                         GLTexture2D* texture,
+                                         Size* texture_size);
 
 private:
 
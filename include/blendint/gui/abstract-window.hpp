@@ -23,8 +23,14 @@
 
 #pragma once
 
+#include <mutex>
+#include <vector>
+
 #include <blendint/core/input.hpp>
+#include <blendint/opengl/gl-framebuffer-pool.hpp>
+#include <blendint/opengl/gl-vertex-arena.hpp>
 #include <blendint/gui/abstract-view.hpp>
+#include <blendint/gui/damage-region.hpp>
 
 #include <blendint/stock/icons.hpp>
 #include <blendint/stock/theme.hpp>
@@ -81,6 +87,53 @@ enum WindowFlags
 
 class AbstractFrame;
 
+namespace Fc {
+class Pattern;
+}
+
+/**
+ * @brief Time spent in each phase of AbstractWindow::InitializeGLContext()
+ *
+ * Times are in milliseconds. The theme, the default font match and the
+ * icon images are loaded in worker threads while the shaders are linked,
+ * so the phases overlap and total is less than their sum.
+ */
+struct StartupProfile
+{
+  StartupProfile ()
+  : theme(0.0),
+    shaders(0.0),
+    vertex_arenas(0.0),
+    icons(0.0),
+    font(0.0),
+    total(0.0),
+    cached_programs(0),
+    linked_programs(0)
+  {
+  }
+
+  // loading the theme, in a worker thread
+  double theme;
+
+  double shaders;
+
+  double vertex_arenas;
+
+  // reading the images in a worker thread and creating the textures
+  double icons;
+
+  // matching the default font in a worker thread and loading the glyphs
+  double font;
+
+  double total;
+
+  // shader programs loaded from the binary cache
+  unsigned int cached_programs;
+
+  // shader programs compiled and linked from sources
+  unsigned int linked_programs;
+};
+
 /**
  * @brief Abstract class for window
  *
@@ -220,6 +273,97 @@ public:
     return viewport_origin_;
   }
 
+  /**
+   * @brief The OpenGL viewport last set by SetViewport()
+   */
+  inline const Rect& viewport () const
+  {
+    return viewport_;
+  }
+
+  /**
+   * @brief The pool of off-screen render targets in this window
+   */
+  inline GLFramebufferPool* framebuffer_pool ()
+  {
+    return &framebuffer_pool_;
+  }
+
+  /**
+   * @brief Add a rectangle in window coordinates to the area redrawn in
+   * the next frame
+   */
+  void Damage (const Rect& rect);
+
+  /**
+   * @brief Redraw the whole window in the next frame
+   */
+  void DamageAll ();
+
+  /**
+   * @brief Check if a view overlaps the area being redrawn
+   *
+   * In a partial redraw each damaged rectangle is redrawn in its own
+   * pass, only the views overlapping the rectangle of the current pass
+   * are drawn. Always true outside a partial redraw, or while an
+   * off-screen buffer is rendered as a whole.
+   */
+  bool IsDamaged (const AbstractView* view) const;
+
+  /**
+   * @brief Get the damaged part of a view
+   * @param[in] view A view drawn in this window
+   * @param[out] rect The bounding box of all damaged rectangles in the
+   * view, relative to the view
+   * @param[out] window_rect The same area in window coordinates, may be 0
+   * @return False if the whole view is to be redrawn
+   *
+   * Used by the views rendered off-screen once a frame, e.g. the
+   * textures of frames, which must cover the damage of every pass.
+   */
+  bool GetDamagedRect (const AbstractView* view, Rect* rect,
+                       Rect* window_rect = 0) const;
+
+  /**
+   * @brief Clip drawing to a rectangle in framebuffer coordinates
+   *
+   * The scissor box is intersected with the clip of the parent and the
+   * damaged area being redrawn, call EndScissor() to restore it.
+   */
+  void BeginScissor (const Rect& rect);
+
+  void EndScissor ();
+
+  /**
+   * @brief Set the OpenGL viewport
+   *
+   * Set the viewport only through this, PushClipRect() maps rectangles
+   * with the viewport kept here instead of reading it back from OpenGL.
+   */
+  void SetViewport (int x, int y, int width, int height);
+
+  /**
+   * @brief Clip drawing to a rectangle of the current widget
+   * @param rect The rectangle in the coordinates of the widget model
+   * matrix, e.g. Rect(0, 0, width, height) in PreDraw()
+   *
+   * An axis-aligned rectangle is clipped with the scissor box, nothing
+   * is drawn into the stencil buffer and there is no nesting limit.
+   * Use the stencil only for the shapes with round corners, call
+   * PopClipRect() to restore the clip of the parent.
+   */
+  void PushClipRect (const Rect& rect);
+
+  void PopClipRect ();
+
+  /**
+   * @brief The area being redrawn in the current frame
+   */
+  inline const DamageRegion& frame_damage () const
+  {
+    return frame_damage_;
+  }
+
   /**
    * @brief Get the current cursor shape
    */
@@ -246,8 +390,25 @@ public:
   
   static AbstractWindow* GetWindow (AbstractView* widget);
 
+  /**
+   * @brief Create the theme, shaders, icons and font shared by windows
+   *
+   * Linked shader programs are cached in the directory set by
+   * GLSLProgram::SetBinaryCacheDirectory(), if none was set the
+   * directory in the environment variable BLENDINT_PROGRAM_CACHE is used
+   * (an empty value disables the cache), or
+   * $XDG_CACHE_HOME/blendint/programs.
+   */
   static bool InitializeGLContext ();
 
+  /**
+   * @brief The time spent in the last InitializeGLContext()
+   */
+  static inline const StartupProfile& startup_profile ()
+  {
+    return kStartupProfile;
+  }
+
   static void ReleaseGLContext ();
 
   static inline std::thread::id& main_thread_id ()
@@ -275,6 +436,55 @@ public:
     return kShaders;
   }
 
+  /**
+   * @brief The shared vertex arena of a vertex layout
+   * @param components 2 for (x, y), 3 for (x, y, shade), 4 for text
+   * glyphs (x, y, u, v)
+   * @return The arena bound to AttributeCoord, or 0 if the OpenGL
+   * context is released
+   */
+  static inline GLVertexArena* vertex_arena (int components)
+  {
+    switch (components) {
+      case 3:
+        return kShadedArena;
+      case 4:
+        return kTextArena;
+      default:
+        return kCoordArena;
+    }
+  }
+
+  /**
+   * @brief Add the area of a view to the damage region of its window
+   *
+   * Does nothing if the view is not in a window.
+   */
+  static void DamageView (const AbstractView* view);
+
+  /**
+   * @brief Redraw only the damaged area of windows or not
+   *
+   * In partial redraw (the default) a window is drawn into a retained
+   * framebuffer, only the views intersecting the damaged rectangles
+   * are redrawn, clipped by scissor, and the result is copied to the
+   * back buffer.
+   */
+  static void SetPartialRedraw (bool partial);
+
+  /**
+   * @brief Wake up the event loop of the main window to synchronize it
+   *
+   * Safe to call in any thread, used by worker threads to hand their
+   * results to the UI thread.
+   */
+  static void WakeUpMainWindow ();
+
+  static inline bool partial_redraw ()
+  {
+    return kPartialRedraw;
+  }
+
 protected:
 
   virtual bool PreDraw (AbstractWindow* context);
@@ -351,12 +561,62 @@ protected:
     window->PostDraw(window);
   }
 
+  /**
+   * @brief Bind the retained framebuffer and take the damaged area
+   * @return The count of redraw passes, at least 1
+   */
+  static inline size_t begin_partial_redraw (AbstractWindow* window)
+  {
+    return window->BeginPartialRedraw();
+  }
+
+  /**
+   * @brief Scissor to the damaged rectangle of a pass
+   *
+   * The window is predrawn, drawn and postdrawn in every pass, the
+   * scissor makes it clear and redraw only the rectangle of the pass.
+   */
+  static inline void begin_redraw_pass (AbstractWindow* window,
+                                        size_t pass)
+  {
+    window->BeginRedrawPass(pass);
+  }
+
+  /**
+   * @brief Copy the retained framebuffer to the back buffer
+   */
+  static inline void end_partial_redraw (AbstractWindow* window)
+  {
+    window->EndPartialRedraw();
+  }
+
+  /**
+   * @brief Mark a view and all its sub views to be redrawn
+   *
+   * Used when something shared by all views changed, e.g. glyphs
+   * rasterized in background arrived.
+   */
+  static void refresh_all (AbstractView* view);
+
+  /**
+   * @brief Delete the vertex arrays the arenas created in a context
+   *
+   * Call with the context current before it is destroyed.
+   */
+  static void ReleaseVertexArrays (const void* context);
+
   static Theme* kTheme;
 
   static Icons* kIcons;
 
   static Shaders* kShaders;
 
+  static GLVertexArena* kCoordArena;
+
+  static GLVertexArena* kShadedArena;
+
+  static GLVertexArena* kTextArena;
+
 private:
 
   friend class AbstractFrame;
@@ -364,11 +624,20 @@ private:
 
   static bool InitializeTheme ();
 
-  static bool InitializeIcons ();
+  static bool InitializeIcons (const Image& icons16, const Image& icons32);
 
   static bool InitializeShaders ();
 
-  static bool InitializeFont ();
+  static bool InitializeVertexArenas ();
+
+  static bool InitializeFont (const Fc::Pattern& match);
+
+  // load the theme and match the default font in it, run in a worker
+  // thread in InitializeGLContext()
+  static bool LoadThemeAndMatchFont (Fc::Pattern* match,
+                                     StartupProfile* profile);
+
+  static void SetDefaultProgramCacheDirectory ();
 
   static void ReleaseTheme ();
 
@@ -376,12 +645,36 @@ private:
 
   static void ReleaseShaders ();
 
+  static void ReleaseVertexArenas ();
+
   static void ReleaseFont ();
 
   static void GetGLVersion (int *major, int *minor);
 
   static void GetGLSLVersion (int *major, int *minor);
 
+  // get the rect of a view in window coordinates, return the window or
+  // 0 if the view is not in a window
+  static AbstractWindow* GetWindowRect (const AbstractView* view, Rect* rect);
+
+  // the area covered by a view including the shadow of frames
+  static Rect GetCoveredRect (const AbstractView* view, const Rect& rect);
+
+  size_t BeginPartialRedraw ();
+
+  void BeginRedrawPass (size_t pass);
+
+  void EndPartialRedraw ();
+
+  // return false if the retained framebuffer was (re)created and its
+  // contents are undefined
+  bool UpdateRetainedFramebuffer ();
+
+  void ReleaseRetainedFramebuffer ();
+
+  // enable the scissor test with the top of the clip stack, or disable it
+  void ApplyScissor ();
+
   AbstractFrame* active_frame_;
 
   AbstractFrame* focused_frame_;
@@ -393,6 +686,48 @@ private:
 
   GLuint stencil_count_;
 
+  // the scissor boxes in framebuffer coordinates, the top one is used
+  std::vector<Rect> clip_stack_;
+
+  // the viewport set by SetViewport()
+  Rect viewport_;
+
+  GLFramebufferPool framebuffer_pool_;
+
+  // the area damaged since the last frame
+  DamageRegion damage_;
+
+  // the area redrawn in the current frame
+  DamageRegion frame_damage_;
+
+  // the rectangles redrawn one by one in the current frame
+  std::vector<Rect> redraw_rects_;
+
+  // the views overlapping this area are drawn, the rectangle of the
+  // current pass or of an off-screen buffer being rendered
+  Rect damage_clip_;
+
+  // damage may be reported in other threads
+  std::mutex damage_mutex_;
+
+  // set while an off-screen buffer is rendered as a whole
+  bool redraw_all_;
+
+  // the framebuffer this window is drawn into, 0 for the default one
+  GLuint window_framebuffer_;
+
+  // the framebuffer bound for drawing, the window framebuffer or the
+  // off-screen target being rendered
+  GLuint draw_framebuffer_;
+
+  GLuint retained_framebuffer_;
+
+  GLuint retained_color_;
+
+  GLuint retained_depth_stencil_;
+
+  Size retained_size_;
+
   CursorShape current_cursor_shape_;
 
   std::stack<CursorShape> cursor_stack_;
@@ -409,6 +744,10 @@ private:
   bool overlap_;
 
   static AbstractWindow* kMainWindow;
+
+  static bool kPartialRedraw;
+
+  static StartupProfile kStartupProfile;
 };
 
 inline int pixel_size (int a)
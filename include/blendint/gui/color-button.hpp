@@ -23,7 +23,7 @@
 
 #pragma once
 
-#include <blendint/opengl/gl-buffer.hpp>
+#include <blendint/gui/rounded-geometry.hpp>
 
 #include <blendint/core/color.hpp>
 #include <blendint/gui/abstract-button.hpp>
@@ -78,9 +78,7 @@ private:
 
   void OnSelectorDestroyed (AbstractFrame* sender);
 
-  GLuint vao_[2];
-
-  GLBuffer<ARRAY_BUFFER, 2> vbo_;
+  RoundedGeometry geometry_;
 
   Color color0_;
   Color color1_;
@@ -26,7 +26,10 @@
 // generate makefile with cmake -DENABLE_OPENCV to activate
 #ifdef __USE_OPENCV__
 
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
+#include <thread>
 
 #include <opencv2/core/core.hpp>
 #include <opencv2/highgui/highgui.hpp>
@@ -40,6 +43,36 @@
 
 namespace BlendInt {
 
+/**
+ * @brief Frame counters of the video stream in a CVImageView
+ */
+struct VideoFrameStats
+{
+  VideoFrameStats ()
+  : decoded(0), presented(0), dropped(0)
+  {
+  }
+
+  // frames read from the stream
+  unsigned long decoded;
+
+  // frames uploaded and drawn
+  unsigned long presented;
+
+  // frames decoded but replaced by a newer one before they were drawn
+  unsigned long dropped;
+};
+
+/**
+ * @brief Show an image or a video stream with OpenCV
+ *
+ * Video frames are decoded in a worker thread into a ring of frame
+ * buffers, which are reused when the frame size does not change. The
+ * newest frame is uploaded in Draw() through pixel buffer objects used
+ * in turn, so the transfer does not block the next frame. If drawing
+ * is slower than decoding, older frames are dropped and counted in
+ * stats().
+ */
 class CVImageView: public AbstractScrollable
 {
 
@@ -83,11 +116,23 @@ public:
 
   /**
    * @brief Release all OpenCV data
+   *
+   * The decode thread is stopped here, a subclass overriding
+   * ProcessImage() should call this in its destructor.
    */
   void Release ();
 
+  VideoFrameStats stats () const;
+
+  void reset_stats ();
+
 protected:
 
+  /**
+   * @brief Process a decoded frame
+   *
+   * Called in the decode thread for each frame of a video stream.
+   */
   virtual void ProcessImage (cv::Mat& image);
 
   void DrawTexture ();
@@ -143,6 +188,46 @@ private:
 
   void OnUpdateFrame ();
 
+  // the loop of the decode thread
+  void Decode ();
+
+  // get a frame buffer to decode into, called with mutex_ locked
+  int GetFreeFrame ();
+
+  // upload the newest decoded frame to texture_, return false if no
+  // frame is ready
+  bool UploadFrame ();
+
+  void StartDecoding ();
+
+  void QuitDecoding ();
+
+  static void GetPixelFormat (int channels,
+                              GLint* internal_format,
+                              GLenum* format);
+
+  enum FrameState
+  {
+    FrameFree,
+    FrameDecoding,
+    FrameReady,
+    FramePresenting
+  };
+
+  struct Frame
+  {
+    Frame ()
+    : state(FrameFree), sequence(0)
+    {
+    }
+
+    cv::Mat image;
+
+    FrameState state;
+
+    unsigned long sequence;
+  };
+
   /**
    * @brief Vertex Array Objects
    *
@@ -156,15 +241,52 @@ private:
 
   GLTexture2D texture_;
 
+  // the size and format texture_ is allocated with
+  Size texture_size_;
+
+  GLenum texture_format_;
+
+  // pixel buffers to stream frames in turn
+  GLBuffer<PIXEL_UNPACK_BUFFER, 2> pbo_;
+
+  int pbo_index_;
+
   cv::VideoCapture video_stream_;
 
   cv::Mat image_;
 
   RefPtr<Timer> timer_;
 
-  std::mutex mutex_;
+  // one frame is decoded, one is uploaded and one is ready for the next
+  // draw
+  static const int kFrameCount = 3;
+
+  Frame frames_[kFrameCount];
+
+  std::thread thread_;
+
+  // guards frames_, stats_ and the requests to the decode thread
+  mutable std::mutex mutex_;
+
+  std::condition_variable condition_;
+
+  bool decoding_;
+
+  // seek to the first frame of a video file
+  bool rewind_;
+
+  bool quit_;
+
+  // the stream is a camera, set before the decode thread starts
+  bool camera_;
+
+  // microseconds between two frames
+  uint64_t interval_;
+
+  // a frame was decoded since the last upload
+  std::atomic<bool> frame_ready_;
 
-  AbstractWindow* off_screen_context_;
+  VideoFrameStats stats_;
 
   Size image_size_;
 
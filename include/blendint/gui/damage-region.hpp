@@ -0,0 +1,120 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free software:
+ * you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is distributed in
+ * the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+
+#pragma once
+
+#include <vector>
+
+#include <blendint/core/rect.hpp>
+
+namespace BlendInt {
+
+/**
+ * @brief The damaged area of a window to be redrawn in the next frame
+ *
+ * Rectangles are in window coordinates. Overlapping or close
+ * rectangles are merged when added, and all rectangles collapse to
+ * their bounding box when there are too many.
+ */
+class DamageRegion
+{
+ public:
+
+  DamageRegion ();
+
+  ~DamageRegion ();
+
+  void Add (const Rect& rect);
+
+  /**
+   * @brief Damage the whole window
+   */
+  void AddAll ();
+
+  void Clear ();
+
+  /**
+   * @brief Check if a rectangle overlaps any damaged area
+   */
+  bool Intersects (const Rect& rect) const;
+
+  /**
+   * @brief The rectangles a partial redraw scissors, clears and redraws
+   * one by one
+   *
+   * The damaged rectangles, or only their bounding box when they cover
+   * most of it, as one pass over the bounding box costs less than
+   * drawing the views in between several times.
+   */
+  void GetRedrawRects (std::vector<Rect>* rects) const;
+
+  inline bool full () const
+  {
+    return full_;
+  }
+
+  inline bool empty () const
+  {
+    return (!full_) && rects_.empty();
+  }
+
+  inline const std::vector<Rect>& rects () const
+  {
+    return rects_;
+  }
+
+  /**
+   * @brief The bounding box of all damaged rectangles
+   */
+  inline const Rect& bounds () const
+  {
+    return bounds_;
+  }
+
+  static bool Intersect (const Rect& rect1, const Rect& rect2);
+
+  static Rect Unite (const Rect& rect1, const Rect& rect2);
+
+  /**
+   * @brief The overlapped area of 2 rectangles, zero sized if none
+   */
+  static Rect Intersection (const Rect& rect1, const Rect& rect2);
+
+  static const size_t kMaxRects = 8;
+
+ private:
+
+  static inline long area (const Rect& rect)
+  {
+    return (long) rect.width() * rect.height();
+  }
+
+  std::vector<Rect> rects_;
+
+  Rect bounds_;
+
+  bool full_;
+};
+
+}
@@ -0,0 +1,158 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free software:
+ * you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is distributed in
+ * the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <stdint.h>
+
+#include <blendint/core/types.hpp>
+
+namespace BlendInt {
+
+/**
+ * @brief The attributes of a file found in DirectoryScanner
+ */
+struct DirectoryEntry
+{
+  DirectoryEntry ()
+  : directory(false),
+    regular(false),
+    size(0),
+    last_write_time(0),
+    permissions(0)
+  {
+  }
+
+  // the file name without the path
+  std::string name;
+
+  bool directory;
+
+  bool regular;
+
+  // the file size, 0 if not a regular file
+  uintmax_t size;
+
+  std::time_t last_write_time;
+
+  unsigned int permissions;
+};
+
+/**
+ * @brief Read the attributes of a file in a directory
+ * @return false if the file does not exist
+ */
+bool ReadDirectoryEntry (const std::string& directory,
+                         const std::string& name,
+                         DirectoryEntry* entry);
+
+/**
+ * @brief List a directory in a worker thread
+ *
+ * The directory iteration and the stat calls for each entry run in a
+ * background thread, so a huge or slow (e.g. network mounted)
+ * directory does not block the UI thread. Entries are published in
+ * batches and collected with Take() in the UI thread.
+ */
+class DirectoryScanner
+{
+ public:
+
+  DirectoryScanner ();
+
+  ~DirectoryScanner ();
+
+  /**
+   * @brief Start listing a directory
+   *
+   * The listing in progress is cancelled and the entries not taken are
+   * dropped.
+   */
+  void Start (const std::string& pathname);
+
+  /**
+   * @brief Cancel the listing in progress
+   */
+  void Cancel ();
+
+  /**
+   * @brief Move the entries found so far into entries
+   * @param[out] entries Entries are appended here
+   * @param[out] finished Set to true if the listing is complete (or
+   * failed) and all entries were taken
+   * @return The number of entries taken
+   */
+  size_t Take (std::vector<DirectoryEntry>* entries, bool* finished);
+
+  /**
+   * @brief If a listing is in progress
+   */
+  bool busy () const;
+
+ private:
+
+  void Run ();
+
+  // publish a batch, return false if the request was cancelled
+  bool Publish (unsigned int request, std::vector<DirectoryEntry>* batch);
+
+  std::thread thread_;
+
+  mutable std::mutex mutex_;
+
+  std::condition_variable condition_;
+
+  std::string pathname_;
+
+  // increased in each Start() and Cancel(), checked by the worker
+  // between entries
+  std::atomic<unsigned int> request_;
+
+  // a request is waiting for the worker
+  bool pending_;
+
+  // the listing of the current request is complete
+  bool finished_;
+
+  bool stop_;
+
+  std::vector<DirectoryEntry> results_;
+
+  // publish at most every kBatchSize entries or kBatchInterval
+  // microseconds
+  static const size_t kBatchSize = 256;
+
+  static const uint64_t kBatchInterval = 30000;
+
+  DISALLOW_COPY_AND_ASSIGN(DirectoryScanner);
+};
+
+}
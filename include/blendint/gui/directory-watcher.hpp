@@ -0,0 +1,196 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free software:
+ * you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is distributed in
+ * the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <stdint.h>
+
+#include <blendint/core/types.hpp>
+#include <blendint/cppevent/event.hpp>
+
+#include <blendint/gui/directory-scanner.hpp>
+
+namespace BlendInt {
+
+/**
+ * @brief A change of a file in a watched directory
+ */
+struct DirectoryChange
+{
+  enum Type
+  {
+    Created,
+    Removed,
+    Modified,
+    Renamed
+  };
+
+  Type type;
+
+  // the file name, the old name if renamed
+  std::string name;
+
+  // the new attributes, empty if removed
+  DirectoryEntry entry;
+};
+
+/**
+ * @brief Watch the files in a directory with inotify
+ *
+ * The inotify events are read in a worker thread. Events of a file in a
+ * short interval are coalesced, a pair of moves in the directory becomes
+ * one Renamed change, and the attributes of the files are read in the
+ * worker too. The event loop is woken up when changes arrive, and
+ * changed() is fired in the UI thread in ProcessChanges().
+ *
+ * Only available on Linux, Watch() fails on other platforms.
+ */
+class DirectoryWatcher
+{
+ public:
+
+  DirectoryWatcher ();
+
+  ~DirectoryWatcher ();
+
+  /**
+   * @brief Watch a directory, the previous one is not watched any more
+   * @return false if the directory cannot be watched
+   */
+  bool Watch (const std::string& pathname);
+
+  void Stop ();
+
+  /**
+   * @brief Move the changes arrived into changes
+   * @param[out] changes Changes are appended here in the order they
+   * happened
+   * @param[out] reset Set to true if events were lost or the directory
+   * itself was removed or moved, the directory should be listed again
+   * @return The number of changes taken
+   */
+  size_t Take (std::vector<DirectoryChange>* changes, bool* reset);
+
+  inline bool watching () const
+  {
+    return !pathname_.empty();
+  }
+
+  inline const std::string& pathname () const
+  {
+    return pathname_;
+  }
+
+  /**
+   * @brief Fired in ProcessChanges() when changes can be taken
+   */
+  CppEvent::EventRef<> changed ()
+  {
+    return changed_;
+  }
+
+  /**
+   * @brief Fire changed() of the watchers with changes arrived
+   * @return True if any watcher changed
+   *
+   * Called in the event loop of the UI thread.
+   */
+  static bool ProcessChanges ();
+
+ private:
+
+  void Run ();
+
+  // read and handle the events available, return false if the inotify
+  // descriptor failed
+  bool ReadEvents ();
+
+  // add a change of the batch, a move is paired by the cookie
+  void AddChange (DirectoryChange::Type type,
+                  const std::string& name,
+                  uint32_t cookie);
+
+  // read the attributes of the files changed and move the batch to
+  // results_
+  void Publish ();
+
+  std::thread thread_;
+
+  std::mutex mutex_;
+
+  std::string pathname_;
+
+  // the directory of the current watch, guarded by mutex_
+  std::string directory_;
+
+  int inotify_;
+
+  // written to wake up the worker to quit
+  int wakeup_;
+
+  // the watch descriptor of the directory, -1 if not watching
+  std::atomic<int> watch_;
+
+  bool stop_;
+
+  // the changes published to the UI thread
+  std::vector<DirectoryChange> results_;
+
+  bool reset_;
+
+  // results_ was filled since the last ProcessChanges()
+  std::atomic<bool> ready_;
+
+  // the changes being coalesced in the worker, of the watch batch_watch_
+  std::vector<DirectoryChange> batch_;
+
+  int batch_watch_;
+
+  bool batch_reset_;
+
+  // the index in batch_ of the last change of each file
+  std::unordered_map<std::string, size_t> index_;
+
+  // the index in batch_ of the files moved out, by the cookie
+  std::unordered_map<uint32_t, size_t> moves_;
+
+  CppEvent::Event<> changed_;
+
+  static std::set<DirectoryWatcher*> kWatchers;
+
+  // the minimal interval in milliseconds between two publishes, events
+  // of a busy directory are coalesced in it
+  static const int kPublishInterval = 50;
+
+  DISALLOW_COPY_AND_ASSIGN(DirectoryWatcher);
+};
+
+}
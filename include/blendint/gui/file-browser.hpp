@@ -31,6 +31,7 @@
 #include <blendint/gui/font.hpp>
 #include <blendint/gui/abstract-item-view.hpp>
 #include <blendint/gui/filesystem-model.hpp>
+#include <blendint/gui/filesystem-proxy-model.hpp>
 
 namespace BlendInt {
 
@@ -82,12 +83,38 @@ public:
     return pathname_;
   }
 
+  /**
+   * @brief Sort the files by a column of FileSystemModel
+   */
+  void SetSortColumn (int column,
+                      SortFilterProxyModel::SortOrder order =
+                          SortFilterProxyModel::AscendingOrder);
+
+  /**
+   * @brief Only show the files whose name contains the pattern
+   */
+  void SetFilter (const String& pattern);
+
+  /**
+   * @brief Select the first file whose name starts with prefix
+   * @return True if found
+   */
+  bool SelectByPrefix (const String& prefix);
+
   virtual bool IsExpandX () const;
 
   virtual bool IsExpandY () const;
 
   virtual const RefPtr<AbstractItemModel> GetModel () const;
 
+  /**
+   * @brief The sorted and filtered rows shown in this view
+   */
+  const RefPtr<FileSystemProxyModel>& proxy () const
+  {
+    return proxy_;
+  }
+
   /**
    * @brief Set the model used in this item view
    * @param model A RefPtr to a item model, must be FileSystemModel
@@ -112,10 +139,16 @@ protected:
 
   virtual Response PerformMousePress (AbstractWindow* context);
 
+  virtual Response PerformKeyPress (AbstractWindow* context);
+
 private:
 
   void InitializeFileBrowserOnce ();
 
+  void OnLayoutChanged ();
+
+  void SelectRow (int row);
+
   GLuint vaos_[2];
 
   Font font_;
@@ -136,6 +169,13 @@ private:
 
   RefPtr<FileSystemModel> model_;
 
+  RefPtr<FileSystemProxyModel> proxy_;
+
+  // the prefix typed for the type-ahead search
+  String search_;
+
+  uint64_t last_search_time_;
+
   int highlight_index_;
 
   CppEvent::Event<> selected_;
@@ -23,7 +23,15 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
+
+#include <blendint/cppevent/event.hpp>
+#include <blendint/core/timer.hpp>
+
 #include <blendint/gui/abstract-item-model.hpp>
+#include <blendint/gui/directory-scanner.hpp>
+#include <blendint/gui/directory-watcher.hpp>
 
 namespace BlendInt {
 
@@ -35,11 +43,30 @@ namespace BlendInt {
  *
  * The default constructor does nothing, use Load() to load and store a file
  * list in a path.
+ *
+ * The directory is listed in a DirectoryScanner, rows are appended in
+ * batches in the UI thread as they arrive and rows_loaded() is fired
+ * for each batch. The columns except the name are formatted when they
+ * are drawn the first time.
+ *
+ * The loaded directory is watched by a DirectoryWatcher, files created,
+ * removed, renamed or modified later are applied as row changes with
+ * rows_loaded(), rows_removed() and row_changed(), the other rows are
+ * kept.
  */
-class FileSystemModel: public AbstractItemModel
+class FileSystemModel: public AbstractItemModel, public CppEvent::Trackable
 {
 public:
 
+  enum Column
+  {
+    NameColumn,
+    LastWriteTimeColumn,
+    TypeColumn,
+    SizeColumn,
+    PermissionsColumn
+  };
+
   FileSystemModel ();
 
   virtual ~FileSystemModel ();
@@ -48,13 +75,80 @@ public:
    * @brief List files in a path
    * @param pathname The path name
    * @return
-   * 	- true success
+   * 	- true if the path is a directory and the listing started
    * 	- false failure
+   *
+   * The previous listing is cancelled and the rows are cleared, the
+   * new rows are added in the next event loop iterations.
    */
   bool Load (const std::string& pathname);
 
+  /**
+   * @brief Stop adding rows of the listing in progress
+   */
+  void Cancel ();
+
   void Clear ();
 
+  /**
+   * @brief Get the attributes of the file in a row
+   *
+   * Rows inserted with InsertRows() have empty attributes.
+   */
+  const DirectoryEntry& GetEntry (int row) const;
+
+  inline bool loading () const
+  {
+    return loading_;
+  }
+
+  inline const std::string& pathname () const
+  {
+    return pathname_;
+  }
+
+  /**
+   * @brief Fired when rows of the listing are appended, with the first
+   * row and the count
+   */
+  CppEvent::EventRef<int, int> rows_loaded ()
+  {
+    return rows_loaded_;
+  }
+
+  /**
+   * @brief Fired when rows are removed for deleted files, with the
+   * first row and the count
+   */
+  CppEvent::EventRef<int, int> rows_removed ()
+  {
+    return rows_removed_;
+  }
+
+  /**
+   * @brief Fired when the file of a row is modified or renamed
+   */
+  CppEvent::EventRef<int> row_changed ()
+  {
+    return row_changed_;
+  }
+
+  /**
+   * @brief Fired when all rows are removed in Clear() or Load()
+   */
+  CppEvent::EventRef<> cleared ()
+  {
+    return cleared_;
+  }
+
+  /**
+   * @brief Fired when the listing is complete
+   */
+  CppEvent::EventRef<> load_finished ()
+  {
+    return load_finished_;
+  }
+
   virtual int GetRowCount (const ModelIndex& superview = ModelIndex()) const
       override;
 
@@ -102,8 +196,35 @@ protected:
     return root_;
   }
 
+  /**
+   * @brief Apply changes of the directory as row changes
+   * @param changes The changes in the order they happened
+   * @param reset If the directory should be listed again
+   */
+  void ApplyChanges (const std::vector<DirectoryChange>& changes, bool reset);
+
 private:
 
+  void OnCheckLoading ();
+
+  void OnDirectoryChanged ();
+
+  // apply the changes taken from the watcher
+  void ApplyChanges ();
+
+  // create the nodes of a row, linked from left to right
+  static ModelNode* CreateRow (const DirectoryEntry& entry);
+
+  // create a row and append it to the tail
+  void AppendRow (const DirectoryEntry& entry);
+
+  // find the row of a file, return the first node and set row, or 0
+  ModelNode* FindRow (const std::string& name, int* row) const;
+
+  void RemoveRow (ModelNode* node, int row);
+
+  void UpdateRow (ModelNode* node, int row, const DirectoryEntry& entry);
+
   void InsertColumns (int column, int count, ModelNode* left);
 
   void DestroyColumnsInRow (int column, int count, ModelNode* node);
@@ -118,8 +239,41 @@ private:
 
   ModelNode* root_;
 
+  // the last row, 0 if it needs to be searched
+  ModelNode* last_;
+
+  // the attributes of each row
+  std::vector<DirectoryEntry> entries_;
+
+  std::string pathname_;
+
+  DirectoryScanner scanner_;
+
+  DirectoryWatcher watcher_;
+
+  RefPtr<Timer> timer_;
+
+  bool loading_;
+
+  CppEvent::Event<int, int> rows_loaded_;
+
+  CppEvent::Event<int, int> rows_removed_;
+
+  CppEvent::Event<int> row_changed_;
+
+  CppEvent::Event<> load_finished_;
+
+  CppEvent::Event<> cleared_;
+
   static const int DefaultColumns = 5;
 
+  // the interval in milliseconds to check the rows listed
+  static const unsigned int kLoadingInterval = 20;
+
+  // more removed, renamed or modified files than this in one batch are
+  // applied by listing the directory again
+  static const size_t kMaxRowChanges = 256;
+
 };
 
 }
@@ -0,0 +1,82 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free software:
+ * you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is distributed in
+ * the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+#pragma once
+
+#include <blendint/gui/filesystem-model.hpp>
+#include <blendint/gui/sort-filter-proxy-model.hpp>
+
+namespace BlendInt {
+
+/**
+ * @brief Sort and filter the files in a FileSystemModel
+ *
+ * The columns are sorted by the file attributes (e.g. the size and the
+ * last write time in numbers instead of the formatted text), folders
+ * are listed first. Rows streamed into the source model are merged
+ * as they arrive, rows removed or changed by the directory watcher are
+ * updated in place.
+ */
+class FileSystemProxyModel: public SortFilterProxyModel
+{
+ public:
+
+  FileSystemProxyModel (const RefPtr<FileSystemModel>& model);
+
+  virtual ~FileSystemProxyModel ();
+
+  void SetFoldersFirst (bool folders_first);
+
+  inline bool folders_first () const
+  {
+    return folders_first_;
+  }
+
+  inline const RefPtr<FileSystemModel>& filesystem_model () const
+  {
+    return model_;
+  }
+
+ protected:
+
+  virtual bool LessThan (int source_left, int source_right) const override;
+
+  virtual int GetSortGroup (int source_row) const override;
+
+ private:
+
+  void OnRowsLoaded (int first, int count);
+
+  void OnRowsRemoved (int first, int count);
+
+  void OnRowChanged (int row);
+
+  void OnModelCleared ();
+
+  RefPtr<FileSystemModel> model_;
+
+  bool folders_first_;
+
+};
+
+}
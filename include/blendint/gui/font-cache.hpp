@@ -24,6 +24,9 @@
 #pragma once
 
 #include <map>
+#include <set>
+#include <string>
+#include <vector>
 
 #include <blendint/core/string.hpp>
 #include <blendint/core/object.hpp>
@@ -34,38 +37,209 @@
 
 #include <blendint/gui/texture-atlas.hpp>
 #include <blendint/gui/glyph.hpp>
+#include <blendint/gui/glyph-table.hpp>
+#include <blendint/gui/glyph-rasterizer.hpp>
 
 namespace BlendInt {
 
+  /**
+   * @brief Statistics of glyph queries in a FontCache
+   */
+  struct FontCacheStats
+  {
+    FontCacheStats ()
+    : hits(0), misses(0), rasterization_time(0)
+    {
+    }
+
+    // queries found in the glyph table
+    unsigned long hits;
+
+    // queries which rasterized a new glyph
+    unsigned long misses;
+
+    // total time in microseconds spent in rasterizing and uploading glyphs
+    uint64_t rasterization_time;
+  };
+
   class FontCache: public Object
   {
   public:
 
+    /**
+     * @brief Get the font cache of a matched pattern
+     *
+     * Font caches are kept in a registry keyed by the pattern hash. When
+     * the total memory_usage() exceeds the memory budget, the least
+     * recently used caches not referenced by any Font are released.
+     */
     static RefPtr<FontCache> Create (const Fc::Pattern& pattern);
 
     static bool Release (const Fc::Pattern& data);
 
+    /**
+     * @brief Find the font matching a pattern
+     * @param[in] pattern The requested pattern, not substituted
+     * @param[out] result The result of fontconfig match
+     *
+     * Runs fontconfig substitution and matching, the matched patterns
+     * are memorized so the same request (e.g. a known family in a new
+     * size) skips fontconfig.
+     */
+    static Fc::Pattern Match (const Fc::Pattern& pattern, FcResult* result);
+
     static inline size_t cache_size ()
     {
       return kCacheDB.size();
     }
 
-    static inline size_t max_cache_size ()
+    /**
+     * @brief Set the max bytes of all font caches in the registry
+     *
+     * The default font and the caches in use may exceed the budget.
+     */
+    static void SetMemoryBudget (size_t bytes);
+
+    static inline size_t memory_budget ()
+    {
+      return kMemoryBudget;
+    }
+
+    static size_t GetTotalMemoryUsage ();
+
+    /**
+     * @brief Rasterize glyphs in background threads or not
+     *
+     * In asynchronous mode (the default) a glyph not in cache is queued
+     * to the worker threads and Query() returns fallback() until the
+     * glyph is uploaded in UploadPendingGlyphs().
+     */
+    static void SetAsyncRasterization (bool async);
+
+    static inline bool async_rasterization ()
+    {
+      return kAsyncRasterization;
+    }
+
+    /**
+     * @brief Upload the glyphs rasterized in background threads
+     * @return True if any glyph arrived
+     *
+     * Glyphs of each font cache are uploaded in one batched transfer.
+     * Must be called in the render thread with a current OpenGL
+     * context, once per frame.
+     */
+    static bool UploadPendingGlyphs ();
+
+    /**
+     * @brief Set the max bytes of the texture atlas of font caches
+     * created after this call
+     */
+    static void SetAtlasMemoryBudget (size_t bytes);
+
+    static inline size_t atlas_memory_budget ()
     {
-      return kMaxCacheSize;
+      return kAtlasMemoryBudget;
     }
 
     FontCache (const Fc::Pattern& pattern);
 
     virtual ~FontCache ();
 
-    const Glyph* Query (uint32_t charcode, bool create = true);
+    /**
+     * @brief Get the glyph of a character
+     * @param charcode The unicode of the character
+     * @param create Rasterize the glyph if it's not in cache
+     * @return The glyph, or 0 if it's not in cache and create is false
+     */
+    inline const Glyph* Query (uint32_t charcode, bool create = true)
+    {
+      const Glyph* glyph = glyph_data_.find(charcode);
+
+      if (glyph) {
+        stats_.hits++;
+        texture_atlas_->Touch(glyph->page);
+        return glyph;
+      }
+
+      if (!create) return 0;
+
+      return kAsyncRasterization ? Request(charcode) : Rasterize(charcode);
+    }
+
+    /**
+     * @brief The blank glyph returned while a glyph is being rasterized
+     */
+    const Glyph* fallback () const
+    {
+      return &fallback_;
+    }
+
+    /**
+     * @brief A counter increased each time pending glyphs arrive
+     *
+     * Text which got fallback() from Query() should regenerate its
+     * vertices when this changes.
+     */
+    unsigned int generation () const
+    {
+      return generation_;
+    }
+
+    /**
+     * @brief Changed each time an atlas page is evicted
+     *
+     * Text which used any glyph before should regenerate its vertices
+     * when this changes.
+     */
+    unsigned int evictions () const
+    {
+      return texture_atlas_->evictions();
+    }
+
+    size_t pending_count () const
+    {
+      return pending_.size();
+    }
+
+    /**
+     * @brief Rasterize all characters in a unicode range in advance
+     * @param first The first character of the range
+     * @param last The last character of the range (inclusive)
+     * @return How many glyphs were rasterized
+     *
+     * Characters which are already cached or not contained in the font
+     * face are skipped. Use this at startup to avoid the stall when a
+     * character is drawn the first time.
+     */
+    int Preload (uint32_t first, uint32_t last);
 
     size_t glyph_count () const
     {
       return glyph_data_.size();
     }
 
+    /**
+     * @brief Approximate bytes used by the texture atlas (with its client
+     * side copy) and the glyphs
+     */
+    size_t memory_usage () const
+    {
+      return texture_atlas_->memory_usage() +
+          texture_atlas_->page_count() * texture_atlas_->page_width() * texture_atlas_->page_height() +
+          glyph_data_.size() * sizeof(Glyph);
+    }
+
+    const FontCacheStats& stats () const
+    {
+      return stats_;
+    }
+
+    void reset_stats ()
+    {
+      stats_ = FontCacheStats();
+    }
+
     const Fc::Pattern& pattern () const
     {
       return pattern_;
@@ -83,21 +257,82 @@ namespace BlendInt {
 
     static void ReleaseAll ();
 
+    const Glyph* Rasterize (uint32_t charcode);
+
+    // render a glyph with face_ and store it, without upload
+    const Glyph* Load (uint32_t charcode);
+
+    // pack the bitmap into the atlas and insert the glyph
+    const Glyph* Store (uint32_t charcode,
+                        const Glyph& metrics,
+                        const unsigned char* bitmap,
+                        int pitch);
+
+    const Glyph* Request (uint32_t charcode);
+
+    // release least recently used caches until the budget is met
+    static void Trim (const FontCache* keep);
+
+    struct MatchedPattern
+    {
+      Fc::Pattern request;
+      Fc::Pattern match;
+      FcResult result;
+    };
+
     Fc::Pattern pattern_;
 
+    std::string file_;
+
+    double size_;
+
+    double dpi_;
+
+    // FC_EMBOLDEN of the pattern, a bold weight synthesized on this face
+    bool embolden_;
+
     Ft::Library library_;
 
     Ft::Face face_;
 
     RefPtr<TextureAtlas> texture_atlas_;
 
-    std::map<uint32_t, Glyph> glyph_data_;
+    GlyphTable glyph_data_;
+
+    Glyph fallback_;
+
+    // characters queued to the rasterizer
+    std::set<uint32_t> pending_;
+
+    unsigned int generation_;
+
+    FontCacheStats stats_;
+
+    // the registry clock when this cache was last created or found
+    unsigned long last_used_;
 
     static std::map<FcChar32, RefPtr<FontCache> > kCacheDB;
 
     static FcChar32 kDefaultFontHash;
 
-    static const unsigned int kMaxCacheSize = 16;
+    static bool kAsyncRasterization;
+
+    static GlyphRasterizer* kRasterizer;
+
+    static size_t kAtlasMemoryBudget;
+
+    static const int kAtlasPageSize = 512;
+
+    static unsigned long kClock;
+
+    static size_t kMemoryBudget;
+
+    // memorized results of Match(), keyed by the request hash
+    static std::map<FcChar32, std::vector<MatchedPattern> > kMatchDB;
+
+    static size_t kMatchCount;
+
+    static const size_t kMaxMatchCount = 256;
   };
 
 } /* namespace BlendInt */
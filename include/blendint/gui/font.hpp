@@ -121,10 +121,17 @@ namespace BlendInt {
     /**
      * @brief Set font weight
      *
-     * Light, medium, demibold, bold or blank
+     * Light, medium, demibold, bold or blank. The face is kept unless a
+     * lighter weight is set on a bold face, a bold weight on a regular
+     * face is synthesized.
      */
     void SetWeight (int weight);
 
+    /**
+     * @brief Set font size
+     *
+     * Keeps the face, fontconfig is not run again.
+     */
     void SetSize (double size);
 
     void SetPixelSize (double pixel_size);
@@ -144,6 +151,53 @@ namespace BlendInt {
       return cache_->Query(charcode, true);
     }
 
+    /**
+     * @brief The blank glyph returned by glyph() while the real one is
+     * rasterized in background
+     */
+    const Glyph* fallback_glyph () const
+    {
+      return cache_->fallback();
+    }
+
+    /**
+     * @brief Changed each time glyphs rasterized in background arrive
+     * @see FontCache::generation()
+     */
+    unsigned int glyph_generation () const
+    {
+      return cache_->generation();
+    }
+
+    /**
+     * @brief Changed each time a page of the texture atlas is evicted
+     * @see FontCache::evictions()
+     */
+    unsigned int atlas_evictions () const
+    {
+      return cache_->evictions();
+    }
+
+    /**
+     * @brief The height of a page in the texture atlas
+     *
+     * The layer of a glyph is encoded in the V coordinate as
+     * offset_v + page * atlas_page_height().
+     */
+    int atlas_page_height () const
+    {
+      return cache_->texture_atlas()->page_height();
+    }
+
+    /**
+     * @brief Rasterize the glyphs of a unicode range in advance
+     * @see FontCache::Preload()
+     */
+    int Preload (uint32_t first, uint32_t last) const
+    {
+      return cache_->Preload(first, last);
+    }
+
     int height () const
     {
       return cache_->face_.face()->size->metrics.height >> 6;
@@ -169,6 +223,15 @@ namespace BlendInt {
       return cache_->face_.has_kerning();
     }
 
+    /**
+     * @brief The hash of the matched font pattern, equal fonts have the
+     * same hash
+     */
+    FcChar32 hash () const
+    {
+      return cache_->pattern().hash();
+    }
+
     void bind_texture () const
     {
       cache_->texture_atlas()->bind();
@@ -219,6 +282,30 @@ namespace BlendInt {
 
     friend inline bool operator == (const Font& src, const Font& dst);
 
+    const FcChar8* family () const;
+
+    double size () const;
+
+    // the weight asked for, bold if the face is emboldened
+    int requested_weight () const;
+
+    int requested_slant () const;
+
+    /**
+     * @brief Find the face of a family, weight and slant
+     *
+     * The request has no size so the memorized match in FontCache is
+     * found for any size, fontconfig runs once for a face.
+     */
+    static Fc::Pattern MatchFace (const Fc::Pattern& request);
+
+    /**
+     * @brief The pattern of a matched face in another size
+     *
+     * Keeps the file and all other properties of the face.
+     */
+    static Fc::Pattern Resize (const Fc::Pattern& face, double size);
+
     RefPtr<FontCache> cache_;
 
   };
@@ -0,0 +1,138 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free software:
+ * you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is distributed in
+ * the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+namespace BlendInt {
+
+/**
+ * @brief Time spent in each phase of a frame, in microseconds
+ */
+struct FrameTimings
+{
+  FrameTimings ()
+  : predraw(0), draw(0), swap(0), idle(0)
+  {
+  }
+
+  uint64_t predraw;
+
+  // Draw() and PostDraw()
+  uint64_t draw;
+
+  uint64_t swap;
+
+  // from the end of last frame to the start of this one
+  uint64_t idle;
+};
+
+/**
+ * @brief Paces and measures the frames drawn in the event loop
+ *
+ * Frames are drawn no faster than the refresh rate, a redraw requested
+ * earlier waits for the next frame slot so all requests in between are
+ * drawn in one frame.
+ */
+class FrameScheduler
+{
+ public:
+
+  enum FramePhase {
+    FramePredraw,
+    FrameDraw,
+    FrameSwap
+  };
+
+  FrameScheduler ();
+
+  ~FrameScheduler ();
+
+  /**
+   * @brief Set the max frames per second, 0 for no limit
+   */
+  void SetRefreshRate (int rate);
+
+  /**
+   * @brief Seconds to wait before the next frame can be drawn
+   */
+  double GetPacingDelay () const;
+
+  void BeginFrame ();
+
+  /**
+   * @brief Add the time since last mark to a phase of current frame
+   *
+   * Call this after each phase of each window drawn in the frame.
+   */
+  void Mark (FramePhase phase);
+
+  void EndFrame ();
+
+  void Reset ();
+
+  inline int refresh_rate () const
+  {
+    return refresh_rate_;
+  }
+
+  inline const FrameTimings& last_frame () const
+  {
+    return last_frame_;
+  }
+
+  /**
+   * @brief The sum of timings of all frames since last Reset()
+   */
+  inline const FrameTimings& total () const
+  {
+    return total_;
+  }
+
+  inline unsigned long frame_count () const
+  {
+    return frame_count_;
+  }
+
+ private:
+
+  int refresh_rate_;
+
+  uint64_t frame_start_;
+
+  uint64_t frame_end_;
+
+  uint64_t last_mark_;
+
+  FrameTimings current_;
+
+  FrameTimings last_frame_;
+
+  FrameTimings total_;
+
+  unsigned long frame_count_;
+
+};
+
+}
@@ -23,8 +23,7 @@
 
 #pragma once
 
-#include <blendint/opengl/gl-buffer.hpp>
-
+#include <blendint/gui/rounded-geometry.hpp>
 #include <blendint/gui/abstract-frame.hpp>
 
 namespace BlendInt {
@@ -109,11 +108,7 @@ private:
 
   AbstractWidget* hovered_widget_;
 
-  // 0 - for inner
-  // 1 - for outer
-  GLuint vao_[2];
-
-  GLBuffer<ARRAY_BUFFER, 2> vbo_;
+  RoundedGeometry geometry_;
 
   int cursor_position_;
 
@@ -0,0 +1,142 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free software:
+ * you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is distributed in
+ * the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <stdint.h>
+
+#include <blendint/core/types.hpp>
+#include <blendint/font/fc-pattern.hpp>
+#include <blendint/gui/glyph.hpp>
+
+namespace BlendInt {
+
+/**
+ * @brief A glyph to be rasterized in GlyphRasterizer
+ */
+struct GlyphRequest
+{
+  // the hash of the font pattern, to find the FontCache of the result
+  FcChar32 font;
+
+  std::string file;
+
+  double size;
+
+  double dpi;
+
+  // synthesize a bold weight
+  bool embolden;
+
+  uint32_t charcode;
+};
+
+/**
+ * @brief A glyph rasterized in a worker thread
+ *
+ * The offset_u and offset_v in glyph are not set, the bitmap is
+ * uploaded and packed into the texture atlas on the render thread.
+ */
+struct RasterizedGlyph
+{
+  FcChar32 font;
+
+  uint32_t charcode;
+
+  Glyph glyph;
+
+  // tightly packed 8-bit coverage of bitmap_width * bitmap_height
+  std::vector<unsigned char> bitmap;
+
+  // time in microseconds spent in the worker
+  uint64_t time;
+};
+
+/**
+ * @brief A thread pool to rasterize glyphs in background
+ *
+ * Each worker thread owns a FreeType library and the faces it opened,
+ * as FreeType objects cannot be shared between threads. Finished glyphs
+ * are collected with Take() on the render thread.
+ */
+class GlyphRasterizer
+{
+ public:
+
+  /**
+   * @brief Constructor
+   * @param notify Called in a worker thread when a glyph is ready, can
+   * be 0
+   * @param thread_count The number of worker threads, 0 to decide by
+   * the hardware concurrency
+   */
+  GlyphRasterizer (void (*notify) (), unsigned int thread_count = 0);
+
+  ~GlyphRasterizer ();
+
+  void Push (const GlyphRequest& request);
+
+  /**
+   * @brief Move all finished glyphs into results
+   * @return The number of glyphs taken
+   */
+  size_t Take (std::vector<RasterizedGlyph>* results);
+
+  size_t thread_count () const
+  {
+    return threads_.size();
+  }
+
+ private:
+
+  void Run ();
+
+  void (*notify_) ();
+
+  std::vector<std::thread> threads_;
+
+  std::mutex mutex_;
+
+  std::condition_variable condition_;
+
+  std::deque<GlyphRequest> requests_;
+
+  std::vector<RasterizedGlyph> results_;
+
+  bool stop_;
+
+  static const size_t kMaxFacesPerThread = 16;
+
+  static const unsigned int kMaxThreads = 4;
+
+  DISALLOW_COPY_AND_ASSIGN(GlyphRasterizer);
+};
+
+}
@@ -0,0 +1,126 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free software:
+ * you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is distributed in
+ * the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include <stdint.h>
+
+#include <blendint/gui/glyph.hpp>
+
+namespace BlendInt {
+
+/**
+ * @brief The glyph lookup table used in FontCache
+ *
+ * Glyphs of characters in the Basic Multilingual Plane are found with
+ * a direct index into lazily allocated pages of 256 characters (the
+ * Latin-1 page is always allocated), other characters are stored in an
+ * open-addressing hash table with linear probing.
+ *
+ * The glyphs are stored in a deque, so the pointers returned by find()
+ * and insert() stay valid until clear().
+ */
+class GlyphTable
+{
+ public:
+
+  GlyphTable ();
+
+  ~GlyphTable ();
+
+  inline const Glyph* find (uint32_t charcode) const
+  {
+    if (charcode < kDirectRange) {
+      Glyph* const * page = pages_[charcode >> kPageShift];
+      return page ? page[charcode & kPageMask] : 0;
+    }
+
+    return FindInHashTable(charcode);
+  }
+
+  /**
+   * @brief Insert or replace the glyph of a character
+   * @return The pointer of the stored glyph
+   */
+  const Glyph* insert (uint32_t charcode, const Glyph& glyph);
+
+  /**
+   * @brief Remove the glyphs stored in a page of the texture atlas
+   * @return The number of glyphs removed
+   *
+   * The table is rebuilt, so pointers returned before are invalid.
+   */
+  size_t erase_page (int page);
+
+  void clear ();
+
+  inline size_t size () const
+  {
+    return storage_.size();
+  }
+
+  // the characters directly indexed: the BMP
+  static const uint32_t kDirectRange = 0x10000;
+
+ private:
+
+  struct Slot
+  {
+    uint32_t charcode;
+    Glyph* glyph;	// 0 for an empty slot
+  };
+
+  const Glyph* FindInHashTable (uint32_t charcode) const;
+
+  void InsertInHashTable (uint32_t charcode, Glyph* glyph);
+
+  void Rehash (size_t capacity);
+
+  static inline size_t hash (uint32_t charcode)
+  {
+    // Fibonacci hashing
+    return (size_t) ((charcode * 2654435769u) >> 8);
+  }
+
+  static const int kPageShift = 8;
+
+  static const uint32_t kPageSize = 1 << kPageShift;
+
+  static const uint32_t kPageMask = kPageSize - 1;
+
+  static const uint32_t kPageCount = kDirectRange >> kPageShift;
+
+  std::deque<Glyph> storage_;
+
+  Glyph** pages_[kPageCount];
+
+  std::vector<Slot> slots_;
+
+  size_t slot_count_;
+
+};
+
+}
@@ -35,7 +35,8 @@ namespace BlendInt {
       advance_x(0),
       advance_y(0),
       offset_u(0),
-      offset_v(0)
+      offset_v(0),
+      page(0)
     {
     }
 
@@ -47,7 +48,8 @@ namespace BlendInt {
       advance_x(orig.advance_x),
       advance_y(orig.advance_y),
       offset_u(orig.offset_u),
-      offset_v(orig.offset_v)
+      offset_v(orig.offset_v),
+      page(orig.page)
     {
     }
 
@@ -64,6 +66,8 @@ namespace BlendInt {
       offset_u = orig.offset_u;
       offset_v = orig.offset_v;
 
+      page = orig.page;
+
       return *this;
     }
 
@@ -78,6 +82,9 @@ namespace BlendInt {
 
     int offset_u;
     int offset_v;
+
+    // the page in the texture atlas
+    int page;
   };
 
 } /* namespace BlendInt */
@@ -0,0 +1,100 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free software:
+ * you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is distributed in
+ * the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+
+#pragma once
+
+#include <vector>
+
+#include <blendint/core/types.hpp>
+#include <blendint/core/point.hpp>
+
+namespace BlendInt {
+
+class AbstractView;
+
+/**
+ * @brief A uniform grid over the sub views of a view for hit testing
+ *
+ * The grid indexes the sub widgets in the order of hover dispatch, from
+ * the last sub view (on top) to the first, and stops at the first sub
+ * view which is not a widget. A point is tested against the views in
+ * its cell only, so finding the view under the cursor costs about the
+ * same for a few views or a thousand.
+ *
+ * The grid does not track changes, AbstractView marks it dirty when a
+ * sub view is added, removed, restacked, moved or resized, and it is
+ * built again on the next query.
+ *
+ * Contain() of a sub view must not reach more than kMargin pixels out
+ * of its rectangle.
+ */
+class HitTestGrid
+{
+ public:
+
+  HitTestGrid ();
+
+  ~HitTestGrid ();
+
+  void Build (const AbstractView* view);
+
+  /**
+   * @brief Get the top sub view containing a point
+   * @param point A point in the coordinates of the sub views
+   * @return The sub view, or 0
+   */
+  AbstractView* Find (const Point& point) const;
+
+  // views with fewer sub views are tested one by one
+  static const int kMinViewCount = 16;
+
+  static const int kMargin = 2;
+
+ private:
+
+  // the indexed views, the top one first
+  std::vector<AbstractView*> views_;
+
+  // the first item of each cell, and the end of the last cell
+  std::vector<int> cells_;
+
+  // the indices of the views overlapping each cell, in ascending order
+  std::vector<int> items_;
+
+  int left_;
+
+  int bottom_;
+
+  int columns_;
+
+  int rows_;
+
+  int cell_width_;
+
+  int cell_height_;
+
+  DISALLOW_COPY_AND_ASSIGN(HitTestGrid);
+};
+
+}
@@ -26,6 +26,7 @@
 #include <blendint/opengl/gl-buffer.hpp>
 
 #include <blendint/gui/font.hpp>
+#include <blendint/gui/rounded-geometry.hpp>
 #include <blendint/gui/abstract-item-view.hpp>
 
 namespace BlendInt {
@@ -41,6 +42,12 @@ namespace BlendInt {
  * ListView is a subclass of AbstractScrollable, so it contains 2
  * native ScrollBar object and will be displayed automatically
  * when the widget cannot show all contents of the list.
+ *
+ * The drawing is virtualized: only the rows intersecting the visible
+ * area are drawn, the zebra stripes are batched into one draw call,
+ * and the data walk seeks directly to the first visible row, so the
+ * cost of a frame depends on the widget height rather than the row
+ * count of the model.
  */
 class ListView: public AbstractItemView
 {
@@ -64,6 +71,18 @@ public:
 
   virtual ModelIndex GetIndexAt (const Point& point) const;
 
+  /**
+   * @brief Get the row at the given local vertical position
+   * @param y The y coordinate in the local coordinate of this view
+   * @return The row index, or -1 if no row at this position
+   */
+  int GetRowAt (int y) const;
+
+  /**
+   * @brief Scroll the view to make the given row visible at the top
+   */
+  void ScrollToRow (int row);
+
 protected:
 
   virtual void PerformSizeUpdate (const AbstractView* source,
@@ -75,21 +94,50 @@ protected:
 
   virtual Response PerformMousePress (AbstractWindow* context);
 
+  virtual Response PerformMouseRelease (AbstractWindow* context);
+
+  virtual Response PerformMouseMove (AbstractWindow* context);
+
 private:
 
   void InitializeListView ();
 
+  /**
+   * @brief Generate the batched stripe vertices for the current size
+   */
+  void GenerateStripeVertices (std::vector<GLfloat>* verts);
+
+  /**
+   * @brief Clamp and set the vertical scroll offset
+   */
+  void SetScrollOffset (int y);
+
+  int GetContentHeight () const;
+
   Font font_;
 
-  // 0 for inner buffer
-  // 1 for row_ background
+  // the background, inner vertices only
+  RoundedGeometry geometry_;
+
+  // 0 for the highlighted row
+  // 1 for the batched zebra stripes
   GLuint vao_[2];
 
   GLBuffer<ARRAY_BUFFER, 2> vbo_;
 
   RefPtr<AbstractItemModel> model_;
 
+  // the model row highlighted, -1 for none
   int highlight_index_;
+
+  // how many rows stored in the stripe buffer
+  int stripe_rows_;
+
+  bool moving_;
+
+  Point cursor_point_;
+
+  Point last_offset_;
 };
 
 }
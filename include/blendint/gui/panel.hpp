@@ -81,6 +81,9 @@ private:
 
   RefPtr<ViewBuffer> view_buffer_;
 
+  // the storage size of the view buffer texture
+  Size texture_size_;
+
 };
 
 } /* namespace BlendInt */
@@ -23,7 +23,7 @@
 
 #pragma once
 
-#include <blendint/opengl/gl-buffer.hpp>
+#include <blendint/gui/rounded-geometry.hpp>
 #include <blendint/gui/abstract-button.hpp>
 
 namespace BlendInt {
@@ -63,9 +63,7 @@ namespace BlendInt {
 
 		void InitializeRadioButtonOnce ();
 
-		GLuint vao_[2];
-
-		GLBuffer<ARRAY_BUFFER, 2> vbo_;
+		RoundedGeometry geometry_;
 
 	};
 }
@@ -0,0 +1,109 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free software:
+ * you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is distributed in
+ * the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+
+#pragma once
+
+#include <vector>
+
+#include <blendint/opengl/gl-vertex-arena.hpp>
+
+namespace BlendInt {
+
+/**
+ * @brief The vertices of a rounded widget shape in the shared arenas
+ *
+ * Keeps the inner and outline vertices generated by
+ * AbstractView::GenerateRoundedVertices() in the vertex arenas of
+ * AbstractWindow instead of a vertex array and buffer per widget. The
+ * ranges are reused when the vertex count does not grow, e.g. in a
+ * resize.
+ *
+ * Used by PushButton, ToggleButton, RadioButton, ColorButton,
+ * TextEntry, Frame and ListView, the other round widgets still own their
+ * vertex arrays.
+ *
+ * @ingroup blendint_gui
+ */
+class RoundedGeometry
+{
+  DISALLOW_COPY_AND_ASSIGN(RoundedGeometry);
+
+ public:
+
+  /**
+   * @brief Constructor
+   * @param inner_components 3 for shaded inner vertices (x, y, shade),
+   * 2 for plain (x, y)
+   */
+  explicit RoundedGeometry (GLint inner_components = 3);
+
+  ~RoundedGeometry ();
+
+  /**
+   * @brief Upload new vertices
+   * @param inner The inner vertices, may be empty
+   * @param outer The outline vertices, may be empty
+   */
+  void Update (const std::vector<GLfloat>& inner,
+               const std::vector<GLfloat>& outer);
+
+  /**
+   * @brief Draw inner vertices with the program in use
+   */
+  void DrawInner (GLenum mode, GLsizei count, GLint first = 0) const;
+
+  /**
+   * @brief Draw outline vertices with the program in use
+   */
+  void DrawOuter (GLenum mode, GLsizei count, GLint first = 0) const;
+
+ private:
+
+  struct Range
+  {
+    GLint first;
+
+    // the vertices allocated in the arena
+    GLsizei capacity;
+  };
+
+  static void Store (GLVertexArena* arena,
+                     Range* range,
+                     const std::vector<GLfloat>& vertices);
+
+  static void Draw (GLVertexArena* arena,
+                    const Range& range,
+                    GLenum mode,
+                    GLsizei count,
+                    GLint first);
+
+  GLint inner_components_;
+
+  Range inner_;
+
+  Range outer_;
+
+};
+
+}
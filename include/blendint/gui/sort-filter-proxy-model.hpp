@@ -0,0 +1,315 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free software:
+ * you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is distributed in
+ * the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <blendint/cppevent/event.hpp>
+#include <blendint/core/string.hpp>
+
+#include <blendint/gui/abstract-item-model.hpp>
+
+namespace BlendInt {
+
+/**
+ * @brief A sorted and filtered view of the rows in a list model
+ *
+ * The proxy keeps the accepted source rows in sort order as a
+ * permutation array and a node grid sharing the data of the source
+ * model, so a view can use it as any other model and GetIndex() is
+ * O(1) for the row. A search index of the source rows sorted by the
+ * text in the search column (0) is kept for prefix search.
+ *
+ * Call InsertSourceRows() and RemoveSourceRows() when rows change in
+ * the source model, the new rows are sorted and merged, so an update
+ * costs O(n + k log k) instead of a full sort. Call Invalidate() if
+ * the source model was changed in other ways.
+ *
+ * Only flat list models are supported, the source rows must be the
+ * children of the root index.
+ *
+ * @ingroup blendint_gui
+ */
+class SortFilterProxyModel: public AbstractItemModel, public CppEvent::Trackable
+{
+ public:
+
+  enum SortOrder
+  {
+    AscendingOrder, DescendingOrder
+  };
+
+  enum FilterMode
+  {
+    FilterSubstring, FilterPrefix
+  };
+
+  SortFilterProxyModel ();
+
+  virtual ~SortFilterProxyModel ();
+
+  void SetSourceModel (const RefPtr<AbstractItemModel>& model);
+
+  /**
+   * @brief Sort the rows by a column
+   * @param column The column, -1 to keep the source order
+   * @param order The sort order
+   */
+  void SetSortColumn (int column, SortOrder order = AscendingOrder);
+
+  /**
+   * @brief Only show the rows whose text in a column matches the
+   * pattern, case insensitive
+   */
+  void SetFilter (const String& pattern,
+                  FilterMode mode = FilterSubstring,
+                  int column = 0);
+
+  void ClearFilter ();
+
+  /**
+   * @brief Rebuild all rows from the source model
+   */
+  void Invalidate ();
+
+  /**
+   * @brief Rows were inserted in the source model
+   */
+  void InsertSourceRows (int first, int count);
+
+  /**
+   * @brief Rows were removed from the source model
+   */
+  void RemoveSourceRows (int first, int count);
+
+  /**
+   * @brief Data of a source row was changed, sort and filter it again
+   */
+  void UpdateSourceRow (int source_row);
+
+  /**
+   * @brief Get the source row of a row in this model
+   */
+  int MapToSource (int row) const;
+
+  /**
+   * @brief Get the row of a source row
+   * @return The row in this model, -1 if the source row is filtered out
+   */
+  int MapFromSource (int source_row) const;
+
+  /**
+   * @brief Find the first row in search order whose text in column 0
+   * starts with prefix, case insensitive
+   * @return The row in this model, or -1
+   *
+   * O(log n) with the search index, use this for the type-ahead search
+   * in a view.
+   */
+  int FindPrefix (const String& prefix) const;
+
+  /**
+   * @brief Find the next row from a row whose text in column 0
+   * contains the text, case insensitive
+   * @return The row in this model, or -1
+   */
+  int FindSubstring (const String& text, int from = 0) const;
+
+  inline const RefPtr<AbstractItemModel>& source_model () const
+  {
+    return source_;
+  }
+
+  inline int sort_column () const
+  {
+    return sort_column_;
+  }
+
+  inline SortOrder sort_order () const
+  {
+    return sort_order_;
+  }
+
+  /**
+   * @brief Fired when rows of this model were changed
+   */
+  CppEvent::EventRef<> layout_changed ()
+  {
+    return layout_changed_;
+  }
+
+  virtual int GetRowCount (const ModelIndex& parent = ModelIndex()) const
+      override;
+
+  virtual int GetColumnCount (const ModelIndex& parent = ModelIndex()) const
+      override;
+
+  virtual int GetPreferredColumnWidth (int index, const ModelIndex& parent =
+                                           ModelIndex()) const override;
+
+  virtual int GetPreferredRowHeight (int index, const ModelIndex& parent =
+                                         ModelIndex()) const override;
+
+  virtual bool InsertColumns (int column, int count, const ModelIndex& parent =
+                                  ModelIndex()) override;
+
+  virtual bool RemoveColumns (int column, int count, const ModelIndex& parent =
+                                  ModelIndex()) override;
+
+  virtual bool InsertRows (int row, int count, const ModelIndex& parent =
+                               ModelIndex()) override;
+
+  virtual bool RemoveRows (int row, int count, const ModelIndex& parent =
+                               ModelIndex()) override;
+
+  virtual ModelIndex GetRootIndex () const override;
+
+  virtual ModelIndex GetIndex (int row, int column, const ModelIndex& parent =
+                                   ModelIndex()) const override;
+
+ protected:
+
+  /**
+   * @brief Compare 2 source rows in the sort column
+   *
+   * The default compares the Text in the column case insensitive.
+   */
+  virtual bool LessThan (int source_left, int source_right) const;
+
+  /**
+   * @brief If a source row is shown
+   *
+   * The default matches the filter pattern with the Text in the
+   * filter column.
+   */
+  virtual bool Accept (int source_row) const;
+
+  /**
+   * @brief The group of a source row
+   *
+   * Rows are sorted by the group in ascending order before the sort
+   * column in any sort order, e.g. to list folders before files. The
+   * default puts all rows in group 0.
+   */
+  virtual int GetSortGroup (int source_row) const;
+
+  /**
+   * @brief The text of a source cell, 0 if the data is not a Text
+   */
+  const String* GetSourceText (int source_row, int column) const;
+
+  /**
+   * @brief Compare strings case insensitive, then case sensitive
+   */
+  static int CompareText (const String& a, const String& b);
+
+  /**
+   * @brief If str contains (or starts with) pattern, case insensitive
+   */
+  static bool MatchText (const String& str,
+                         const String& pattern,
+                         bool prefix);
+
+  inline const String& filter () const
+  {
+    return filter_;
+  }
+
+  inline FilterMode filter_mode () const
+  {
+    return filter_mode_;
+  }
+
+  inline int filter_column () const
+  {
+    return filter_column_;
+  }
+
+ private:
+
+  struct SortCompare;
+
+  struct SearchCompare;
+
+  // the order of source rows in this model, stable
+  bool Before (int source_left, int source_right) const;
+
+  void Sort ();
+
+  // merge accepted rows of source_rows into mapping_, return the first
+  // changed position in mapping_
+  size_t Merge (std::vector<int>* source_rows);
+
+  ModelNode* CreateNode (int source_row);
+
+  void DestroyNode (int source_row);
+
+  // reset the links, row numbers and the reverse mapping of the rows
+  // from a position, all rows are reset if from is 0
+  void LinkRows (size_t from = 0);
+
+  void DestroyAllNodes ();
+
+  RefPtr<AbstractItemModel> source_;
+
+  ModelNode* root_;
+
+  // the first node of each source row
+  std::vector<ModelNode*> source_rows_;
+
+  // the text in column 0 of each source row, cached for the comparisons
+  // in sorting and searching
+  std::vector<const String*> texts_;
+
+  // the first node of the row in this model for each source row, 0 if
+  // filtered out
+  std::vector<ModelNode*> nodes_;
+
+  // the source row of each row in this model
+  std::vector<int> mapping_;
+
+  // the row in this model of each source row, -1 if filtered out
+  std::vector<int> reverse_;
+
+  // source rows sorted by the text in column 0
+  std::vector<int> search_index_;
+
+  int columns_;
+
+  int sort_column_;
+
+  SortOrder sort_order_;
+
+  String filter_;
+
+  FilterMode filter_mode_;
+
+  int filter_column_;
+
+  CppEvent::Event<> layout_changed_;
+
+  DISALLOW_COPY_AND_ASSIGN(SortFilterProxyModel);
+};
+
+}
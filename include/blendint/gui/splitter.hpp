@@ -25,7 +25,7 @@
 
 #include <deque>
 
-#include <blendint/opengl/gl-buffer.hpp>
+#include <blendint/opengl/gl-vertex-arena.hpp>
 
 #include <blendint/gui/abstract-widget.hpp>
 
@@ -74,11 +74,22 @@ private:
 
   friend class Splitter;
 
+  /**
+   * @brief Generate the grip lines for the current size
+   */
+  void UpdateLines ();
+
   Orientation orientation_;
 
-  GLuint vao_;
+  // the dark lines then the light lines of the grip in the coordinate
+  // arena, a strip of 4 vertices each
+  GLint lines_first_;
+
+  GLsizei lines_capacity_;
+
+  GLsizei dark_lines_;
 
-  GLBuffer<ARRAY_BUFFER, 1> vbo_;
+  GLsizei light_lines_;
 
   bool highlight_;
   bool pressed_;
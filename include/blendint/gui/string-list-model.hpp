@@ -23,11 +23,11 @@
 
 #pragma once
 
-#include <blendint/gui/abstract-list-model.hpp>
+#include <blendint/gui/abstract-array-list-model.hpp>
 
 namespace BlendInt {
 
-class StringListModel: public AbstractListModel
+class StringListModel: public AbstractArrayListModel
 {
 public:
 
@@ -69,10 +69,6 @@ protected:
   virtual bool RemoveRows (int row, int count, const ModelIndex& parent =
                                ModelIndex());
 
-private:
-
-  int rows_;
-
 };
 
 }
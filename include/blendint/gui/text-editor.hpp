@@ -0,0 +1,203 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free software:
+ * you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is distributed in
+ * the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <blendint/core/margin.hpp>
+#include <blendint/core/text-document.hpp>
+
+#include <blendint/gui/text.hpp>
+#include <blendint/gui/rounded-geometry.hpp>
+#include <blendint/gui/abstract-round-widget.hpp>
+
+namespace BlendInt {
+
+/**
+ * @brief A multi-line text editor
+ *
+ * The text is kept in a TextDocument, only the visible lines have a
+ * Text object, and the line under the cursor is edited in place, so
+ * the cost of an edit or a redraw does not grow with the count of
+ * lines.
+ *
+ * @ingroup blendint_gui_widgets
+ */
+class TextEditor: public AbstractRoundWidget
+{
+  DISALLOW_COPY_AND_ASSIGN(TextEditor);
+
+ public:
+
+  TextEditor ();
+
+  TextEditor (const String& text);
+
+  virtual ~TextEditor ();
+
+  void SetText (const String& text);
+
+  String GetText () const;
+
+  void ClearText ();
+
+  void SetFont (const Font& font);
+
+  /**
+   * @brief Move the cursor, the position is clamped to the text
+   */
+  void SetCursor (size_t line, size_t column);
+
+  virtual Size GetPreferredSize () const;
+
+  virtual bool IsExpandX () const;
+
+  virtual bool IsExpandY () const;
+
+  inline const TextDocument& document () const
+  {
+    return document_;
+  }
+
+  inline const Font& font () const
+  {
+    return font_;
+  }
+
+  inline size_t cursor_line () const
+  {
+    return cursor_line_;
+  }
+
+  inline size_t cursor_column () const
+  {
+    return cursor_column_;
+  }
+
+  inline size_t first_visible_line () const
+  {
+    return first_line_;
+  }
+
+  static inline const Margin& padding ()
+  {
+    return kPadding;
+  }
+
+ protected:
+
+  virtual void PerformSizeUpdate (const AbstractView* source,
+                                  const AbstractView* target,
+                                  int width,
+                                  int height);
+
+  virtual void PerformRoundTypeUpdate (int round_type);
+
+  virtual void PerformRoundRadiusUpdate (float radius);
+
+  virtual void PerformFocusOn (AbstractWindow* context);
+
+  virtual void PerformFocusOff (AbstractWindow* context);
+
+  virtual void PerformHoverIn (AbstractWindow* context);
+
+  virtual void PerformHoverOut (AbstractWindow* context);
+
+  virtual Response PerformKeyPress (AbstractWindow* context);
+
+  virtual Response PerformMousePress (AbstractWindow* context);
+
+  virtual Response Draw (AbstractWindow* context);
+
+ private:
+
+  void InitializeTextEditor ();
+
+  void UpdateGeometries ();
+
+  void InsertText (const String& text);
+
+  void DisposeBackspacePress ();
+
+  void DisposeDeletePress ();
+
+  /**
+   * @brief Move the cursor to another line, keep the x position
+   */
+  void MoveCursorToLine (size_t line);
+
+  /**
+   * @brief Scroll to show the cursor
+   */
+  void EnsureCursorVisible ();
+
+  /**
+   * @brief Scroll vertically
+   *
+   * The Text objects of the lines still visible are kept.
+   */
+  void SetFirstVisibleLine (size_t line);
+
+  /**
+   * @brief Get the Text of a visible line, update it if the line was
+   * changed
+   */
+  Text* GetLineText (size_t line);
+
+  /**
+   * @brief The cached Text of a visible line if it's up to date
+   */
+  Text* FindLineText (size_t line) const;
+
+  int GetVisibleLineCount () const;
+
+  RoundedGeometry geometry_;
+
+  // the vertices of the cursor
+  RoundedGeometry cursor_;
+
+  TextDocument document_;
+
+  Font font_;
+
+  // the Text of the visible lines from first_line_
+  std::vector<RefPtr<Text> > lines_;
+
+  size_t first_line_;
+
+  size_t cursor_line_;
+
+  size_t cursor_column_;
+
+  // the horizontal scroll in pixels
+  int x_offset_;
+
+  bool focused_;
+
+  bool hovered_;
+
+  static Margin kPadding;
+};
+
+}
@@ -0,0 +1,118 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free software:
+ * you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is distributed in
+ * the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+
+#pragma once
+
+#include <list>
+#include <map>
+
+#include <blendint/gui/text-layout.hpp>
+
+namespace BlendInt {
+
+/**
+ * @brief A least recently used cache of text layouts
+ *
+ * Layouts are keyed by the font pattern and the hash of the string, so
+ * measuring the same string again in layout or hit testing does not
+ * query glyphs and kerning. Used by Font::GetTextWidth().
+ *
+ * Must be used in the thread which owns the fonts.
+ *
+ * @ingroup blendint_gui
+ */
+class TextLayoutCache
+{
+ public:
+
+  /**
+   * @brief Get the layout of a string in a font
+   *
+   * A layout generated with fallback glyphs is generated again once
+   * the glyphs arrive.
+   */
+  static RefPtr<TextLayout> Get (const Font& font, const String& text);
+
+  /**
+   * @brief Set the max count of layouts kept
+   */
+  static void SetCapacity (size_t capacity);
+
+  static inline size_t capacity ()
+  {
+    return kCapacity;
+  }
+
+  static inline size_t size ()
+  {
+    return kEntries.size();
+  }
+
+  static inline unsigned long hits ()
+  {
+    return kHits;
+  }
+
+  static inline unsigned long misses ()
+  {
+    return kMisses;
+  }
+
+  static void Clear ();
+
+  static const size_t kDefaultCapacity = 512;
+
+ private:
+
+  // font pattern hash, string hash
+  typedef std::pair<FcChar32, size_t> Key;
+
+  struct Entry
+  {
+    Key key;
+
+    // to detect hash collisions
+    String text;
+
+    RefPtr<TextLayout> layout;
+  };
+
+  // the most recently used at front
+  typedef std::list<Entry> EntryList;
+
+  static void Trim ();
+
+  static EntryList kEntries;
+
+  static std::map<Key, EntryList::iterator> kIndex;
+
+  static size_t kCapacity;
+
+  static unsigned long kHits;
+
+  static unsigned long kMisses;
+
+};
+
+}
@@ -0,0 +1,153 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free software:
+ * you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is distributed in
+ * the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+#include <blendint/core/object.hpp>
+#include <blendint/core/string.hpp>
+
+#include <blendint/gui/font.hpp>
+
+namespace BlendInt {
+
+/**
+ * @brief The horizontal positions of the glyphs of a string in a font
+ *
+ * Advances and kerning are queried once in Generate() and stored as a
+ * prefix sum, so the width of any substring and the conversions
+ * between a cursor index and an x position need no glyph or kerning
+ * query.
+ *
+ * @ingroup blendint_gui
+ */
+class TextLayout: public Object
+{
+ public:
+
+  TextLayout ();
+
+  TextLayout (const Font& font, const String& text);
+
+  virtual ~TextLayout ();
+
+  void Generate (const Font& font, const String& text);
+
+  /**
+   * @brief Update the layout after the text was edited
+   * @param font The font used in Generate()
+   * @param text The edited text
+   * @param start The first character removed or inserted
+   * @param removed The count of characters removed at start
+   * @param inserted The count of characters inserted at start
+   *
+   * Only the glyphs inserted and the one before start are queried, the
+   * positions after the edit are shifted.
+   */
+  void Update (const Font& font,
+               const String& text,
+               size_t start,
+               size_t removed,
+               size_t inserted);
+
+  /**
+   * @brief Get the width of a substring
+   * @param length The count of characters
+   * @param start The first character
+   *
+   * The kerning between the last character and the next one is not
+   * counted, same as Font::GetTextWidth().
+   */
+  int GetWidth (size_t length, size_t start = 0) const;
+
+  /**
+   * @brief Get the index of the glyph under a position
+   * @param x The x position relative to the pen position of start
+   * @param start The first character
+   * @return The index of the glyph, start if x is before start or
+   * length() if x is beyond the text
+   */
+  size_t GetIndex (int x, size_t start = 0) const;
+
+  /**
+   * @brief The pen position before a character, or the width of the
+   * text if index is length()
+   */
+  inline int GetX (size_t index) const
+  {
+    return offsets_[std::min(index, kernings_.size())];
+  }
+
+  /**
+   * @brief The kerning between a character and the next one
+   */
+  inline int kerning (size_t index) const
+  {
+    return index < kernings_.size() ? kernings_[index] : 0;
+  }
+
+  inline size_t length () const
+  {
+    return kernings_.size();
+  }
+
+  inline int width () const
+  {
+    return offsets_.back();
+  }
+
+  /**
+   * @brief If any glyph was not rasterized yet when generated
+   *
+   * The fallback glyph has a different advance, generate again when
+   * generation() is not the glyph generation of the font.
+   */
+  inline bool pending () const
+  {
+    return pending_;
+  }
+
+  inline unsigned int generation () const
+  {
+    return generation_;
+  }
+
+ private:
+
+  // the pen position before each character, and the total width at
+  // the end
+  std::vector<int> offsets_;
+
+  // the kerning between each character and the next one
+  std::vector<int> kernings_;
+
+  bool pending_;
+
+  unsigned int generation_;
+
+};
+
+}
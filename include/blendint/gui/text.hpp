@@ -28,7 +28,9 @@
 #include <blendint/core/string.hpp>
 #include <blendint/core/color.hpp>
 #include <blendint/opengl/gl-buffer.hpp>
+#include <blendint/opengl/gl-vertex-arena.hpp>
 #include <blendint/gui/font.hpp>
+#include <blendint/gui/text-layout.hpp>
 
 namespace BlendInt {
 
@@ -158,38 +160,130 @@ namespace BlendInt {
       return text_.length();
     }
 
+    /**
+     * @brief The glyph positions of this text, for measuring and hit
+     * testing
+     */
+    inline const TextLayout& layout () const
+    {
+      return layout_;
+    }
+
   protected:
 
     virtual void PerformSizeUpdate (int width, int height);
 
   private:
 
+    friend class AbstractWindow;
+
     /**
-     * @brief Generate vertices to be used in VBO for this text
+     * @brief Generate vertices of the glyphs from first to the end
+     *
+     * Positions are read from layout_.
      */
-    void GenerateTextVertices (std::vector<GLfloat>& verts,
-                               int* ptr_width,
-                               int* ptr_ascender,
-                               int* ptr_descender);
+    void GenerateTextVertices (size_t first, std::vector<GLfloat>* verts);
 
     /**
-     * @brief Re-calculate vertices and load to VBO
+     * @brief Extend ascender_ and descender_ to the glyphs of a range
+     */
+    void MergeExtents (size_t start, size_t count);
+
+    /**
+     * @brief Re-calculate the size and glyph positions
      *
-     * Also reset the size of this form.
+     * The vertices are generated and uploaded in the next draw, so a
+     * text which is only measured never allocates in the GPU.
      */
     void ReloadBuffer ();
 
+    /**
+     * @brief Update the size and glyph positions after an edit
+     *
+     * Only the glyph positions around the edit are queried, and only
+     * the vertices from start to the end are uploaded in the next draw.
+     */
+    void UpdateBuffer (size_t start, size_t removed, size_t inserted);
+
+    /**
+     * @brief Generate the changed vertices and upload them to the shared
+     * text arena
+     */
+    void UploadVertices ();
+
+    /**
+     * @brief How many glyphs from start fit in the width
+     */
+    size_t GetFittingLength (size_t start, int width) const;
+
+    /**
+     * @brief Draw a run of glyphs in one call, the text program must be
+     * in use
+     */
+    void DrawGlyphs (size_t start, size_t count) const;
+
+    /**
+     * @brief Make sure the shared index buffer has indices of count
+     * glyph quads
+     *
+     * The buffer is the element buffer of the text arena, attached to
+     * its vertex array in each OpenGL context.
+     */
+    static void ReserveQuadIndices (size_t count);
+
+    static void ReleaseQuadIndices ();
+
+    /**
+     * @brief Reload the buffer if fallback glyphs used in vertices are
+     * now rasterized, or glyphs were evicted from the atlas
+     */
+    inline void UpdatePendingGlyphs () const
+    {
+      if ((pending_ && (generation_ != font_.glyph_generation())) ||
+          (evictions_ != font_.atlas_evictions())) {
+        const_cast<Text*>(this)->ReloadBuffer();
+      }
+    }
+
     // the ascender of this text
     int ascender_;
 
     // the descender of this text
     int descender_;
 
-    GLuint vao_;
-    GLBuffer<> vbo_;
+    // if any glyph in the vertices is the fallback glyph
+    bool pending_;
+
+    // the glyph generation of font when vertices were generated
+    unsigned int generation_;
+
+    // the atlas evictions of font when vertices were generated
+    unsigned int evictions_;
+
+    // the kerning-adjusted pen position of each glyph
+    TextLayout layout_;
+
+    // the first glyph whose vertices need to be uploaded before
+    // drawing, or kClean
+    size_t dirty_from_;
+
+    // the first vertex of this text in the text arena
+    GLint first_;
+
+    // the vertices allocated in the text arena
+    GLsizei capacity_;
 
     String text_;
     Font font_;
+
+    // element buffer with 6 indices per glyph quad, attached to the text
+    // arena
+    static GLuint kQuadIndexBuffer;
+
+    // the count of quads in kQuadIndexBuffer
+    static size_t kQuadIndexCapacity;
+
+    static const size_t kClean = (size_t) -1;
   };
 
 }
@@ -31,6 +31,7 @@
 #include <blendint/opengl/gl-buffer.hpp>
 
 #include <blendint/gui/text.hpp>
+#include <blendint/gui/rounded-geometry.hpp>
 #include <blendint/gui/abstract-round-widget.hpp>
 
 namespace BlendInt {
@@ -104,16 +105,12 @@ namespace BlendInt {
 
     size_t GetTextCursorIndex (AbstractWindow* context);
 
-    /**
-     * @brief Vertex array objects
-     *
-     * 	- 0: for inner buffer
-     * 	- 1: for outline buffer
-     * 	- 2: for cursor buffer
-     */
-    GLuint vao_[3];
+    RoundedGeometry geometry_;
+
+    // the vertex array and buffer of the cursor
+    GLuint vao_;
 
-    GLBuffer<ARRAY_BUFFER, 3> vbo_;
+    GLBuffer<ARRAY_BUFFER, 1> vbo_;
 
     RefPtr<Text> text_;
 
@@ -23,88 +23,194 @@
 
 #pragma once
 
+#include <vector>
+
+#include <stdint.h>
+
 #include <blendint/core/object.hpp>
 #include <blendint/opengl/opengl.hpp>
 
 namespace BlendInt {
 
+  /**
+   * @brief A glyph atlas of fixed size pages in a 2D texture array
+   *
+   * Bitmaps are packed into pages with a skyline packer. New pages are
+   * added until the memory budget is reached, then the least recently
+   * used page is cleared and reused. Watch evictions() to drop the
+   * glyphs stored in the evicted page.
+   *
+   * A client side copy of each page is kept, so bitmaps are copied with
+   * Blit() and uploaded in one batch with Commit().
+   */
   class TextureAtlas: public Object
   {
 
   public:
 
-    TextureAtlas ()
-    : Object(),
-      id_(0),
-      width_(0),
-      height_(0),
-      last_x_(0),
-      last_y_(0),
-      last_row_height_(0)
-    {
-    }
+    TextureAtlas ();
 
-    virtual ~TextureAtlas ()
-    {
-      if (id_) glDeleteTextures(1, &id_);
-    }
+    virtual ~TextureAtlas ();
 
-    void Generate (GLsizei width, GLsizei height);
+    /**
+     * @brief Create the texture
+     * @param[in] page_width
+     * @param[in] page_height
+     * @param[in] memory_budget Max bytes of the texture, at least 2
+     * pages are allowed
+     */
+    void Generate (GLsizei page_width,
+                   GLsizei page_height,
+                   size_t memory_budget = kDefaultMemoryBudget);
 
     inline void bind () const
     {
-      glBindTexture(GL_TEXTURE_2D, id_);
+      glBindTexture(GL_TEXTURE_2D_ARRAY, id_);
     }
 
     static inline void reset ()
     {
-      glBindTexture(GL_TEXTURE_2D, 0);
+      glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
     }
 
     /**
-     * @brief Upload glyph bitmap to the texture
+     * @brief Reserve space for a glyph bitmap
      * @param[in] bitmap_width
      * @param[in] bitmap_rows
-     * @param[in] bitmap
-     * @param[out] x
-     * @param[out] y
+     * @param[out] ox
+     * @param[out] oy
+     * @param[out] opage
+     * @return False if the bitmap is larger than a page
      *
-     * Upload glyph bitmap to texture and get the position in the
-     * texture for calculating UV.
+     * This may evict the least recently used page, which is then the
+     * page returned in opage. The texture is not touched until
+     * Commit().
+     */
+    bool Allocate (int bitmap_width,
+                   int bitmap_rows,
+                   int* ox,
+                   int* oy,
+                   int* opage);
+
+    /**
+     * @brief Copy a glyph bitmap into the client side copy of a page
+     * @param[in] pitch Bytes of a row in bitmap, 0 if rows are tightly
+     * packed
      *
-     * @note MUST call bind() before use this function
+     * The position should be reserved with Allocate().
      */
-    bool Upload (int bitmap_width,
-                 int bitmap_rows,
-                 const unsigned char* bitmap,
-                 int* ox,
-                 int* oy);
+    void Blit (int page,
+               int x,
+               int y,
+               int bitmap_width,
+               int bitmap_rows,
+               const unsigned char* bitmap,
+               int pitch = 0);
 
-  private:
+    /**
+     * @brief Upload the changed area of each page
+     *
+     * This function binds the texture.
+     */
+    void Commit ();
+
+    /**
+     * @brief Mark a page as used, for the LRU eviction
+     */
+    inline void Touch (int page)
+    {
+      pages_[page].last_used = ++clock_;
+    }
+
+    inline GLsizei page_width () const
+    {
+      return page_width_;
+    }
+
+    inline GLsizei page_height () const
+    {
+      return page_height_;
+    }
+
+    inline size_t page_count () const
+    {
+      return pages_.size();
+    }
+
+    inline size_t max_pages () const
+    {
+      return max_pages_;
+    }
+
+    /**
+     * @brief How many times a page was evicted
+     */
+    inline unsigned int evictions () const
+    {
+      return evictions_;
+    }
 
-    inline void clear ()
+    /**
+     * @brief Bytes of the texture storage
+     */
+    inline size_t memory_usage () const
     {
-      glDeleteTextures(1, &id_);
-      id_ = 0;
-
-      width_ = 0;
-      height_ = 0;
-      last_x_ = 0;
-      last_y_ = 0;
-      last_row_height_ = 0;
+      return (size_t) page_width_ * page_height_ * texture_layers_;
     }
 
+    static const size_t kDefaultMemoryBudget = 4 * 1024 * 1024;
+
+  private:
+
+    struct SkylineNode
+    {
+      int x;
+      int y;
+      int width;
+    };
+
+    struct Page
+    {
+      std::vector<GLubyte> pixels;
+
+      std::vector<SkylineNode> skyline;
+
+      uint64_t last_used;
+
+      // the area not uploaded yet, empty if right <= left
+      int dirty_left;
+      int dirty_top;
+      int dirty_right;
+      int dirty_bottom;
+    };
+
+    void ResetPage (Page& page);
+
+    bool Pack (Page& page, int width, int height, int* ox, int* oy);
+
+    int Fit (const Page& page, size_t index, int width, int height) const;
+
+    static void MarkDirty (Page& page, int left, int top, int right, int bottom);
+
     GLuint id_;
 
-    GLsizei width_;
+    GLsizei page_width_;
+
+    GLsizei page_height_;
+
+    // the number of layers allocated in the texture array
+    GLsizei texture_layers_;
+
+    size_t max_pages_;
 
-    GLsizei height_;
+    std::vector<Page> pages_;
 
-    GLsizei last_x_;
+    uint64_t clock_;
 
-    GLsizei last_y_;
+    unsigned int evictions_;
 
-    GLsizei last_row_height_;
+    // blank pixels between glyphs to avoid bleeding in linear filtering
+    static const int kPadding = 1;
 
   };
 
@@ -30,6 +30,7 @@
 #include <blendint/core/string.hpp>
 #include <blendint/gui/abstract-window.hpp>
 #include <blendint/gui/abstract-cursor-theme.hpp>
+#include <blendint/gui/frame-scheduler.hpp>
 
 namespace BlendInt {
 
@@ -82,6 +83,16 @@ public:
     return resized_;
   }
 
+  /**
+   * @brief The frame pacing and timings of the event loop
+   *
+   * Only the scheduler of the main window is used in Exec().
+   */
+  FrameScheduler* frame_scheduler ()
+  {
+    return &frame_scheduler_;
+  }
+
   static bool Initialize ();
 
   static void Terminate ();
@@ -104,6 +115,9 @@ private:
 
   void Close ();
 
+  // if any visible window needs to be redrawn
+  bool IsRefreshRequested () const;
+
   GLFWwindow* window_;
 
   bool running_;
@@ -112,6 +126,8 @@ private:
 
   CppEvent::Event<const Size&> resized_;
 
+  FrameScheduler frame_scheduler_;
+
   static GLFWcursor* kArrowCursor;
 
   static GLFWcursor* kCrossCursor;
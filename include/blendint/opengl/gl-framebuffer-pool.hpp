@@ -0,0 +1,158 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free
+ * software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is
+ * distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+#include <blendint/core/types.hpp>
+#include <blendint/opengl/opengl.hpp>
+
+namespace BlendInt {
+
+/**
+ * @brief A framebuffer object with a depth-stencil renderbuffer
+ *
+ * The color attachment is not owned by the target, the caller attaches
+ * its own texture after GLFramebufferPool::Acquire().
+ *
+ * @ingroup opengl
+ */
+struct GLOffscreenTarget
+{
+  GLuint framebuffer;
+
+  GLuint renderbuffer;
+
+  // the storage size of the renderbuffer, rounded up to the bucket size
+  int width;
+
+  int height;
+
+  bool in_use;
+
+  // the value of the pool clock when this target was last acquired
+  unsigned long last_used;
+};
+
+/**
+ * @brief A size-bucketed pool of off-screen render targets
+ *
+ * Rendering a frame or a widget to texture needs a framebuffer and a
+ * depth-stencil renderbuffer, creating and deleting them in every
+ * redraw is expensive. This pool keeps them across frames: a target is
+ * reused if its size bucket matches the requested size, and new storage
+ * is allocated only when the size changes to another bucket.
+ *
+ * Framebuffer objects are not shared between OpenGL contexts, so every
+ * window owns its own pool.
+ *
+ * @ingroup opengl
+ */
+class GLFramebufferPool
+{
+  DISALLOW_COPY_AND_ASSIGN(GLFramebufferPool);
+
+ public:
+
+  GLFramebufferPool ();
+
+  ~GLFramebufferPool ();
+
+  /**
+   * @brief Get a target with at least the given size and bind it
+   *
+   * The framebuffer of the returned target is bound to
+   * GL_FRAMEBUFFER. Release() it when the off-screen rendering is
+   * done, nested calls get different targets.
+   */
+  GLOffscreenTarget* Acquire (int width, int height);
+
+  /**
+   * @brief Give back a target acquired from this pool
+   *
+   * The least recently used idle targets are deleted if there are
+   * more than kMaxIdleTargets.
+   */
+  void Release (GLOffscreenTarget* target);
+
+  /**
+   * @brief Delete all idle targets
+   */
+  void Clear ();
+
+  inline void reset_counters ()
+  {
+    hits_ = 0;
+    misses_ = 0;
+  }
+
+  /**
+   * @brief How many Acquire() calls reused an existing target
+   */
+  inline unsigned long hits () const
+  {
+    return hits_;
+  }
+
+  /**
+   * @brief How many Acquire() calls allocated a new target
+   */
+  inline unsigned long misses () const
+  {
+    return misses_;
+  }
+
+  /**
+   * @brief The count of targets currently allocated
+   */
+  inline int size () const
+  {
+    return (int) targets_.size();
+  }
+
+  static const int kBucketSize = 64;
+
+  static const int kMaxIdleTargets = 8;
+
+ private:
+
+  static inline int bucket (int size)
+  {
+    return ((std::max(size, 1) + kBucketSize - 1) / kBucketSize) * kBucketSize;
+  }
+
+  static void Destroy (GLOffscreenTarget* target);
+
+  std::vector<GLOffscreenTarget*> targets_;
+
+  unsigned long hits_;
+
+  unsigned long misses_;
+
+  unsigned long clock_;
+
+};
+
+}
@@ -0,0 +1,266 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free
+ * software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is
+ * distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+
+#pragma once
+
+#include <map>
+#include <vector>
+#include <algorithm>
+
+#include <blendint/core/types.hpp>
+#include <blendint/opengl/opengl.hpp>
+
+namespace BlendInt {
+
+/**
+ * @brief A shared vertex buffer sub-allocated by many drawables
+ *
+ * Most widgets draw a few small rounded shapes, giving each of them its
+ * own vertex array and buffer objects costs a VAO bind and a buffer per
+ * shape. An arena keeps the vertices of all shapes with the same layout
+ * in one buffer object behind one vertex array object, a shape only
+ * owns a range of vertices and draws it with the first vertex offset of
+ * glDrawArrays().
+ *
+ * Ranges are allocated first-fit from a free list and rounded up to
+ * kGranularity vertices, freed ranges are coalesced with their
+ * neighbours. The buffer grows by doubling and keeps its content, so
+ * allocated ranges stay valid.
+ *
+ * The buffer objects are shared with the shared contexts of the main
+ * window, but vertex array objects are not. An arena creates a vertex
+ * array for each context it is bound in, the context made current is
+ * told with set_current_context(). A vertex array of another context is
+ * re-pointed the next time it is bound after the buffer changed.
+ *
+ * Ranges drawn one after another with the same program and uniforms
+ * can be queued with Submit() and issued with one glMultiDrawArrays()
+ * by Flush().
+ *
+ * @ingroup opengl
+ */
+class GLVertexArena
+{
+  DISALLOW_COPY_AND_ASSIGN(GLVertexArena);
+
+ public:
+
+  /**
+   * @brief Constructor
+   * @param attribute The vertex attribute index of the layout
+   * @param components The number of float components per vertex
+   * @param capacity The initial capacity in vertices
+   *
+   * Must be constructed with a current OpenGL context, the one told by
+   * set_current_context().
+   */
+  GLVertexArena (GLuint attribute,
+                 GLint components,
+                 GLsizei capacity = kDefaultCapacity);
+
+  /**
+   * @brief Destructor
+   *
+   * Deletes the vertex array of the current context, the other
+   * contexts must have been released or destroyed.
+   */
+  ~GLVertexArena ();
+
+  /**
+   * @brief Allocate a range of vertices
+   * @param count The vertex count
+   * @return The first vertex of the range
+   *
+   * The allocated range may be larger than count, use
+   * allocated_size() to know the real size.
+   */
+  GLint Allocate (GLsizei count);
+
+  /**
+   * @brief Give back a range returned by Allocate()
+   */
+  void Free (GLint first, GLsizei count);
+
+  /**
+   * @brief Copy vertices into an allocated range
+   * @param first The first vertex to write
+   * @param count The vertex count
+   * @param data count * components() floats
+   */
+  void Upload (GLint first, GLsizei count, const GLfloat* data);
+
+  /**
+   * @brief Queue a draw of vertices in this arena
+   * @param mode The primitive mode
+   * @param first The first vertex
+   * @param count The vertex count
+   *
+   * The program, uniforms and constant vertex attributes in use when
+   * Flush() is called apply to all queued draws, the caller must flush
+   * before changing them. A draw of another mode flushes the queue
+   * first.
+   */
+  void Submit (GLenum mode, GLint first, GLsizei count);
+
+  /**
+   * @brief Issue the queued draws
+   */
+  void Flush ();
+
+  /**
+   * @brief Attach an element buffer to the vertex array of this arena
+   *
+   * The indices are relative to a range, draw with
+   * glDrawElementsBaseVertex() and the first vertex of the range. The
+   * buffer is attached to the vertex array of every context.
+   */
+  void SetElementBuffer (GLuint buffer);
+
+  /**
+   * @brief Delete the vertex array of a context
+   *
+   * Must be called with the context current, before it is destroyed.
+   */
+  void ReleaseContext (const void* context);
+
+  inline void bind ()
+  {
+    if ((current_ == 0) || (context_ != kCurrentContext)) SwitchContext();
+    glBindVertexArray(current_->vao);
+  }
+
+  /**
+   * @brief Tell the arenas the OpenGL context made current
+   * @param context An opaque key of the context, e.g. the native window
+   *
+   * Call this after every context switch, like
+   * GLSLProgram::invalidate_current().
+   */
+  static inline void set_current_context (const void* context)
+  {
+    kCurrentContext = context;
+  }
+
+  static inline void reset ()
+  {
+    glBindVertexArray(0);
+  }
+
+  static inline GLsizei allocated_size (GLsizei count)
+  {
+    return ((std::max(count, 1) + kGranularity - 1) / kGranularity)
+        * kGranularity;
+  }
+
+  inline GLint components () const
+  {
+    return components_;
+  }
+
+  /**
+   * @brief The capacity of the buffer in vertices
+   */
+  inline GLsizei capacity () const
+  {
+    return capacity_;
+  }
+
+  /**
+   * @brief The vertices allocated
+   */
+  inline GLsizei used () const
+  {
+    return used_;
+  }
+
+  /**
+   * @brief The count of ranges in the free list
+   */
+  inline size_t free_block_count () const
+  {
+    return free_blocks_.size();
+  }
+
+  static const GLsizei kDefaultCapacity = 4096;
+
+  static const GLsizei kGranularity = 8;
+
+ private:
+
+  struct VertexArray
+  {
+    GLuint vao;
+
+    // the revision_ its attribute and element buffer point to
+    unsigned int revision;
+  };
+
+  // find or create the vertex array of the current context
+  void SwitchContext ();
+
+  // point the current vertex array to the buffers
+  void SetupVertexArray ();
+
+  void Grow (GLsizei min_capacity);
+
+  // add a range to the free list, coalesced with its neighbours
+  void InsertFreeBlock (GLint first, GLsizei count);
+
+  GLuint attribute_;
+
+  GLint components_;
+
+  GLuint vbo_;
+
+  GLuint element_buffer_;
+
+  // bumped when vbo_ or element_buffer_ changes
+  unsigned int revision_;
+
+  // the context and vertex array bind() used last
+  const void* context_;
+
+  VertexArray* current_;
+
+  std::map<const void*, VertexArray> vertex_arrays_;
+
+  GLsizei capacity_;
+
+  GLsizei used_;
+
+  // free ranges: first vertex -> vertex count
+  std::map<GLint, GLsizei> free_blocks_;
+
+  // the draws queued by Submit()
+  GLenum batch_mode_;
+
+  std::vector<GLint> batch_first_;
+
+  std::vector<GLsizei> batch_count_;
+
+  static const void* kCurrentContext;
+
+};
+
+}
@@ -23,6 +23,11 @@
 
 #pragma once
 
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
 #include <blendint/core/object.hpp>
 #include <blendint/opengl/opengl.hpp>
 #include <blendint/opengl/glsl-shader.hpp>
@@ -75,6 +80,9 @@ namespace BlendInt {
 		 * 	- GL_FRAGMENT_SHADER
 		 *
 		 * The param type is defined in manual of glCreateShader
+		 *
+		 * If the binary cache is enabled the source is compiled in
+		 * Link(), and only if the program is not found in the cache.
 		 */
 		void AttachShader (const char* buf, GLenum type);
 
@@ -116,6 +124,11 @@ namespace BlendInt {
 		 * 	- false if fail
 		 *
 		 * 	@note this function should be called after attaching correct shaders
+		 *
+		 * If the binary cache is enabled and all shaders were attached
+		 * as sources, the program is loaded from the binary cached for
+		 * the sources and the current driver, or linked and saved in the
+		 * cache.
 		 */
 		bool Link ();
 
@@ -138,18 +151,37 @@ namespace BlendInt {
 
 		/**
 		 * @brief Use this program for render
+		 *
+		 * glUseProgram() is skipped if this program is already in use.
 		 */
 		inline void use () const
 		{
-			glUseProgram (m_id);
+			if (kCurrentProgram != m_id) {
+				glUseProgram (m_id);
+				kCurrentProgram = m_id;
+			}
 		}
 
 		/**
 		 * @brief Unuse this program for render
+		 *
+		 * The program is not unbound actually, the next use() of the same
+		 * program costs nothing. All drawing goes through a program in
+		 * the core profile so this is never observable.
 		 */
 		static inline void reset ()
 		{
-			glUseProgram(0);
+		}
+
+		/**
+		 * @brief Forget the program in use
+		 *
+		 * The program in use is a per-context state, call this after
+		 * making another OpenGL context current.
+		 */
+		static inline void invalidate_current ()
+		{
+			kCurrentProgram = 0;
 		}
 
 		/**
@@ -180,6 +212,47 @@ namespace BlendInt {
 		 */
 		GLint GetUniformLocation (const char *name);
 
+		/**
+		 * @brief If the last Link() loaded the program from the binary cache
+		 */
+		bool loaded_from_cache () const
+		{
+			return m_cached;
+		}
+
+		/**
+		 * @brief Set the directory to cache linked program binaries in
+		 * @param path The directory, created if it does not exist, an
+		 * empty string disables the cache
+		 *
+		 * The cache is used only with OpenGL 4.1 or
+		 * GL_ARB_get_program_binary. A cached binary is named by a hash of
+		 * the driver strings and the shader sources, and is replaced if
+		 * the driver rejects it.
+		 */
+		static void SetBinaryCacheDirectory (const std::string& path);
+
+		static const std::string& binary_cache_directory ()
+		{
+			return kBinaryCacheDirectory;
+		}
+
+		/**
+		 * @brief Programs loaded from the binary cache in this process
+		 */
+		static unsigned int binary_cache_hits ()
+		{
+			return kBinaryCacheHits;
+		}
+
+		/**
+		 * @brief Programs linked from sources in this process
+		 */
+		static unsigned int linked_programs ()
+		{
+			return kLinkedPrograms;
+		}
+
 		void SetVertexAttrib1f (GLuint index, GLfloat v0);
 
 		bool SetVertexAttrib1f (const char* name, GLfloat v0);
@@ -234,7 +307,51 @@ namespace BlendInt {
 
 	private:
 
+		struct ShaderSource
+		{
+			GLenum type;
+			std::string source;
+		};
+
+		static bool IsBinaryCacheEnabled ();
+
+		// hash of the driver and the attached sources
+		uint64_t GetBinaryKey () const;
+
+		static std::string GetBinaryCacheFile (uint64_t key);
+
+		bool LoadBinary (uint64_t key);
+
+		void SaveBinary (uint64_t key);
+
+		void CompileSources ();
+
 		GLuint m_id;
+
+		// the sources attached while the binary cache is enabled, compiled
+		// in Link() if the program is not in the cache
+		std::vector<ShaderSource> m_sources;
+
+		// false if a compiled shader was attached, the program cannot be
+		// cached as its sources are unknown
+		bool m_cacheable;
+
+		bool m_cached;
+
+		static std::string kBinaryCacheDirectory;
+
+		// 1 if program binaries are supported, 0 if not, -1 if unknown
+		static int kBinarySupport;
+
+		// hash of the vendor, renderer and version strings
+		static uint64_t kDriverHash;
+
+		static unsigned int kBinaryCacheHits;
+
+		static unsigned int kLinkedPrograms;
+
+		// the program last passed to glUseProgram() in the current context
+		static GLuint kCurrentProgram;
 	};
 
 }
@@ -41,3 +41,7 @@
 //#include <GL/glcorearb.h>
 #endif
 #endif	// __UNIX__
+
+// the gl* functions counted by RenderStats are redirected after all
+// OpenGL headers are included
+#include <blendint/opengl/render-stats.hpp>
@@ -0,0 +1,452 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free
+ * software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is
+ * distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+
+#pragma once
+
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <blendint/opengl/opengl.hpp>
+
+namespace BlendInt {
+
+/**
+ * @brief Counters of OpenGL calls
+ */
+struct RenderCounters
+{
+  RenderCounters ()
+  : draw_calls(0),
+    vertices(0),
+    program_switches(0),
+    vao_binds(0),
+    uniform_uploads(0),
+    buffer_uploads(0),
+    stencil_pushes(0),
+    clip_pushes(0)
+  {
+  }
+
+  RenderCounters& operator += (const RenderCounters& other);
+
+  RenderCounters operator - (const RenderCounters& other) const;
+
+  // glDrawArrays(), glDrawElements() and glDrawElementsBaseVertex()
+  unsigned long draw_calls;
+
+  // vertices or indices passed to the draw calls
+  unsigned long vertices;
+
+  // glUseProgram() with a program other than the current one
+  unsigned long program_switches;
+
+  unsigned long vao_binds;
+
+  // glUniform*()
+  unsigned long uniform_uploads;
+
+  // glBufferData() and glBufferSubData()
+  unsigned long buffer_uploads;
+
+  // AbstractWindow::BeginPushStencil()
+  unsigned long stencil_pushes;
+
+  // AbstractWindow::PushClipRect()
+  unsigned long clip_pushes;
+};
+
+/**
+ * @brief Render statistics of a view drawn in a frame
+ */
+struct ViewRenderStats
+{
+  ViewRenderStats ()
+  : view(0), type(0), depth(0), time(0)
+  {
+  }
+
+  const void* view;
+
+  std::string name;
+
+  // the mangled class name from typeid
+  const char* type;
+
+  // 0 for the views drawn directly by a window
+  int depth;
+
+  // calls made by this view only, not by its subviews
+  RenderCounters self;
+
+  // calls made by this view and its subviews
+  RenderCounters total;
+
+  // microseconds spent in drawing this view and its subviews
+  uint64_t time;
+};
+
+/**
+ * @brief Render statistics of a shader program
+ */
+struct ProgramRenderStats
+{
+  ProgramRenderStats ()
+  : program(0)
+  {
+  }
+
+  GLuint program;
+
+  std::string name;
+
+  // calls made while this program is in use
+  RenderCounters counters;
+};
+
+/**
+ * @brief Opt-in statistics of the OpenGL calls in each frame
+ *
+ * Nothing is counted until SetEnabled(true). Views are recorded in
+ * AbstractView::DispatchDrawEvent(), frames in Window::Exec().
+ *
+ * OpenGL calls are counted only if the library is built with
+ * WITH_RENDER_STATS, which redirects the counted gl* functions included
+ * from opengl.hpp to the wrappers in this class. Otherwise only stencil
+ * and clip pushes and the time of views are recorded.
+ */
+class RenderStats
+{
+ public:
+
+  enum DumpFormat {
+    DumpText,
+    DumpJSON
+  };
+
+  static void SetEnabled (bool enabled);
+
+  static inline bool enabled ()
+  {
+    return kEnabled;
+  }
+
+  static void BeginFrame ();
+
+  static void EndFrame ();
+
+  /**
+   * @brief Start recording calls for a view, must be paired with EndView()
+   */
+  static void BeginView (const void* view,
+                         const std::string& name,
+                         const char* type);
+
+  static void EndView ();
+
+  /**
+   * @brief Give a shader program a readable name in the dump
+   */
+  static void SetProgramName (GLuint program, const char* name);
+
+  /**
+   * @brief Clear the accumulated statistics
+   */
+  static void Reset ();
+
+  /**
+   * @brief Print the statistics of the last frame and the totals
+   */
+  static std::string Dump (DumpFormat format = DumpText);
+
+  static inline void CountDraw (GLsizei count)
+  {
+    kFrame.draw_calls++;
+    kFrame.vertices += count;
+    if (kProgram) {
+      kProgram->counters.draw_calls++;
+      kProgram->counters.vertices += count;
+    }
+    if (kView) {
+      kView->self.draw_calls++;
+      kView->self.vertices += count;
+    }
+  }
+
+  static void CountProgram (GLuint program);
+
+  static inline void CountVertexArrayBind ()
+  {
+    kFrame.vao_binds++;
+    if (kProgram) kProgram->counters.vao_binds++;
+    if (kView) kView->self.vao_binds++;
+  }
+
+  static inline void CountUniform ()
+  {
+    kFrame.uniform_uploads++;
+    if (kProgram) kProgram->counters.uniform_uploads++;
+    if (kView) kView->self.uniform_uploads++;
+  }
+
+  static inline void CountBufferUpload ()
+  {
+    kFrame.buffer_uploads++;
+    if (kProgram) kProgram->counters.buffer_uploads++;
+    if (kView) kView->self.buffer_uploads++;
+  }
+
+  static inline void CountStencilPush ()
+  {
+    if (!kEnabled) return;
+
+    kFrame.stencil_pushes++;
+    if (kProgram) kProgram->counters.stencil_pushes++;
+    if (kView) kView->self.stencil_pushes++;
+  }
+
+  static inline void CountClipPush ()
+  {
+    if (!kEnabled) return;
+
+    kFrame.clip_pushes++;
+    if (kProgram) kProgram->counters.clip_pushes++;
+    if (kView) kView->self.clip_pushes++;
+  }
+
+  static inline void DrawArrays (GLenum mode, GLint first, GLsizei count)
+  {
+    if (kEnabled) CountDraw(count);
+    (glDrawArrays)(mode, first, count);
+  }
+
+  static inline void DrawElements (GLenum mode,
+                                   GLsizei count,
+                                   GLenum type,
+                                   const GLvoid* indices)
+  {
+    if (kEnabled) CountDraw(count);
+    (glDrawElements)(mode, count, type, indices);
+  }
+
+  static inline void DrawElementsBaseVertex (GLenum mode,
+                                             GLsizei count,
+                                             GLenum type,
+                                             const GLvoid* indices,
+                                             GLint basevertex)
+  {
+    if (kEnabled) CountDraw(count);
+    (glDrawElementsBaseVertex)(mode, count, type, indices, basevertex);
+  }
+
+  static inline void UseProgram (GLuint program)
+  {
+    if (kEnabled) CountProgram(program);
+    (glUseProgram)(program);
+  }
+
+  static inline void BindVertexArray (GLuint array)
+  {
+    if (kEnabled) CountVertexArrayBind();
+    (glBindVertexArray)(array);
+  }
+
+  static inline void BufferData (GLenum target,
+                                 GLsizeiptr size,
+                                 const GLvoid* data,
+                                 GLenum usage)
+  {
+    if (kEnabled) CountBufferUpload();
+    (glBufferData)(target, size, data, usage);
+  }
+
+  static inline void BufferSubData (GLenum target,
+                                    GLintptr offset,
+                                    GLsizeiptr size,
+                                    const GLvoid* data)
+  {
+    if (kEnabled) CountBufferUpload();
+    (glBufferSubData)(target, offset, size, data);
+  }
+
+  static inline void Uniform1i (GLint location, GLint v0)
+  {
+    if (kEnabled) CountUniform();
+    (glUniform1i)(location, v0);
+  }
+
+  static inline void Uniform1f (GLint location, GLfloat v0)
+  {
+    if (kEnabled) CountUniform();
+    (glUniform1f)(location, v0);
+  }
+
+  static inline void Uniform2f (GLint location, GLfloat v0, GLfloat v1)
+  {
+    if (kEnabled) CountUniform();
+    (glUniform2f)(location, v0, v1);
+  }
+
+  static inline void Uniform3f (GLint location,
+                                GLfloat v0,
+                                GLfloat v1,
+                                GLfloat v2)
+  {
+    if (kEnabled) CountUniform();
+    (glUniform3f)(location, v0, v1, v2);
+  }
+
+  static inline void Uniform4f (GLint location,
+                                GLfloat v0,
+                                GLfloat v1,
+                                GLfloat v2,
+                                GLfloat v3)
+  {
+    if (kEnabled) CountUniform();
+    (glUniform4f)(location, v0, v1, v2, v3);
+  }
+
+  static inline void Uniform3fv (GLint location,
+                                 GLsizei count,
+                                 const GLfloat* value)
+  {
+    if (kEnabled) CountUniform();
+    (glUniform3fv)(location, count, value);
+  }
+
+  static inline void Uniform4fv (GLint location,
+                                 GLsizei count,
+                                 const GLfloat* value)
+  {
+    if (kEnabled) CountUniform();
+    (glUniform4fv)(location, count, value);
+  }
+
+  static inline void UniformMatrix3fv (GLint location,
+                                       GLsizei count,
+                                       GLboolean transpose,
+                                       const GLfloat* value)
+  {
+    if (kEnabled) CountUniform();
+    (glUniformMatrix3fv)(location, count, transpose, value);
+  }
+
+  static inline void UniformMatrix4fv (GLint location,
+                                       GLsizei count,
+                                       GLboolean transpose,
+                                       const GLfloat* value)
+  {
+    if (kEnabled) CountUniform();
+    (glUniformMatrix4fv)(location, count, transpose, value);
+  }
+
+  static inline const RenderCounters& last_frame ()
+  {
+    return kLastFrame;
+  }
+
+  static inline const RenderCounters& total ()
+  {
+    return kTotal;
+  }
+
+  static inline unsigned long frame_count ()
+  {
+    return kFrameCount;
+  }
+
+  /**
+   * @brief The views drawn in the last frame, in drawing order
+   */
+  static inline const std::vector<ViewRenderStats>& views ()
+  {
+    return kLastViews;
+  }
+
+  /**
+   * @brief Statistics of shader programs accumulated since Reset()
+   */
+  static inline const std::map<GLuint, ProgramRenderStats>& programs ()
+  {
+    return kPrograms;
+  }
+
+ private:
+
+  struct ViewRecord
+  {
+    size_t index;
+    RenderCounters start;
+    uint64_t start_time;
+  };
+
+  static bool kEnabled;
+
+  static RenderCounters kFrame;
+
+  static RenderCounters kLastFrame;
+
+  static RenderCounters kTotal;
+
+  static unsigned long kFrameCount;
+
+  // the program in use, 0 if unknown
+  static ProgramRenderStats* kProgram;
+
+  // the innermost view being drawn
+  static ViewRenderStats* kView;
+
+  static std::vector<ViewRenderStats> kViews;
+
+  static std::vector<ViewRenderStats> kLastViews;
+
+  static std::vector<ViewRecord> kViewStack;
+
+  static std::map<GLuint, ProgramRenderStats> kPrograms;
+};
+
+}
+
+#ifdef BLENDINT_RENDER_STATS
+
+#define glDrawArrays(...) BlendInt::RenderStats::DrawArrays(__VA_ARGS__)
+#define glDrawElements(...) BlendInt::RenderStats::DrawElements(__VA_ARGS__)
+#define glDrawElementsBaseVertex(...) BlendInt::RenderStats::DrawElementsBaseVertex(__VA_ARGS__)
+#define glUseProgram(...) BlendInt::RenderStats::UseProgram(__VA_ARGS__)
+#define glBindVertexArray(...) BlendInt::RenderStats::BindVertexArray(__VA_ARGS__)
+#define glBufferData(...) BlendInt::RenderStats::BufferData(__VA_ARGS__)
+#define glBufferSubData(...) BlendInt::RenderStats::BufferSubData(__VA_ARGS__)
+#define glUniform1i(...) BlendInt::RenderStats::Uniform1i(__VA_ARGS__)
+#define glUniform1f(...) BlendInt::RenderStats::Uniform1f(__VA_ARGS__)
+#define glUniform2f(...) BlendInt::RenderStats::Uniform2f(__VA_ARGS__)
+#define glUniform3f(...) BlendInt::RenderStats::Uniform3f(__VA_ARGS__)
+#define glUniform4f(...) BlendInt::RenderStats::Uniform4f(__VA_ARGS__)
+#define glUniform3fv(...) BlendInt::RenderStats::Uniform3fv(__VA_ARGS__)
+#define glUniform4fv(...) BlendInt::RenderStats::Uniform4fv(__VA_ARGS__)
+#define glUniformMatrix3fv(...) BlendInt::RenderStats::UniformMatrix3fv(__VA_ARGS__)
+#define glUniformMatrix4fv(...) BlendInt::RenderStats::UniformMatrix4fv(__VA_ARGS__)
+
+#endif	// BLENDINT_RENDER_STATS
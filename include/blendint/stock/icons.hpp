@@ -32,6 +32,8 @@
 
 namespace BlendInt {
 
+class Image;
+
 /**
  * @brief Stock Icons
  *
@@ -1101,6 +1103,13 @@ public:
     return icons_32x32_[index];
   }
 
+  /**
+   * @brief Read the images of the pixel icons
+   *
+   * No OpenGL call is made, this can run in another thread.
+   */
+  static bool ReadImages (Image* icons16, Image* icons32);
+
 private:
 
   friend class AbstractWindow;
@@ -1110,6 +1119,11 @@ private:
    */
   Icons ();
 
+  /**
+   * @brief Create icons with the images read by ReadImages()
+   */
+  Icons (const Image& icons16, const Image& icons32);
+
   /**
    * @brief private destructor
    */
@@ -1120,13 +1134,13 @@ private:
    *
    * Call in constructor
    */
-  void CreateIcons ();
+  void CreateIcons (const Image& icons16, const Image& icons32);
 
   void CreateVectorIcons ();
 
-  void CreatePixelIcons16x16 ();
+  void CreatePixelIcons16x16 (const Image& image);
 
-  void CreatePixelIcons32x32 ();
+  void CreatePixelIcons32x32 (const Image& image);
 
   RefPtr<VectorIcon> menu_;
   RefPtr<VectorIcon> circle_;
@@ -24,6 +24,7 @@
 #pragma once
 
 #include <stack>
+#include <vector>
 
 #include <glm/glm.hpp>
 
@@ -148,8 +149,9 @@ class Shaders
     LocationLast
   };
 
-  inline const RefPtr<GLSLProgram>& widget_text_program () const
+  inline const RefPtr<GLSLProgram>& widget_text_program ()
   {
+    ApplyWidgetModelMatrix();
     return widget_text_program_;
   }
 
@@ -158,48 +160,57 @@ class Shaders
     return primitive_program_;
   }
 
-  inline const RefPtr<GLSLProgram>& widget_triangle_program () const
+  inline const RefPtr<GLSLProgram>& widget_triangle_program ()
   {
+    ApplyWidgetModelMatrix();
     return widget_triangle_program_;
   }
 
-  inline const RefPtr<GLSLProgram>& widget_simple_triangle_program () const
+  inline const RefPtr<GLSLProgram>& widget_simple_triangle_program ()
   {
+    ApplyWidgetModelMatrix();
     return widget_simple_triangle_program_;
   }
 
-  inline const RefPtr<GLSLProgram>& widget_inner_program () const
+  inline const RefPtr<GLSLProgram>& widget_inner_program ()
   {
+    ApplyWidgetModelMatrix();
     return widget_inner_program_;
   }
 
-  inline const RefPtr<GLSLProgram>& widget_split_inner_program () const
+  inline const RefPtr<GLSLProgram>& widget_split_inner_program ()
   {
+    ApplyWidgetModelMatrix();
     return widget_split_inner_program_;
   }
 
-  inline const RefPtr<GLSLProgram>& widget_outer_program () const
+  inline const RefPtr<GLSLProgram>& widget_outer_program ()
   {
+    ApplyWidgetModelMatrix();
     return widget_outer_program_;
   }
 
-  inline const RefPtr<GLSLProgram>& widget_image_program () const
+  inline const RefPtr<GLSLProgram>& widget_image_program ()
   {
+    ApplyWidgetModelMatrix();
     return widget_image_program_;
   }
 
-  inline const RefPtr<GLSLProgram>& widget_line_program () const
+  inline const RefPtr<GLSLProgram>& widget_line_program ()
   {
+    ApplyWidgetModelMatrix();
     return widget_line_program_;
   }
 
-  inline const RefPtr<GLSLProgram>& widget_shadow_program () const
+  inline const RefPtr<GLSLProgram>& widget_shadow_program ()
   {
+    ApplyWidgetModelMatrix();
     return widget_shadow_program_;
   }
 
-  inline const RefPtr<GLSLProgram>& widget_debug_program () const
+  inline const RefPtr<GLSLProgram>& widget_debug_program ()
   {
+    ApplyWidgetModelMatrix();
     return widget_debug_program_;
   }
   
@@ -235,7 +246,7 @@ class Shaders
 
   inline const glm::mat3& widget_model_matrix () const
   {
-    return current_widget_model_matrix_;
+    return widget_model_matrices_[widget_model_depth_];
   }
 
   void SetWidgetProjectionMatrix (const glm::mat4& matrix);
@@ -250,12 +261,32 @@ class Shaders
 
   void PopWidgetViewMatrix ();
 
+  /**
+   * @brief Set the model matrix on the top of the stack
+   *
+   * The model matrix stack is kept in memory only, the matrix is
+   * uploaded by ApplyWidgetModelMatrix() when a widget program is
+   * used for drawing.
+   */
   void SetWidgetModelMatrix (const glm::mat3& matrix);
 
   void PushWidgetModelMatrix ();
 
   void PopWidgetModelMatrix ();
 
+  /**
+   * @brief Upload the model matrix to the uniform block if it was
+   * changed since the last draw
+   *
+   * The widget_*_program() accessors call this, so get the program
+   * right before drawing instead of keeping it across
+   * Push/PopWidgetModelMatrix().
+   */
+  inline void ApplyWidgetModelMatrix ()
+  {
+    if (widget_model_matrix_changed_) UploadWidgetModelMatrix();
+  }
+
   void SetFrameProjectionMatrix (const glm::mat4& matrix);
 
   void SetFrameViewMatrix (const glm::mat4& matrix);
@@ -274,7 +305,7 @@ class Shaders
 
   inline const glm::mat3& current_widget_model_matrix () const
   {
-    return current_widget_model_matrix_;
+    return widget_model_matrices_[widget_model_depth_];
   }
 
   inline GLint location (LocationType index) const
@@ -299,6 +330,8 @@ class Shaders
 
   bool Setup ();
 
+  void UploadWidgetModelMatrix ();
+
   bool SetupWidgetInnerProgram ();
 
   bool SetupWidgetSplitInnerProgram ();
@@ -386,13 +419,20 @@ class Shaders
 
   glm::mat4 current_widget_view_matrix_;
 
-  glm::mat3 current_widget_model_matrix_;
-
   std::stack<glm::mat4> widget_projection_matrix_stack;
 
   std::stack<glm::mat4> widget_view_matrix_stack;
 
-  std::stack<glm::mat3> widget_model_matrix_stack;
+  // the model matrix stack, grows but never shrinks, the top is at
+  // widget_model_depth_
+  std::vector<glm::mat3> widget_model_matrices_;
+
+  size_t widget_model_depth_;
+
+  // the model matrix in the uniform block
+  glm::mat3 uploaded_widget_model_matrix_;
+
+  bool widget_model_matrix_changed_;
 
   static const GLuint kFrameMatricesBindingPoint = 1;
 
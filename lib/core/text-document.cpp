@@ -0,0 +1,152 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free
+ * software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is
+ * distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+#include <blendint/core/text-document.hpp>
+
+namespace BlendInt {
+
+TextDocument::TextDocument ()
+{
+  lines_.Insert(0, String());
+}
+
+TextDocument::TextDocument (const String& text)
+{
+  SetText(text);
+}
+
+TextDocument::~TextDocument ()
+{
+}
+
+void TextDocument::SetText (const String& text)
+{
+  size_t count = 1;
+  for (size_t i = 0; i < text.length(); i++) {
+    if (text[i] == '\n') count++;
+  }
+
+  lines_.Clear();
+  lines_.Reserve(count);
+
+  size_t begin = 0;
+  size_t end = 0;
+  size_t index = 0;
+
+  while ((end = text.find('\n', begin)) != String::npos) {
+    lines_.Insert(index, String());
+    lines_[index].assign(text, begin, end - begin);
+    index++;
+    begin = end + 1;
+  }
+
+  lines_.Insert(index, String());
+  lines_[index].assign(text, begin, String::npos);
+}
+
+String TextDocument::GetText () const
+{
+  size_t length = lines_.size() - 1;
+  for (size_t i = 0; i < lines_.size(); i++) {
+    length += lines_[i].length();
+  }
+
+  String text;
+  text.reserve(length);
+
+  for (size_t i = 0; i < lines_.size(); i++) {
+    if (i > 0) text.push_back('\n');
+    text.append(lines_[i]);
+  }
+
+  return text;
+}
+
+void TextDocument::Insert (size_t* line, size_t* column, const String& text)
+{
+  DBG_ASSERT(*line < lines_.size());
+  DBG_ASSERT(*column <= lines_[*line].length());
+
+  size_t end = text.find('\n');
+
+  if (end == String::npos) {
+    lines_[*line].insert(*column, text);
+    *column += text.length();
+    return;
+  }
+
+  // the part after the position goes to the last inserted line
+  String tail;
+  tail.assign(lines_[*line], *column, String::npos);
+  lines_[*line].erase(*column);
+  lines_[*line].append(text, 0, end);
+
+  size_t begin = end + 1;
+  size_t index = *line + 1;
+
+  while ((end = text.find('\n', begin)) != String::npos) {
+    lines_.Insert(index, String());
+    lines_[index].assign(text, begin, end - begin);
+    index++;
+    begin = end + 1;
+  }
+
+  lines_.Insert(index, String());
+  lines_[index].assign(text, begin, String::npos);
+
+  *line = index;
+  *column = lines_[index].length();
+
+  lines_[index].append(tail);
+}
+
+void TextDocument::Erase (size_t line,
+                          size_t column,
+                          size_t end_line,
+                          size_t end_column)
+{
+  DBG_ASSERT(line <= end_line);
+  DBG_ASSERT(end_line < lines_.size());
+
+  if (line == end_line) {
+    DBG_ASSERT(column <= end_column);
+
+    lines_[line].erase(column, end_column - column);
+    return;
+  }
+
+  lines_[line].erase(column);
+  lines_[line].append(lines_[end_line],
+                      std::min(end_column, lines_[end_line].length()),
+                      String::npos);
+
+  lines_.Erase(line + 1, end_line - line);
+}
+
+void TextDocument::Clear ()
+{
+  lines_.Clear();
+  lines_.Insert(0, String());
+}
+
+}
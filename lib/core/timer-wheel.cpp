@@ -0,0 +1,239 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free
+ * software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is
+ * distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+#include <time.h>
+#include <string.h>
+
+#include <algorithm>
+#include <climits>
+
+#include <blendint/core/timer.hpp>
+#include <blendint/core/timer-wheel.hpp>
+
+namespace BlendInt {
+
+static uint64_t GetMonotonicMilliseconds ()
+{
+  struct timespec ts = {0, 0};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+TimerWheel::TimerWheel ()
+: current_(0),
+  start_time_(GetMonotonicMilliseconds()),
+  count_(0)
+{
+  memset(slots_, 0, sizeof(slots_));
+}
+
+TimerWheel::~TimerWheel ()
+{
+  // timers may be destroyed after a static wheel, detach them
+  for (int level = 0; level < kLevels; level++) {
+    for (int i = 0; i < kSlots; i++) {
+      while (slots_[level][i]) {
+        Timer* timer = slots_[level][i];
+        Unlink(timer);
+        timer->enabled_ = false;
+      }
+    }
+  }
+}
+
+uint64_t TimerWheel::GetCurrentTick () const
+{
+  return GetMonotonicMilliseconds() - start_time_;
+}
+
+void TimerWheel::Schedule (Timer* timer, unsigned int delay)
+{
+  if (timer->level_ >= 0) {
+    Unlink(timer);
+  } else {
+    // the wheel does not advance while empty
+    if (count_ == 0) current_ = std::max(current_, GetCurrentTick());
+    count_++;
+  }
+
+  delay = std::max(delay, 1u);
+
+  timer->deadline_ = GetCurrentTick() + delay;
+  timer->expires_ = RoundUp(timer->deadline_, delay);
+
+  Place(timer);
+}
+
+void TimerWheel::Cancel (Timer* timer)
+{
+  if (timer->level_ < 0) return;
+
+  Unlink(timer);
+  count_--;
+}
+
+int TimerWheel::Advance ()
+{
+  uint64_t now = GetCurrentTick();
+  int fired = 0;
+  Timer* timer = 0;
+
+  while (count_ && (current_ < now)) {
+
+    current_++;
+
+    int index = (int)(current_ & kSlotMask);
+    if (index == 0) Cascade(1);
+
+    while ((timer = slots_[0][index]) != 0) {
+
+      Unlink(timer);
+
+      // a timer beyond the range of the wheel is placed again
+      if (timer->expires_ > current_) {
+        Place(timer);
+        continue;
+      }
+
+      count_--;
+
+      // reschedule from the deadline to not drift, unless far behind
+      unsigned int interval = std::max(timer->interval_, 1u);
+      uint64_t deadline = timer->deadline_ + interval;
+      if (deadline <= current_) deadline = current_ + interval;
+
+      timer->deadline_ = deadline;
+      timer->expires_ = RoundUp(deadline, interval);
+
+      Place(timer);
+      count_++;
+
+      timer->timeout_.Invoke();
+      fired++;
+    }
+  }
+
+  if (count_ == 0) current_ = std::max(current_, now);
+
+  return fired;
+}
+
+int TimerWheel::GetTimeout () const
+{
+  if (count_ == 0) return -1;
+
+  uint64_t next = UINT64_MAX;
+
+  // slots in level 0 hold timers of exact ticks
+  for (int i = 1; i <= kSlots; i++) {
+    if (slots_[0][(current_ + i) & kSlotMask]) {
+      next = current_ + i;
+      break;
+    }
+  }
+
+  for (int level = 1; level < kLevels; level++) {
+    for (int i = 0; i < kSlots; i++) {
+      for (Timer* p = slots_[level][i]; p; p = p->wheel_next_) {
+        next = std::min(next, p->expires_);
+      }
+    }
+  }
+
+  uint64_t now = GetCurrentTick();
+  if (next <= now) return 0;
+
+  return (int)std::min(next - now, (uint64_t)INT_MAX);
+}
+
+uint64_t TimerWheel::RoundUp (uint64_t deadline, unsigned int delay)
+{
+  // a power of 2 not larger than 1/8 of the delay
+  uint64_t granularity = 1;
+  while (((granularity * 2) <= (delay / 8)) && ((granularity * 2) <= kMaxGranularity)) {
+    granularity *= 2;
+  }
+
+  return (deadline + granularity - 1) & ~(granularity - 1);
+}
+
+void TimerWheel::Place (Timer* timer)
+{
+  uint64_t expires = std::max(timer->expires_, current_ + 1);
+  uint64_t delta = expires - current_;
+
+  int level = 0;
+  while ((level < (kLevels - 1)) && (delta >> (kSlotBits * (level + 1)))) {
+    level++;
+  }
+
+  // clamp to the last slot, the timer will be placed again when reached
+  uint64_t range = (uint64_t)1 << (kSlotBits * kLevels);
+  if (delta >= range) expires = current_ + range - 1;
+
+  int slot = (int)((expires >> (kSlotBits * level)) & kSlotMask);
+
+  timer->level_ = level;
+  timer->slot_ = slot;
+  timer->wheel_prev_ = 0;
+  timer->wheel_next_ = slots_[level][slot];
+  if (timer->wheel_next_) timer->wheel_next_->wheel_prev_ = timer;
+  slots_[level][slot] = timer;
+}
+
+void TimerWheel::Unlink (Timer* timer)
+{
+  if (timer->wheel_prev_) {
+    timer->wheel_prev_->wheel_next_ = timer->wheel_next_;
+  } else {
+    slots_[timer->level_][timer->slot_] = timer->wheel_next_;
+  }
+
+  if (timer->wheel_next_) {
+    timer->wheel_next_->wheel_prev_ = timer->wheel_prev_;
+  }
+
+  timer->wheel_prev_ = 0;
+  timer->wheel_next_ = 0;
+  timer->level_ = -1;
+  timer->slot_ = -1;
+}
+
+void TimerWheel::Cascade (int level)
+{
+  int index = (int)((current_ >> (kSlotBits * level)) & kSlotMask);
+
+  Timer* timer = slots_[level][index];
+  slots_[level][index] = 0;
+
+  while (timer) {
+    Timer* next = timer->wheel_next_;
+    Place(timer);
+    timer = next;
+  }
+
+  if ((index == 0) && ((level + 1) < kLevels)) Cascade(level + 1);
+}
+
+}
@@ -24,10 +24,154 @@
  * SOFTWARE.
  */
 
+#include <mutex>
+#include <new>
+
 #include <cppevent/abstract-trackable.hpp>
 
 namespace CppEvent {
 
+// blocks are in size classes of kBlockAlignment bytes, larger objects
+// are allocated from the heap
+static const std::size_t kBlockAlignment = 16;
+static const std::size_t kMaxBlockSize = 128;
+static const std::size_t kBlocksPerSlab = 64;
+
+struct FreeBlock
+{
+  FreeBlock* next;
+};
+
+static const std::size_t kSizeClasses = kMaxBlockSize / kBlockAlignment;
+
+// Blocks left by exited threads, taken by the next thread running out
+// of blocks of a size class.
+static std::mutex kOrphanMutex;
+static FreeBlock* kOrphanBlocks[kSizeClasses] = { 0 };
+
+// Each thread has its own free lists so no lock is needed. A block
+// freed in another thread joins the free lists of that thread, slabs are
+// never returned to the heap.
+struct FreeLists
+{
+  FreeBlock* blocks[kSizeClasses];
+
+  // cleared when destroyed, the thread_local objects of the main thread
+  // are destroyed before the static objects which may still free blocks
+  bool alive;
+
+  // hand the blocks to kOrphanBlocks, or the blocks freed in a
+  // short-lived thread (e.g. a std::async worker) would leak with it
+  ~FreeLists ()
+  {
+    std::lock_guard<std::mutex> lock(kOrphanMutex);
+
+    alive = false;
+
+    for (std::size_t i = 0; i < kSizeClasses; i++) {
+      if (blocks[i] == 0) continue;
+
+      FreeBlock* last = blocks[i];
+      while (last->next) last = last->next;
+
+      last->next = kOrphanBlocks[i];
+      kOrphanBlocks[i] = blocks[i];
+      blocks[i] = 0;
+    }
+  }
+};
+
+static thread_local FreeLists kFreeLists = { { 0 }, true };
+
+static void* AllocateBlock (std::size_t size)
+{
+  if (size == 0) size = 1;
+  if (size > kMaxBlockSize) return ::operator new(size);
+
+  std::size_t index = (size - 1) / kBlockAlignment;
+
+  // the free lists of this thread are gone, take an orphan block
+  if (!kFreeLists.alive) {
+    std::lock_guard<std::mutex> lock(kOrphanMutex);
+    FreeBlock* block = kOrphanBlocks[index];
+    if (block == 0) return ::operator new((index + 1) * kBlockAlignment);
+    kOrphanBlocks[index] = block->next;
+    return block;
+  }
+
+  FreeBlock* block = kFreeLists.blocks[index];
+
+  if (block == 0) {
+    std::lock_guard<std::mutex> lock(kOrphanMutex);
+    block = kOrphanBlocks[index];
+    kOrphanBlocks[index] = 0;
+  }
+
+  if (block == 0) {
+    std::size_t block_size = (index + 1) * kBlockAlignment;
+    char* slab = static_cast<char*>(::operator new(block_size * kBlocksPerSlab));
+
+    // keep the first block, link the others
+    for (std::size_t i = 1; i < kBlocksPerSlab; i++) {
+      FreeBlock* p = reinterpret_cast<FreeBlock*>(slab + i * block_size);
+      p->next = (i + 1 < kBlocksPerSlab) ?
+          reinterpret_cast<FreeBlock*>(slab + (i + 1) * block_size) : 0;
+    }
+    kFreeLists.blocks[index] = reinterpret_cast<FreeBlock*>(slab + block_size);
+
+    return slab;
+  }
+
+  kFreeLists.blocks[index] = block->next;
+  return block;
+}
+
+static void ReleaseBlock (void* ptr, std::size_t size)
+{
+  if (ptr == 0) return;
+
+  if (size == 0) size = 1;
+  if (size > kMaxBlockSize) {
+    ::operator delete(ptr);
+    return;
+  }
+
+  std::size_t index = (size - 1) / kBlockAlignment;
+  FreeBlock* block = static_cast<FreeBlock*>(ptr);
+
+  // freed by a static object after the free lists of the main thread
+  // were destroyed
+  if (!kFreeLists.alive) {
+    std::lock_guard<std::mutex> lock(kOrphanMutex);
+    block->next = kOrphanBlocks[index];
+    kOrphanBlocks[index] = block;
+    return;
+  }
+
+  block->next = kFreeLists.blocks[index];
+  kFreeLists.blocks[index] = block;
+}
+
+void* Binding::operator new (std::size_t size)
+{
+  return AllocateBlock(size);
+}
+
+void Binding::operator delete (void* ptr, std::size_t size)
+{
+  ReleaseBlock(ptr, size);
+}
+
+void* Token::operator new (std::size_t size)
+{
+  return AllocateBlock(size);
+}
+
+void Token::operator delete (void* ptr, std::size_t size)
+{
+  ReleaseBlock(ptr, size);
+}
+
 Binding::~Binding()
 {
   if (trackable_object) {
@@ -0,0 +1,453 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free software:
+ * you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is distributed in
+ * the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+#include <algorithm>
+
+#include <blendint/gui/abstract-array-list-model.hpp>
+
+namespace BlendInt {
+
+AbstractArrayListModel::AbstractArrayListModel ()
+    : AbstractItemModel(), root_(0), row_count_(0), columns_(0)
+{
+  root_ = new ModelNode;
+}
+
+AbstractArrayListModel::~AbstractArrayListModel ()
+{
+  Clear();
+
+  delete root_;
+}
+
+bool AbstractArrayListModel::InsertColumns (int column,
+                                            int count,
+                                            const ModelIndex& parent)
+{
+  if (get_index_node(parent) != root_) return false;
+
+  DBG_ASSERT(count > 0);
+  DBG_ASSERT(column >= 0);
+
+  column = std::min(column, columns_);
+
+  if (row_count_ == 0) {	// create and append 1 row with count columns
+    columns_ = count;
+    return InsertRows(0, 1, parent);
+  }
+
+  for (size_t i = 0; i < blocks_.size(); i++) {
+
+    std::vector<ModelNode*>& rows = blocks_[i]->rows;
+
+    for (size_t j = 0; j < rows.size(); j++) {
+
+      ModelNode* first = new ModelNode;
+      ModelNode* last = first;
+      for (int k = 1; k < count; k++) {
+        last->right = new ModelNode;
+        last->right->left = last;
+        last = last->right;
+      }
+
+      if (column == 0) {
+        last->right = rows[j];
+        rows[j]->left = last;
+        rows[j]->up = 0;
+        rows[j]->down = 0;
+        rows[j]->parent = 0;
+        rows[j]->row = -1;
+        rows[j]->row_base = 0;
+        rows[j] = first;
+      } else {
+        ModelNode* node = rows[j];
+        for (int k = 1; k < column; k++) {
+          node = node->right;
+        }
+
+        last->right = node->right;
+        if (node->right) node->right->left = last;
+        node->right = first;
+        first->left = node;
+      }
+
+      NumberColumns(rows[j]);
+    }
+  }
+
+  columns_ += count;
+
+  if (column == 0) RelinkAll();
+
+  return true;
+}
+
+bool AbstractArrayListModel::RemoveColumns (int column,
+                                            int count,
+                                            const ModelIndex& parent)
+{
+  if (get_index_node(parent) != root_) return false;
+  if (row_count_ == 0) return false;
+
+  DBG_ASSERT(count > 0);
+  DBG_ASSERT(column >= 0);
+
+  if (column >= columns_) return false;
+  count = std::min(count, columns_ - column);
+
+  if (count == columns_) {	// remove all columns
+    Clear();
+    return true;
+  }
+
+  for (size_t i = 0; i < blocks_.size(); i++) {
+
+    std::vector<ModelNode*>& rows = blocks_[i]->rows;
+
+    for (size_t j = 0; j < rows.size(); j++) {
+
+      ModelNode* node = rows[j];
+      for (int k = 0; k < column; k++) {
+        node = node->right;
+      }
+
+      ModelNode* left = node->left;
+      ModelNode* next = 0;
+      for (int k = 0; k < count; k++) {
+        next = node->right;
+        delete node;
+        node = next;
+      }
+
+      if (left) {
+        left->right = node;
+      } else {
+        rows[j] = node;
+      }
+      if (node) node->left = left;
+
+      NumberColumns(rows[j]);
+    }
+  }
+
+  columns_ -= count;
+
+  if (column == 0) RelinkAll();
+
+  return true;
+}
+
+bool AbstractArrayListModel::InsertRows (int row,
+                                         int count,
+                                         const ModelIndex& parent)
+{
+  if (get_index_node(parent) != root_) return false;
+
+  DBG_ASSERT(count > 0);
+  DBG_ASSERT(row >= 0);
+
+  if (columns_ == 0) columns_ = 1;
+
+  row = std::min(row, row_count_);
+
+  if (blocks_.empty()) {
+    blocks_.push_back(new RowBlock);
+    blocks_[0]->first = 0;
+  }
+
+  size_t index = FindBlock(row);
+  std::vector<ModelNode*>& rows = blocks_[index]->rows;
+  int offset = row - blocks_[index]->first;
+
+  rows.insert(rows.begin() + offset, count, 0);
+  for (int i = offset; i < (offset + count); i++) {
+    rows[i] = CreateRow();
+  }
+  row_count_ += count;
+
+  BalanceBlock(index);
+  LinkRows(row - 1, row + count);
+
+  return true;
+}
+
+bool AbstractArrayListModel::RemoveRows (int row,
+                                         int count,
+                                         const ModelIndex& parent)
+{
+  if (get_index_node(parent) != root_) return false;
+
+  DBG_ASSERT(count > 0);
+  DBG_ASSERT(row >= 0);
+
+  if (row >= row_count_) return false;
+  count = std::min(count, row_count_ - row);
+
+  size_t index = FindBlock(row);
+  int offset = row - blocks_[index]->first;
+  int remaining = count;
+
+  // the first rows of the blocks are updated after all rows are removed
+  size_t last = index;
+  for (size_t i = index; remaining > 0; i++) {
+    std::vector<ModelNode*>& rows = blocks_[i]->rows;
+    int n = std::min(remaining, (int) rows.size() - offset);
+
+    for (int j = offset; j < (offset + n); j++) {
+      DestroyRow(rows[j]);
+    }
+    rows.erase(rows.begin() + offset, rows.begin() + offset + n);
+
+    remaining -= n;
+    offset = 0;
+    last = i;
+  }
+
+  row_count_ -= count;
+
+  // drop the emptied blocks
+  for (size_t i = last + 1; i > index; i--) {
+    if (blocks_[i - 1]->rows.empty()) {
+      delete blocks_[i - 1];
+      blocks_.erase(blocks_.begin() + (i - 1));
+    }
+  }
+
+  if (blocks_.empty()) {
+    root_->child = 0;
+    return true;
+  }
+
+  // the rows left in the last block touched were shifted to its front
+  if ((index + 1) < blocks_.size()) NumberBlock(index + 1);
+
+  if (index < blocks_.size()) BalanceBlock(index);
+  if (index > 0) BalanceBlock(index - 1);
+
+  LinkRows(row - 1, row);
+
+  return true;
+}
+
+ModelIndex AbstractArrayListModel::GetRootIndex () const
+{
+  ModelIndex retval;
+  set_index_node(retval, root_);
+
+  return retval;
+}
+
+ModelIndex AbstractArrayListModel::GetIndex (int row,
+                                             int column,
+                                             const ModelIndex& parent) const
+{
+  ModelIndex index;
+
+  if (get_index_node(parent) != root_) return index;
+  if (row < 0 || row >= row_count_) return index;
+  if (column < 0 || column >= columns_) return index;
+
+  ModelNode* node = GetRowNode(row);
+  while (column > 0) {
+    node = node->right;
+    column--;
+  }
+
+  set_index_node(index, node);
+  return index;
+}
+
+void AbstractArrayListModel::Clear ()
+{
+  for (size_t i = 0; i < blocks_.size(); i++) {
+    for (size_t j = 0; j < blocks_[i]->rows.size(); j++) {
+      DestroyRow(blocks_[i]->rows[j]);
+    }
+    delete blocks_[i];
+  }
+
+  blocks_.clear();
+  row_count_ = 0;
+  root_->child = 0;
+  columns_ = 0;
+}
+
+size_t AbstractArrayListModel::FindBlock (int row) const
+{
+  DBG_ASSERT(!blocks_.empty());
+
+  size_t low = 0;
+  size_t high = blocks_.size();
+
+  while ((high - low) > 1) {
+    size_t mid = (low + high) / 2;
+    if (blocks_[mid]->first <= row) {
+      low = mid;
+    } else {
+      high = mid;
+    }
+  }
+
+  return low;
+}
+
+ModelNode* AbstractArrayListModel::GetRowNode (int row) const
+{
+  const RowBlock* block = blocks_[FindBlock(row)];
+  return block->rows[row - block->first];
+}
+
+void AbstractArrayListModel::BalanceBlock (size_t index)
+{
+  RowBlock* block = blocks_[index];
+  const size_t size = block->rows.size();
+
+  if (size > (2 * kBlockSize)) {
+
+    // cut the tail into new blocks of kBlockSize rows
+    std::vector<RowBlock*> tail;
+    for (size_t pos = kBlockSize; pos < size; pos += kBlockSize) {
+      RowBlock* next = new RowBlock;
+      next->first = 0;
+      next->rows.assign(block->rows.begin() + pos,
+                        block->rows.begin() + std::min(pos + kBlockSize, size));
+      tail.push_back(next);
+    }
+    block->rows.resize(kBlockSize);
+
+    blocks_.insert(blocks_.begin() + index + 1, tail.begin(), tail.end());
+    for (size_t i = 0; i < tail.size(); i++) {
+      NumberBlock(index + 1 + i);
+    }
+
+  } else if (((index + 1) < blocks_.size())
+      && ((size + blocks_[index + 1]->rows.size()) <= kBlockSize)) {
+
+    RowBlock* next = blocks_[index + 1];
+    block->rows.insert(block->rows.end(), next->rows.begin(),
+                       next->rows.end());
+    delete next;
+    blocks_.erase(blocks_.begin() + index + 1);
+
+  }
+
+  NumberBlock(index);
+  UpdateFirstRows(index);
+}
+
+void AbstractArrayListModel::NumberBlock (size_t index)
+{
+  RowBlock* block = blocks_[index];
+
+  for (size_t i = 0; i < block->rows.size(); i++) {
+    block->rows[i]->row = (int) i;
+    block->rows[i]->row_base = &block->first;
+  }
+}
+
+void AbstractArrayListModel::UpdateFirstRows (size_t index)
+{
+  for (size_t i = index; i < blocks_.size(); i++) {
+    blocks_[i]->first =
+        i > 0 ? (blocks_[i - 1]->first + (int) blocks_[i - 1]->rows.size()) :
+                0;
+  }
+}
+
+void AbstractArrayListModel::LinkRows (int first, int last)
+{
+  first = std::max(first, 0);
+  last = std::min(last, row_count_ - 1);
+
+  for (int i = first; i <= last; i++) {
+    ModelNode* node = GetRowNode(i);
+    node->up = i > 0 ? GetRowNode(i - 1) : 0;
+    node->down = (i + 1) < row_count_ ? GetRowNode(i + 1) : 0;
+    node->parent = i == 0 ? root_ : 0;
+  }
+
+  root_->child = row_count_ > 0 ? GetRowNode(0) : 0;
+}
+
+void AbstractArrayListModel::RelinkAll ()
+{
+  ModelNode* prev = 0;
+
+  for (size_t i = 0; i < blocks_.size(); i++) {
+    NumberBlock(i);
+
+    std::vector<ModelNode*>& rows = blocks_[i]->rows;
+    for (size_t j = 0; j < rows.size(); j++) {
+      rows[j]->up = prev;
+      rows[j]->down = 0;
+      rows[j]->parent = 0;
+      if (prev) prev->down = rows[j];
+      prev = rows[j];
+    }
+  }
+
+  UpdateFirstRows(0);
+
+  root_->child = row_count_ > 0 ? GetRowNode(0) : 0;
+  if (root_->child) root_->child->parent = root_;
+}
+
+ModelNode* AbstractArrayListModel::CreateRow () const
+{
+  ModelNode* first = new ModelNode;
+  ModelNode* last = first;
+
+  for (int i = 1; i < columns_; i++) {
+    last->right = new ModelNode;
+    last->right->left = last;
+    last = last->right;
+  }
+
+  NumberColumns(first);
+  return first;
+}
+
+void AbstractArrayListModel::NumberColumns (ModelNode* node)
+{
+  int i = 0;
+  while (node) {
+    node->column = i;
+    node = node->right;
+    i++;
+  }
+}
+
+void AbstractArrayListModel::DestroyRow (ModelNode* node)
+{
+  DBG_ASSERT(node);
+  DBG_ASSERT(node->left == 0);
+
+  ModelNode* tmp = 0;
+  while (node) {
+    tmp = node->right;
+    delete node;
+    node = tmp;
+  }
+}
+
+}
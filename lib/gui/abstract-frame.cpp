@@ -37,6 +37,30 @@
 
 namespace BlendInt {
 
+/**
+ * @brief Get the position of a view in the window without exceptions
+ * @return false if the view is not contained in the frame
+ */
+static bool GetPositionInFrame (const AbstractFrame* frame,
+                                const AbstractView* view,
+                                Point* pos)
+{
+  if (view == nullptr) return false;
+
+  *pos = view->position();
+  const AbstractView* parent = view->super();
+
+  while (parent && (!AbstractView::is_frame(parent))) {
+    *pos = *pos + parent->position() + parent->GetOffset();
+    parent = parent->super();
+  }
+
+  if (parent != frame) return false;
+
+  *pos = *pos + frame->position() + frame->GetOffset();
+  return true;
+}
+
 glm::mat4 AbstractFrame::kViewMatrix = glm::lookAt(glm::vec3(0.f, 0.f, 1.f),
                                                    glm::vec3(0.f, 0.f, 0.f),
                                                    glm::vec3(0.f, 1.f, 0.f));
@@ -149,6 +173,7 @@ bool AbstractFrame::EnableViewBuffer ()
 void AbstractFrame::DisableViewBuffer ()
 {
   view_buffer_.destroy();
+  texture_size_.reset(0, 0);
 }
 
 AbstractFrame* AbstractFrame::GetFrame (AbstractView* view)
@@ -193,33 +218,7 @@ AbstractWidget* AbstractFrame::DispatchMouseHover (AbstractWidget* orig,
       return RecheckSubWidgetUnderCursor(orig, context);
     }
 
-    try {
-      return RecheckWidgetUnderCursor(orig, context);
-    }
-
-    catch (const std::bad_cast& e) {
-      DBG_PRINT_MSG("Error: %s", e.what());
-      return FindWidgetUnderCursor(context);
-    }
-
-    catch (const std::invalid_argument& e) {
-      DBG_PRINT_MSG("Error: %s", e.what());
-      return FindWidgetUnderCursor(context);
-    }
-
-    catch (const std::domain_error& e) {
-      DBG_PRINT_MSG("Error: %s", e.what());
-      return FindWidgetUnderCursor(context);
-    }
-
-    catch (const std::out_of_range& e) {
-      DBG_PRINT_MSG("Error: %s", e.what());
-      return FindWidgetUnderCursor(context);
-    }
-
-    catch (...) {
-      return FindWidgetUnderCursor(context);
-    }
+    return RecheckWidgetUnderCursor(orig, context);
 
   } else {
 
@@ -271,10 +270,14 @@ AbstractWidget* AbstractFrame::RecheckWidgetUnderCursor (AbstractWidget* orig,
   AbstractWidget* result = orig;
   AbstractView* parent = result->super();
   Point offset;
+  Point pos;
+
+  if (!GetPositionInFrame(this, parent, &pos)) {
+    DBG_PRINT_MSG("%s", "Error: the widget is not contained in this frame");
+    return FindWidgetUnderCursor(context);
+  }
 
-  Rect rect(
-      GetAbsolutePosition(dynamic_cast<AbstractWidget*>(orig->super())),
-      orig->super()->size());
+  Rect rect(pos, parent->size());
 
   bool cursor_in_superview = rect.contains(
       context->GetGlobalCursorPosition());
@@ -312,10 +315,12 @@ AbstractWidget* AbstractFrame::RecheckWidgetUnderCursor (AbstractWidget* orig,
         parent = parent->super();
       }
 
-      result = dynamic_cast<AbstractWidget*>(parent);
-
-      if (result) {
+      if (parent) {
+        DBG_ASSERT(is_widget(parent));
+        result = static_cast<AbstractWidget*>(parent);
         result = RecursiveDispatchHoverEvent(result, context);
+      } else {
+        result = 0;
       }
 
     }
@@ -324,53 +329,38 @@ AbstractWidget* AbstractFrame::RecheckWidgetUnderCursor (AbstractWidget* orig,
 
     dispatch_mouse_hover_out(result, context);
 
-    // find which contianer contains cursor position
+    // find which contianer contains cursor position, the position of
+    // each container is got from the last one
+    AbstractView* view = parent;
     parent = parent->super();
-    while (parent != nullptr) {
+    while (parent != this) {
 
-      if (parent == this) {
-        parent = nullptr;
-        break;
-      }
+      DBG_ASSERT(is_widget(parent));
 
-      if (is_widget(parent)) {
-        rect.set_position(GetAbsolutePosition(parent));
-        rect.set_size(parent->size());
-      } else {
-        DBG_ASSERT(parent == this);
-        rect.set_position(position());
-        rect.set_size(size());
-      }
-
-      offset = parent->GetOffset();
-      context->set_local_cursor_position(
-          context->GetGlobalCursorPosition().x() - rect.x() - offset.x(),
-          context->GetGlobalCursorPosition().y() - rect.y() - offset.y());
+      pos = pos - view->position() - parent->GetOffset();
+      rect.set_position(pos);
+      rect.set_size(parent->size());
 
       if (rect.contains(context->GetGlobalCursorPosition())) break;
 
+      view = parent;
       parent = parent->super();
     }
 
-    result = dynamic_cast<AbstractWidget*>(parent);
-    if (result) {
-
-      for (AbstractView* p = parent->GetLastSubView(); p; p =
-               parent->GetPreviousSubView(p)) {
+    if (parent == this) return 0;
 
-        if (is_widget(p)) {
-          if (p->Contain(context->local_cursor_position())) {
-            result = dynamic_cast<AbstractWidget*>(p);
+    offset = parent->GetOffset();
+    context->set_local_cursor_position(
+        context->GetGlobalCursorPosition().x() - rect.x() - offset.x(),
+        context->GetGlobalCursorPosition().y() - rect.y() - offset.y());
 
-            dispatch_mouse_hover_in(result, context);
-            result = RecursiveDispatchHoverEvent(result, context);
+    result = static_cast<AbstractWidget*>(parent);
 
-            break;
-          }
-        } else {
-          break;
-        }
-      }
+    AbstractView* p = parent->GetSubWidgetAt(context->local_cursor_position());
+    if (p) {
+      result = static_cast<AbstractWidget*>(p);
+      dispatch_mouse_hover_in(result, context);
+      result = RecursiveDispatchHoverEvent(result, context);
     }
 
   }
@@ -388,21 +378,11 @@ AbstractWidget* AbstractFrame::FindWidgetUnderCursor (AbstractWindow* context)
       context->GetGlobalCursorPosition().x() - position().x() - offset.x(),
       context->GetGlobalCursorPosition().y() - position().y() - offset.y());
 
-  for (AbstractView* p = GetLastSubView(); p; p = GetPreviousSubView(p)) {
-
-    if (is_widget(p)) {
-      result = dynamic_cast<AbstractWidget*>(p);
-      if (p->Contain(context->local_cursor_position())) {
-        dispatch_mouse_hover_in(result, context);
-        break;
-      }
-    } else {
-      break;
-    }
+  AbstractView* p = GetSubWidgetAt(context->local_cursor_position());
 
-  }
-
-  if (result) {
+  if (p) {
+    result = static_cast<AbstractWidget*>(p);
+    dispatch_mouse_hover_in(result, context);
     result = RecursiveDispatchHoverEvent(result, context);
   }
 
@@ -438,42 +418,49 @@ bool AbstractFrame::RenderToTexture (AbstractFrame* frame,
 
   bool         retval = false;
   GLTexture2D* tex    = texture;
-
-  if (!tex->id()) tex->generate();
+  const int    width  = frame->size().width();
+  const int    height = frame->size().height();
+
+  // the texture keeps the last contents, only the damaged part of the
+  // frame is redrawn unless the storage is re-specified, the texture is
+  // rendered once for all redraw passes of the window
+  Rect damaged;
+  Rect damaged_in_window;
+  bool partial = context->GetDamagedRect(frame, &damaged, &damaged_in_window);
+
+  if (!tex->id()) {
+    tex->generate();
+    // a new texture has no storage yet
+    frame->texture_size_.reset(0, 0);
+  }
 
   tex->bind();
-  tex->SetWrapMode(GL_REPEAT, GL_REPEAT);
-  tex->SetMinFilter(GL_NEAREST);
-  tex->SetMagFilter(GL_NEAREST);
-  tex->SetImage(0, GL_RGBA, frame->size().width(), frame->size().height(), 0,
-                GL_RGBA,
-                GL_UNSIGNED_BYTE, 0);
-
-  // The framebuffer, which regroups 0, 1, or more textures, and 0 or 1 depth buffer.
-  GLFramebuffer* fb = new GLFramebuffer;
-  fb->generate();
-  fb->bind();
+
+  // re-specify the texture storage only if the frame was resized
+  if ((frame->texture_size_.width() != width) ||
+      (frame->texture_size_.height() != height)) {
+    tex->SetWrapMode(GL_REPEAT, GL_REPEAT);
+    tex->SetMinFilter(GL_NEAREST);
+    tex->SetMagFilter(GL_NEAREST);
+    tex->SetImage(0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+    frame->texture_size_.reset(width, height);
+    partial = false;
+  }
+
+  // the window tracks the bound framebuffer and the scissor box, no
+  // need to query the GL state
+  GLuint original_framebuffer = context->draw_framebuffer_;
+
+  // The framebuffer and the depth-stencil renderbuffer are reused from
+  // the pool, the framebuffer is bound when acquired
+  GLOffscreenTarget* target = context->framebuffer_pool()->Acquire(width,
+                                                                   height);
+  context->draw_framebuffer_ = target->framebuffer;
 
   // Set "renderedTexture" as our colour attachement #0
   glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
                          GL_TEXTURE_2D,
                          tex->id(), 0);
-  //fb->Attach(*tex, GL_COLOR_ATTACHMENT0);
-
-  // Critical: Create a Depth_STENCIL renderbuffer for this off-screen rendering
-  GLuint rb;
-  glGenRenderbuffers(1, &rb);
-
-  glBindRenderbuffer(GL_RENDERBUFFER, rb);
-  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_STENCIL,
-                        frame->size().width(), frame->size().height());
-  //Attach depth buffer to FBO
-  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
-                            GL_RENDERBUFFER,
-                            rb);
-  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT,
-                            GL_RENDERBUFFER,
-                            rb);
 
   if (GLFramebuffer::CheckStatus()) {
 
@@ -484,41 +471,61 @@ bool AbstractFrame::RenderToTexture (AbstractFrame* frame,
     GLuint original_stencil_count = context->stencil_count_;
     context->stencil_count_ = 0;
 
+    // and the clip rectangles in the window do not apply
+    std::vector<Rect> original_clip_stack;
+    original_clip_stack.swap(context->clip_stack_);
+
     glClearColor(0.f, 0.f, 0.f, 0.f);
     glClearDepth(1.0);
     glClearStencil(0);
 
-    glClear(
-        GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
-
     glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE,
                         GL_ONE_MINUS_SRC_ALPHA);
     //glEnable(GL_BLEND);
 
-    glViewport(0, 0, frame->size().width(), frame->size().height());
+    context->SetViewport(0, 0, width, height);
+
+    bool original_redraw_all = context->redraw_all_;
+    context->redraw_all_ = !partial;
+    Rect original_damage_clip = context->damage_clip_;
+    context->damage_clip_ = damaged_in_window;
+
+    if (partial) {
+      context->BeginScissor(damaged);
+    } else {
+      glDisable(GL_SCISSOR_TEST);
+    }
+
+    glClear(
+        GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
     // Draw context:
     frame->DrawSubViewsOnce(context);
 
+    context->redraw_all_ = original_redraw_all;
+    context->damage_clip_ = original_damage_clip;
+
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    glViewport(0, 0, context->size().width(), context->size().height());
+    context->SetViewport(0, 0, context->size().width(),
+                         context->size().height());
     DBG_ASSERT(context->stencil_count_ == 0);
     context->stencil_count_ = original_stencil_count;
+    context->clip_stack_.swap(original_clip_stack);
+    context->ApplyScissor();
 
     retval = true;
   }
 
-  fb->reset();
-  tex->reset();
-
-  //delete tex; tex = 0;
+  // detach the texture so the pooled framebuffer does not keep it alive
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                         0, 0);
 
-  glBindRenderbuffer(GL_RENDERBUFFER, 0);
-  glDeleteRenderbuffers(1, &rb);
+  glBindFramebuffer(GL_FRAMEBUFFER, original_framebuffer);
+  context->draw_framebuffer_ = original_framebuffer;
+  tex->reset();
 
-  delete fb;
-  fb = nullptr;
+  context->framebuffer_pool()->Release(target);
 
   return retval;
 }
@@ -535,20 +542,12 @@ AbstractWidget* AbstractFrame::RecursiveDispatchHoverEvent (AbstractWidget* widg
       context->local_cursor_position().y() - widget->position().y()
       - offset.y());
 
-  for (AbstractView* p = widget->GetLastSubView(); p; p = widget->GetPreviousSubView(p)) {
-
-    if (is_widget(p)) {
-      if (p->Contain(context->local_cursor_position())) {
-        retval = dynamic_cast<AbstractWidget*>(p);
-        dispatch_mouse_hover_in(retval, context);
-        retval = RecursiveDispatchHoverEvent(retval, context);
-
-        break;
-      }
-    } else {
-      break;
-    }
+  AbstractView* p = widget->GetSubWidgetAt(context->local_cursor_position());
 
+  if (p) {
+    retval = static_cast<AbstractWidget*>(p);
+    dispatch_mouse_hover_in(retval, context);
+    retval = RecursiveDispatchHoverEvent(retval, context);
   }
 
   return retval;
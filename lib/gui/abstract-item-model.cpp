@@ -45,6 +45,10 @@ int ModelIndex::GetRow () const
       node = node->left;
     }
 
+    if (node->row >= 0) {
+      return node->row_base ? (*node->row_base + node->row) : node->row;
+    }
+
     int count = 0;
     while (node->up) {
       node = node->up;
@@ -61,6 +65,8 @@ int ModelIndex::GetColumn () const
 {
   if (node_) {
 
+    if (node_->column >= 0) return node_->column;
+
     ModelNode* node = node_;
     int count = 0;
     while (node->left) {
@@ -21,15 +21,19 @@
  * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
  */
 
+#include <typeinfo>
+
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtx/transform.hpp>
 
 #include <blendint/opengl/opengl.hpp>
+#include <blendint/opengl/render-stats.hpp>
 
 #include <blendint/gui/abstract-view.hpp>
 #include <blendint/gui/abstract-window.hpp>
+#include <blendint/gui/hit-test-grid.hpp>
 
 #include <blendint/gui/managed-ptr.hpp>
 
@@ -116,7 +120,9 @@ AbstractView::AbstractView ()
   previous_(0),
   next_(0),
   first_(0),
-  last_(0)
+  last_(0),
+  subview_grid_(0),
+  subview_grid_dirty_(true)
 {
 }
 
@@ -131,7 +137,9 @@ AbstractView::AbstractView (int width, int height)
   previous_(0),
   next_(0),
   first_(0),
-  last_(0)
+  last_(0),
+  subview_grid_(0),
+  subview_grid_dirty_(true)
 {
   set_size(std::abs(width), std::abs(height));
 }
@@ -152,6 +160,8 @@ AbstractView::~AbstractView ()
     DBG_ASSERT(previous_ == 0);
     DBG_ASSERT(next_ == 0);
   }
+
+  delete subview_grid_;
 }
 
 Point AbstractView::GetGlobalPosition () const
@@ -171,6 +181,8 @@ void AbstractView::Resize (int width, int height)
 {
   if (size().width() == width && size().height() == height) return;
 
+  AbstractWindow::DamageView(this);
+
   if (super_) {
     if (super_->SizeUpdateTest(this, this, width, height)
         && SizeUpdateTest(this, this, width, height)) {
@@ -183,12 +195,16 @@ void AbstractView::Resize (int width, int height)
       set_size(width, height);
     }
   }
+
+  AbstractWindow::DamageView(this);
 }
 
 void AbstractView::Resize (const Size& size)
 {
   if (AbstractView::size() == size) return;
 
+  AbstractWindow::DamageView(this);
+
   if (super_) {
     if (super_->SizeUpdateTest(this, this, size.width(), size.height())
         && SizeUpdateTest(this, this, size.width(), size.height())) {
@@ -201,12 +217,16 @@ void AbstractView::Resize (const Size& size)
       set_size(size);
     }
   }
+
+  AbstractWindow::DamageView(this);
 }
 
 void AbstractView::MoveTo (int x, int y)
 {
   if (position().x() == x && position().y() == y) return;
 
+  AbstractWindow::DamageView(this);
+
   if (super_) {
     if (super_->PositionUpdateTest(this, this, x, y)
         && PositionUpdateTest(this, this, x, y)) {
@@ -219,12 +239,16 @@ void AbstractView::MoveTo (int x, int y)
       set_position(x, y);
     }
   }
+
+  AbstractWindow::DamageView(this);
 }
 
 void AbstractView::MoveTo (const Point& pos)
 {
   if (position() == pos) return;
 
+  AbstractWindow::DamageView(this);
+
   if (super_) {
     if (super_->PositionUpdateTest(this, this, pos.x(), pos.y())
         && PositionUpdateTest(this, this, pos.x(), pos.y())) {
@@ -237,10 +261,15 @@ void AbstractView::MoveTo (const Point& pos)
       set_position(pos);
     }
   }
+
+  AbstractWindow::DamageView(this);
 }
 
 void AbstractView::RequestRedraw ()
 {
+  // record the area even if a redraw was requested, it may have changed
+  AbstractWindow::DamageView(this);
+
   if (!refresh()) {
 
     AbstractView* root = this;
@@ -406,6 +435,8 @@ void AbstractView::MoveToFirst (AbstractView* view)
 {
   if (view->super_) {
 
+    view->super_->subview_grid_dirty_ = true;
+
     if (view->super_->first_ == view) {
       DBG_ASSERT(view->previous_ == 0);
       return;	// already at first
@@ -432,6 +463,8 @@ void AbstractView::MoveToLast (AbstractView* view)
 {
   if (view->super_) {
 
+    view->super_->subview_grid_dirty_ = true;
+
     if (view->super_->last_ == view) {
       DBG_ASSERT(view->next_ == 0);
       return;	// already at last
@@ -459,6 +492,8 @@ void AbstractView::MoveForward (AbstractView* view)
 {
   if (view->super_) {
 
+    view->super_->subview_grid_dirty_ = true;
+
     if (view->next_) {
 
       AbstractView* tmp = view->next_;
@@ -503,6 +538,8 @@ void AbstractView::MoveBackward (AbstractView* view)
 {
   if (view->super_) {
 
+    view->super_->subview_grid_dirty_ = true;
+
     if (view->previous_) {
 
       AbstractView* tmp = view->previous_;
@@ -583,9 +620,15 @@ void AbstractView::DrawSubViewsOnce (AbstractWindow* context)
   for (ManagedPtr p = GetFirstSubView(); p; ++p) {
 
     set_refresh(false);
+
+    // keep the retained pixels of views outside the damaged area
+    if (!p->refresh() && !context->IsDamaged(p.get())) continue;
     
     if (p->PreDraw(context)) {
 
+      if (RenderStats::enabled())
+        RenderStats::BeginView(p.get(), p->name(), typeid(*p).name());
+
       Response response = p->Draw(context);
 
       p->set_refresh(refresh());
@@ -597,6 +640,8 @@ void AbstractView::DrawSubViewsOnce (AbstractWindow* context)
       }
 
       p->PostDraw(context);
+
+      if (RenderStats::enabled()) RenderStats::EndView();
     }
 
     //if(refresh()) refresh_record = true;
@@ -629,6 +674,8 @@ bool AbstractView::SwapIndex (AbstractView *view1, AbstractView *view2)
   if (view1->super_ != view2->super_) return false;
   if (view1->super_ == nullptr) return false;
 
+  view1->super_->subview_grid_dirty_ = true;
+
   AbstractView* tmp1 = nullptr;
   AbstractView* tmp2 = nullptr;
 
@@ -730,6 +777,8 @@ bool AbstractView::InsertSiblingBefore (AbstractView *src, AbstractView *dst)
   if (src == nullptr || dst == nullptr) return false;
   if (src == dst) return false;
 
+  if (src->super_) src->super_->subview_grid_dirty_ = true;
+
   if (dst->super_ != nullptr) {
 
     if (dst->super_ == src->super_) {
@@ -800,6 +849,8 @@ bool AbstractView::InsertSiblingAfter (AbstractView *src, AbstractView *dst)
   if (src == nullptr || dst == nullptr) return false;
   if (src == dst) return false;
 
+  if (src->super_) src->super_->subview_grid_dirty_ = true;
+
   if (dst->super_ != nullptr) {
 
     if (dst->previous_ == src->super_) {
@@ -870,8 +921,13 @@ void AbstractView::DispatchDrawEvent (AbstractView* view,
 {
   DBG_ASSERT(view != 0);
 
+  if (!view->refresh() && !context->IsDamaged(view)) return;
+
   if (view->PreDraw(context)) {
 
+    if (RenderStats::enabled())
+      RenderStats::BeginView(view, view->name(), typeid(*view).name());
+
     Response response = view->Draw(context);
 
     view->set_refresh(view->super_->refresh());
@@ -883,6 +939,8 @@ void AbstractView::DispatchDrawEvent (AbstractView* view,
     }
 
     view->PostDraw(context);
+
+    if (RenderStats::enabled()) RenderStats::EndView();
   }
 }
 
@@ -2041,6 +2099,28 @@ AbstractView* AbstractView::GetSubViewAt (int i) const
   return widget;
 }
 
+AbstractView* AbstractView::GetSubWidgetAt (const Point& point)
+{
+  if (GetSubViewCount() >= HitTestGrid::kMinViewCount) {
+
+    if (subview_grid_ == 0) subview_grid_ = new HitTestGrid;
+
+    if (subview_grid_dirty_) {
+      subview_grid_->Build(this);
+      subview_grid_dirty_ = false;
+    }
+
+    return subview_grid_->Find(point);
+  }
+
+  for (AbstractView* p = GetLastSubView(); p; p = GetPreviousSubView(p)) {
+    if (!is_widget(p)) break;
+    if (p->Contain(point)) return p;
+  }
+
+  return 0;
+}
+
 AbstractView* AbstractView::PushFrontSubView (AbstractView* view)
 {
   if (!view) return 0;
@@ -2075,6 +2155,9 @@ AbstractView* AbstractView::PushFrontSubView (AbstractView* view)
   view->previous_ = 0;
   view->super_ = this;
   subview_count_++;
+  subview_grid_dirty_ = true;
+
+  AbstractWindow::DamageView(view);
 
   view->PerformAfterAdded();
 
@@ -2153,6 +2236,9 @@ AbstractView* AbstractView::InsertSubView (int index, AbstractView* view)
 
   view->super_ = this;
   subview_count_++;
+  subview_grid_dirty_ = true;
+
+  AbstractWindow::DamageView(view);
 
   view->PerformAfterAdded();
 
@@ -2193,6 +2279,9 @@ AbstractView* AbstractView::PushBackSubView (AbstractView* view)
   view->next_ = 0;
   view->super_ = this;
   subview_count_++;
+  subview_grid_dirty_ = true;
+
+  AbstractWindow::DamageView(view);
 
   view->PerformAfterAdded();
   DBG_ASSERT(view->super_ == this);
@@ -2208,6 +2297,8 @@ AbstractView* AbstractView::RemoveSubView (AbstractView* view)
   view->PerformBeforeRemoved();
   DBG_ASSERT(view->super_ == this);
 
+  AbstractWindow::DamageView(view);
+
   if (view->previous_) {
     view->previous_->next_ = view->next_;
   } else {
@@ -2224,6 +2315,7 @@ AbstractView* AbstractView::RemoveSubView (AbstractView* view)
 
   subview_count_--;
   DBG_ASSERT(subview_count_ >= 0);
+  subview_grid_dirty_ = true;
 
   view->previous_ = 0;
   view->next_ = 0;
@@ -2244,6 +2336,8 @@ void AbstractView::PerformBeforeRemoved ()
 
 void AbstractView::ClearSubViews ()
 {
+  if (first_) AbstractWindow::DamageView(this);
+
   AbstractView* ptr = first_;
   AbstractView* next_ptr = 0;
 
@@ -2264,6 +2358,7 @@ void AbstractView::ClearSubViews ()
   subview_count_ = 0;
   first_ = 0;
   last_ = 0;
+  subview_grid_dirty_ = true;
 }
 
 void AbstractView::ResizeSubView (AbstractView* sub, int width, int height)
@@ -2272,10 +2367,14 @@ void AbstractView::ResizeSubView (AbstractView* sub, int width, int height)
 
   if (sub->size().width() == width && sub->size().height() == height) return;
 
+  AbstractWindow::DamageView(sub);
+
   if (sub->SizeUpdateTest(this, sub, width, height)) {
     sub->PerformSizeUpdate(this, sub, width, height);
     sub->set_size(width, height);
   }
+
+  AbstractWindow::DamageView(sub);
 }
 
 void AbstractView::ResizeSubView (AbstractView* sub, const Size& size)
@@ -2284,10 +2383,14 @@ void AbstractView::ResizeSubView (AbstractView* sub, const Size& size)
 
   if (sub->size() == size) return;
 
+  AbstractWindow::DamageView(sub);
+
   if (sub->SizeUpdateTest(this, sub, size.width(), size.height())) {
     sub->PerformSizeUpdate(this, sub, size.width(), size.height());
     sub->set_size(size);
   }
+
+  AbstractWindow::DamageView(sub);
 }
 
 void AbstractView::MoveSubViewTo (AbstractView* sub, int x, int y)
@@ -2296,10 +2399,14 @@ void AbstractView::MoveSubViewTo (AbstractView* sub, int x, int y)
 
   if (sub->position().x() == x && sub->position().y() == y) return;
 
+  AbstractWindow::DamageView(sub);
+
   if (sub->PositionUpdateTest(this, sub, x, y)) {
     sub->PerformPositionUpdate(this, sub, x, y);
     sub->set_position(x, y);
   }
+
+  AbstractWindow::DamageView(sub);
 }
 
 void AbstractView::MoveSubViewTo (AbstractView* sub, const Point& pos)
@@ -2308,10 +2415,14 @@ void AbstractView::MoveSubViewTo (AbstractView* sub, const Point& pos)
 
   if (sub->position() == pos) return;
 
+  AbstractWindow::DamageView(sub);
+
   if (sub->PositionUpdateTest(this, sub, pos.x(), pos.y())) {
     sub->PerformPositionUpdate(this, sub, pos.x(), pos.y());
     sub->set_position(pos);
   }
+
+  AbstractWindow::DamageView(sub);
 }
 
 Response AbstractView::RecursiveDispatchKeyEvent (AbstractView* subview,
@@ -168,10 +168,10 @@ namespace BlendInt {
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 6);
 
     // now set viewport for 3D scene
-    glViewport(position().x(), position().y(), size().width(), size().height());
+    context->SetViewport(position().x(), position().y(), size().width(),
+                         size().height());
 
-    glEnable(GL_SCISSOR_TEST);
-    glScissor(position().x(), position().y(), size().width(), size().height());
+    context->BeginScissor(Rect(position(), size()));
 
     return true;
   }
@@ -192,8 +192,9 @@ namespace BlendInt {
 
   void AbstractViewport::PostDraw (AbstractWindow* context)
   {
-    glDisable(GL_SCISSOR_TEST);
-    glViewport(0, 0, context->size().width(), context->size().height());
+    context->EndScissor();
+    context->SetViewport(0, 0, context->size().width(),
+                         context->size().height());
   }
 
 }
@@ -150,58 +150,53 @@ Response AbstractWidget::PerformMouseMove (AbstractWindow* context)
 
 bool AbstractWidget::RenderSubWidgetsToTexture (AbstractWidget* widget,
                                                 AbstractWindow* context,
-                                                GLTexture2D* texture)
+                                                GLTexture2D* texture,
+                                                Size* texture_size)
 {
   bool retval = false;
   DBG_ASSERT(texture != nullptr);
+  DBG_ASSERT(texture_size != nullptr);
+
+  const int width = widget->size().width();
+  const int height = widget->size().height();
 
   // Create and set texture to render to.
   GLTexture2D* tex = texture;
-  if (!tex->id()) tex->generate();
+  if (!tex->id()) {
+    tex->generate();
+    // a new texture has no storage yet
+    texture_size->reset(0, 0);
+  }
 
   tex->bind();
-  tex->SetWrapMode(GL_REPEAT, GL_REPEAT);
-  tex->SetMinFilter(GL_NEAREST);
-  tex->SetMagFilter(GL_NEAREST);
-  tex->SetImage(0, GL_RGBA, widget->size().width(), widget->size().height(), 0,
-                GL_RGBA, GL_UNSIGNED_BYTE, 0);
 
-  GLint current_framebuffer = 0;
-  glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &current_framebuffer);
+  // re-specify the texture storage only if the widget was resized
+  if ((texture_size->width() != width) || (texture_size->height() != height)) {
+    tex->SetWrapMode(GL_REPEAT, GL_REPEAT);
+    tex->SetMinFilter(GL_NEAREST);
+    tex->SetMagFilter(GL_NEAREST);
+    tex->SetImage(0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+    texture_size->reset(width, height);
+  }
+
+  // the window tracks the bound framebuffer and the scissor box, no
+  // need to query the GL state
+  GLuint original_framebuffer = context->draw_framebuffer_;
 
-  // The framebuffer, which regroups 0, 1, or more textures, and 0 or 1 depth buffer.
-  GLuint fbo = 0;
-  glGenFramebuffers(1, &fbo);
-  glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+  // The framebuffer and the depth-stencil renderbuffer are reused from
+  // the pool, the framebuffer is bound when acquired
+  GLOffscreenTarget* target = context->framebuffer_pool()->Acquire(width,
+                                                                   height);
+  context->draw_framebuffer_ = target->framebuffer;
 
   // Set "renderedTexture" as our colour attachement #0
   glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
   GL_TEXTURE_2D,
                          tex->id(), 0);
-  //fb->Attach(*tex, GL_COLOR_ATTACHMENT0);
-
-  // Critical: Create a Depth_STENCIL renderbuffer for this off-screen rendering
-  GLuint rb;
-  glGenRenderbuffers(1, &rb);
-
-  glBindRenderbuffer(GL_RENDERBUFFER, rb);
-  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_STENCIL,
-                        widget->size().width(), widget->size().height());
-  //Attach depth buffer to FBO
-  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
-  GL_RENDERBUFFER,
-                            rb);
-  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT,
-  GL_RENDERBUFFER,
-                            rb);
 
   if (GLFramebuffer::CheckStatus()) {
 
-    GLint vp[4];
-    glGetIntegerv(GL_VIEWPORT, vp);
-
-    GLboolean scissor_test;
-    glGetBooleanv(GL_SCISSOR_TEST, &scissor_test);
+    Rect vp = context->viewport();
 
     AbstractWindow* c = context;
     glm::vec3 pos = AbstractWindow::shaders()->widget_model_matrix()
@@ -215,17 +210,20 @@ bool AbstractWidget::RenderSubWidgetsToTexture (AbstractWidget* widget,
     glm::mat3 identity(1.f);
     AbstractWindow::shaders()->SetWidgetModelMatrix(identity);
 
-    glm::mat4 projection = glm::ortho(0.f, (float) widget->size().width(), 0.f,
-                                      (float) widget->size().height(), 100.f,
-                                      -100.f);
+    glm::mat4 projection = glm::ortho(0.f, (float) width, 0.f,
+                                      (float) height, 100.f, -100.f);
     AbstractWindow::shaders()->SetWidgetProjectionMatrix(projection);
 
-    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, target->framebuffer);
 
     // in this off-screen framebuffer, a new stencil buffer was created, reset the stencil count to 0 and restore later
     GLuint original_stencil_count = c->stencil_count_;
     c->stencil_count_ = 0;
 
+    // and the clip rectangles in the window do not apply
+    std::vector<Rect> original_clip_stack;
+    original_clip_stack.swap(c->clip_stack_);
+
     glClearColor(0.f, 0.f, 0.f, 0.f);
     glClearDepth(1.0);
     glClearStencil(0);
@@ -233,20 +231,26 @@ bool AbstractWidget::RenderSubWidgetsToTexture (AbstractWidget* widget,
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
     // FIXME: the blend func works abnormally in most cases.
-    if (current_framebuffer == 0) {
+    if (original_framebuffer == c->window_framebuffer_) {
       glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE,
                           GL_ONE_MINUS_SRC_ALPHA);
     }
 
-    glViewport(0, 0, widget->size().width(), widget->size().height());
+    c->SetViewport(0, 0, width, height);
     glDisable(GL_SCISSOR_TEST);
 
     //DrawPanel();
 
+    // the whole texture was cleared, draw all sub widgets
+    bool original_redraw_all = c->redraw_all_;
+    c->redraw_all_ = true;
+
     // Draw context:
     widget->DrawSubViewsOnce(context);
 
-    if (current_framebuffer == 0) {
+    c->redraw_all_ = original_redraw_all;
+
+    if (original_framebuffer == c->window_framebuffer_) {
       glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     }
 
@@ -255,12 +259,12 @@ bool AbstractWidget::RenderSubWidgetsToTexture (AbstractWidget* widget,
     AbstractWindow::shaders()->PopWidgetProjectionMatrix();
     AbstractWindow::shaders()->PopWidgetModelMatrix();
 
-    if (scissor_test) {
-      glEnable(GL_SCISSOR_TEST);
-    }
+    // the sub widgets may have changed the scissor box
+    c->clip_stack_.swap(original_clip_stack);
+    c->ApplyScissor();
 
     c->viewport_origin_ = original;
-    glViewport(vp[0], vp[1], vp[2], vp[3]);
+    c->SetViewport(vp.x(), vp.y(), vp.width(), vp.height());
 
 #ifdef DEBUG
     DBG_ASSERT(c->stencil_count_ == 0);
@@ -270,15 +274,17 @@ bool AbstractWidget::RenderSubWidgetsToTexture (AbstractWidget* widget,
     retval = true;
   }
 
-  tex->reset();
+  // detach the texture so the pooled framebuffer does not keep it alive
+  glBindFramebuffer(GL_FRAMEBUFFER, target->framebuffer);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                         0, 0);
 
-  //delete tex; tex = 0;
+  tex->reset();
 
-  glBindRenderbuffer(GL_RENDERBUFFER, 0);
-  glDeleteRenderbuffers(1, &rb);
-  glDeleteFramebuffers(1, &fbo);
+  glBindFramebuffer(GL_FRAMEBUFFER, original_framebuffer);
+  context->draw_framebuffer_ = original_framebuffer;
 
-  glBindFramebuffer(GL_FRAMEBUFFER, current_framebuffer);
+  context->framebuffer_pool()->Release(target);
 
   return retval;
 }
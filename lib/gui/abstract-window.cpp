@@ -21,22 +21,33 @@
  * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
  */
 
+#include <stdlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <future>
 #include <stdexcept>
+#include <typeinfo>
 
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtx/transform.hpp>
 
 #include <blendint/core/types.hpp>
-#include <blendint/core/timer.hpp>
 
 #include <blendint/opengl/opengl.hpp>
+#include <blendint/opengl/render-stats.hpp>
+#include <blendint/opengl/gl-framebuffer.hpp>
+#include <blendint/opengl/glsl-program.hpp>
 
+#include <blendint/core/image.hpp>
 #include <blendint/font/fc-pattern.hpp>
-#include <blendint/font/fc-config.hpp>
 
 #include <blendint/gui/managed-ptr.hpp>
 #include <blendint/gui/abstract-frame.hpp>
 #include <blendint/gui/abstract-window.hpp>
+#include <blendint/gui/text.hpp>
+#include <blendint/gui/text-layout-cache.hpp>
 
 namespace BlendInt {
 
@@ -46,8 +57,18 @@ Theme* AbstractWindow::kTheme = 0;
 Icons* AbstractWindow::kIcons = 0;
 Shaders* AbstractWindow::kShaders = 0;
 
+GLVertexArena* AbstractWindow::kCoordArena = 0;
+
+GLVertexArena* AbstractWindow::kShadedArena = 0;
+
+GLVertexArena* AbstractWindow::kTextArena = 0;
+
 AbstractWindow* AbstractWindow::kMainWindow = 0;
 
+bool AbstractWindow::kPartialRedraw = true;
+
+StartupProfile AbstractWindow::kStartupProfile;
+
 glm::mat4 AbstractWindow::default_view_matrix = glm::lookAt(
     glm::vec3(0.f, 0.f, 1.f), // eye
     glm::vec3(0.f, 0.f, 0.f), // center
@@ -59,6 +80,12 @@ AbstractWindow::AbstractWindow (int flags)
   active_frame_(nullptr),
   focused_frame_(nullptr),
   stencil_count_(0),
+  redraw_all_(false),
+  window_framebuffer_(0),
+  draw_framebuffer_(0),
+  retained_framebuffer_(0),
+  retained_color_(0),
+  retained_depth_stencil_(0),
   current_cursor_shape_(ArrowCursor),
   floating_frame_count_(0),
   pressed_(false),
@@ -69,6 +96,7 @@ AbstractWindow::AbstractWindow (int flags)
 
   set_size(640, 480);
   set_refresh(true);
+  frame_damage_.AddAll();
 
   if (kMainWindow == 0) kMainWindow = this;
 }
@@ -78,6 +106,12 @@ AbstractWindow::AbstractWindow (int width, int height, int flags)
   active_frame_(nullptr),
   focused_frame_(nullptr),
   stencil_count_(0),
+  redraw_all_(false),
+  window_framebuffer_(0),
+  draw_framebuffer_(0),
+  retained_framebuffer_(0),
+  retained_color_(0),
+  retained_depth_stencil_(0),
   current_cursor_shape_(ArrowCursor),
   floating_frame_count_(0),
   pressed_(false),
@@ -87,6 +121,7 @@ AbstractWindow::AbstractWindow (int width, int height, int flags)
   set_view_type(ViewTypeWindow);
 
   set_refresh(true);
+  frame_damage_.AddAll();
 
   if (kMainWindow == 0) kMainWindow = this;
 }
@@ -109,6 +144,8 @@ AbstractWindow::~AbstractWindow ()
     DBG_ASSERT(previous_ == 0);
     DBG_ASSERT(next_ == 0);
   }
+
+  ReleaseRetainedFramebuffer();
 }
 
 AbstractFrame* AbstractWindow::AddFrame (AbstractFrame* frame)
@@ -283,6 +320,8 @@ void AbstractWindow::PopCursor ()
 
 void AbstractWindow::BeginPushStencil ()
 {
+  RenderStats::CountStencilPush();
+
   glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
 
   if (stencil_count_ == 0) {
@@ -327,6 +366,322 @@ void AbstractWindow::EndPopStencil ()
   }
 }
 
+void AbstractWindow::Damage (const Rect& rect)
+{
+  Rect area = DamageRegion::Intersection(rect, Rect(0, 0, size().width(),
+                                                    size().height()));
+  if (area.zero()) return;
+
+  damage_mutex_.lock();
+  damage_.Add(area);
+  damage_mutex_.unlock();
+}
+
+void AbstractWindow::DamageAll ()
+{
+  damage_mutex_.lock();
+  damage_.AddAll();
+  damage_mutex_.unlock();
+}
+
+bool AbstractWindow::IsDamaged (const AbstractView* view) const
+{
+  if (redraw_all_ || frame_damage_.full()) return true;
+
+  Rect rect;
+  if (GetWindowRect(view, &rect) == 0) return true;
+
+  // only the rectangle of the current pass is scissored and cleared
+  return DamageRegion::Intersect(damage_clip_, GetCoveredRect(view, rect));
+}
+
+bool AbstractWindow::GetDamagedRect (const AbstractView* view,
+                                     Rect* rect,
+                                     Rect* window_rect) const
+{
+  if (redraw_all_ || frame_damage_.full()) return false;
+
+  Rect view_rect;
+  if (GetWindowRect(view, &view_rect) == 0) return false;
+
+  // unite the damaged rectangles in the view, an off-screen buffer is
+  // rendered once for all passes
+  Rect area;
+  const std::vector<Rect>& rects = frame_damage_.rects();
+  for (std::vector<Rect>::const_iterator it = rects.begin();
+       it != rects.end(); it++) {
+    Rect part = DamageRegion::Intersection(*it, view_rect);
+    if (part.zero()) continue;
+    area = area.zero() ? part : DamageRegion::Unite(area, part);
+  }
+
+  rect->set_position(area.x() - view_rect.x(), area.y() - view_rect.y());
+  rect->set_size(area.width(), area.height());
+  if (window_rect) *window_rect = area;
+
+  return true;
+}
+
+void AbstractWindow::BeginScissor (const Rect& rect)
+{
+  // the bottom of the stack is the damaged area in a partial redraw
+  Rect box = rect;
+  if (!clip_stack_.empty()) {
+    box = DamageRegion::Intersection(rect, clip_stack_.back());
+  }
+
+  clip_stack_.push_back(box);
+
+  glEnable(GL_SCISSOR_TEST);
+  glScissor(box.x(), box.y(), box.width(), box.height());
+}
+
+void AbstractWindow::EndScissor ()
+{
+  DBG_ASSERT(!clip_stack_.empty());
+  if (clip_stack_.empty()) return;
+
+  clip_stack_.pop_back();
+
+  ApplyScissor();
+}
+
+void AbstractWindow::ApplyScissor ()
+{
+  if (clip_stack_.empty()) {
+    glDisable(GL_SCISSOR_TEST);
+  } else {
+    const Rect& box = clip_stack_.back();
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(box.x(), box.y(), box.width(), box.height());
+  }
+}
+
+void AbstractWindow::SetViewport (int x, int y, int width, int height)
+{
+  viewport_ = Rect(x, y, width, height);
+  glViewport(x, y, width, height);
+}
+
+void AbstractWindow::PushClipRect (const Rect& rect)
+{
+  RenderStats::CountClipPush();
+
+  // map the corners to framebuffer coordinates with the widget
+  // matrices, as the vertices of the widget are mapped in shaders, the
+  // viewport is changed by frames and off-screen buffers
+  const int vp[4] = { viewport_.x(), viewport_.y(), viewport_.width(),
+      viewport_.height() };
+
+  glm::mat4 matrix = kShaders->widget_projection_matrix()
+      * kShaders->widget_view_matrix();
+  const glm::mat3& model = kShaders->widget_model_matrix();
+
+  glm::vec3 p0 = model * glm::vec3(rect.left(), rect.bottom(), 1.f);
+  glm::vec3 p1 = model * glm::vec3(rect.right(), rect.top(), 1.f);
+  glm::vec4 n0 = matrix * glm::vec4(p0.x, p0.y, 0.f, 1.f);
+  glm::vec4 n1 = matrix * glm::vec4(p1.x, p1.y, 0.f, 1.f);
+
+  float x0 = vp[0] + (n0.x / n0.w + 1.f) * 0.5f * vp[2];
+  float y0 = vp[1] + (n0.y / n0.w + 1.f) * 0.5f * vp[3];
+  float x1 = vp[0] + (n1.x / n1.w + 1.f) * 0.5f * vp[2];
+  float y1 = vp[1] + (n1.y / n1.w + 1.f) * 0.5f * vp[3];
+
+  int left = (int) std::floor(std::min(x0, x1) + 0.5f);
+  int bottom = (int) std::floor(std::min(y0, y1) + 0.5f);
+  int right = (int) std::floor(std::max(x0, x1) + 0.5f);
+  int top = (int) std::floor(std::max(y0, y1) + 0.5f);
+
+  BeginScissor(Rect(left, bottom, right - left, top - bottom));
+}
+
+void AbstractWindow::PopClipRect ()
+{
+  EndScissor();
+}
+
+void AbstractWindow::DamageView (const AbstractView* view)
+{
+  if (view->super() == 0) {
+    if (is_window(view)) {
+      AbstractView* window = const_cast<AbstractView*>(view);
+      static_cast<AbstractWindow*>(window)->DamageAll();
+    }
+    return;
+  }
+
+  Rect rect;
+  AbstractWindow* window = GetWindowRect(view, &rect);
+
+  if (window) window->Damage(GetCoveredRect(view, rect));
+}
+
+void AbstractWindow::SetPartialRedraw (bool partial)
+{
+  kPartialRedraw = partial;
+}
+
+void AbstractWindow::WakeUpMainWindow ()
+{
+  // glfwPostEmptyEvent() in Synchronize() is thread safe
+  AbstractWindow* window = kMainWindow;
+  if (window) window->Synchronize();
+}
+
+AbstractWindow* AbstractWindow::GetWindowRect (const AbstractView* view,
+                                               Rect* rect)
+{
+  const AbstractView* p = view->super();
+  if (p == 0) return 0;
+
+  Point pos = view->position();
+  while (p->super()) {
+    pos = pos + p->position() + p->GetOffset();
+    p = p->super();
+  }
+
+  if (!is_window(p)) return 0;
+
+  rect->set_position(pos);
+  rect->set_size(view->size());
+
+  return const_cast<AbstractWindow*>(static_cast<const AbstractWindow*>(p));
+}
+
+Rect AbstractWindow::GetCoveredRect (const AbstractView* view,
+                                     const Rect& rect)
+{
+  if (!is_frame(view) || (kTheme == 0)) return rect;
+
+  // frames may draw a shadow outside
+  int margin = kTheme->shadow_width() * 2;
+
+  return Rect(rect.x() - margin, rect.y() - margin,
+              rect.width() + margin * 2, rect.height() + margin * 2);
+}
+
+size_t AbstractWindow::BeginPartialRedraw ()
+{
+  clip_stack_.clear();
+  redraw_rects_.clear();
+
+  damage_mutex_.lock();
+  frame_damage_ = damage_;
+  damage_.Clear();
+  damage_mutex_.unlock();
+
+  // a redraw requested without any damage, e.g. set_refresh()
+  if (frame_damage_.empty()) frame_damage_.AddAll();
+
+  if (!kPartialRedraw) {
+    ReleaseRetainedFramebuffer();
+    frame_damage_.AddAll();
+    return 1;
+  }
+
+  if (!UpdateRetainedFramebuffer()) frame_damage_.AddAll();
+
+  glBindFramebuffer(GL_FRAMEBUFFER, window_framebuffer_);
+  draw_framebuffer_ = window_framebuffer_;
+
+  frame_damage_.GetRedrawRects(&redraw_rects_);
+
+  return std::max(redraw_rects_.size(), (size_t) 1);
+}
+
+void AbstractWindow::BeginRedrawPass (size_t pass)
+{
+  clip_stack_.clear();
+
+  if (pass < redraw_rects_.size()) {
+    damage_clip_ = redraw_rects_[pass];
+    BeginScissor(damage_clip_);
+  } else {
+    damage_clip_ = Rect(0, 0, size().width(), size().height());
+    glDisable(GL_SCISSOR_TEST);
+  }
+}
+
+void AbstractWindow::EndPartialRedraw ()
+{
+  clip_stack_.clear();
+  glDisable(GL_SCISSOR_TEST);
+
+  if (window_framebuffer_) {
+    int w = retained_size_.width();
+    int h = retained_size_.height();
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, window_framebuffer_);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, w, h, 0, 0, w, h, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  }
+
+  // views drawn outside Window::Exec() are drawn as a whole
+  window_framebuffer_ = 0;
+  draw_framebuffer_ = 0;
+  frame_damage_.AddAll();
+}
+
+bool AbstractWindow::UpdateRetainedFramebuffer ()
+{
+  if (retained_framebuffer_ && (retained_size_ == size())) {
+    window_framebuffer_ = retained_framebuffer_;
+    return true;
+  }
+
+  int w = std::max(size().width(), 1);
+  int h = std::max(size().height(), 1);
+
+  if (retained_framebuffer_ == 0) {
+    glGenFramebuffers(1, &retained_framebuffer_);
+    glGenRenderbuffers(1, &retained_color_);
+    glGenRenderbuffers(1, &retained_depth_stencil_);
+  }
+
+  glBindRenderbuffer(GL_RENDERBUFFER, retained_color_);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, w, h);
+  glBindRenderbuffer(GL_RENDERBUFFER, retained_depth_stencil_);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, w, h);
+  glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+  glBindFramebuffer(GL_FRAMEBUFFER, retained_framebuffer_);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                            GL_RENDERBUFFER, retained_color_);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT,
+                            GL_RENDERBUFFER, retained_depth_stencil_);
+
+  retained_size_ = size();
+
+  if (GLFramebuffer::CheckStatus()) {
+    window_framebuffer_ = retained_framebuffer_;
+  } else {
+    // draw into the default framebuffer as before
+    DBG_PRINT_MSG("%s", "Fail to create the retained framebuffer");
+    ReleaseRetainedFramebuffer();
+  }
+
+  GLFramebuffer::reset();
+
+  return false;
+}
+
+void AbstractWindow::ReleaseRetainedFramebuffer ()
+{
+  if (retained_framebuffer_ == 0) return;
+
+  glDeleteFramebuffers(1, &retained_framebuffer_);
+  glDeleteRenderbuffers(1, &retained_color_);
+  glDeleteRenderbuffers(1, &retained_depth_stencil_);
+
+  retained_framebuffer_ = 0;
+  retained_color_ = 0;
+  retained_depth_stencil_ = 0;
+  retained_size_ = Size();
+  window_framebuffer_ = 0;
+  draw_framebuffer_ = 0;
+}
+
 Point AbstractWindow::GetAbsolutePosition (const AbstractView* widget)
 {
 #ifdef DEBUG
@@ -384,6 +739,27 @@ AbstractWindow* AbstractWindow::GetWindow (AbstractView* view)
   return dynamic_cast<AbstractWindow*>(parent);
 }
 
+// milliseconds since a time point, the Timer functions are not thread
+// safe
+static double GetMillisecondsSince (
+    const std::chrono::steady_clock::time_point& start)
+{
+  return std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - start).count();
+}
+
+// read the icon images, run in a worker thread in InitializeGLContext()
+static bool ReadIconImages (Image* icons16, Image* icons32, double* time)
+{
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+
+  bool retval = Icons::ReadImages(icons16, icons32);
+
+  *time = GetMillisecondsSince(start);
+  return retval;
+}
+
 bool AbstractWindow::InitializeGLContext ()
 {
   bool success = true;
@@ -396,43 +772,87 @@ bool AbstractWindow::InitializeGLContext ()
   DBG_PRINT_MSG("OpenGL shading language version: %d.%d", major, minor);
 #endif
 
-  Timer::SaveCurrentTime();
-  if (success && InitializeTheme()) {
-    DBG_PRINT_MSG("Timer to intialize theme: %g (ms)",
-                  Timer::GetIntervalOfMilliseconds());
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  std::chrono::steady_clock::time_point phase;
+
+  StartupProfile profile;
+  unsigned int cached_programs = GLSLProgram::binary_cache_hits();
+  unsigned int linked_programs = GLSLProgram::linked_programs();
+
+  // Parsing the theme, matching the default font (which is set in the
+  // theme) and decoding the icon images make no OpenGL calls, run them
+  // in worker threads while the shaders are linked in this thread. Each
+  // thread writes its own fields of profile.
+  Fc::Pattern font_match;
+  std::future<bool> theme_task = std::async(
+      std::launch::async, &AbstractWindow::LoadThemeAndMatchFont,
+      &font_match, &profile);
+
+  Image icons16;
+  Image icons32;
+  std::future<bool> icons_task = std::async(
+      std::launch::async, &ReadIconImages, &icons16, &icons32,
+      &profile.icons);
+
+  SetDefaultProgramCacheDirectory();
+
+  phase = std::chrono::steady_clock::now();
+  if (InitializeShaders()) {
+    profile.shaders = GetMillisecondsSince(phase);
   } else {
-    DBG_PRINT_MSG("%s", "Cannot initialize Themes");
+    DBG_PRINT_MSG("%s", "The Shader Manager is not initialized successfully!");
     success = false;
   }
 
-  Timer::SaveCurrentTime();
-  if (success && InitializeShaders()) {
-    DBG_PRINT_MSG("Timer to intialize shaders: %g (ms)",
-                  Timer::GetIntervalOfMilliseconds());
+  phase = std::chrono::steady_clock::now();
+  if (success && InitializeVertexArenas()) {
+    profile.vertex_arenas = GetMillisecondsSince(phase);
   } else {
-    DBG_PRINT_MSG("%s", "The Shader Manager is not initialized successfully!");
+    DBG_PRINT_MSG("%s", "Cannot create vertex arenas");
     success = false;
   }
 
-  Timer::SaveCurrentTime();
-  if (success && InitializeIcons()) {
-    DBG_PRINT_MSG("Timer to intialize icons: %g (ms)",
-                  Timer::GetIntervalOfMilliseconds());
+  // always wait for the workers, they write to the locals above
+  bool theme_loaded = theme_task.get();
+  bool icons_read = icons_task.get();
+
+  if (!theme_loaded) {
+    DBG_PRINT_MSG("%s", "Cannot initialize Themes");
+    success = false;
+  }
+
+  if (!icons_read) {
+    DBG_PRINT_MSG("%s", "Cannot read the images of Stock Icons");
+  }
+
+  phase = std::chrono::steady_clock::now();
+  if (success && InitializeIcons(icons16, icons32)) {
+    profile.icons += GetMillisecondsSince(phase);
   } else {
     DBG_PRINT_MSG("%s", "Cannot initialize Stock Icons");
     success = false;
   }
 
-  Timer::SaveCurrentTime();
-  // Create Default font: must call this after theme initialized as it read the default_font
-  if (success && InitializeFont()) {
-    DBG_PRINT_MSG("Timer to intialize font: %g (ms)",
-                  Timer::GetIntervalOfMilliseconds());
+  phase = std::chrono::steady_clock::now();
+  if (success && InitializeFont(font_match)) {
+    profile.font += GetMillisecondsSince(phase);
   } else {
     DBG_PRINT_MSG("%s", "Cannot initialize font");
     success = false;
   }
 
+  profile.total = GetMillisecondsSince(start);
+  profile.cached_programs = GLSLProgram::binary_cache_hits() - cached_programs;
+  profile.linked_programs = GLSLProgram::linked_programs() - linked_programs;
+  kStartupProfile = profile;
+
+  DBG_PRINT_MSG("Startup: theme %g, shaders %g (%u cached, %u linked), "
+                "vertex arenas %g, icons %g, font %g, total %g (ms)",
+                profile.theme, profile.shaders, profile.cached_programs,
+                profile.linked_programs, profile.vertex_arenas,
+                profile.icons, profile.font, profile.total);
+
   return success;
 }
 
@@ -440,6 +860,7 @@ void AbstractWindow::ReleaseGLContext ()
 {
   ReleaseFont();
   ReleaseIcons();
+  ReleaseVertexArenas();
   ReleaseShaders();
   ReleaseTheme();
 }
@@ -468,10 +889,18 @@ bool AbstractWindow::PreDraw (AbstractWindow* context)
 Response AbstractWindow::Draw (AbstractWindow* context)
 {
   for (ManagedPtr p = first(); p; ++p) {
+    // keep the retained pixels of views outside the damaged area
+    if (!p->refresh() && !context->IsDamaged(p.get())) continue;
+
+    if (RenderStats::enabled())
+      RenderStats::BeginView(p.get(), p->name(), typeid(*p).name());
+
     p->PreDraw(context);
     p->Draw(context);
     p->set_refresh(this->refresh());
     p->PostDraw(context);
+
+    if (RenderStats::enabled()) RenderStats::EndView();
   }
 
   return Finish;
@@ -615,9 +1044,10 @@ bool AbstractWindow::InitializeTheme ()
   return true;
 }
 
-bool AbstractWindow::InitializeIcons ()
+bool AbstractWindow::InitializeIcons (const Image& icons16,
+                                      const Image& icons32)
 {
-  if (!kIcons) kIcons = new Icons;
+  if (!kIcons) kIcons = new Icons(icons16, icons32);
 
   return true;
 }
@@ -639,24 +1069,35 @@ bool AbstractWindow::InitializeShaders ()
   return ret;
 }
 
-bool AbstractWindow::InitializeFont ()
+bool AbstractWindow::InitializeVertexArenas ()
 {
-  bool retval = true;
+  if (!kCoordArena) {
+    kCoordArena = new GLVertexArena(AttributeCoord, 2);
+  }
 
-  if (FontCache::kDefaultFontHash == 0) {
+  if (!kShadedArena) {
+    kShadedArena = new GLVertexArena(AttributeCoord, 3);
+  }
 
-    Fc::Pattern p = Fc::Pattern::name_parse(
-        (const FcChar8*) kTheme->default_font());
+  if (!kTextArena) {
+    kTextArena = new GLVertexArena(AttributeCoord, 4);
+  }
 
-    Fc::Config::substitute(0, p, FcMatchPattern);
-    p.default_substitute();
+  return true;
+}
 
-    FcResult result;
-    Fc::Pattern match = Fc::Config::match(0, p, &result);
+bool AbstractWindow::InitializeFont (const Fc::Pattern& match)
+{
+  bool retval = true;
+
+  if (FontCache::kDefaultFontHash == 0) {
 
     if (match) {
-      FontCache::Create(match);
+      RefPtr<FontCache> cache = FontCache::Create(match);
       FontCache::kDefaultFontHash = match.hash();
+
+      // pre-warm the printable ASCII characters of the default font
+      cache->Preload(0x20, 0x7E);
     } else {
       retval = false;
     }
@@ -666,6 +1107,56 @@ bool AbstractWindow::InitializeFont ()
   return retval;
 }
 
+bool AbstractWindow::LoadThemeAndMatchFont (Fc::Pattern* match,
+                                            StartupProfile* profile)
+{
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+
+  if (!InitializeTheme()) return false;
+
+  profile->theme = GetMillisecondsSince(start);
+  start = std::chrono::steady_clock::now();
+
+  // the font cache is not used by the main thread before this returns
+  if (FontCache::kDefaultFontHash == 0) {
+    Fc::Pattern p = Fc::Pattern::name_parse(
+        (const FcChar8*) kTheme->default_font());
+
+    FcResult result;
+    *match = FontCache::Match(p, &result);
+  }
+
+  profile->font = GetMillisecondsSince(start);
+
+  return true;
+}
+
+void AbstractWindow::SetDefaultProgramCacheDirectory ()
+{
+  if (!GLSLProgram::binary_cache_directory().empty()) return;
+
+  const char* path = getenv("BLENDINT_PROGRAM_CACHE");
+  if (path) {
+    GLSLProgram::SetBinaryCacheDirectory(path);
+    return;
+  }
+
+  std::string dir;
+  const char* cache_home = getenv("XDG_CACHE_HOME");
+  const char* home = getenv("HOME");
+
+  if (cache_home && cache_home[0]) {
+    dir = cache_home;
+  } else if (home && home[0]) {
+    dir = std::string(home) + "/.cache";
+  } else {
+    return;
+  }
+
+  GLSLProgram::SetBinaryCacheDirectory(dir + "/blendint/programs");
+}
+
 void AbstractWindow::ReleaseTheme ()
 {
   if (kTheme) {
@@ -690,11 +1181,49 @@ void AbstractWindow::ReleaseShaders ()
   }
 }
 
+void AbstractWindow::ReleaseVertexArenas ()
+{
+  if (kCoordArena) {
+    delete kCoordArena;
+    kCoordArena = 0;
+  }
+
+  if (kShadedArena) {
+    delete kShadedArena;
+    kShadedArena = 0;
+  }
+
+  if (kTextArena) {
+    delete kTextArena;
+    kTextArena = 0;
+  }
+}
+
+void AbstractWindow::ReleaseVertexArrays (const void* context)
+{
+  if (kCoordArena) kCoordArena->ReleaseContext(context);
+  if (kShadedArena) kShadedArena->ReleaseContext(context);
+  if (kTextArena) kTextArena->ReleaseContext(context);
+}
+
 void AbstractWindow::ReleaseFont ()
 {
+  Text::ReleaseQuadIndices();
+  TextLayoutCache::Clear();
   FontCache::ReleaseAll();
 }
 
+void AbstractWindow::refresh_all (AbstractView* view)
+{
+  view->set_refresh(true);
+
+  if (is_window(view)) static_cast<AbstractWindow*>(view)->DamageAll();
+
+  for (AbstractView* p = view->first(); p; p = next(p)) {
+    refresh_all(p);
+  }
+}
+
 void AbstractWindow::GetGLVersion (int* major, int* minor)
 {
   const char* verstr = (const char*) glGetString(GL_VERSION);
@@ -732,22 +1261,15 @@ void AbstractWindow::GetGLSLVersion (int* major, int* minor)
 
 void AbstractWindow::DispatchMouseHover ()
 {
-  try {
-
-    active_frame_ = 0;
-    overlap_ = false;
-    
-    Response response = Ignore;
-    for (ManagedPtr p = last(); p; --p) {
-      response = dynamic_cast<AbstractFrame*>(p.get())->PerformMouseHover(this);
-      if (response == Finish) break;
-    }
-
-  } catch (std::bad_cast& e) {
-
-    DBG_PRINT_MSG("Error: %s", "Only AbstractFrame should be added in window");
-    exit(EXIT_FAILURE);
+  active_frame_ = 0;
+  overlap_ = false;
 
+  Response response = Ignore;
+  for (ManagedPtr p = last(); p; --p) {
+    // only AbstractFrame should be added in window
+    DBG_ASSERT(is_frame(p.get()));
+    response = static_cast<AbstractFrame*>(p.get())->PerformMouseHover(this);
+    if (response == Finish) break;
   }
 }
 
@@ -53,7 +53,6 @@ ColorButton::ColorButton ()
 
 ColorButton::~ColorButton ()
 {
-  glDeleteVertexArrays(2, vao_);
 }
 
 void ColorButton::SetColor (const Color& color)
@@ -77,11 +76,7 @@ void ColorButton::PerformSizeUpdate (const AbstractView* source,
     std::vector<GLfloat> outer_verts;
 
     GenerateRoundedVertices(&inner_verts, &outer_verts);
-    vbo_.bind(0);
-    vbo_.set_data(sizeof(GLfloat) * inner_verts.size(), &inner_verts[0]);
-    vbo_.bind(1);
-    vbo_.set_data(sizeof(GLfloat) * outer_verts.size(), &outer_verts[0]);
-    vbo_.reset();
+    geometry_.Update(inner_verts, outer_verts);
 
     RequestRedraw();
   }
@@ -99,11 +94,7 @@ void ColorButton::PerformRoundTypeUpdate (int round_type)
   std::vector<GLfloat> outer_verts;
 
   GenerateRoundedVertices(&inner_verts, &outer_verts);
-  vbo_.bind(0);
-  vbo_.set_data(sizeof(GLfloat) * inner_verts.size(), &inner_verts[0]);
-  vbo_.bind(1);
-  vbo_.set_data(sizeof(GLfloat) * outer_verts.size(), &outer_verts[0]);
-  vbo_.reset();
+  geometry_.Update(inner_verts, outer_verts);
 
   RequestRedraw();
 }
@@ -116,11 +107,7 @@ void ColorButton::PerformRoundRadiusUpdate (float radius)
   std::vector<GLfloat> outer_verts;
 
   GenerateRoundedVertices(&inner_verts, &outer_verts);
-  vbo_.bind(0);
-  vbo_.set_data(sizeof(GLfloat) * inner_verts.size(), &inner_verts[0]);
-  vbo_.bind(1);
-  vbo_.set_data(sizeof(GLfloat) * outer_verts.size(), &outer_verts[0]);
-  vbo_.reset();
+  geometry_.Update(inner_verts, outer_verts);
 
   RequestRedraw();
 }
@@ -159,8 +146,7 @@ Response ColorButton::Draw (AbstractWindow* context)
         0);
   }
 
-  glBindVertexArray(vao_[0]);
-  glDrawArrays(GL_TRIANGLE_FAN, 0, outline_vertex_count(round_type()) + 2);
+  geometry_.DrawInner(GL_TRIANGLE_FAN, outline_vertex_count(round_type()) + 2);
 
   AbstractWindow::shaders()->widget_outer_program()->use();
 
@@ -169,9 +155,8 @@ Response ColorButton::Draw (AbstractWindow* context)
   glUniform4fv(AbstractWindow::shaders()->location(Shaders::WIDGET_OUTER_COLOR),
                1, AbstractWindow::theme()->regular().outline.data());
 
-  glBindVertexArray(vao_[1]);
-  glDrawArrays(GL_TRIANGLE_STRIP, 0,
-               outline_vertex_count(round_type()) * 2 + 2);
+  geometry_.DrawOuter(GL_TRIANGLE_STRIP,
+                      outline_vertex_count(round_type()) * 2 + 2);
 
   if (emboss()) {
     glUniform4f(
@@ -182,7 +167,8 @@ Response ColorButton::Draw (AbstractWindow* context)
         AbstractWindow::shaders()->location(Shaders::WIDGET_OUTER_OFFSET), 0.f,
         -1.f);
 
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, emboss_vertex_count(round_type()) * 2);
+    geometry_.DrawOuter(GL_TRIANGLE_STRIP,
+                        emboss_vertex_count(round_type()) * 2);
   }
 
   DrawIconText();
@@ -210,26 +196,7 @@ void ColorButton::InitializeColorButton ()
 
   GenerateRoundedVertices(&inner_verts, &outer_verts);
 
-  vbo_.generate();
-
-  glGenVertexArrays(2, vao_);
-  glBindVertexArray(vao_[0]);
-
-  vbo_.bind(0);
-  vbo_.set_data(sizeof(GLfloat) * inner_verts.size(), &inner_verts[0]);
-
-  glEnableVertexAttribArray(AttributeCoord);
-  glVertexAttribPointer(AttributeCoord, 3, GL_FLOAT, GL_FALSE, 0, 0);
-
-  glBindVertexArray(vao_[1]);
-  vbo_.bind(1);
-  vbo_.set_data(sizeof(GLfloat) * outer_verts.size(), &outer_verts[0]);
-
-  glEnableVertexAttribArray(AttributeCoord);
-  glVertexAttribPointer(AttributeCoord, 2, GL_FLOAT, GL_FALSE, 0, 0);
-
-  glBindVertexArray(0);
-  vbo_.reset();
+  geometry_.Update(inner_verts, outer_verts);
 }
 
 void ColorButton::OnClick ()
@@ -240,14 +240,16 @@ Response ColorSelector::Draw (AbstractWindow* context)
 
   } else {
 
-    glViewport(position().x(), position().y(), size().width(), size().height());
+    context->SetViewport(position().x(), position().y(), size().width(),
+                         size().height());
 
     AbstractWindow::shaders()->SetWidgetProjectionMatrix(projection_matrix_);
     AbstractWindow::shaders()->SetWidgetModelMatrix(model_matrix_);
 
     DrawSubViewsOnce(context);
 
-    glViewport(0, 0, context->size().width(), context->size().height());
+    context->SetViewport(0, 0, context->size().width(),
+                         context->size().height());
 
   }
 
@@ -292,9 +292,7 @@ Response ComboListView::Draw (AbstractWindow* context)
   glBindVertexArray(vao_[0]);
   // glDrawArrays(GL_TRIANGLE_FAN, 0, outline_vertex_count(round_type()) + 2);
 
-  context->BeginPushStencil();  // inner stencil
-  glDrawArrays(GL_TRIANGLE_FAN, 0, outline_vertex_count(round_type()) + 2);
-  context->EndPushStencil();
+  context->PushClipRect(Rect(0, 0, size().width(), size().height()));
 
   /*
   AbstractWindow::shaders()->widget_triangle_program()->use();
@@ -370,13 +368,7 @@ Response ComboListView::Draw (AbstractWindow* context)
 
   }
 
-  AbstractWindow::shaders()->widget_inner_program()->use();
-
-  context->BeginPopStencil(); // pop inner stencil
-  glBindVertexArray(vao_[0]);
-  glDrawArrays(GL_TRIANGLE_FAN, 0, outline_vertex_count(round_type()) + 2);
-  glBindVertexArray(0);
-  context->EndPopStencil();
+  context->PopClipRect();
 
   return Finish;
 }
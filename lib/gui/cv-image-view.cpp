@@ -23,6 +23,9 @@
 
 #ifdef __USE_OPENCV__
 
+#include <chrono>
+#include <cstring>
+
 #include <glm/gtx/matrix_transform_2d.hpp>
 
 #include <blendint/gui/cv-image-view.hpp>
@@ -30,7 +33,16 @@
 namespace BlendInt {
 
 CVImageView::CVImageView ()
-    : AbstractScrollable(), off_screen_context_(0), flags_(0)
+    : AbstractScrollable(),
+      texture_format_(0),
+      pbo_index_(0),
+      decoding_(false),
+      rewind_(false),
+      quit_(false),
+      camera_(false),
+      interval_(0),
+      frame_ready_(false),
+      flags_(0)
 {
   set_size(400, 300);
   image_size_.reset(400, 300);
@@ -82,20 +94,20 @@ CVImageView::CVImageView ()
   texture_.SetMagFilter(GL_LINEAR);
   texture_.SetImage(0, GL_RGBA, 4, 4, 0, GL_RGBA, GL_UNSIGNED_BYTE, &buf[0]);
   texture_.reset();
+
+  pbo_.generate();
 }
 
 CVImageView::~CVImageView ()
 {
+  QuitDecoding();
+
   if (video_stream_.isOpened()) {
     video_stream_.release();
     image_.release();
   }
 
   glDeleteVertexArrays(2, vao_);
-
-  if (off_screen_context_) {
-    delete off_screen_context_;
-  }
 }
 
 bool CVImageView::IsExpandX () const
@@ -143,24 +155,18 @@ bool CVImageView::OpenCamera (int n, int fps, const Size& resolution)
     vbo_.reset();
 
     fps = fps <= 0 ? 15 : (fps > 60 ? 60 : fps);
-    timer_->SetInterval(1000 / fps);
+    interval_ = 1000000 / fps;
+    camera_ = true;
+
+    // check new frames at twice the frame rate, a frame waits at most
+    // half of the interval to be drawn
+    timer_->SetInterval(std::max(500 / fps, 1));
 
     SETBIT(flags_, DisplayModeMask);
     SETBIT(flags_, DeviceTypeMask);
     CLRBIT(flags_, StreamingMask);
     CLRBIT(flags_, PlaybackMask);
 
-    if (off_screen_context_ == 0) {
-
-      AbstractWindow* win = AbstractWindow::GetWindow(this);
-      off_screen_context_ = win->CreateSharedContext(win->size().width(),
-                                                     win->size().height(),
-                                                     WindowInvisible);
-
-    }
-
-    DBG_ASSERT(off_screen_context_);
-
     retval = true;
 
   } else {
@@ -193,47 +199,30 @@ bool CVImageView::OpenImageFile (const std::string& filename)
     vbo_.unmap();
     vbo_.reset();
 
-    texture_.bind();
-
-    switch (image_.channels()) {
-
-      case 1: {
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-        texture_.SetImage(0, GL_RED, image_.cols, image_.rows, 0, GL_RED,
-                          GL_UNSIGNED_BYTE, image_.data);
-        break;
-      }
-
-      case 2: {
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
-        texture_.SetImage(0, GL_RG, image_.cols, image_.rows, 0, GL_RG,
-                          GL_UNSIGNED_BYTE, image_.data);
-        break;
-      }
-
-      case 3: {
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 3);
-        texture_.SetImage(0, GL_RGB, image_.cols, image_.rows, 0, GL_BGR,
-                          GL_UNSIGNED_BYTE, image_.data);
-        break;
-      }
+    GLint internal_format = 0;
+    GLenum format = 0;
+    GetPixelFormat(image_.channels(), &internal_format, &format);
 
-      case 4: {    // opencv does not support alpha-channel,
-        // only masking, these code will never be
-        // called
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
-        texture_.SetImage(0, GL_RGBA, image_.cols, image_.rows, 0, GL_BGRA,
-                          GL_UNSIGNED_BYTE, image_.data);
-        break;
+    if (format) {
+      texture_.bind();
+      glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+      texture_.SetImage(0, internal_format, image_.cols, image_.rows, 0,
+                        format, GL_UNSIGNED_BYTE,
+                        image_.isContinuous() ? image_.data : 0);
+      if (!image_.isContinuous()) {
+        for (int i = 0; i < image_.rows; i++) {
+          texture_.SetSubImage(0, 0, i, image_.cols, 1, format,
+                               GL_UNSIGNED_BYTE, image_.ptr(i));
+        }
       }
+      glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+      texture_.reset();
 
-      default: {
-        break;
-      }
+      // the next video frame allocates the texture again
+      texture_size_.reset(0, 0);
     }
 
     flags_ = 0;
-    DBG_ASSERT(off_screen_context_ == 0);
 
     RequestRedraw();
     return true;
@@ -271,24 +260,16 @@ bool CVImageView::OpenVideoFile (const std::string& filename, int fps)
     vbo_.reset();
 
     fps = fps <= 0 ? 15 : (fps > 60 ? 60 : fps);
-    timer_->SetInterval(1000 / fps);
+    interval_ = 1000000 / fps;
+    camera_ = false;
+
+    timer_->SetInterval(std::max(500 / fps, 1));
 
     SETBIT(flags_, DisplayModeMask);
     CLRBIT(flags_, DeviceTypeMask);
     CLRBIT(flags_, StreamingMask);
     CLRBIT(flags_, PlaybackMask);
 
-    if (off_screen_context_ == 0) {
-
-      AbstractWindow* win = AbstractWindow::GetWindow(this);
-      off_screen_context_ = win->CreateSharedContext(win->size().width(),
-                                                     win->size().height(),
-                                                     WindowInvisible);
-
-    }
-
-    DBG_ASSERT(off_screen_context_);
-
     retval = true;
 
   } else {
@@ -310,6 +291,7 @@ void CVImageView::Play ()
     SETBIT(flags_, StreamingMask);
     SETBIT(flags_, VideoPlayMask);
 
+    StartDecoding();
     timer_->Start();
 
   } else {
@@ -318,6 +300,8 @@ void CVImageView::Play ()
 
       CLRBIT(flags_, PlaybackMask);
       SETBIT(flags_, VideoPlayMask);
+
+      StartDecoding();
       timer_->Start();
 
     }
@@ -335,6 +319,9 @@ void CVImageView::Pause ()
       CLRBIT(flags_, PlaybackMask);
       SETBIT(flags_, VideoPauseMask);
       timer_->Stop();
+
+      std::lock_guard<std::mutex> lock(mutex_);
+      decoding_ = false;
     }
 
   } else {
@@ -352,6 +339,13 @@ void CVImageView::Stop ()
       CLRBIT(flags_, PlaybackMask);
       SETBIT(flags_, VideoStopMask);
       timer_->Stop();
+
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        decoding_ = false;
+        rewind_ = !camera_;
+      }
+      condition_.notify_one();
     }
 
   } else {
@@ -362,22 +356,32 @@ void CVImageView::Stop ()
 void CVImageView::Release ()
 {
   if (flags_ & DisplayModeMask) { // play video
+    QuitDecoding();
     video_stream_.release();
     timer_->Stop();
-    if (off_screen_context_) {
-      delete off_screen_context_;
-      off_screen_context_ = 0;
-    }
   }
 
-  DBG_ASSERT(off_screen_context_ == 0);
-
   image_.release();
   flags_ = 0;
 
   std::vector<unsigned char> buf(4 * 4 * 4, 255);
   glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  texture_.bind();
   texture_.SetImage(0, GL_RGBA, 4, 4, 0, GL_RGBA, GL_UNSIGNED_BYTE, &buf[0]);
+  texture_.reset();
+  texture_size_.reset(0, 0);
+}
+
+VideoFrameStats CVImageView::stats () const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void CVImageView::reset_stats ()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_ = VideoFrameStats();
 }
 
 void CVImageView::ProcessImage (cv::Mat& image)
@@ -387,15 +391,9 @@ void CVImageView::ProcessImage (cv::Mat& image)
 
 void CVImageView::DrawTexture ()
 {
-  // TODO: use double textures
   glBindVertexArray(vao_[1]);
-  if (mutex_.try_lock()) {
-    texture_.bind();
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-    mutex_.unlock();
-  } else {
-    DBG_PRINT_MSG("%s", "fail to lock");
-  }
+  texture_.bind();
+  glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 }
 
 void CVImageView::PerformSizeUpdate (const AbstractView* source,
@@ -445,9 +443,7 @@ bool CVImageView::PreDraw (AbstractWindow* context)
   glBindVertexArray(vao_[0]);
   glDrawArrays(GL_TRIANGLE_FAN, 0, 6);
 
-  context->BeginPushStencil();	// inner stencil
-  glDrawArrays(GL_TRIANGLE_FAN, 0, 6);
-  context->EndPushStencil();
+  context->PushClipRect(Rect(0, 0, size().width(), size().height()));
 
   return true;
 }
@@ -465,6 +461,8 @@ Response CVImageView::Draw (AbstractWindow* context)
   glUniform1i(AbstractWindow::shaders()->location(Shaders::WIDGET_IMAGE_GAMMA),
               0);
 
+  if (flags_ & StreamingMask) UploadFrame();
+
   DrawTexture();
 
   return Finish;
@@ -472,76 +470,277 @@ Response CVImageView::Draw (AbstractWindow* context)
 
 void CVImageView::PostDraw (AbstractWindow* context)
 {
-  // draw background again to unmask stencil
-  AbstractWindow::shaders()->widget_inner_program()->use();
-
-  glBindVertexArray(vao_[0]);
-
-  context->BeginPopStencil();	// pop inner stencil
-  glDrawArrays(GL_TRIANGLE_FAN, 0, 6);
-  context->EndPopStencil();
+  context->PopClipRect();
 
   AbstractWindow::shaders()->PopWidgetModelMatrix();
 }
 
 void CVImageView::OnUpdateFrame ()
 {
-  video_stream_ >> image_;
+  // the frame is uploaded in Draw()
+  if (frame_ready_) RequestRedraw();
+}
 
-  if (mutex_.try_lock()) {
-    
-    off_screen_context_->MakeCurrent();
+void CVImageView::StartDecoding ()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    decoding_ = true;
+  }
 
-    if (image_.data) ProcessImage(image_);
+  // the thread is created when the stream is played the first time
+  if (!thread_.joinable()) {
+    thread_ = std::thread(&CVImageView::Decode, this);
+  } else {
+    condition_.notify_one();
+  }
+}
 
-    if (image_.data) {
+void CVImageView::QuitDecoding ()
+{
+  if (!thread_.joinable()) return;
 
-      texture_.bind();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    quit_ = true;
+  }
+  condition_.notify_one();
 
-      switch (image_.channels()) {
+  thread_.join();
 
-        case 1: {
-          glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-          texture_.SetImage(0, GL_RED, image_.cols, image_.rows, 0, GL_RED,
-                            GL_UNSIGNED_BYTE, image_.data);
-          break;
-        }
+  quit_ = false;
+  decoding_ = false;
+  rewind_ = false;
+  frame_ready_ = false;
 
-        case 2: {
-          glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
-          texture_.SetImage(0, GL_RG, image_.cols, image_.rows, 0, GL_RG,
-                            GL_UNSIGNED_BYTE, image_.data);
-          break;
-        }
+  for (int i = 0; i < kFrameCount; i++) {
+    frames_[i].state = FrameFree;
+    frames_[i].image.release();
+  }
+}
 
-        case 3: {
-          glPixelStorei(GL_UNPACK_ALIGNMENT, 3);
-          texture_.SetImage(0, GL_RGB, image_.cols, image_.rows, 0, GL_BGR,
-                            GL_UNSIGNED_BYTE, image_.data);
-          break;
-        }
+void CVImageView::Decode ()
+{
+  int index = 0;
+  bool rewind = false;
+  bool ok = false;
+  uint64_t deadline = 0;
+  uint64_t now = 0;
 
-        case 4: {
-          // opencv does not support alpha-channel, only masking, these code will never be called
-          glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
-          texture_.SetImage(0, GL_RGBA, image_.cols, image_.rows, 0, GL_BGRA,
-                            GL_UNSIGNED_BYTE, image_.data);
-          break;
-        }
+  while (true) {
 
-        default: {
-          break;
-        }
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
 
+      while ((!quit_) && (!decoding_) && (!rewind_)) {
+        condition_.wait(lock);
       }
 
+      if (quit_) break;
+
+      rewind = rewind_;
+      rewind_ = false;
+
+      if (!rewind) {
+        index = GetFreeFrame();
+        frames_[index].state = FrameDecoding;
+      }
     }
 
-    RequestRedraw();
-    mutex_.unlock();
+    if (rewind) {
+      video_stream_.set(CV_CAP_PROP_POS_FRAMES, 0);
+      deadline = 0;
+      continue;
+    }
+
+    // the buffer of the frame is reused if the size does not change
+    ok = video_stream_.read(frames_[index].image)
+        && (frames_[index].image.data != 0);
+
+    if (ok) ProcessImage(frames_[index].image);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+
+      if (ok) {
+        frames_[index].state = FrameReady;
+        frames_[index].sequence = ++stats_.decoded;
+        frame_ready_ = true;
+      } else {
+        frames_[index].state = FrameFree;
+        // wait at the end of a video file, a camera may recover
+        if (!camera_) decoding_ = false;
+      }
+    }
+
+    // keep the frame rate of the stream, the decoding time is included
+    now = Timer::GetMicroSeconds();
+    if ((deadline == 0) || (now > deadline + interval_)) {
+      deadline = now;	// start or fell behind, do not catch up in a burst
+    }
+    deadline += interval_;
+
+    if (deadline > now) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      condition_.wait_for(lock, std::chrono::microseconds(deadline - now));
+    }
+
+  }
+}
+
+int CVImageView::GetFreeFrame ()
+{
+  int oldest = -1;
+
+  for (int i = 0; i < kFrameCount; i++) {
+    if (frames_[i].state == FrameFree) return i;
+
+    if ((frames_[i].state == FrameReady)
+        && ((oldest < 0) || (frames_[i].sequence < frames_[oldest].sequence))) {
+      oldest = i;
+    }
+  }
+
+  // drawing is behind, drop the oldest frame not drawn, at most one frame
+  // is decoded and one is uploaded at a time
+  DBG_ASSERT(oldest >= 0);
+  stats_.dropped++;
+
+  return oldest;
+}
+
+bool CVImageView::UploadFrame ()
+{
+  int index = -1;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    frame_ready_ = false;
+
+    // take the newest frame, the older ones are dropped
+    for (int i = 0; i < kFrameCount; i++) {
+      if (frames_[i].state != FrameReady) continue;
+
+      if (index < 0) {
+        index = i;
+      } else if (frames_[i].sequence > frames_[index].sequence) {
+        frames_[index].state = FrameFree;
+        stats_.dropped++;
+        index = i;
+      } else {
+        frames_[i].state = FrameFree;
+        stats_.dropped++;
+      }
+    }
+
+    if (index < 0) return false;
+    frames_[index].state = FramePresenting;
+  }
+
+  // the decode thread does not touch a frame being presented
+  const cv::Mat& image = frames_[index].image;
+
+  GLint internal_format = 0;
+  GLenum format = 0;
+  GetPixelFormat(image.channels(), &internal_format, &format);
+
+  if (format) {
+
+    const size_t row = image.cols * image.elemSize();
+    const size_t bytes = row * image.rows;
+
+    texture_.bind();
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    // allocate the texture only when the size or format changes, frames
+    // are copied into it afterwards
+    if ((texture_size_.width() != image.cols)
+        || (texture_size_.height() != image.rows)
+        || (texture_format_ != format)) {
+      texture_.SetImage(0, internal_format, image.cols, image.rows, 0, format,
+                        GL_UNSIGNED_BYTE, 0);
+      texture_size_.reset(image.cols, image.rows);
+      texture_format_ = format;
+    }
+
+    // the buffers are used in turn and orphaned before they are written,
+    // the transfer of the previous frame does not block this one
+    pbo_.bind(pbo_index_);
+    pbo_.set_data(bytes, 0, GL_STREAM_DRAW);
+
+    GLubyte* ptr = (GLubyte*) glMapBufferRange(
+        GL_PIXEL_UNPACK_BUFFER, 0, bytes,
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+
+    if (ptr) {
+      if (image.isContinuous()) {
+        memcpy(ptr, image.data, bytes);
+      } else {
+        for (int i = 0; i < image.rows; i++) {
+          memcpy(ptr + i * row, image.ptr(i), row);
+        }
+      }
+      pbo_.unmap();
+
+      texture_.SetSubImage(0, 0, 0, image.cols, image.rows, format,
+                           GL_UNSIGNED_BYTE, BUFFER_OFFSET(0));
+    }
+
+    pbo_.reset();
+    pbo_index_ = (pbo_index_ + 1) % pbo_.size();
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    texture_.reset();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    frames_[index].state = FrameFree;
+    stats_.presented++;
+  }
+
+  return true;
+}
+
+void CVImageView::GetPixelFormat (int channels,
+                                  GLint* internal_format,
+                                  GLenum* format)
+{
+  switch (channels) {
+
+    case 1: {
+      *internal_format = GL_RED;
+      *format = GL_RED;
+      break;
+    }
+
+    case 2: {
+      *internal_format = GL_RG;
+      *format = GL_RG;
+      break;
+    }
+
+    case 3: {
+      *internal_format = GL_RGB;
+      *format = GL_BGR;
+      break;
+    }
+
+    case 4: {
+      // opencv does not support alpha-channel, only masking, these code
+      // will never be called
+      *internal_format = GL_RGBA;
+      *format = GL_BGRA;
+      break;
+    }
+
+    default: {
+      *internal_format = 0;
+      *format = 0;
+      break;
+    }
 
-  } else {
-    DBG_PRINT_MSG("%s", "Fail to lock mutex, lost one frame");
   }
 }
 
@@ -0,0 +1,147 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free software:
+ * you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is distributed in
+ * the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+
+#include <algorithm>
+
+#include <blendint/gui/damage-region.hpp>
+
+namespace BlendInt {
+
+DamageRegion::DamageRegion ()
+: full_(false)
+{
+}
+
+DamageRegion::~DamageRegion ()
+{
+}
+
+void DamageRegion::Add (const Rect& rect)
+{
+  if (full_ || rect.zero()) return;
+
+  Rect merged = rect;
+  std::vector<Rect>::iterator it = rects_.begin();
+
+  // merge with the rectangles whose union wastes no more area than the
+  // two rectangles drawn apart, start over as the merged one grows
+  while (it != rects_.end()) {
+    Rect u = Unite(*it, merged);
+    if (area(u) <= area(*it) + area(merged)) {
+      merged = u;
+      rects_.erase(it);
+      it = rects_.begin();
+    } else {
+      ++it;
+    }
+  }
+
+  bounds_ = rects_.empty() ? merged : Unite(bounds_, merged);
+
+  if (rects_.size() >= kMaxRects) {
+    rects_.clear();
+    rects_.push_back(bounds_);
+  } else {
+    rects_.push_back(merged);
+  }
+}
+
+void DamageRegion::AddAll ()
+{
+  full_ = true;
+  rects_.clear();
+  bounds_ = Rect();
+}
+
+void DamageRegion::Clear ()
+{
+  full_ = false;
+  rects_.clear();
+  bounds_ = Rect();
+}
+
+bool DamageRegion::Intersects (const Rect& rect) const
+{
+  if (full_) return true;
+
+  if (!Intersect(bounds_, rect)) return false;
+
+  for (std::vector<Rect>::const_iterator it = rects_.begin();
+       it != rects_.end(); it++) {
+    if (Intersect(*it, rect)) return true;
+  }
+
+  return false;
+}
+
+void DamageRegion::GetRedrawRects (std::vector<Rect>* rects) const
+{
+  rects->clear();
+  if (full_ || rects_.empty()) return;
+
+  long covered = 0;
+  for (std::vector<Rect>::const_iterator it = rects_.begin();
+       it != rects_.end(); it++) {
+    covered += area(*it);
+  }
+
+  // rectangles reaching kMaxRects were already collapsed to the bounds
+  if ((rects_.size() > 1) && (covered * 4 < area(bounds_) * 3)) {
+    rects->assign(rects_.begin(), rects_.end());
+  } else {
+    rects->push_back(bounds_);
+  }
+}
+
+bool DamageRegion::Intersect (const Rect& rect1, const Rect& rect2)
+{
+  if (rect1.zero() || rect2.zero()) return false;
+
+  return (rect1.left() < rect2.right()) && (rect2.left() < rect1.right())
+      && (rect1.bottom() < rect2.top()) && (rect2.bottom() < rect1.top());
+}
+
+Rect DamageRegion::Unite (const Rect& rect1, const Rect& rect2)
+{
+  int left = std::min(rect1.left(), rect2.left());
+  int bottom = std::min(rect1.bottom(), rect2.bottom());
+  int right = std::max(rect1.right(), rect2.right());
+  int top = std::max(rect1.top(), rect2.top());
+
+  return Rect(left, bottom, right - left, top - bottom);
+}
+
+Rect DamageRegion::Intersection (const Rect& rect1, const Rect& rect2)
+{
+  if (!Intersect(rect1, rect2)) return Rect();
+
+  int left = std::max(rect1.left(), rect2.left());
+  int bottom = std::max(rect1.bottom(), rect2.bottom());
+  int right = std::min(rect1.right(), rect2.right());
+  int top = std::min(rect1.top(), rect2.top());
+
+  return Rect(left, bottom, right - left, top - bottom);
+}
+
+}
@@ -0,0 +1,232 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free software:
+ * you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is distributed in
+ * the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+#include <iostream>
+
+#include <boost/filesystem.hpp>
+
+#include <blendint/core/timer.hpp>
+
+#include <blendint/gui/directory-scanner.hpp>
+
+namespace BlendInt {
+
+namespace fs = boost::filesystem;
+
+static void ReadAttributes (const fs::path& path,
+                            const fs::file_status& status,
+                            DirectoryEntry* entry)
+{
+  boost::system::error_code ec;
+
+  entry->directory = fs::is_directory(status);
+  entry->regular = fs::is_regular_file(status);
+  entry->permissions = status.permissions();
+
+  entry->last_write_time = fs::last_write_time(path, ec);
+  if (ec) entry->last_write_time = 0;
+
+  if (entry->regular) {
+    entry->size = fs::file_size(path, ec);
+    if (ec) entry->size = 0;
+  }
+}
+
+bool ReadDirectoryEntry (const std::string& directory,
+                         const std::string& name,
+                         DirectoryEntry* entry)
+{
+  boost::system::error_code ec;
+  fs::path path = fs::path(directory) / name;
+
+  fs::file_status status = fs::status(path, ec);
+  if (ec) return false;
+
+  // name may be a reference to entry->name
+  DirectoryEntry result;
+  result.name = name;
+  ReadAttributes(path, status, &result);
+  *entry = result;
+
+  return true;
+}
+
+DirectoryScanner::DirectoryScanner ()
+: request_(0),
+  pending_(false),
+  finished_(true),
+  stop_(false)
+{
+}
+
+DirectoryScanner::~DirectoryScanner ()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+    request_++;
+  }
+  condition_.notify_all();
+
+  if (thread_.joinable()) thread_.join();
+}
+
+void DirectoryScanner::Start (const std::string& pathname)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pathname_ = pathname;
+    request_++;
+    pending_ = true;
+    finished_ = false;
+    results_.clear();
+  }
+
+  // the thread is created on the first listing
+  if (!thread_.joinable()) {
+    thread_ = std::thread(&DirectoryScanner::Run, this);
+  } else {
+    condition_.notify_one();
+  }
+}
+
+void DirectoryScanner::Cancel ()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  request_++;
+  pending_ = false;
+  finished_ = true;
+  results_.clear();
+}
+
+size_t DirectoryScanner::Take (std::vector<DirectoryEntry>* entries,
+                               bool* finished)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  size_t count = results_.size();
+  if (count) {
+    if (entries->empty()) {
+      entries->swap(results_);
+    } else {
+      entries->insert(entries->end(), results_.begin(), results_.end());
+      results_.clear();
+    }
+  }
+
+  if (finished) *finished = finished_;
+
+  return count;
+}
+
+bool DirectoryScanner::busy () const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return !finished_;
+}
+
+void DirectoryScanner::Run ()
+{
+  std::string pathname;
+  unsigned int request = 0;
+
+  std::vector<DirectoryEntry> batch;
+  boost::system::error_code ec;
+  fs::file_status status;
+  uint64_t last_publish = 0;
+
+  while (true) {
+
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      while (!stop_ && !pending_) {
+        condition_.wait(lock);
+      }
+
+      if (stop_) break;
+
+      pathname = pathname_;
+      request = request_;
+      pending_ = false;
+    }
+
+    batch.clear();
+    last_publish = Timer::GetMicroSeconds();
+
+    fs::directory_iterator it(fs::path(pathname), ec);
+    fs::directory_iterator it_end;
+
+    if (ec) {
+      std::cerr << pathname << ": " << ec.message() << std::endl;
+    }
+
+    while ((!ec) && (it != it_end) && (request == request_)) {
+
+      DirectoryEntry entry;
+      entry.name = it->path().filename().native();
+
+      // a broken link or a file removed in the meantime fails here,
+      // keep it with empty attributes
+      status = it->status(ec);
+      if (!ec) ReadAttributes(it->path(), status, &entry);
+
+      batch.push_back(entry);
+
+      if ((batch.size() >= kBatchSize)
+          || ((Timer::GetMicroSeconds() - last_publish) >= kBatchInterval)) {
+        if (!Publish(request, &batch)) break;
+        last_publish = Timer::GetMicroSeconds();
+      }
+
+      it.increment(ec);
+      if (ec) {
+        std::cerr << pathname << ": " << ec.message() << std::endl;
+      }
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (request == request_) {
+        results_.insert(results_.end(), batch.begin(), batch.end());
+        finished_ = true;
+      }
+    }
+
+    ec.clear();
+  }
+}
+
+bool DirectoryScanner::Publish (unsigned int request,
+                                std::vector<DirectoryEntry>* batch)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (request != request_) return false;
+
+  results_.insert(results_.end(), batch->begin(), batch->end());
+  batch->clear();
+
+  return true;
+}
+
+}
@@ -0,0 +1,411 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free software:
+ * you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is distributed in
+ * the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+#ifdef __linux__
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#endif
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <blendint/core/timer.hpp>
+
+#include <blendint/gui/abstract-window.hpp>
+#include <blendint/gui/directory-watcher.hpp>
+
+namespace BlendInt {
+
+#ifdef __linux__
+static const uint32_t kWatchMask = IN_CREATE | IN_DELETE | IN_MOVED_FROM
+    | IN_MOVED_TO | IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_DELETE_SELF
+    | IN_MOVE_SELF | IN_ONLYDIR;
+#endif
+
+std::set<DirectoryWatcher*> DirectoryWatcher::kWatchers;
+
+DirectoryWatcher::DirectoryWatcher ()
+: inotify_(-1),
+  wakeup_(-1),
+  watch_(-1),
+  stop_(false),
+  reset_(false),
+  ready_(false),
+  batch_watch_(-1),
+  batch_reset_(false)
+{
+}
+
+DirectoryWatcher::~DirectoryWatcher ()
+{
+  kWatchers.erase(this);
+
+#ifdef __linux__
+  if (thread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+
+    uint64_t value = 1;
+    if (write(wakeup_, &value, sizeof(value)) < 0) {
+      std::cerr << "Fail to stop the directory watcher: " << strerror(errno)
+                << std::endl;
+    }
+
+    thread_.join();
+  }
+
+  if (inotify_ >= 0) close(inotify_);
+  if (wakeup_ >= 0) close(wakeup_);
+#endif
+}
+
+bool DirectoryWatcher::Watch (const std::string& pathname)
+{
+#ifdef __linux__
+  if (inotify_ < 0) {
+
+    inotify_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_ < 0) {
+      std::cerr << "inotify: " << strerror(errno) << std::endl;
+      return false;
+    }
+
+    wakeup_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeup_ < 0) {
+      std::cerr << "eventfd: " << strerror(errno) << std::endl;
+      close(inotify_);
+      inotify_ = -1;
+      return false;
+    }
+
+  }
+
+  Stop();
+
+  int watch = inotify_add_watch(inotify_, pathname.c_str(), kWatchMask);
+  if (watch < 0) {
+    std::cerr << pathname << ": " << strerror(errno) << std::endl;
+    return false;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    directory_ = pathname;
+    watch_ = watch;
+  }
+
+  pathname_ = pathname;
+  kWatchers.insert(this);
+
+  // the thread is created on the first watch
+  if (!thread_.joinable()) {
+    thread_ = std::thread(&DirectoryWatcher::Run, this);
+  }
+
+  return true;
+#else
+  return false;
+#endif
+}
+
+void DirectoryWatcher::Stop ()
+{
+  kWatchers.erase(this);
+  pathname_.clear();
+
+#ifdef __linux__
+  // events of the removed watch are dropped in the worker
+  int watch = watch_.exchange(-1);
+  if (watch >= 0) inotify_rm_watch(inotify_, watch);
+#endif
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  results_.clear();
+  reset_ = false;
+  ready_ = false;
+}
+
+size_t DirectoryWatcher::Take (std::vector<DirectoryChange>* changes,
+                               bool* reset)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  size_t count = results_.size();
+  if (count) {
+    if (changes->empty()) {
+      changes->swap(results_);
+    } else {
+      changes->insert(changes->end(), results_.begin(), results_.end());
+      results_.clear();
+    }
+  }
+
+  if (reset) *reset = reset_;
+  reset_ = false;
+
+  return count;
+}
+
+bool DirectoryWatcher::ProcessChanges ()
+{
+  if (kWatchers.empty()) return false;
+
+  std::vector<DirectoryWatcher*> changed;
+  std::set<DirectoryWatcher*>::iterator it;
+  for (it = kWatchers.begin(); it != kWatchers.end(); it++) {
+    if ((*it)->ready_.exchange(false)) changed.push_back(*it);
+  }
+
+  // a callee may stop or destroy other watchers
+  for (size_t i = 0; i < changed.size(); i++) {
+    if (kWatchers.count(changed[i])) changed[i]->changed_.Invoke();
+  }
+
+  return !changed.empty();
+}
+
+void DirectoryWatcher::Run ()
+{
+#ifdef __linux__
+  struct pollfd fds[2];
+  fds[0].fd = inotify_;
+  fds[0].events = POLLIN;
+  fds[1].fd = wakeup_;
+  fds[1].events = POLLIN;
+
+  uint64_t last_publish = 0;
+  uint64_t elapsed = 0;
+  int timeout = -1;
+  int ret = 0;
+
+  while (true) {
+
+    // sleep until an event arrives, or the end of the publish interval
+    // if a batch is pending
+    timeout = -1;
+    if ((!batch_.empty()) || batch_reset_) {
+      elapsed = (Timer::GetMicroSeconds() - last_publish) / 1000;
+      timeout = elapsed >= (uint64_t) kPublishInterval ?
+          0 : (int) (kPublishInterval - elapsed);
+    }
+
+    ret = poll(fds, 2, timeout);
+    if ((ret < 0) && (errno != EINTR)) {
+      std::cerr << "Directory watcher: " << strerror(errno) << std::endl;
+      break;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (stop_) break;
+    }
+
+    if ((ret > 0) && (fds[0].revents & POLLIN)) {
+      if (!ReadEvents()) break;
+    }
+
+    if (((!batch_.empty()) || batch_reset_)
+        && ((Timer::GetMicroSeconds() - last_publish)
+            >= (uint64_t) kPublishInterval * 1000)) {
+      Publish();
+      last_publish = Timer::GetMicroSeconds();
+    }
+
+  }
+#endif
+}
+
+bool DirectoryWatcher::ReadEvents ()
+{
+#ifdef __linux__
+  char buffer[4096]
+  __attribute__ ((aligned(__alignof__(struct inotify_event))));
+
+  const struct inotify_event* event = 0;
+  ssize_t length = 0;
+  int watch = watch_;
+
+  // drop the changes of a previous watch
+  if (watch != batch_watch_) {
+    batch_.clear();
+    index_.clear();
+    moves_.clear();
+    batch_reset_ = false;
+    batch_watch_ = watch;
+  }
+
+  while (true) {
+
+    length = read(inotify_, buffer, sizeof(buffer));
+    if (length < 0) {
+      if (errno == EINTR) continue;
+      if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) break;
+
+      std::cerr << "inotify: " << strerror(errno) << std::endl;
+      return false;
+    }
+    if (length == 0) break;
+
+    for (char* p = buffer; p < buffer + length;
+        p += sizeof(struct inotify_event) + event->len) {
+
+      event = (const struct inotify_event*) p;
+
+      // events are lost, list the directory again
+      if (event->mask & IN_Q_OVERFLOW) {
+        batch_reset_ = true;
+        continue;
+      }
+
+      if (event->wd != watch) continue;
+
+      // the directory itself is gone
+      if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED
+          | IN_UNMOUNT)) {
+        batch_reset_ = true;
+        continue;
+      }
+
+      if (event->len == 0) continue;
+
+      if (event->mask & IN_CREATE) {
+        AddChange(DirectoryChange::Created, event->name, 0);
+      } else if (event->mask & IN_DELETE) {
+        AddChange(DirectoryChange::Removed, event->name, 0);
+      } else if (event->mask & IN_MOVED_FROM) {
+        AddChange(DirectoryChange::Removed, event->name, event->cookie);
+      } else if (event->mask & IN_MOVED_TO) {
+        AddChange(DirectoryChange::Created, event->name, event->cookie);
+      } else {
+        AddChange(DirectoryChange::Modified, event->name, 0);
+      }
+    }
+
+  }
+#endif
+
+  return true;
+}
+
+void DirectoryWatcher::AddChange (DirectoryChange::Type type,
+                                  const std::string& name,
+                                  uint32_t cookie)
+{
+  std::unordered_map<std::string, size_t>::iterator it;
+
+  if (type == DirectoryChange::Removed) {
+
+    DirectoryChange change;
+    change.type = type;
+    change.name = name;
+    batch_.push_back(change);
+
+    // a change after this one is of another file with the name
+    index_.erase(name);
+    if (cookie) moves_[cookie] = batch_.size() - 1;
+
+    return;
+  }
+
+  // a file moved in the directory is renamed
+  if (cookie) {
+    std::unordered_map<uint32_t, size_t>::iterator moved = moves_.find(cookie);
+    if (moved != moves_.end()) {
+      batch_[moved->second].type = DirectoryChange::Renamed;
+      batch_[moved->second].entry.name = name;
+      index_[name] = moved->second;
+      moves_.erase(moved);
+      return;
+    }
+  }
+
+  // the file changed again in this batch, the attributes are read once
+  // in Publish()
+  it = index_.find(name);
+  if (it != index_.end()) return;
+
+  DirectoryChange change;
+  change.type = type;
+  change.name = name;
+  change.entry.name = name;
+  batch_.push_back(change);
+  index_[name] = batch_.size() - 1;
+}
+
+void DirectoryWatcher::Publish ()
+{
+  std::string directory;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    directory = directory_;
+  }
+
+  // read the attributes out of the lock, a file removed in the meantime
+  // is dropped, the Removed event follows
+  size_t j = 0;
+  for (size_t i = 0; i < batch_.size(); i++) {
+
+    DirectoryChange& change = batch_[i];
+
+    if (change.type != DirectoryChange::Removed) {
+      if (!ReadDirectoryEntry(directory, change.entry.name, &change.entry)) {
+        if (change.type != DirectoryChange::Renamed) continue;
+        change.type = DirectoryChange::Removed;
+        change.entry = DirectoryEntry();
+      }
+    }
+
+    if (j != i) batch_[j] = change;
+    j++;
+  }
+  batch_.resize(j);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (batch_watch_ == watch_) {
+      if (batch_reset_) {
+        // the directory is listed again, changes before are useless
+        results_.clear();
+        reset_ = true;
+      } else {
+        results_.insert(results_.end(), batch_.begin(), batch_.end());
+      }
+      ready_ = true;
+    }
+  }
+
+  batch_.clear();
+  index_.clear();
+  moves_.clear();
+  batch_reset_ = false;
+
+  AbstractWindow::WakeUpMainWindow();
+}
+
+}
@@ -37,7 +37,10 @@ namespace BlendInt {
 namespace fs = boost::filesystem;
 
 FileBrowser::FileBrowser ()
-    : AbstractItemView(), history_index_(0), highlight_index_(-1)
+    : AbstractItemView(),
+      history_index_(0),
+      last_search_time_(0),
+      highlight_index_(-1)
 {
   set_size(400, 300);
 
@@ -153,6 +156,26 @@ bool FileBrowser::GoForward ()
   return false;
 }
 
+void FileBrowser::SetSortColumn (int column,
+                                 SortFilterProxyModel::SortOrder order)
+{
+  proxy_->SetSortColumn(column, order);
+}
+
+void FileBrowser::SetFilter (const String& pattern)
+{
+  proxy_->SetFilter(pattern);
+}
+
+bool FileBrowser::SelectByPrefix (const String& prefix)
+{
+  int row = proxy_->FindPrefix(prefix);
+  if (row < 0) return false;
+
+  SelectRow(row);
+  return true;
+}
+
 bool FileBrowser::IsExpandX () const
 {
   return true;
@@ -174,7 +197,16 @@ void FileBrowser::SetModel (const RefPtr<AbstractItemModel>& model)
       model);
 
   if (fs_model) {
+    SortFilterProxyModel::SortOrder order = proxy_->sort_order();
+    int column = proxy_->sort_column();
+
     model_ = fs_model;
+    proxy_.reset(new FileSystemProxyModel(model_));
+    proxy_->SetSortColumn(column, order);
+    proxy_->layout_changed().connect(this, &FileBrowser::OnLayoutChanged);
+
+    highlight_index_ = -1;
+    RequestRedraw();
   } else {
     DBG_PRINT_MSG("Error: %s", "FileBrowser only accept FileSystemModel");
   }
@@ -184,7 +216,7 @@ ModelIndex FileBrowser::GetIndexAt (const Point& point) const
 {
   ModelIndex index;
 
-  int rows = model_->GetRowCount();
+  int rows = proxy_->GetRowCount();
 
   if (rows > 0) {
     int h = font_.height();	// the row height
@@ -199,13 +231,7 @@ ModelIndex FileBrowser::GetIndexAt (const Point& point) const
 
     i = i / h;
 
-    index = model_->GetRootIndex();
-
-    index = index.GetChildIndex(0, 0);
-    while ((i > 0) && index.valid()) {
-      index = index.GetDownIndex();
-      i--;
-    }
+    index = proxy_->GetIndex(i, 0);
   }
 
   return index;
@@ -225,9 +251,14 @@ Response FileBrowser::Draw (AbstractWindow* context)
   glBindVertexArray(vaos_[0]);
   glDrawArrays(GL_TRIANGLE_FAN, 0, outline_vertex_count(round_type()) + 2);
 
-  context->BeginPushStencil();	// inner stencil
-  glDrawArrays(GL_TRIANGLE_FAN, 0, outline_vertex_count(round_type()) + 2);
-  context->EndPushStencil();
+  // the stencil is needed only for round corners
+  if (rounded()) {
+    context->BeginPushStencil();	// inner stencil
+    glDrawArrays(GL_TRIANGLE_FAN, 0, outline_vertex_count(round_type()) + 2);
+    context->EndPushStencil();
+  } else {
+    context->PushClipRect(Rect(0, 0, size().width(), size().height()));
+  }
 
   AbstractWindow::shaders()->widget_simple_triangle_program()->use();
 
@@ -272,13 +303,14 @@ Response FileBrowser::Draw (AbstractWindow* context)
     i++;
   }
 
-  if (GetModel()) {
+  if (proxy_) {
 
-    ModelIndex index = GetModel()->GetRootIndex();
+    ModelIndex index = proxy_->GetRootIndex();
     index = index.GetChildIndex(0, 0);
 
     Rect rect(0, size().height() - h, size().width(), h);
-    while (index.valid()) {
+    // stop at the bottom, a large directory may have many more rows
+    while (index.valid() && (rect.y() + h > 0)) {
       index.GetRawData()->DrawInRect(
           rect, AlignLeft | AlignVerticalCenter | AlignBaseline | AlignJustify,
           AbstractWindow::theme()->regular().text.data());
@@ -288,12 +320,16 @@ Response FileBrowser::Draw (AbstractWindow* context)
 
   }
 
-  AbstractWindow::shaders()->widget_inner_program()->use();
+  if (rounded()) {
+    AbstractWindow::shaders()->widget_inner_program()->use();
 
-  context->BeginPopStencil();	// pop inner stencil
-  glBindVertexArray(vaos_[0]);
-  glDrawArrays(GL_TRIANGLE_FAN, 0, outline_vertex_count(round_type()) + 2);
-  context->EndPopStencil();
+    context->BeginPopStencil();	// pop inner stencil
+    glBindVertexArray(vaos_[0]);
+    glDrawArrays(GL_TRIANGLE_FAN, 0, outline_vertex_count(round_type()) + 2);
+    context->EndPopStencil();
+  } else {
+    context->PopClipRect();
+  }
 
   return Finish;
 }
@@ -345,7 +381,7 @@ Response FileBrowser::PerformMousePress (AbstractWindow* context)
 {
   ModelIndex index;
 
-  int rows = model_->GetRowCount();
+  int rows = proxy_->GetRowCount();
 
   if (rows > 0) {
     int h = font_.height();	// the row height
@@ -360,11 +396,7 @@ Response FileBrowser::PerformMousePress (AbstractWindow* context)
     i = i / h;
     highlight_index_ = i;
 
-    index = model_->GetRootIndex().GetChildIndex();
-    while ((i > 0) && index.valid()) {
-      index = index.GetDownIndex();
-      i--;
-    }
+    index = proxy_->GetIndex(i, 0);
 
     if (!index.valid()) {
       highlight_index_ = -1;
@@ -390,6 +422,54 @@ Response FileBrowser::PerformMousePress (AbstractWindow* context)
   return Finish;
 }
 
+void FileBrowser::OnLayoutChanged ()
+{
+  // the highlighted row may be moved, select it again by the name
+  if (!file_selected_.empty()) {
+    highlight_index_ = proxy_->FindPrefix(file_selected_);
+    if (highlight_index_ >= 0) {
+      Text* t = dynamic_cast<Text*>(proxy_->GetIndex(highlight_index_, 0).GetData().get());
+      if ((t == 0) || (t->text() != file_selected_)) highlight_index_ = -1;
+    }
+  } else {
+    highlight_index_ = -1;
+  }
+
+  RequestRedraw();
+}
+
+void FileBrowser::SelectRow (int row)
+{
+  ModelIndex index = proxy_->GetIndex(row, 0);
+
+  if (index.valid()) {
+    highlight_index_ = row;
+    Text* t = dynamic_cast<Text*>(index.GetData().get());
+    file_selected_ = t ? t->text() : String();
+  } else {
+    highlight_index_ = -1;
+    file_selected_.clear();
+  }
+
+  RequestRedraw();
+  selected_.Invoke();
+}
+
+Response FileBrowser::PerformKeyPress (AbstractWindow* context)
+{
+  if (context->GetTextInput().empty()) return Ignore;
+
+  // a pause starts a new search
+  uint64_t now = Timer::GetMicroSeconds();
+  if ((now - last_search_time_) > 1000000) search_.clear();
+  last_search_time_ = now;
+
+  search_.append(context->GetTextInput());
+  SelectByPrefix(search_);
+
+  return Finish;
+}
+
 void FileBrowser::InitializeFileBrowserOnce ()
 {
   GLfloat row_height = (GLfloat) font_.height();
@@ -437,6 +517,9 @@ void FileBrowser::InitializeFileBrowserOnce ()
   buffer_.reset();
 
   model_.reset(new FileSystemModel);
+  proxy_.reset(new FileSystemProxyModel(model_));
+  proxy_->SetSortColumn(FileSystemModel::NameColumn);
+  proxy_->layout_changed().connect(this, &FileBrowser::OnLayoutChanged);
 
   // Load(getenv("PWD"));
 }
@@ -21,7 +21,11 @@
  * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
  */
 
+#include <ctime>
+#include <cstdio>
 #include <iostream>
+#include <algorithm>
+#include <unordered_set>
 
 #include <boost/filesystem.hpp>
 
@@ -30,17 +34,151 @@
 
 namespace BlendInt {
 
+/**
+ * @brief A cell of file attributes formatted on the first draw
+ */
+class FileAttribute: public AbstractForm
+{
+ public:
+
+  enum Type
+  {
+    LastWriteTime, FileType, FileSize, Permissions
+  };
+
+  FileAttribute (Type type, const DirectoryEntry& entry)
+  : AbstractForm(), type_(type), value_(0), regular_(entry.regular)
+  {
+    switch (type_) {
+      case LastWriteTime:
+        value_ = (uintmax_t) entry.last_write_time;
+        break;
+      case FileType:
+        value_ = entry.directory ? 1 : 0;
+        break;
+      case FileSize:
+        value_ = entry.size;
+        break;
+      case Permissions:
+        value_ = entry.permissions;
+        break;
+    }
+  }
+
+  virtual ~FileAttribute ()
+  {
+  }
+
+  virtual void Draw (int x,
+                     int y,
+                     const float* color_ptr = Color(Palette::Black).data(),
+                     short gamma = 0,
+                     float rotate = 0.f,
+                     float scale_x = 1.f,
+                     float scale_y = 1.f) const
+  {
+    GetText()->Draw(x, y, color_ptr, gamma, rotate, scale_x, scale_y);
+  }
+
+  virtual void DrawInRect (const Rect& rect,
+                           int align,
+                           const float* color_ptr =
+                           Color(Palette::White).data(),
+                           short gamma = 0,
+                           float rotate = 0.f,
+                           bool scale = false) const
+  {
+    GetText()->DrawInRect(rect, align, color_ptr, gamma, rotate, scale);
+  }
+
+ protected:
+
+  virtual void PerformSizeUpdate (int width, int height)
+  {
+    set_size(width, height);
+  }
+
+ private:
+
+  const Text* GetText () const
+  {
+    if (text_) return text_.get();
+
+    char buf[32];
+
+    switch (type_) {
+
+      case LastWriteTime: {
+        std::time_t time = (std::time_t) value_;
+        std::string time_str = std::asctime(std::localtime(&time));
+        time_str.erase(time_str.size() - 1, 1);	// remove the '\n' char
+        text_.reset(new Text(time_str));
+        break;
+      }
+
+      case FileType: {
+        text_.reset(new Text(value_ ? "d" : "-"));
+        break;
+      }
+
+      case FileSize: {
+        if (regular_) {
+          snprintf(buf, 32, "%ju", value_);
+        } else {
+          snprintf(buf, 32, " ");
+        }
+        text_.reset(new Text(buf));
+        break;
+      }
+
+      case Permissions: {
+        snprintf(buf, 32, "%o", (unsigned int) value_);
+        text_.reset(new Text(buf));
+        break;
+      }
+    }
+
+    const_cast<FileAttribute*>(this)->set_size(text_->size());
+
+    return text_.get();
+  }
+
+  Type type_;
+
+  uintmax_t value_;
+
+  bool regular_;
+
+  mutable RefPtr<Text> text_;
+};
+
+// the attributes shown in the columns after the name
+static const FileAttribute::Type kAttributeColumns[] = {
+    FileAttribute::LastWriteTime,
+    FileAttribute::FileType,
+    FileAttribute::FileSize,
+    FileAttribute::Permissions };
+
 FileSystemModel::FileSystemModel ()
     : AbstractItemModel(), rows_(0), columns_(DefaultColumns),// temporary value
-      root_(0)
+      root_(0),
+      last_(0),
+      loading_(false)
 {
   root_ = new ModelNode;
   RefPtr<Text> data(new Text("Root Node"));
   root_->data = data;
+
+  timer_.reset(new Timer);
+  timer_->SetInterval(kLoadingInterval);
+  timer_->timeout().connect(this, &FileSystemModel::OnCheckLoading);
+
+  watcher_.changed().connect(this, &FileSystemModel::OnDirectoryChanged);
 }
 
 FileSystemModel::~FileSystemModel ()
 {
+  timer_->Stop();
   Clear();
   delete root_;
 }
@@ -48,104 +186,54 @@ FileSystemModel::~FileSystemModel ()
 bool FileSystemModel::Load (const std::string& pathname)
 {
   namespace fs = boost::filesystem;
-  bool is_path = false;
-
-  fs::path path = fs::path(pathname);
 
-  fs::file_status status;
-  char buf[32];
-
-  try {
-    if (fs::exists(path) && fs::is_directory(path)) {
-
-      Clear();
-      DBG_ASSERT(root_->child == 0);
-
-      ModelNode* first = 0;
-      ModelNode* tmp = 0;
-
-      int i = 0, j = 0;
-      fs::directory_iterator it(path);
-      fs::directory_iterator it_end;
-      while (it != it_end) {
-
-        j = 0;
+  boost::system::error_code ec;
+  fs::path path(pathname);
 
-        status = fs::status(it->path());
-
-        if (first == 0) {
-          first = new ModelNode;
-          first->parent = root_;
-          root_->child = first;
-          DBG_ASSERT(first->up == 0);
-        } else {
-          first->down = new ModelNode;
-          first->down->up = first;
-          first = first->down;
-        }
-
-        DBG_ASSERT(first->left == 0);
-
-        first->data = RefPtr<Text>(new Text(it->path().filename().native()));
+  // only the path itself is checked here, the entries are listed in
+  // the scanner thread
+  if (!fs::is_directory(path, ec)) {
+    if (ec) std::cerr << pathname << ": " << ec.message() << std::endl;
+    return false;
+  }
 
-        j++;
+  Clear();
+  DBG_ASSERT(root_->child == 0);
 
-        tmp = first;
+  pathname_ = pathname;
+  columns_ = DefaultColumns;
 
-        std::time_t time = fs::last_write_time(it->path());
-        std::string time_str = std::asctime(std::localtime(&time));
-        time_str.erase(time_str.size() - 1, 1);	// remove the '\n' char
-        tmp->right = new ModelNode;
-        tmp->right->data = RefPtr<Text>(new Text(time_str));
-        tmp->right->left = tmp->right;
-        tmp = tmp->right;
-        j++;
-
-        tmp->right = new ModelNode;
-        tmp->right->data = RefPtr<Text>(
-            new Text(fs::is_directory(it->path()) ? "d" : "-"));
-        tmp->right->left = tmp->right;
-        tmp = tmp->right;
-        j++;
-
-        if (fs::is_regular(it->path())) {
-          snprintf(buf, 32, "%ld", fs::file_size(it->path()));
-        } else {
-          snprintf(buf, 32, " ");
-        }
-        tmp->right = new ModelNode;
-        tmp->right->data = RefPtr<Text>(new Text(buf));
-        tmp->right->left = tmp->right;
-        tmp = tmp->right;
-        j++;
-
-        snprintf(buf, 32, "%o", status.permissions());
-        tmp->right = new ModelNode;
-        tmp->right->data = RefPtr<Text>(new Text(buf));
-        tmp->right->left = tmp->right;
-        j++;
-
-        it++;
-        i++;
-      }
+  // watch before listing, the changes in the listing are applied when
+  // it's finished
+  watcher_.Watch(pathname);
 
-//				DBG_PRINT_MSG("ROWS: %d", i);
-      DBG_ASSERT(j == DefaultColumns);
+  scanner_.Start(pathname);
+  loading_ = true;
+  timer_->Start();
 
-      rows_ = i;
-      columns_ = DefaultColumns;
+  return true;
+}
 
-      is_path = true;
-    }
-  } catch (const fs::filesystem_error& ex) {
-    std::cerr << ex.what() << std::endl;
+void FileSystemModel::Cancel ()
+{
+  if (loading_) {
+    scanner_.Cancel();
+    timer_->Stop();
+    loading_ = false;
   }
+}
 
-  return is_path;
+const DirectoryEntry& FileSystemModel::GetEntry (int row) const
+{
+  DBG_ASSERT(row >= 0 && row < (int) entries_.size());
+  return entries_[row];
 }
 
 void FileSystemModel::Clear ()
 {
+  Cancel();
+  watcher_.Stop();
+
   if (root_->child) {
     ModelNode* node = root_->child;
     ModelNode* tmp = 0;
@@ -160,6 +248,11 @@ void FileSystemModel::Clear ()
     rows_ = 0;
     columns_ = DefaultColumns;
   }
+
+  last_ = 0;
+  entries_.clear();
+
+  cleared_.Invoke();
 }
 
 int FileSystemModel::GetRowCount (const ModelIndex& parent) const
@@ -243,6 +336,8 @@ bool FileSystemModel::RemoveColumns (int column,
     // remove all data
     rows_ = 0;
     columns_ = 0;
+    last_ = 0;
+    entries_.clear();
     return true;
   }
 
@@ -263,6 +358,8 @@ bool FileSystemModel::InsertRows (int row, int count, const ModelIndex& parent)
   DBG_ASSERT(count > 0);
   DBG_ASSERT(row >= 0);
 
+  size_t position = std::min((size_t) row, entries_.size());
+
   if (columns_ == 0) {
     columns_ = DefaultColumns;
   }
@@ -339,6 +436,9 @@ bool FileSystemModel::InsertRows (int row, int count, const ModelIndex& parent)
     }
   }
 
+  entries_.insert(entries_.begin() + position, count, DirectoryEntry());
+  last_ = 0;
+
   rows_ += count;
   return true;
 }
@@ -353,6 +453,7 @@ bool FileSystemModel::RemoveRows (int row, int count, const ModelIndex& parent)
   ModelNode* node = get_index_node(parent);
   if (node->child == 0) return false;
 
+  size_t position = (size_t) row;
   node = node->child;
 
   while (node->down && (row > 0)) {
@@ -394,6 +495,12 @@ bool FileSystemModel::RemoveRows (int row, int count, const ModelIndex& parent)
       }
     }
 
+    if (position < entries_.size()) {
+      entries_.erase(entries_.begin() + position,
+                     entries_.begin() + std::min(position + i, entries_.size()));
+    }
+    last_ = 0;
+
     rows_ -= i;
     return true;
   }
@@ -492,6 +599,273 @@ void FileSystemModel::PrintRow (ModelNode* first)
 
 #endif	// DEBUG
 
+void FileSystemModel::OnCheckLoading ()
+{
+  std::vector<DirectoryEntry> entries;
+  bool finished = false;
+
+  scanner_.Take(&entries, &finished);
+
+  if (!entries.empty()) {
+
+    int first = rows_;
+
+    for (size_t i = 0; i < entries.size(); i++) {
+      AppendRow(entries[i]);
+    }
+
+    rows_loaded_.Invoke(first, (int) entries.size());
+  }
+
+  if (finished) {
+    timer_->Stop();
+    loading_ = false;
+    load_finished_.Invoke();
+
+    ApplyChanges();
+  }
+}
+
+void FileSystemModel::OnDirectoryChanged ()
+{
+  // the changes in listing are applied when it's finished
+  if (loading_) return;
+
+  ApplyChanges();
+}
+
+void FileSystemModel::ApplyChanges ()
+{
+  std::vector<DirectoryChange> changes;
+  bool reset = false;
+
+  watcher_.Take(&changes, &reset);
+
+  ApplyChanges(changes, reset);
+}
+
+void FileSystemModel::ApplyChanges (const std::vector<DirectoryChange>& changes,
+                                    bool reset)
+{
+  size_t count = 0;
+  for (size_t i = 0; i < changes.size(); i++) {
+    if (changes[i].type != DirectoryChange::Created) count++;
+  }
+
+  // each removed or changed row costs O(n) in the views and proxies, a
+  // large burst is cheaper to list again
+  if (reset || (count > kMaxRowChanges)) {
+    std::string pathname = pathname_;
+    if (!Load(pathname)) Clear();
+    return;
+  }
+
+  // the names of all rows, to skip searching the rows for many new files
+  std::unordered_set<std::string> names;
+  bool indexed = (changes.size() - count) > kMaxRowChanges;
+  if (indexed) {
+    for (size_t i = 0; i < entries_.size(); i++) {
+      names.insert(entries_[i].name);
+    }
+  }
+
+  ModelNode* node = 0;
+  ModelNode* other = 0;
+  int row = 0;
+  int other_row = 0;
+
+  // new rows are appended to the tail, rows_loaded() is fired once
+  // before other changes touch them
+  int first = rows_;
+
+  for (size_t i = 0; i < changes.size(); i++) {
+
+    const DirectoryChange& change = changes[i];
+
+    if (change.type == DirectoryChange::Created) {
+      if (indexed && (names.count(change.entry.name) == 0)) {
+        AppendRow(change.entry);
+        names.insert(change.entry.name);
+        continue;
+      }
+    }
+
+    // the old name if removed or renamed
+    node = FindRow(change.name, &row);
+
+    if (node == 0) {
+      if (change.type == DirectoryChange::Removed) continue;
+
+      // renamed from a file not listed, e.g. a temporary file created
+      // and renamed in one batch when an editor saves, the file of the
+      // new name is replaced if listed
+      other = 0;
+      if (change.type == DirectoryChange::Renamed) {
+        other = FindRow(change.entry.name, &other_row);
+      }
+
+      if (other == 0) {
+        AppendRow(change.entry);
+        if (indexed) names.insert(change.entry.name);
+        continue;
+      }
+
+      if (first < rows_) {
+        rows_loaded_.Invoke(first, rows_ - first);
+        first = rows_;
+      }
+
+      UpdateRow(other, other_row, change.entry);
+      continue;
+    }
+
+    if (first < rows_) {
+      rows_loaded_.Invoke(first, rows_ - first);
+      first = rows_;
+    }
+
+    switch (change.type) {
+
+      case DirectoryChange::Created:
+      case DirectoryChange::Modified: {
+        UpdateRow(node, row, change.entry);
+        break;
+      }
+
+      case DirectoryChange::Removed: {
+        RemoveRow(node, row);
+        if (indexed) names.erase(change.name);
+        break;
+      }
+
+      case DirectoryChange::Renamed: {
+        // the file replaced by the renamed one
+        other = FindRow(change.entry.name, &other_row);
+        if (other && (other != node)) {
+          RemoveRow(other, other_row);
+          if (other_row < row) row--;
+        }
+
+        UpdateRow(node, row, change.entry);
+        if (indexed) {
+          names.erase(change.name);
+          names.insert(change.entry.name);
+        }
+        break;
+      }
+
+    }
+
+  }
+
+  if (first < rows_) {
+    rows_loaded_.Invoke(first, rows_ - first);
+  }
+}
+
+ModelNode* FileSystemModel::CreateRow (const DirectoryEntry& entry)
+{
+  ModelNode* first = new ModelNode;
+  first->data = RefPtr<Text>(new Text(entry.name));
+
+  ModelNode* tmp = first;
+  for (int j = 1; j < DefaultColumns; j++) {
+    tmp->right = new ModelNode;
+    tmp->right->data = RefPtr<AbstractForm>(
+        new FileAttribute(kAttributeColumns[j - 1], entry));
+    tmp->right->left = tmp;
+    tmp = tmp->right;
+  }
+
+  return first;
+}
+
+void FileSystemModel::AppendRow (const DirectoryEntry& entry)
+{
+  if (last_ == 0) {
+    last_ = root_->child;
+    while (last_ && last_->down) {
+      last_ = last_->down;
+    }
+  }
+
+  ModelNode* row = CreateRow(entry);
+
+  if (last_ == 0) {
+    root_->child = row;
+    row->parent = root_;
+  } else {
+    last_->down = row;
+    row->up = last_;
+  }
+  last_ = row;
+
+  entries_.push_back(entry);
+  rows_++;
+}
+
+ModelNode* FileSystemModel::FindRow (const std::string& name, int* row) const
+{
+  ModelNode* node = root_->child;
+
+  for (size_t i = 0; node && (i < entries_.size()); i++) {
+    if (entries_[i].name == name) {
+      *row = (int) i;
+      return node;
+    }
+    node = node->down;
+  }
+
+  return 0;
+}
+
+void FileSystemModel::RemoveRow (ModelNode* node, int row)
+{
+  DBG_ASSERT(node && node->left == 0);
+
+  ModelNode* up = node->up;
+  ModelNode* down = node->down;
+
+  if (up) {
+    up->down = down;
+  } else {
+    root_->child = down;
+    if (down) down->parent = root_;
+  }
+  if (down) down->up = up;
+
+  if (last_ == node) last_ = up;
+
+  DestroyRow(node);
+  entries_.erase(entries_.begin() + row);
+  rows_--;
+
+  rows_removed_.Invoke(row, 1);
+}
+
+void FileSystemModel::UpdateRow (ModelNode* node,
+                                 int row,
+                                 const DirectoryEntry& entry)
+{
+  DBG_ASSERT(node && node->left == 0);
+
+  // keep the text of the name if it's not renamed
+  if (entries_[row].name != entry.name) {
+    node->data = RefPtr<Text>(new Text(entry.name));
+  }
+
+  ModelNode* tmp = node->right;
+  for (int j = 1; tmp && (j < DefaultColumns); j++) {
+    tmp->data = RefPtr<AbstractForm>(
+        new FileAttribute(kAttributeColumns[j - 1], entry));
+    tmp = tmp->right;
+  }
+
+  entries_[row] = entry;
+
+  row_changed_.Invoke(row);
+}
+
 void FileSystemModel::DestroyRow (ModelNode* node)
 {
   DBG_ASSERT(node);
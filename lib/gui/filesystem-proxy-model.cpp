@@ -0,0 +1,104 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free software:
+ * you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is distributed in
+ * the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+#include <blendint/gui/filesystem-proxy-model.hpp>
+
+namespace BlendInt {
+
+FileSystemProxyModel::FileSystemProxyModel (const RefPtr<FileSystemModel>& model)
+: SortFilterProxyModel(),
+  model_(model),
+  folders_first_(true)
+{
+  model_->rows_loaded().connect(this, &FileSystemProxyModel::OnRowsLoaded);
+  model_->rows_removed().connect(this, &FileSystemProxyModel::OnRowsRemoved);
+  model_->row_changed().connect(this, &FileSystemProxyModel::OnRowChanged);
+  model_->cleared().connect(this, &FileSystemProxyModel::OnModelCleared);
+
+  SetSourceModel(model_);
+}
+
+FileSystemProxyModel::~FileSystemProxyModel ()
+{
+}
+
+void FileSystemProxyModel::SetFoldersFirst (bool folders_first)
+{
+  if (folders_first_ == folders_first) return;
+
+  folders_first_ = folders_first;
+  Invalidate();
+}
+
+bool FileSystemProxyModel::LessThan (int source_left, int source_right) const
+{
+  const DirectoryEntry& left = model_->GetEntry(source_left);
+  const DirectoryEntry& right = model_->GetEntry(source_right);
+
+  switch (sort_column()) {
+
+    case FileSystemModel::LastWriteTimeColumn:
+      return left.last_write_time < right.last_write_time;
+
+    case FileSystemModel::TypeColumn:
+      return left.directory > right.directory;
+
+    case FileSystemModel::SizeColumn:
+      return left.size < right.size;
+
+    case FileSystemModel::PermissionsColumn:
+      return left.permissions < right.permissions;
+
+    default:
+      return SortFilterProxyModel::LessThan(source_left, source_right);
+  }
+}
+
+int FileSystemProxyModel::GetSortGroup (int source_row) const
+{
+  if (folders_first_ && model_->GetEntry(source_row).directory) return 0;
+
+  return folders_first_ ? 1 : 0;
+}
+
+void FileSystemProxyModel::OnRowsLoaded (int first, int count)
+{
+  InsertSourceRows(first, count);
+}
+
+void FileSystemProxyModel::OnRowsRemoved (int first, int count)
+{
+  RemoveSourceRows(first, count);
+}
+
+void FileSystemProxyModel::OnRowChanged (int row)
+{
+  UpdateSourceRow(row);
+}
+
+void FileSystemProxyModel::OnModelCleared ()
+{
+  Invalidate();
+}
+
+}
@@ -24,8 +24,11 @@
 #include <cassert>
 
 #include <blendint/core/types.hpp>
+#include <blendint/core/timer.hpp>
 #include <blendint/opengl/opengl.hpp>
+#include <blendint/font/fc-config.hpp>
 #include <blendint/gui/font-cache.hpp>
+#include <blendint/gui/abstract-window.hpp>
 
 namespace BlendInt {
 
@@ -135,26 +138,122 @@ namespace BlendInt {
 
     FcChar32 FontCache::kDefaultFontHash = 0;
 
+    bool FontCache::kAsyncRasterization = true;
+
+    size_t FontCache::kAtlasMemoryBudget = TextureAtlas::kDefaultMemoryBudget;
+
+    GlyphRasterizer* FontCache::kRasterizer = 0;
+
+    unsigned long FontCache::kClock = 0;
+
+    size_t FontCache::kMemoryBudget = 64 * 1024 * 1024;
+
+    std::map<FcChar32, std::vector<FontCache::MatchedPattern> > FontCache::kMatchDB;
+
+    size_t FontCache::kMatchCount = 0;
+
     RefPtr<FontCache> FontCache::Create (const Fc::Pattern& pattern)
     {
-        if(kCacheDB.size() == kMaxCacheSize) {
-            DBG_PRINT_MSG("Warning: %s", "max font cache reached, use default font");
-            return kCacheDB[kDefaultFontHash];
-        }
-
         RefPtr<FontCache> cache;
-        
+
     	FcChar32 hash_id = pattern.hash();
-    	if(kCacheDB.count(hash_id)) {
-    		cache = kCacheDB[hash_id];
+    	std::map<FcChar32, RefPtr<FontCache> >::iterator it = kCacheDB.find(hash_id);
+    	if(it != kCacheDB.end()) {
+    		cache = it->second;
     	} else {
     		cache.reset(new FontCache(pattern));
     		kCacheDB[hash_id] = cache;
     	}
 
+    	cache->last_used_ = ++kClock;
+    	Trim(cache.get());
+
     	return cache;
     }
 
+    Fc::Pattern FontCache::Match (const Fc::Pattern& pattern, FcResult* result)
+    {
+    	FcChar32 hash_id = pattern.hash();
+
+    	std::vector<MatchedPattern>& bucket = kMatchDB[hash_id];
+    	for (size_t i = 0; i < bucket.size(); i++) {
+    		if (FcPatternEqual(bucket[i].request.pattern(), pattern.pattern())) {
+    			if (result) *result = bucket[i].result;
+    			return bucket[i].match;
+    		}
+    	}
+
+    	// substitution changes the pattern, keep the request as it is
+    	Fc::Pattern p = Fc::Pattern::duplicate(pattern);
+    	Fc::Config::substitute(0, p, FcMatchPattern);
+    	p.default_substitute();
+
+    	MatchedPattern matched;
+    	matched.request = Fc::Pattern::duplicate(pattern);
+    	matched.match = Fc::Config::match(0, p, &matched.result);
+
+    	if (result) *result = matched.result;
+
+    	if (kMatchCount >= kMaxMatchCount) {
+    		kMatchDB.clear();
+    		kMatchCount = 0;
+    	}
+
+    	kMatchDB[hash_id].push_back(matched);
+    	kMatchCount++;
+
+    	return matched.match;
+    }
+
+    void FontCache::SetMemoryBudget (size_t bytes)
+    {
+    	kMemoryBudget = bytes;
+    	Trim(0);
+    }
+
+    size_t FontCache::GetTotalMemoryUsage ()
+    {
+    	size_t total = 0;
+
+    	std::map<FcChar32, RefPtr<FontCache> >::iterator it;
+    	for (it = kCacheDB.begin(); it != kCacheDB.end(); it++) {
+    		total += it->second->memory_usage();
+    	}
+
+    	return total;
+    }
+
+    void FontCache::Trim (const FontCache* keep)
+    {
+    	size_t total = GetTotalMemoryUsage();
+    	std::map<FcChar32, RefPtr<FontCache> >::iterator it;
+    	std::map<FcChar32, RefPtr<FontCache> >::iterator lru;
+
+    	while (total > kMemoryBudget) {
+
+    		lru = kCacheDB.end();
+
+    		for (it = kCacheDB.begin(); it != kCacheDB.end(); it++) {
+
+    			// a cache referenced by a Font is still in use
+    			if (it->first == kDefaultFontHash ||
+    					it->second.get() == keep ||
+    					it->second->reference_count() > 1) continue;
+
+    			if (lru == kCacheDB.end() ||
+    					it->second->last_used_ < lru->second->last_used_) {
+    				lru = it;
+    			}
+    		}
+
+    		if (lru == kCacheDB.end()) break;
+
+    		DBG_PRINT_MSG("release font cache %u", lru->first);
+    		total -= lru->second->memory_usage();
+    		kCacheDB.erase(lru);
+    	}
+    }
+
     bool FontCache::Release (const Fc::Pattern& pattern)
     {
     	FcChar32 hash_id = pattern.hash();
@@ -169,12 +268,82 @@ namespace BlendInt {
 
     void FontCache::ReleaseAll ()
     {
+        // stop the workers before the caches they fill are destroyed
+        delete kRasterizer;
+        kRasterizer = 0;
+
         kDefaultFontHash = 0;
     	kCacheDB.clear();
+
+    	kMatchDB.clear();
+    	kMatchCount = 0;
+    }
+
+    void FontCache::SetAsyncRasterization (bool async)
+    {
+        kAsyncRasterization = async;
+    }
+
+    void FontCache::SetAtlasMemoryBudget (size_t bytes)
+    {
+        kAtlasMemoryBudget = bytes;
+    }
+
+    bool FontCache::UploadPendingGlyphs ()
+    {
+        if (kRasterizer == 0) return false;
+
+        std::vector<RasterizedGlyph> results;
+        if (kRasterizer->Take(&results) == 0) return false;
+
+        // results of the same font are usually adjacent, commit each
+        // atlas once after all its glyphs are copied
+        std::set<FontCache*> touched;
+        std::map<FcChar32, RefPtr<FontCache> >::iterator it;
+        FontCache* cache = 0;
+        FcChar32 font = 0;
+
+        for (size_t i = 0; i < results.size(); i++) {
+
+            RasterizedGlyph& result = results[i];
+
+            if (cache == 0 || font != result.font) {
+                font = result.font;
+                it = kCacheDB.find(font);
+                cache = (it == kCacheDB.end()) ? 0 : it->second.get();
+            }
+
+            // the font was released before the glyph arrived
+            if (cache == 0) continue;
+
+            cache->pending_.erase(result.charcode);
+            if (cache->glyph_data_.find(result.charcode)) continue;
+
+            cache->Store(result.charcode, result.glyph,
+                    result.bitmap.empty() ? 0 : &result.bitmap[0], 0);
+            cache->stats_.misses++;
+            cache->stats_.rasterization_time += result.time;
+
+            touched.insert(cache);
+        }
+
+        for (std::set<FontCache*>::iterator p = touched.begin(); p != touched.end(); p++) {
+            (*p)->texture_atlas_->Commit();
+            (*p)->generation_++;
+        }
+
+        TextureAtlas::reset();
+
+        return !touched.empty();
     }
 
     FontCache::FontCache (const Fc::Pattern& pattern)
-    : pattern_(pattern)
+    : pattern_(pattern),
+      size_(0.0),
+      dpi_(0.0),
+      embolden_(false),
+      generation_(0),
+      last_used_(0)
     {
         FcChar8* file = 0;
         double size;
@@ -198,12 +367,32 @@ namespace BlendInt {
 			exit(EXIT_FAILURE);
     	}
 
+    	file_ = (const char*)(file);
+    	size_ = size;
+    	dpi_ = dpi;
+
+    	FcBool embolden = FcFalse;
+    	pattern_.get_bool(FC_EMBOLDEN, 0, &embolden);
+    	embolden_ = embolden;
+
     	library_.Init();
     	face_.New(library_, (const char*)(file));
     	face_.set_char_size((unsigned long)size << 6, 0, (unsigned int)dpi, 0);
 
+    	// pages hold at least 4 lines for large fonts
+    	GLsizei page_size = kAtlasPageSize;
+    	while (page_size < 4 * (face_.face()->size->metrics.height >> 6)) {
+    		page_size *= 2;
+    	}
+
     	texture_atlas_.reset(new TextureAtlas);
-    	texture_atlas_->Generate(500, face_.face()->size->metrics.height >> 6);
+    	texture_atlas_->Generate(page_size, page_size, kAtlasMemoryBudget);
+
+    	// a blank glyph with the advance of space
+    	if (face_.load_char(' ', FT_LOAD_DEFAULT) == 0) {
+    		fallback_.advance_x = face_.face()->glyph->advance.x >> 6;
+    		fallback_.advance_y = face_.face()->glyph->advance.y >> 6;
+    	}
     }
 
     FontCache::~FontCache ()
@@ -215,17 +404,49 @@ namespace BlendInt {
     	library_.Done();
     }
 
-	const Glyph* FontCache::Query (uint32_t charcode, bool create)
+	int FontCache::Preload (uint32_t first, uint32_t last)
 	{
-		typedef std::map<uint32_t, Glyph>::iterator iterator_type;
+		uint64_t start = Timer::GetMicroSeconds();
+		int count = 0;
+
+		// a 64-bit counter ends the loop if last is UINT32_MAX
+		for (uint64_t c = first; c <= last; c++) {
 
-		iterator_type it = glyph_data_.find(charcode);
+			uint32_t charcode = static_cast<uint32_t>(c);
 
-		if(it != glyph_data_.end()) {
-			return &(it->second);
+			if (glyph_data_.find(charcode)) continue;
+			if (face_.get_char_index(charcode) == 0) continue;
+
+			Load(charcode);
+			count++;
 		}
 
-		face_.load_char(charcode, FT_LOAD_RENDER);
+		// upload all in one batch
+		if (count) {
+			texture_atlas_->Commit();
+			stats_.misses += count;
+			stats_.rasterization_time += Timer::GetMicroSeconds() - start;
+		}
+
+		return count;
+	}
+
+	const Glyph* FontCache::Rasterize (uint32_t charcode)
+	{
+		uint64_t start = Timer::GetMicroSeconds();
+
+		const Glyph* retval = Load(charcode);
+		texture_atlas_->Commit();
+
+		stats_.misses++;
+		stats_.rasterization_time += Timer::GetMicroSeconds() - start;
+
+		return retval;
+	}
+
+	const Glyph* FontCache::Load (uint32_t charcode)
+	{
+		face_.load_rendered_char(charcode, embolden_);
 		FT_GlyphSlot g = face_.face()->glyph;
 
 		Glyph glyph;
@@ -236,16 +457,69 @@ namespace BlendInt {
 		glyph.advance_x = g->advance.x >> 6;
 		glyph.advance_y = g->advance.y >> 6;
 
-		texture_atlas_->bind();
-		texture_atlas_->Upload(g->bitmap.width,
-				g->bitmap.rows,
-				g->bitmap.buffer,
-				&(glyph.offset_u),
-				&(glyph.offset_v));
+		return Store(charcode, glyph, g->bitmap.buffer, g->bitmap.pitch);
+	}
+
+	const Glyph* FontCache::Store (uint32_t charcode,
+			const Glyph& metrics,
+			const unsigned char* bitmap,
+			int pitch)
+	{
+		Glyph glyph = metrics;
+
+		if (glyph.bitmap_width > 0 && glyph.bitmap_height > 0) {
+
+			unsigned int evictions = texture_atlas_->evictions();
+
+			if (texture_atlas_->Allocate(glyph.bitmap_width,
+					glyph.bitmap_height,
+					&(glyph.offset_u),
+					&(glyph.offset_v),
+					&(glyph.page))) {
+
+				// the page is reused, glyphs in it will be rasterized again
+				if (texture_atlas_->evictions() != evictions) {
+					glyph_data_.erase_page(glyph.page);
+				}
+
+				texture_atlas_->Blit(glyph.page,
+						glyph.offset_u,
+						glyph.offset_v,
+						glyph.bitmap_width,
+						glyph.bitmap_height,
+						bitmap,
+						pitch);
+
+			} else {
+				// larger than an atlas page, keep the metrics only
+				glyph.bitmap_width = 0;
+				glyph.bitmap_height = 0;
+			}
+		}
+
+		return glyph_data_.insert(charcode, glyph);
+	}
+
+	const Glyph* FontCache::Request (uint32_t charcode)
+	{
+		if (pending_.insert(charcode).second) {
 
-		std::pair<iterator_type, bool> result = glyph_data_.insert(std::pair<uint32_t, Glyph>(charcode, glyph));
+			if (kRasterizer == 0) {
+				kRasterizer = new GlyphRasterizer(&AbstractWindow::WakeUpMainWindow);
+			}
+
+			GlyphRequest request;
+			request.font = pattern_.hash();
+			request.file = file_;
+			request.size = size_;
+			request.dpi = dpi_;
+			request.embolden = embolden_;
+			request.charcode = charcode;
+
+			kRasterizer->Push(request);
+		}
 
-		return &(result.first->second);
+		return &fallback_;
 	}
 
 } /* namespace BlendInt */
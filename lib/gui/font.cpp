@@ -26,9 +26,9 @@
 #endif
 
 #include <blendint/core/types.hpp>
-#include <blendint/font/fc-config.hpp>
 
 #include <blendint/gui/font.hpp>
+#include <blendint/gui/text-layout-cache.hpp>
 
 namespace BlendInt {
 
@@ -43,21 +43,16 @@ namespace BlendInt {
   {
     Fc::Pattern p = Fc::Pattern::name_parse(name);
 
-    Fc::Config::substitute(0, p, FcMatchPattern);
-    p.default_substitute();
+    double size = 0.0;
+    bool has_size = (p.get_double(FC_SIZE, 0, &size) == FcResultMatch);
 
-    FcResult result;
-    Fc::Pattern match = Fc::Config::match(0, p, &result);
+    // match the face only, a size given in the name is set afterwards
+    p.del(FC_SIZE);
+    p.del(FC_PIXEL_SIZE);
 
-#ifdef DEBUG
-    DBG_ASSERT(match);
-#endif
+    Fc::Pattern match = MatchFace(p);
 
-    if (result != FcResultMatch) {
-      DBG_PRINT_MSG("Warning: %s", "the font was not found");
-    }
-
-    cache_ = FontCache::Create(match);
+    cache_ = FontCache::Create(has_size ? Resize(match, size) : match);
   }
 
   Font::Font (const FcChar8* family, double size, int weight, int slant)
@@ -65,25 +60,10 @@ namespace BlendInt {
   {
     Fc::Pattern p;
     p.add_string(FC_FAMILY, family);
-    p.add_double(FC_SIZE, size);
     p.add_integer(FC_WEIGHT, weight);
     p.add_integer(FC_SLANT, slant);
 
-    Fc::Config::substitute(0, p, FcMatchPattern);
-    p.default_substitute();
-
-    FcResult result;
-    Fc::Pattern match = Fc::Config::match(0, p, &result);
-
-#ifdef DEBUG
-    DBG_ASSERT(match);
-#endif
-
-    if (result != FcResultMatch) {
-      DBG_PRINT_MSG("Warning: %s", "the font was not found");
-    }
-
-    cache_ = FontCache::Create(match);
+    cache_ = FontCache::Create(Resize(MatchFace(p), size));
   }
 
   Font::~Font ()
@@ -92,29 +72,12 @@ namespace BlendInt {
 
   void Font::SetFamily (const FcChar8* family)
   {
-    Fc::Pattern p = Fc::Pattern::duplicate(cache_->pattern());
-
-    if (!p.del(FC_FAMILY)) {
-      DBG_PRINT_MSG("Warning: %s", "no faimliy property");
-    }
-
+    Fc::Pattern p;
     p.add_string(FC_FAMILY, family);
+    p.add_integer(FC_WEIGHT, requested_weight());
+    p.add_integer(FC_SLANT, requested_slant());
 
-    Fc::Config::substitute(0, p, FcMatchPattern);
-    p.default_substitute();
-
-    FcResult result;
-    Fc::Pattern match = Fc::Config::match(0, p, &result);
-
-#ifdef DEBUG
-    DBG_ASSERT(match);
-#endif
-
-    if (result != FcResultMatch) {
-      DBG_PRINT_MSG("Warning: %s", "the font was not found");
-    }
-
-    cache_ = FontCache::Create(match);
+    cache_ = FontCache::Create(Resize(MatchFace(p), size()));
   }
 
   void Font::SetStyle (const FcChar8* style)
@@ -127,110 +90,58 @@ namespace BlendInt {
 
   void Font::SetSlant (int slant)
   {
-    Fc::Pattern p = Fc::Pattern::duplicate(cache_->pattern());
-
-    if (!p.del(FC_SLANT)) {
-      DBG_PRINT_MSG("Warning: %s", "no fullname property");
-    }
-
+    // an italic or oblique face is another file of the family
+    Fc::Pattern p;
+    p.add_string(FC_FAMILY, family());
+    p.add_integer(FC_WEIGHT, requested_weight());
     p.add_integer(FC_SLANT, slant);
 
-    Fc::Config::substitute(0, p, FcMatchPattern);
-    p.default_substitute();
-
-    FcResult result;
-    Fc::Pattern match = Fc::Config::match(0, p, &result);
-
-#ifdef DEBUG
-    DBG_ASSERT(match);
-#endif
-
-    if (result != FcResultMatch) {
-      DBG_PRINT_MSG("Warning: %s", "the font was not found");
-    }
-
-    cache_ = FontCache::Create(match);
+    cache_ = FontCache::Create(Resize(MatchFace(p), size()));
   }
 
   void Font::SetWeight (int weight)
   {
     Fc::Pattern p = Fc::Pattern::duplicate(cache_->pattern());
 
-    if (!p.del(FC_WEIGHT)) {
-      DBG_PRINT_MSG("Warning: %s", "no weight property");
-    }
+    int face_weight = FC_WEIGHT_REGULAR;
+    p.get_integer(FC_WEIGHT, 0, &face_weight);
 
-    p.add_integer(FC_WEIGHT, weight);
-
-    Fc::Config::substitute(0, p, FcMatchPattern);
-    p.default_substitute();
+    if (weight < face_weight && face_weight > FC_WEIGHT_MEDIUM) {
 
-    FcResult result;
-    Fc::Pattern match = Fc::Config::match(0, p, &result);
+      // a bold face cannot be made lighter, find the regular one
+      Fc::Pattern request;
+      request.add_string(FC_FAMILY, family());
+      request.add_integer(FC_WEIGHT, weight);
+      request.add_integer(FC_SLANT, requested_slant());
 
-#ifdef DEBUG
-    DBG_ASSERT(match);
-#endif
+      cache_ = FontCache::Create(Resize(MatchFace(request), size()));
+      return;
+    }
 
-    if (result != FcResultMatch) {
-      DBG_PRINT_MSG("Warning: %s", "the font was not found");
+    // keep the face, a bold weight on a regular face is synthesized by
+    // emboldening the glyphs, the same rule fontconfig uses for a family
+    // without a bold face
+    p.del(FC_EMBOLDEN);
+    if (weight >= FC_WEIGHT_BOLD && face_weight <= FC_WEIGHT_MEDIUM) {
+      p.add_bool(FC_EMBOLDEN, true);
     }
 
-    cache_ = FontCache::Create(match);
+    cache_ = FontCache::Create(p);
   }
 
   void Font::SetSize (double size)
   {
-    Fc::Pattern p = Fc::Pattern::duplicate(cache_->pattern());
-
-    if (!p.del(FC_SIZE)) {
-      DBG_PRINT_MSG("Warning: %s", "no size property");
-    }
-
-    p.add_double(FC_SIZE, size);
-
-    Fc::Config::substitute(0, p, FcMatchPattern);
-    p.default_substitute();
-
-    FcResult result;
-    Fc::Pattern match = Fc::Config::match(0, p, &result);
-
-#ifdef DEBUG
-    DBG_ASSERT(match);
-#endif
-
-    if (result != FcResultMatch) {
-      DBG_PRINT_MSG("Warning: %s", "the font was not found");
-    }
-
-    cache_ = FontCache::Create(match);
+    // the face does not depend on the size, no need to match again
+    cache_ = FontCache::Create(Resize(cache_->pattern(), size));
   }
 
   void Font::SetPixelSize (double pixel_size)
   {
-    Fc::Pattern p = Fc::Pattern::duplicate(cache_->pattern());
-
-    if (!p.del(FC_PIXEL_SIZE)) {
-      DBG_PRINT_MSG("Warning: %s", "no pixelsize property");
-    }
-
-    p.add_double(FC_PIXEL_SIZE, pixel_size);
-
-    Fc::Config::substitute(0, p, FcMatchPattern);
-    p.default_substitute();
+    double dpi = 72.0;
+    cache_->pattern().get_double(FC_DPI, 0, &dpi);
 
-    FcResult result;
-    Fc::Pattern match = Fc::Config::match(0, p, &result);
-
-#ifdef DEBUG
-    DBG_ASSERT(match);
-#endif
-
-    if (result != FcResultMatch) {
-      DBG_PRINT_MSG("Warning: %s", "the font was not found");
-    }
-
-    cache_ = FontCache::Create(match);
+    cache_ = FontCache::Create(Resize(cache_->pattern(),
+                                      pixel_size * 72.0 / dpi));
   }
 
   size_t Font::GetTextWidth (const String& text) const
@@ -242,40 +153,7 @@ namespace BlendInt {
                              size_t length,
                              size_t start) const
   {
-    size_t width = 0;
-    const Glyph* g = 0;
-
-    size_t str_len = text.length();
-    size_t last = std::min(start + length, str_len);
-    size_t next = 0;
-
-    if (has_kerning()) {
-
-      Kerning kerning;
-      for (size_t i = start; i < last; i++) {
-
-        g = glyph(text[i]);
-        next = i + 1;
-
-        if (next < last) {
-          kerning = GetKerning(text[i], text[next], KerningDefault);
-          width += (g->advance_x + kerning.x);
-        } else {
-          width += g->advance_x;
-        }
-
-      }
-
-    } else {
-
-      for (size_t i = start; i < last; i++) {
-        g = glyph(text[i]);
-        width += g->advance_x;
-      }
-
-    }
-
-    return width;
+    return TextLayoutCache::Get(*this, text)->GetWidth(length, start);
   }
 
   Kerning Font::GetKerning (uint32_t left_glyph,
@@ -294,4 +172,69 @@ namespace BlendInt {
     return retval;
   }
 
+  const FcChar8* Font::family () const
+  {
+    FcChar8* family = 0;
+    cache_->pattern().get_string(FC_FAMILY, 0, &family);
+    return family;
+  }
+
+  double Font::size () const
+  {
+    double size = 12.0;
+    cache_->pattern().get_double(FC_SIZE, 0, &size);
+    return size;
+  }
+
+  int Font::requested_weight () const
+  {
+    int weight = FC_WEIGHT_REGULAR;
+    cache_->pattern().get_integer(FC_WEIGHT, 0, &weight);
+
+    // an emboldened face stands for the bold weight
+    FcBool embolden = FcFalse;
+    cache_->pattern().get_bool(FC_EMBOLDEN, 0, &embolden);
+    if (embolden) weight = FC_WEIGHT_BOLD;
+
+    return weight;
+  }
+
+  int Font::requested_slant () const
+  {
+    int slant = FC_SLANT_ROMAN;
+    cache_->pattern().get_integer(FC_SLANT, 0, &slant);
+    return slant;
+  }
+
+  Fc::Pattern Font::MatchFace (const Fc::Pattern& request)
+  {
+    FcResult result;
+    Fc::Pattern match = FontCache::Match(request, &result);
+
+#ifdef DEBUG
+    DBG_ASSERT(match);
+#endif
+
+    if (result != FcResultMatch) {
+      DBG_PRINT_MSG("Warning: %s", "the font was not found");
+    }
+
+    return match;
+  }
+
+  Fc::Pattern Font::Resize (const Fc::Pattern& face, double size)
+  {
+    Fc::Pattern p = Fc::Pattern::duplicate(face);
+
+    double dpi = 72.0;
+    p.get_double(FC_DPI, 0, &dpi);
+
+    p.del(FC_SIZE);
+    p.del(FC_PIXEL_SIZE);
+    p.add_double(FC_SIZE, size);
+    p.add_double(FC_PIXEL_SIZE, size * dpi / 72.0);
+
+    return p;
+  }
+
 }
@@ -0,0 +1,105 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free software:
+ * you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is distributed in
+ * the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+#include <blendint/core/timer.hpp>
+#include <blendint/gui/frame-scheduler.hpp>
+
+namespace BlendInt {
+
+FrameScheduler::FrameScheduler ()
+: refresh_rate_(60),
+  frame_start_(0),
+  frame_end_(0),
+  last_mark_(0),
+  frame_count_(0)
+{
+}
+
+FrameScheduler::~FrameScheduler ()
+{
+}
+
+void FrameScheduler::SetRefreshRate (int rate)
+{
+  refresh_rate_ = rate > 0 ? rate : 0;
+}
+
+double FrameScheduler::GetPacingDelay () const
+{
+  if (refresh_rate_ == 0 || frame_start_ == 0) return 0.0;
+
+  uint64_t interval = 1000000 / refresh_rate_;
+  uint64_t elapsed = Timer::GetMonotonicMicroSeconds() - frame_start_;
+
+  return elapsed < interval ? (interval - elapsed) / 1000000.0 : 0.0;
+}
+
+void FrameScheduler::BeginFrame ()
+{
+  frame_start_ = Timer::GetMonotonicMicroSeconds();
+  last_mark_ = frame_start_;
+
+  current_ = FrameTimings();
+  if (frame_end_) current_.idle = frame_start_ - frame_end_;
+}
+
+void FrameScheduler::Mark (FramePhase phase)
+{
+  uint64_t now = Timer::GetMonotonicMicroSeconds();
+
+  switch (phase) {
+    case FramePredraw:
+      current_.predraw += now - last_mark_;
+      break;
+    case FrameDraw:
+      current_.draw += now - last_mark_;
+      break;
+    case FrameSwap:
+      current_.swap += now - last_mark_;
+      break;
+  }
+
+  last_mark_ = now;
+}
+
+void FrameScheduler::EndFrame ()
+{
+  frame_end_ = Timer::GetMonotonicMicroSeconds();
+
+  last_frame_ = current_;
+
+  total_.predraw += current_.predraw;
+  total_.draw += current_.draw;
+  total_.swap += current_.swap;
+  total_.idle += current_.idle;
+  frame_count_++;
+}
+
+void FrameScheduler::Reset ()
+{
+  last_frame_ = FrameTimings();
+  total_ = FrameTimings();
+  frame_count_ = 0;
+}
+
+}
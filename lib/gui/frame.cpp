@@ -79,8 +79,6 @@ Frame::Frame (int width, int height, AbstractLayout* layout)
 
 Frame::~Frame ()
 {
-  glDeleteVertexArrays(2, vao_);
-
   if (focused_widget_) {
     focused_widget_->destroyed().disconnect1(
         this, &Frame::OnFocusedWidgetDestroyed);
@@ -137,13 +135,7 @@ void Frame::PerformSizeUpdate (const AbstractView* source, const AbstractView* t
     GenerateVertices(size(), 1.f * AbstractWindow::theme()->pixel(),
                      RoundNone, 0.f, &inner_verts, &outer_verts);
 
-    vbo_.bind(0);
-    vbo_.set_sub_data(0, sizeof(GLfloat) * inner_verts.size(),
-                      &inner_verts[0]);
-    vbo_.bind(1);
-    vbo_.set_sub_data(0, sizeof(GLfloat) * outer_verts.size(),
-                      &outer_verts[0]);
-    vbo_.reset();
+    geometry_.Update(inner_verts, outer_verts);
 
     ResizeSubView(layout_, size());
     RequestRedraw();
@@ -178,8 +170,7 @@ Response Frame::Draw (AbstractWindow* context)
   glUniform4f(AbstractWindow::shaders()->location(Shaders::FRAME_INNER_COLOR),
               0.447f, 0.447f, 0.447f, 1.f);
 
-  glBindVertexArray(vao_[0]);
-  glDrawArrays(GL_TRIANGLE_FAN, 0, 6);
+  geometry_.DrawInner(GL_TRIANGLE_FAN, 6);
 
   if (view_buffer()) {
 
@@ -198,15 +189,16 @@ Response Frame::Draw (AbstractWindow* context)
 
   } else {
 
-    glViewport(position().x(), position().y(), size().width(),
-               size().height());
+    context->SetViewport(position().x(), position().y(), size().width(),
+                         size().height());
 
     AbstractWindow::shaders()->SetWidgetProjectionMatrix(projection_matrix_);
     AbstractWindow::shaders()->SetWidgetModelMatrix(model_matrix_);
 
     DrawSubViewsOnce(context);
 
-    glViewport(0, 0, context->size().width(), context->size().height());
+    context->SetViewport(0, 0, context->size().width(),
+                         context->size().height());
 
   }
 
@@ -215,15 +207,13 @@ Response Frame::Draw (AbstractWindow* context)
   glUniform2f(
       AbstractWindow::shaders()->location(Shaders::FRAME_OUTER_POSITION),
       position().x(), position().y());
-  glBindVertexArray(vao_[1]);
-
   glUniform4f(AbstractWindow::shaders()->location(Shaders::FRAME_OUTER_COLOR),
               0.576f, 0.576f, 0.576f, 1.f);
-  glDrawArrays(GL_TRIANGLE_STRIP, 4, 6);
+  geometry_.DrawOuter(GL_TRIANGLE_STRIP, 6, 4);
 
   glUniform4f(AbstractWindow::shaders()->location(Shaders::FRAME_OUTER_COLOR),
               0.4f, 0.4f, 0.4f, 1.f);
-  glDrawArrays(GL_TRIANGLE_STRIP, 0, 6);
+  geometry_.DrawOuter(GL_TRIANGLE_STRIP, 6);
 
   return Finish;
 }
@@ -432,23 +422,7 @@ void Frame::InitializeFrameOnce ()
   GenerateVertices(size(), pixel_size(1), RoundNone, 0.f, &inner_verts,
                    &outer_verts);
 
-  vbo_.generate();
-  glGenVertexArrays(2, vao_);
-
-  glBindVertexArray(vao_[0]);
-  vbo_.bind(0);
-  vbo_.set_data(sizeof(GLfloat) * inner_verts.size(), &inner_verts[0]);
-  glEnableVertexAttribArray(AttributeCoord);
-  glVertexAttribPointer(AttributeCoord, 3, GL_FLOAT, GL_FALSE, 0, 0);
-
-  glBindVertexArray(vao_[1]);
-  vbo_.bind(1);
-  vbo_.set_data(sizeof(GLfloat) * outer_verts.size(), &outer_verts[0]);
-  glEnableVertexAttribArray(AttributeCoord);
-  glVertexAttribPointer(AttributeCoord, 2, GL_FLOAT, GL_FALSE, 0, 0);
-
-  glBindVertexArray(0);
-  vbo_.reset();
+  geometry_.Update(inner_verts, outer_verts);
 }
 
 void Frame::SetFocusedWidget (AbstractWidget* widget, AbstractWindow* context)
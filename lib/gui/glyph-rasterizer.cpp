@@ -0,0 +1,185 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free software:
+ * you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is distributed in
+ * the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+#include <cstring>
+#include <algorithm>
+#include <map>
+#include <utility>
+
+#include <blendint/core/timer.hpp>
+#include <blendint/font/ft-library.hpp>
+#include <blendint/font/ft-face.hpp>
+
+#include <blendint/gui/glyph-rasterizer.hpp>
+
+namespace BlendInt {
+
+GlyphRasterizer::GlyphRasterizer (void (*notify) (), unsigned int thread_count)
+    : notify_(notify), stop_(false)
+{
+  if (thread_count == 0) {
+    // leave one core for the render thread
+    unsigned int cores = std::thread::hardware_concurrency();
+    thread_count = cores > 1 ? std::min(cores - 1, kMaxThreads) : 1;
+  }
+
+  for (unsigned int i = 0; i < thread_count; i++) {
+    threads_.push_back(std::thread(&GlyphRasterizer::Run, this));
+  }
+}
+
+GlyphRasterizer::~GlyphRasterizer ()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  condition_.notify_all();
+
+  for (size_t i = 0; i < threads_.size(); i++) {
+    threads_[i].join();
+  }
+}
+
+void GlyphRasterizer::Push (const GlyphRequest& request)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    requests_.push_back(request);
+  }
+  condition_.notify_one();
+}
+
+size_t GlyphRasterizer::Take (std::vector<RasterizedGlyph>* results)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  size_t count = results_.size();
+  if (count) {
+    if (results->empty()) {
+      results->swap(results_);
+    } else {
+      results->insert(results->end(), results_.begin(), results_.end());
+      results_.clear();
+    }
+  }
+
+  return count;
+}
+
+void GlyphRasterizer::Run ()
+{
+  Ft::Library library;
+  library.Init();
+
+  // faces opened in this thread, 0 if the font file cannot be loaded
+  std::map<FcChar32, Ft::Face*> faces;
+  std::map<FcChar32, Ft::Face*>::iterator it;
+
+  GlyphRequest request;
+
+  while (true) {
+
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      while (!stop_ && requests_.empty()) {
+        condition_.wait(lock);
+      }
+
+      if (stop_) break;
+
+      request = requests_.front();
+      requests_.pop_front();
+    }
+
+    uint64_t start = Timer::GetMicroSeconds();
+
+    Ft::Face* face = 0;
+    it = faces.find(request.font);
+
+    if (it == faces.end()) {
+
+      if (faces.size() >= kMaxFacesPerThread) {
+        for (it = faces.begin(); it != faces.end(); it++) {
+          delete it->second;
+        }
+        faces.clear();
+      }
+
+      face = new Ft::Face;
+      if (face->New(library, request.file.c_str())) {
+        face->set_char_size((unsigned long) request.size << 6, 0,
+                            (unsigned int) request.dpi, 0);
+      } else {
+        delete face;
+        face = 0;
+      }
+      faces[request.font] = face;
+
+    } else {
+      face = it->second;
+    }
+
+    RasterizedGlyph result;
+    result.font = request.font;
+    result.charcode = request.charcode;
+
+    if (face && (face->load_rendered_char(request.charcode,
+                                        request.embolden) == 0)) {
+
+      FT_GlyphSlot g = face->face()->glyph;
+
+      result.glyph.bitmap_left = g->bitmap_left;
+      result.glyph.bitmap_top = g->bitmap_top;
+      result.glyph.bitmap_width = g->bitmap.width;
+      result.glyph.bitmap_height = g->bitmap.rows;
+      result.glyph.advance_x = g->advance.x >> 6;
+      result.glyph.advance_y = g->advance.y >> 6;
+
+      // the bitmap is reused by FreeType, copy it row by row as the
+      // pitch may be larger than the width
+      result.bitmap.resize(g->bitmap.width * g->bitmap.rows);
+      for (unsigned int row = 0; row < (unsigned int) g->bitmap.rows; row++) {
+        memcpy(&result.bitmap[row * g->bitmap.width],
+               g->bitmap.buffer + row * g->bitmap.pitch,
+               g->bitmap.width);
+      }
+
+    }
+
+    result.time = Timer::GetMicroSeconds() - start;
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      results_.push_back(std::move(result));
+    }
+
+    if (notify_) notify_();
+  }
+
+  for (it = faces.begin(); it != faces.end(); it++) {
+    delete it->second;
+  }
+}
+
+}
@@ -0,0 +1,169 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free software:
+ * you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is distributed in
+ * the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+#include <string.h>
+#include <utility>
+
+#include <blendint/gui/glyph-table.hpp>
+
+namespace BlendInt {
+
+GlyphTable::GlyphTable ()
+: slot_count_(0)
+{
+  memset(pages_, 0, sizeof(pages_));
+
+  // Latin-1 is always used
+  pages_[0] = new Glyph*[kPageSize];
+  memset(pages_[0], 0, sizeof(Glyph*) * kPageSize);
+}
+
+GlyphTable::~GlyphTable ()
+{
+  for (uint32_t i = 0; i < kPageCount; i++) {
+    delete [] pages_[i];
+  }
+}
+
+const Glyph* GlyphTable::insert (uint32_t charcode, const Glyph& glyph)
+{
+  const Glyph* found = find(charcode);
+  if (found) {
+    *(const_cast<Glyph*>(found)) = glyph;
+    return found;
+  }
+
+  storage_.push_back(glyph);
+  Glyph* stored = &storage_.back();
+
+  if (charcode < kDirectRange) {
+
+    Glyph**& page = pages_[charcode >> kPageShift];
+    if (page == 0) {
+      page = new Glyph*[kPageSize];
+      memset(page, 0, sizeof(Glyph*) * kPageSize);
+    }
+    page[charcode & kPageMask] = stored;
+
+  } else {
+
+    // keep the load factor under 0.5
+    if ((slot_count_ + 1) * 2 > slots_.size()) {
+      Rehash(slots_.empty() ? 64 : slots_.size() * 2);
+    }
+
+    InsertInHashTable(charcode, stored);
+    slot_count_++;
+
+  }
+
+  return stored;
+}
+
+size_t GlyphTable::erase_page (int page)
+{
+  std::vector<std::pair<uint32_t, Glyph> > kept;
+  kept.reserve(storage_.size());
+
+  for (uint32_t i = 0; i < kPageCount; i++) {
+    if (pages_[i] == 0) continue;
+    for (uint32_t j = 0; j < kPageSize; j++) {
+      const Glyph* glyph = pages_[i][j];
+      if (glyph && glyph->page != page) {
+        kept.push_back(std::make_pair((i << kPageShift) | j, *glyph));
+      }
+    }
+  }
+
+  for (size_t i = 0; i < slots_.size(); i++) {
+    if (slots_[i].glyph && slots_[i].glyph->page != page) {
+      kept.push_back(std::make_pair(slots_[i].charcode, *slots_[i].glyph));
+    }
+  }
+
+  size_t removed = storage_.size() - kept.size();
+  if (removed == 0) return 0;
+
+  clear();
+  for (size_t i = 0; i < kept.size(); i++) {
+    insert(kept[i].first, kept[i].second);
+  }
+
+  return removed;
+}
+
+void GlyphTable::clear ()
+{
+  for (uint32_t i = 1; i < kPageCount; i++) {
+    delete [] pages_[i];
+    pages_[i] = 0;
+  }
+  memset(pages_[0], 0, sizeof(Glyph*) * kPageSize);
+
+  slots_.clear();
+  slot_count_ = 0;
+  storage_.clear();
+}
+
+const Glyph* GlyphTable::FindInHashTable (uint32_t charcode) const
+{
+  if (slots_.empty()) return 0;
+
+  const size_t mask = slots_.size() - 1;
+  size_t i = hash(charcode) & mask;
+
+  while (slots_[i].glyph) {
+    if (slots_[i].charcode == charcode) return slots_[i].glyph;
+    i = (i + 1) & mask;
+  }
+
+  return 0;
+}
+
+void GlyphTable::InsertInHashTable (uint32_t charcode, Glyph* glyph)
+{
+  const size_t mask = slots_.size() - 1;
+  size_t i = hash(charcode) & mask;
+
+  while (slots_[i].glyph) {
+    i = (i + 1) & mask;
+  }
+
+  slots_[i].charcode = charcode;
+  slots_[i].glyph = glyph;
+}
+
+void GlyphTable::Rehash (size_t capacity)
+{
+  std::vector<Slot> old;
+  old.swap(slots_);
+
+  Slot empty = { 0, 0 };
+  slots_.assign(capacity, empty);
+
+  for (size_t i = 0; i < old.size(); i++) {
+    if (old[i].glyph) InsertInHashTable(old[i].charcode, old[i].glyph);
+  }
+}
+
+}
@@ -0,0 +1,153 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free software:
+ * you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is distributed in
+ * the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+
+#include <algorithm>
+#include <cmath>
+
+#include <blendint/gui/abstract-view.hpp>
+#include <blendint/gui/hit-test-grid.hpp>
+
+namespace BlendInt {
+
+HitTestGrid::HitTestGrid ()
+: left_(0),
+  bottom_(0),
+  columns_(0),
+  rows_(0),
+  cell_width_(1),
+  cell_height_(1)
+{
+}
+
+HitTestGrid::~HitTestGrid ()
+{
+}
+
+void HitTestGrid::Build (const AbstractView* view)
+{
+  views_.clear();
+  cells_.clear();
+  items_.clear();
+  columns_ = 0;
+  rows_ = 0;
+
+  for (AbstractView* p = view->GetLastSubView(); p;
+      p = view->GetPreviousSubView(p)) {
+    if (!AbstractView::is_widget(p)) break;
+    views_.push_back(p);
+  }
+
+  if (views_.empty()) return;
+
+  // the bounds of all views, Contain() includes the right and top edges
+  int left = views_[0]->position().x();
+  int bottom = views_[0]->position().y();
+  int right = left + views_[0]->size().width();
+  int top = bottom + views_[0]->size().height();
+
+  for (AbstractView* p : views_) {
+    left = std::min(left, p->position().x());
+    bottom = std::min(bottom, p->position().y());
+    right = std::max(right, p->position().x() + p->size().width());
+    top = std::max(top, p->position().y() + p->size().height());
+  }
+
+  left_ = left - kMargin;
+  bottom_ = bottom - kMargin;
+  const int width = right - left + 2 * kMargin + 1;
+  const int height = top - bottom + 2 * kMargin + 1;
+
+  // about one cell for each view
+  const int side = (int) std::ceil(std::sqrt((double) views_.size()));
+  columns_ = std::max(1, std::min(side, width));
+  rows_ = std::max(1, std::min(side, height));
+  cell_width_ = (width + columns_ - 1) / columns_;
+  cell_height_ = (height + rows_ - 1) / rows_;
+
+  // count the views in each cell, then fill them in top-first order
+  cells_.assign(columns_ * rows_ + 1, 0);
+
+  int c0, c1, r0, r1;
+  for (int pass = 0; pass < 2; pass++) {
+
+    for (size_t i = 0; i < views_.size(); i++) {
+
+      const AbstractView* p = views_[i];
+      c0 = (p->position().x() - kMargin - left_) / cell_width_;
+      r0 = (p->position().y() - kMargin - bottom_) / cell_height_;
+      c1 = (p->position().x() + p->size().width() + kMargin - left_)
+          / cell_width_;
+      r1 = (p->position().y() + p->size().height() + kMargin - bottom_)
+          / cell_height_;
+
+      for (int r = r0; r <= r1; r++) {
+        for (int c = c0; c <= c1; c++) {
+          if (pass == 0) {
+            cells_[r * columns_ + c + 1]++;
+          } else {
+            items_[cells_[r * columns_ + c]++] = (int) i;
+          }
+        }
+      }
+
+    }
+
+    if (pass == 0) {
+      for (size_t i = 1; i < cells_.size(); i++) {
+        cells_[i] += cells_[i - 1];
+      }
+      items_.resize(cells_.back());
+    } else {
+      // each start was moved to the end of its cell
+      for (size_t i = cells_.size() - 1; i > 0; i--) {
+        cells_[i] = cells_[i - 1];
+      }
+      cells_[0] = 0;
+    }
+
+  }
+}
+
+AbstractView* HitTestGrid::Find (const Point& point) const
+{
+  if (views_.empty()) return 0;
+
+  int x = point.x() - left_;
+  int y = point.y() - bottom_;
+  if ((x < 0) || (y < 0)) return 0;
+
+  int c = x / cell_width_;
+  int r = y / cell_height_;
+  if ((c >= columns_) || (r >= rows_)) return 0;
+
+  const int cell = r * columns_ + c;
+  for (int i = cells_[cell]; i < cells_[cell + 1]; i++) {
+    AbstractView* p = views_[items_[i]];
+    if (p->Contain(point)) return p;
+  }
+
+  return 0;
+}
+
+}
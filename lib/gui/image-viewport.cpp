@@ -294,10 +294,9 @@ namespace BlendInt {
 	{
 		DeclareActiveFrame(context, this);
 
-		glViewport(position().x(), position().y(), size().width(), size().height());
+		context->SetViewport(position().x(), position().y(), size().width(), size().height());
 
-		glEnable(GL_SCISSOR_TEST);
-		glScissor(position().x(), position().y(), size().width(), size().height());
+		context->BeginScissor(Rect(position(), size()));
 
 		AbstractWindow::shaders()->SetWidgetProjectionMatrix(projection_matrix_);
 		AbstractWindow::shaders()->SetWidgetModelMatrix(model_matrix_);
@@ -337,8 +336,8 @@ namespace BlendInt {
 	
 	void ImageViewport::PostDraw(AbstractWindow* context)
 	{
-		glDisable(GL_SCISSOR_TEST);
-		glViewport(0, 0, context->size().width(), context->size().height());
+		context->EndScissor();
+		context->SetViewport(0, 0, context->size().width(), context->size().height());
 	}
 
 	void ImageViewport::InitializeImageViewport ()
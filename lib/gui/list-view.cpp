@@ -21,6 +21,8 @@
  * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
  */
 
+#include <algorithm>
+
 #include <blendint/opengl/gl-framebuffer.hpp>
 
 #include <blendint/gui/list-view.hpp>
@@ -28,8 +30,19 @@
 
 namespace BlendInt {
 
+// vertices of one stripe row: 2 triangles, each vertex has a 2D coord and a color
+static const int kStripeVertexCount = 6;
+static const int kStripeVertexSize = 6;
+
+// the gamma added to odd stripe rows and the highlighted row
+static const int kOddRowGamma = 15;
+static const int kHighlightGamma = -35;
+
 ListView::ListView ()
-    : AbstractItemView(), highlight_index_(-1)
+    : AbstractItemView(),
+      highlight_index_(-1),
+      stripe_rows_(0),
+      moving_(false)
 {
   set_size(400, 300);
 
@@ -58,18 +71,12 @@ const RefPtr<AbstractItemModel> ListView::GetModel () const
 
 void ListView::SetModel (const RefPtr<AbstractItemModel>& model)
 {
-  if (model_) {
-    model_ = model;
-    RequestRedraw();
-  } else if (model) {
+  if (model_ || model) {
     model_ = model;
+    highlight_index_ = -1;
+    set_offset(0, 0);
     RequestRedraw();
   }
-
-  if (model_) {
-    int h = font_.height();
-    h = model_->GetRowCount() * h;	// total height
-  }
 }
 
 Size ListView::GetPreferredSize () const
@@ -77,10 +84,34 @@ Size ListView::GetPreferredSize () const
   return Size(400, 300);
 }
 
+int ListView::GetRowAt (int y) const
+{
+  if (!model_) return -1;
+
+  const int h = font_.height();
+  int distance = size().height() - y + GetOffset().y();
+  if (distance < 0) return -1;
+
+  int row = distance / h;
+  if (row >= model_->GetRowCount(model_->GetRootIndex())) return -1;
+
+  return row;
+}
+
+void ListView::ScrollToRow (int row)
+{
+  SetScrollOffset(row * font_.height());
+}
+
 Response ListView::Draw (AbstractWindow* context)
 {
-  int y = size().height();
   const int h = font_.height();
+  const int offset_y = GetOffset().y();
+
+  // the first row intersecting the visible area, and the pixels of it
+  // scrolled out of the top edge
+  const int first = offset_y / h;
+  const int shift = offset_y % h;
 
   AbstractWindow::shaders()->widget_inner_program()->use();
 
@@ -92,12 +123,9 @@ Response ListView::Draw (AbstractWindow* context)
   glUniform4fv(AbstractWindow::shaders()->location(Shaders::WIDGET_INNER_COLOR),
                1, AbstractWindow::theme()->regular().inner.data());
 
-  glBindVertexArray(vao_[0]);
-  glDrawArrays(GL_TRIANGLE_FAN, 0, outline_vertex_count(round_type()) + 2);
+  geometry_.DrawInner(GL_TRIANGLE_FAN, outline_vertex_count(round_type()) + 2);
 
-  context->BeginPushStencil();	// inner stencil
-  glDrawArrays(GL_TRIANGLE_FAN, 0, outline_vertex_count(round_type()) + 2);
-  context->EndPushStencil();
+  context->PushClipRect(Rect(0, 0, size().width(), size().height()));
 
   AbstractWindow::shaders()->widget_triangle_program()->use();
 
@@ -106,47 +134,50 @@ Response ListView::Draw (AbstractWindow* context)
   glUniform1i(
       AbstractWindow::shaders()->location(Shaders::WIDGET_TRIANGLE_ANTI_ALIAS),
       0);
-  glVertexAttrib4f(AttributeColor, 0.475f, 0.475f, 0.475f, 0.75f);
+
+  // draw all stripes in one call, the stripe buffer begins with an even
+  // row, so skip one row in buffer if the first visible row is odd
+  int parity = first % 2;
+  glUniform2f(
+      AbstractWindow::shaders()->location(Shaders::WIDGET_TRIANGLE_POSITION),
+      0.f, (GLfloat) (size().height() + shift + parity * h));
 
   glBindVertexArray(vao_[1]);
+  glDrawArrays(GL_TRIANGLES, parity * kStripeVertexCount,
+               (stripe_rows_ - 1) * kStripeVertexCount);
 
-  int i = 0;
-  while (y > 0) {
-    y -= h;
+  int rows = 0;
+  RefPtr<AbstractItemModel> model = GetModel();
+  if (model) {
+    rows = model->GetRowCount(model->GetRootIndex());
+  }
+
+  // the last row (exclusive) intersecting the visible area
+  int last = std::min(rows, (offset_y + size().height() + h - 1) / h);
 
+  if (highlight_index_ >= first && highlight_index_ < last) {
+
+    glUniform1i(
+        AbstractWindow::shaders()->location(Shaders::WIDGET_TRIANGLE_GAMMA),
+        kHighlightGamma);
     glUniform2f(
         AbstractWindow::shaders()->location(Shaders::WIDGET_TRIANGLE_POSITION),
-        0, y);
-
-    if (i == highlight_index_) {// TODO: use different functions for performance
-      glUniform1i(
-          AbstractWindow::shaders()->location(Shaders::WIDGET_TRIANGLE_GAMMA),
-          -35);
-    } else {
-      if (i % 2 == 0) {
-        glUniform1i(
-            AbstractWindow::shaders()->location(Shaders::WIDGET_TRIANGLE_GAMMA),
-            0);
-      } else {
-        glUniform1i(
-            AbstractWindow::shaders()->location(Shaders::WIDGET_TRIANGLE_GAMMA),
-            15);
-      }
-    }
+        0.f, (GLfloat) (size().height() + offset_y - (highlight_index_ + 1) * h));
+    glVertexAttrib4f(AttributeColor, 0.475f, 0.475f, 0.475f, 0.75f);
 
+    glBindVertexArray(vao_[0]);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-    i++;
+
   }
 
-  RefPtr<AbstractItemModel> model = GetModel();
-  if (model) {
+  if (first < last) {
 
-    ModelIndex index = model->GetRootIndex();
-    index = index.GetChildIndex(0, 0);
+    ModelIndex index = model->GetIndex(first, 0, model->GetRootIndex());
 
-    Rect rect(0, size().height() - h, size().width(), h);
+    Rect rect(0, size().height() + offset_y - (first + 1) * h, size().width(),
+              h);
 
-    while (index.valid()) {
+    for (int i = first; (i < last) && index.valid(); i++) {
       index.GetData()->DrawInRect(
           rect, AlignLeft | AlignVerticalCenter | AlignJustify | AlignBaseline,
           AbstractWindow::theme()->regular().text.data());
@@ -156,61 +187,68 @@ Response ListView::Draw (AbstractWindow* context)
 
   }
 
-  AbstractWindow::shaders()->widget_inner_program()->use();
-
-  context->BeginPopStencil();	// pop inner stencil
-  glBindVertexArray(vao_[0]);
-  glDrawArrays(GL_TRIANGLE_FAN, 0, outline_vertex_count(round_type()) + 2);
-  glBindVertexArray(0);
-  context->EndPopStencil();
+  context->PopClipRect();
 
   return Finish;
 }
 
 Response ListView::PerformMousePress (AbstractWindow* context)
 {
-  if (model_) {
+  if (context->GetMouseButton() == MouseButtonMiddle) {
+    moving_ = true;
+    cursor_point_ = context->GetGlobalCursorPosition();
+    last_offset_ = GetOffset();
+    return Finish;
+  }
 
-    ModelIndex index;
+  if (model_) {
+    Point pos = context->GetAbsolutePosition(this);
+    highlight_index_ = GetRowAt(
+        context->GetGlobalCursorPosition().y() - pos.y());
+  } else {
+    highlight_index_ = -1;
+  }
 
-    int rows = model_->GetRowCount();
+  RequestRedraw();
+  return Finish;
+}
 
-    if (rows > 0) {
-      int h = font_.height();	// the row height
-      int total = rows * h;
+Response ListView::PerformMouseRelease (AbstractWindow* context)
+{
+  if (moving_) {
+    moving_ = false;
+    RequestRedraw();
+  }
 
-      int i = 0;
-      if (total > size().height()) {
-        i = position().y() - context->GetGlobalCursorPosition().y();
-      } else {	// no vbar
-        i = position().y() + size().height()
-            - context->GetGlobalCursorPosition().y();
-      }
+  return Finish;
+}
 
-      i = i / h;
-      highlight_index_ = i;
+Response ListView::PerformMouseMove (AbstractWindow* context)
+{
+  if (moving_) {
 
-      index = model_->GetRootIndex().GetChildIndex();
-      while ((i > 0) && index.valid()) {
-        index = index.GetDownIndex();
-        i--;
-      }
+    int oy = context->GetGlobalCursorPosition().y() - cursor_point_.y();
 
-      if (!index.valid()) {
-        highlight_index_ = -1;
-      }
+    if (oy != 0) {
+      SetScrollOffset(last_offset_.y() + oy);
     }
 
-  } else {
-    highlight_index_ = -1;
+    return Finish;
   }
 
-  return Finish;
+  return Ignore;
 }
 
 ModelIndex ListView::GetIndexAt (const Point& point) const
 {
-  return ModelIndex();
+  ModelIndex index;
+
+  int row = GetRowAt(point.y());
+  if (row >= 0) {
+    index = model_->GetIndex(row, 0, model_->GetRootIndex());
+  }
+
+  return index;
 }
 
 void ListView::PerformSizeUpdate (const AbstractView* source,
@@ -226,15 +264,23 @@ void ListView::PerformSizeUpdate (const AbstractView* source,
     GLfloat verts[] = { 0.f, 0.f, (GLfloat) width, 0.f, 0.f, h, (GLfloat) width,
         h };
 
-    vbo_.bind(1);
+    vbo_.bind(0);
     vbo_.set_data(sizeof(verts), verts);
 
+    std::vector<GLfloat> stripe_verts;
+    GenerateStripeVertices(&stripe_verts);
+
+    vbo_.bind(1);
+    vbo_.set_data(sizeof(GLfloat) * stripe_verts.size(), &stripe_verts[0]);
+    vbo_.reset();
+
     std::vector<GLfloat> inner_verts;
     GenerateVertices(size(), 0.f, RoundNone, 0.f, &inner_verts, 0);
 
-    vbo_.bind(0);
-    vbo_.set_sub_data(0, sizeof(GLfloat) * inner_verts.size(), &inner_verts[0]);
-    vbo_.reset();
+    geometry_.Update(inner_verts, std::vector<GLfloat>());
+
+    // keep the offset valid for the new height
+    SetScrollOffset(GetOffset().y());
   }
 
   if (source == this) {
@@ -249,8 +295,13 @@ void ListView::InitializeListView ()
       (GLfloat) size().width(), h };
 
   std::vector<GLfloat> inner_verts;
+  std::vector<GLfloat> stripe_verts;
 
   GenerateVertices(size(), 0.f, RoundNone, 0.f, &inner_verts, 0);
+  GenerateStripeVertices(&stripe_verts);
+
+  geometry_.Update(inner_verts, std::vector<GLfloat>());
+
   vbo_.generate();
 
   glGenVertexArrays(2, vao_);
@@ -258,21 +309,82 @@ void ListView::InitializeListView ()
   glBindVertexArray(vao_[0]);
 
   vbo_.bind(0);
-  vbo_.set_data(sizeof(GLfloat) * inner_verts.size(), &inner_verts[0]);
+  vbo_.set_data(sizeof(verts), verts);
 
   glEnableVertexAttribArray(AttributeCoord);
-  glVertexAttribPointer(AttributeCoord, 3, GL_FLOAT, GL_FALSE, 0, 0);
+  glVertexAttribPointer(AttributeCoord, 2, GL_FLOAT, GL_FALSE, 0, 0);
 
   glBindVertexArray(vao_[1]);
 
   vbo_.bind(1);
-  vbo_.set_data(sizeof(verts), verts);
+  vbo_.set_data(sizeof(GLfloat) * stripe_verts.size(), &stripe_verts[0]);
 
   glEnableVertexAttribArray(AttributeCoord);
-  glVertexAttribPointer(AttributeCoord, 2, GL_FLOAT, GL_FALSE, 0, 0);
+  glEnableVertexAttribArray(AttributeColor);
+  glVertexAttribPointer(AttributeCoord, 2, GL_FLOAT, GL_FALSE,
+                        sizeof(GLfloat) * kStripeVertexSize,
+                        BUFFER_OFFSET(0));
+  glVertexAttribPointer(AttributeColor, 4, GL_FLOAT, GL_FALSE,
+                        sizeof(GLfloat) * kStripeVertexSize,
+                        BUFFER_OFFSET(2 * sizeof(GLfloat)));
 
   glBindVertexArray(0);
   vbo_.reset();
 }
 
+void ListView::GenerateStripeVertices (std::vector<GLfloat>* verts)
+{
+  const GLfloat h = (GLfloat) font_.height();
+  const GLfloat w = (GLfloat) size().width();
+
+  // one more row for the partially scrolled row, one more row for the
+  // parity skip in Draw()
+  stripe_rows_ = size().height() / font_.height() + 3;
+
+  verts->resize(stripe_rows_ * kStripeVertexCount * kStripeVertexSize);
+
+  const GLfloat shade = kOddRowGamma / 255.f;
+  GLfloat* p = &(*verts)[0];
+
+  for (int i = 0; i < stripe_rows_; i++) {
+
+    // the stripes grow down from y = 0
+    GLfloat top = -i * h;
+    GLfloat bottom = top - h;
+    GLfloat c = (i % 2) ? 0.475f + shade : 0.475f;
+
+    const GLfloat corners[kStripeVertexCount][2] = {
+        { 0.f, bottom }, { w, bottom }, { 0.f, top },
+        { 0.f, top }, { w, bottom }, { w, top } };
+
+    for (int j = 0; j < kStripeVertexCount; j++) {
+      *(p++) = corners[j][0];
+      *(p++) = corners[j][1];
+      *(p++) = c;
+      *(p++) = c;
+      *(p++) = c;
+      *(p++) = 0.75f;
+    }
+  }
+}
+
+void ListView::SetScrollOffset (int y)
+{
+  int max = std::max(0, GetContentHeight() - size().height());
+  y = std::min(std::max(0, y), max);
+
+  if (y != GetOffset().y()) {
+    set_offset(0, y);
+    fire_scrolled_event(0, y);
+    RequestRedraw();
+  }
+}
+
+int ListView::GetContentHeight () const
+{
+  if (!model_) return 0;
+
+  return model_->GetRowCount(model_->GetRootIndex()) * font_.height();
+}
+
 }
@@ -387,9 +387,14 @@ bool NodeView::PreDraw (AbstractWindow* context)
   glBindVertexArray(vao_);
   glDrawArrays(GL_TRIANGLE_FAN, 0, 6);
 
-  context->BeginPushStencil();	// inner stencil
-  glDrawArrays(GL_TRIANGLE_FAN, 0, 6);
-  context->EndPushStencil();
+  // the stencil is needed only for round corners
+  if (rounded()) {
+    context->BeginPushStencil();	// inner stencil
+    glDrawArrays(GL_TRIANGLE_FAN, 0, 6);
+    context->EndPushStencil();
+  } else {
+    context->PushClipRect(Rect(0, 0, size().width(), size().height()));
+  }
 
   return true;
 }
@@ -423,14 +428,18 @@ void NodeView::PostDraw (AbstractWindow* context)
     AbstractWindow::shaders()->PopWidgetModelMatrix();
   }
 
-  // draw mask
-  AbstractWindow::shaders()->widget_inner_program()->use();
+  if (rounded()) {
+    // draw mask
+    AbstractWindow::shaders()->widget_inner_program()->use();
 
-  glBindVertexArray(vao_);
+    glBindVertexArray(vao_);
 
-  context->BeginPopStencil();	// pop inner stencil
-  glDrawArrays(GL_TRIANGLE_FAN, 0, 6);
-  context->EndPopStencil();
+    context->BeginPopStencil();	// pop inner stencil
+    glDrawArrays(GL_TRIANGLE_FAN, 0, 6);
+    context->EndPopStencil();
+  } else {
+    context->PopClipRect();
+  }
 
   AbstractWindow::shaders()->PopWidgetModelMatrix();
 }
@@ -232,7 +232,8 @@ Response Panel::Draw (AbstractWindow* context)
 
   if (refresh() && view_buffer_) {
     //DBG_PRINT_MSG("%s", "refresh once");
-    RenderSubWidgetsToTexture(this, context, view_buffer_->texture());
+    RenderSubWidgetsToTexture(this, context, view_buffer_->texture(),
+                              &texture_size_);
   }
 
   AbstractWindow::shaders()->widget_inner_program()->use();
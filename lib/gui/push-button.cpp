@@ -97,7 +97,6 @@ PushButton::PushButton (const RefPtr<AbstractIcon>& icon, const String& text)
 
 PushButton::~PushButton ()
 {
-  glDeleteVertexArrays(2, vao_);
 }
 
 Size PushButton::GetPreferredSize () const
@@ -140,11 +139,7 @@ void PushButton::PerformSizeUpdate (const AbstractView* source,
     GenerateRoundedVertices(Vertical, AbstractWindow::theme()->push_button(),
                             &inner_verts, &outer_verts);
 
-    vbo_.bind(0);
-    vbo_.set_sub_data(0, sizeof(GLfloat) * inner_verts.size(), &inner_verts[0]);
-    vbo_.bind(1);
-    vbo_.set_sub_data(0, sizeof(GLfloat) * outer_verts.size(), &outer_verts[0]);
-    vbo_.reset();
+    geometry_.Update(inner_verts, outer_verts);
 
     RequestRedraw();
   }
@@ -164,11 +159,7 @@ void PushButton::PerformRoundTypeUpdate (int type)
   GenerateRoundedVertices(Vertical, AbstractWindow::theme()->push_button(),
                           &inner_verts, &outer_verts);
 
-  vbo_.bind(0);
-  vbo_.set_data(sizeof(GLfloat) * inner_verts.size(), &inner_verts[0]);
-  vbo_.bind(1);
-  vbo_.set_data(sizeof(GLfloat) * outer_verts.size(), &outer_verts[0]);
-  vbo_.reset();
+  geometry_.Update(inner_verts, outer_verts);
 
   RequestRedraw();
 }
@@ -183,11 +174,7 @@ void PushButton::PerformRoundRadiusUpdate (float radius)
   GenerateRoundedVertices(Vertical, AbstractWindow::theme()->push_button(),
                           &inner_verts, &outer_verts);
 
-  vbo_.bind(0);
-  vbo_.set_data(sizeof(GLfloat) * inner_verts.size(), &inner_verts[0]);
-  vbo_.bind(1);
-  vbo_.set_data(sizeof(GLfloat) * outer_verts.size(), &outer_verts[0]);
-  vbo_.reset();
+  geometry_.Update(inner_verts, outer_verts);
 
   RequestRedraw();
 }
@@ -226,8 +213,7 @@ Response PushButton::Draw (AbstractWindow* context)
         AbstractWindow::theme()->push_button().inner.data());
   }
 
-  glBindVertexArray(vao_[0]);
-  glDrawArrays(GL_TRIANGLE_FAN, 0, outline_vertex_count(round_type()) + 2);
+  geometry_.DrawInner(GL_TRIANGLE_FAN, outline_vertex_count(round_type()) + 2);
 
   AbstractWindow::shaders()->widget_outer_program()->use();
 
@@ -236,9 +222,8 @@ Response PushButton::Draw (AbstractWindow* context)
   glUniform4fv(AbstractWindow::shaders()->location(Shaders::WIDGET_OUTER_COLOR),
                1, AbstractWindow::theme()->push_button().outline.data());
 
-  glBindVertexArray(vao_[1]);
-  glDrawArrays(GL_TRIANGLE_STRIP, 0,
-               outline_vertex_count(round_type()) * 2 + 2);
+  geometry_.DrawOuter(GL_TRIANGLE_STRIP,
+                      outline_vertex_count(round_type()) * 2 + 2);
 
   if (emboss()) {
     glUniform4f(
@@ -247,7 +232,8 @@ Response PushButton::Draw (AbstractWindow* context)
     glUniform2f(
         AbstractWindow::shaders()->location(Shaders::WIDGET_OUTER_OFFSET), 0.f,
         -1.f);
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, emboss_vertex_count(round_type()) * 2);
+    geometry_.DrawOuter(GL_TRIANGLE_STRIP,
+                        emboss_vertex_count(round_type()) * 2);
   }
 
   DrawIconText();
@@ -265,26 +251,7 @@ void PushButton::InitializeButtonOnce ()
                           &inner_verts,
                           &outer_verts);
 
-  glGenVertexArrays(2, vao_);
-  vbo_.generate();
-
-  glBindVertexArray(vao_[0]);
-
-  vbo_.bind(0);
-  vbo_.set_data(sizeof(GLfloat) * inner_verts.size(), &inner_verts[0]);
-  glEnableVertexAttribArray(AttributeCoord);
-  glVertexAttribPointer(AttributeCoord, 3, GL_FLOAT, GL_FALSE, 0, 0);
-
-  glBindVertexArray(vao_[1]);
-  vbo_.bind(1);
-  vbo_.set_data(sizeof(GLfloat) * outer_verts.size(), &outer_verts[0]);
-  glEnableVertexAttribArray(AttributeCoord);
-  glVertexAttribPointer(AttributeCoord, 2,
-  GL_FLOAT,
-                        GL_FALSE, 0, 0);
-
-  glBindVertexArray(0);
-  vbo_.reset();
+  geometry_.Update(inner_verts, outer_verts);
 }
 
 }
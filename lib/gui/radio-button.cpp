@@ -103,7 +103,6 @@ RadioButton::RadioButton (const RefPtr<AbstractIcon>& icon,
 
 RadioButton::~RadioButton ()
 {
-  glDeleteVertexArrays(2, vao_);
 }
 
 void RadioButton::PerformSizeUpdate (const AbstractView* source, const AbstractView* target, int width, int height)
@@ -125,11 +124,7 @@ void RadioButton::PerformSizeUpdate (const AbstractView* source, const AbstractV
       GenerateRoundedVertices(&inner_verts, &outer_verts);
     }
 
-    vbo_.bind(0);
-    vbo_.set_sub_data(0, sizeof(GLfloat) * inner_verts.size(), &inner_verts[0]);
-    vbo_.bind(1);
-    vbo_.set_sub_data(0, sizeof(GLfloat) * outer_verts.size(), &outer_verts[0]);
-    vbo_.reset();
+    geometry_.Update(inner_verts, outer_verts);
 
     RequestRedraw();
   }
@@ -156,11 +151,7 @@ void RadioButton::PerformRoundTypeUpdate (int round_type)
     GenerateRoundedVertices(&inner_verts, &outer_verts);
   }
 
-  vbo_.bind(0);
-  vbo_.set_data(sizeof(GLfloat) * inner_verts.size(), &inner_verts[0]);
-  vbo_.bind(1);
-  vbo_.set_data(sizeof(GLfloat) * outer_verts.size(), &outer_verts[0]);
-  vbo_.reset();
+  geometry_.Update(inner_verts, outer_verts);
 
   RequestRedraw();
 }
@@ -182,11 +173,7 @@ void RadioButton::PerformRoundRadiusUpdate (float radius)
     GenerateRoundedVertices(&inner_verts, &outer_verts);
   }
 
-  vbo_.bind(0);
-  vbo_.set_data(sizeof(GLfloat) * inner_verts.size(), &inner_verts[0]);
-  vbo_.bind(1);
-  vbo_.set_data(sizeof(GLfloat) * outer_verts.size(), &outer_verts[0]);
-  vbo_.reset();
+  geometry_.Update(inner_verts, outer_verts);
 
   RequestRedraw();
 }
@@ -208,8 +195,7 @@ Response RadioButton::Draw (AbstractWindow* context)
                  AbstractWindow::theme()->radio_button().inner.data());
   }
 
-  glBindVertexArray(vao_[0]);
-  glDrawArrays(GL_TRIANGLE_FAN, 0, outline_vertex_count(round_type()) + 2);
+  geometry_.DrawInner(GL_TRIANGLE_FAN, outline_vertex_count(round_type()) + 2);
 
   AbstractWindow::shaders()->widget_outer_program()->use();
 
@@ -217,17 +203,16 @@ Response RadioButton::Draw (AbstractWindow* context)
   glUniform4fv(AbstractWindow::shaders()->location(Shaders::WIDGET_OUTER_COLOR), 1,
                AbstractWindow::theme()->radio_button().outline.data());
 
-  glBindVertexArray(vao_[1]);
-  glDrawArrays(GL_TRIANGLE_STRIP, 0,
-               outline_vertex_count(round_type()) * 2 + 2);
+  geometry_.DrawOuter(GL_TRIANGLE_STRIP,
+                      outline_vertex_count(round_type()) * 2 + 2);
 
   if (emboss()) {
     glUniform4f(AbstractWindow::shaders()->location(Shaders::WIDGET_OUTER_COLOR), 1.0f,
                 1.0f, 1.0f, 0.16f);
     glUniform2f(AbstractWindow::shaders()->location(Shaders::WIDGET_OUTER_OFFSET),
                 0.f, 0.f - 1.f);
-    glDrawArrays(GL_TRIANGLE_STRIP, 0,
-                 emboss_vertex_count(round_type()) * 2);
+    geometry_.DrawOuter(GL_TRIANGLE_STRIP,
+                        emboss_vertex_count(round_type()) * 2);
   }
 
   if (is_down()) {
@@ -254,26 +239,7 @@ void RadioButton::InitializeRadioButtonOnce ()
     GenerateRoundedVertices(&inner_verts, &outer_verts);
   }
 
-  glGenVertexArrays(2, vao_);
-  vbo_.generate();
-
-  glBindVertexArray(vao_[0]);
-
-  vbo_.bind(0);
-  vbo_.set_data(sizeof(GLfloat) * inner_verts.size(), &inner_verts[0]);
-  glEnableVertexAttribArray(AttributeCoord);
-  glVertexAttribPointer(AttributeCoord, 3,
-                        GL_FLOAT, GL_FALSE, 0, 0);
-
-  glBindVertexArray(vao_[1]);
-  vbo_.bind(1);
-  vbo_.set_data(sizeof(GLfloat) * outer_verts.size(), &outer_verts[0]);
-  glEnableVertexAttribArray(AttributeCoord);
-  glVertexAttribPointer(AttributeCoord, 2,
-                        GL_FLOAT, GL_FALSE, 0, 0);
-
-  glBindVertexArray(0);
-  vbo_.reset();
+  geometry_.Update(inner_verts, outer_verts);
 }
 
 }
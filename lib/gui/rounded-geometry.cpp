@@ -0,0 +1,101 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free software:
+ * you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is distributed in
+ * the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+
+#include <blendint/gui/rounded-geometry.hpp>
+#include <blendint/gui/abstract-window.hpp>
+
+namespace BlendInt {
+
+RoundedGeometry::RoundedGeometry (GLint inner_components)
+: inner_components_(inner_components)
+{
+  inner_.first = 0;
+  inner_.capacity = 0;
+  outer_.first = 0;
+  outer_.capacity = 0;
+}
+
+RoundedGeometry::~RoundedGeometry ()
+{
+  // the arenas are gone if the context was released before this
+  GLVertexArena* arena = AbstractWindow::vertex_arena(inner_components_);
+  if (arena && inner_.capacity > 0) {
+    arena->Free(inner_.first, inner_.capacity);
+  }
+
+  arena = AbstractWindow::vertex_arena(2);
+  if (arena && outer_.capacity > 0) {
+    arena->Free(outer_.first, outer_.capacity);
+  }
+}
+
+void RoundedGeometry::Update (const std::vector<GLfloat>& inner,
+                              const std::vector<GLfloat>& outer)
+{
+  Store(AbstractWindow::vertex_arena(inner_components_), &inner_, inner);
+  Store(AbstractWindow::vertex_arena(2), &outer_, outer);
+}
+
+void RoundedGeometry::DrawInner (GLenum mode, GLsizei count, GLint first) const
+{
+  Draw(AbstractWindow::vertex_arena(inner_components_), inner_, mode, count,
+       first);
+}
+
+void RoundedGeometry::DrawOuter (GLenum mode, GLsizei count, GLint first) const
+{
+  Draw(AbstractWindow::vertex_arena(2), outer_, mode, count, first);
+}
+
+void RoundedGeometry::Store (GLVertexArena* arena,
+                             Range* range,
+                             const std::vector<GLfloat>& vertices)
+{
+  GLsizei count = (GLsizei) (vertices.size() / arena->components());
+  if (count == 0) return;
+
+  if (range->capacity < count) {
+    if (range->capacity > 0) {
+      arena->Free(range->first, range->capacity);
+    }
+    range->first = arena->Allocate(count);
+    range->capacity = GLVertexArena::allocated_size(count);
+  }
+
+  arena->Upload(range->first, count, &vertices[0]);
+}
+
+void RoundedGeometry::Draw (GLVertexArena* arena,
+                            const Range& range,
+                            GLenum mode,
+                            GLsizei count,
+                            GLint first)
+{
+  DBG_ASSERT((first + count) <= range.capacity);
+
+  arena->Submit(mode, range.first + first, count);
+  arena->Flush();
+}
+
+}
@@ -232,9 +232,7 @@ bool ScrollView::PreDraw(AbstractWindow* context)
   glBindVertexArray(vao_);
   glDrawArrays(GL_TRIANGLE_FAN, 0, 6);
 
-  context->BeginPushStencil();	// inner stencil
-  glDrawArrays(GL_TRIANGLE_FAN, 0, 6);
-  context->EndPushStencil();
+  context->PushClipRect(Rect(0, 0, size().width(), size().height()));
 
   return true;
 }
@@ -263,23 +261,7 @@ void ScrollView::PostDraw(AbstractWindow* context)
   if(subview_count())
     AbstractWindow::shaders()->PopWidgetModelMatrix();
 
-  // draw mask
-  AbstractWindow::shaders()->widget_inner_program()->use();
-  glUniform1i(AbstractWindow::shaders()->location(Shaders::WIDGET_INNER_GAMMA), 0);
-  glUniform1i(
-      AbstractWindow::shaders()->location(Shaders::WIDGET_INNER_SHADED),
-      0);
-
-  if(subview_count()) {
-    glUniform4f(AbstractWindow::shaders()->location(Shaders::WIDGET_INNER_COLOR), 0.908f, 0.208f, 0.208f, 0.25f);
-  } else {
-    glUniform4f(AbstractWindow::shaders()->location(Shaders::WIDGET_INNER_COLOR), 0.947f, 0.447f, 0.447f, 0.25f);
-  }
-
-  glBindVertexArray(vao_);
-  context->BeginPopStencil();	// pop inner stencil
-  glDrawArrays(GL_TRIANGLE_FAN, 0, 6);
-  context->EndPopStencil();
+  context->PopClipRect();
 
   AbstractWindow::shaders()->PopWidgetModelMatrix();
 }
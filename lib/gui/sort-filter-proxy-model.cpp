@@ -0,0 +1,732 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free software:
+ * you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is distributed in
+ * the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+#include <cwctype>
+#include <algorithm>
+
+#include <blendint/gui/text.hpp>
+#include <blendint/gui/sort-filter-proxy-model.hpp>
+
+namespace BlendInt {
+
+static inline char32_t FoldCase (char32_t c)
+{
+  if (c < 128) {
+    return (c >= 'A' && c <= 'Z') ? (c + ('a' - 'A')) : c;
+  }
+
+  return (char32_t) std::towlower((wint_t) c);
+}
+
+// compare case insensitive only
+static int CompareFolded (const String& a, const String& b)
+{
+  size_t length = std::min(a.length(), b.length());
+  char32_t x = 0;
+  char32_t y = 0;
+
+  for (size_t i = 0; i < length; i++) {
+    x = FoldCase(a[i]);
+    y = FoldCase(b[i]);
+    if (x != y) return x < y ? -1 : 1;
+  }
+
+  if (a.length() == b.length()) return 0;
+  return a.length() < b.length() ? -1 : 1;
+}
+
+static const String kEmptyString;
+
+static inline const String* GetNodeText (const ModelNode* node)
+{
+  const Text* text = node ? dynamic_cast<const Text*>(node->data.get()) : 0;
+  return text ? &text->text() : 0;
+}
+
+/*
+ * Merge a sorted batch into a sorted array and return the position of
+ * the first new element. The position of each new row is found by binary
+ * search, so a batch costs O(k log n) comparisons and a plain copy of the
+ * array, instead of comparing the whole array.
+ */
+template<typename Compare>
+static size_t MergeSorted (std::vector<int>* array,
+                           const std::vector<int>& sorted,
+                           Compare compare)
+{
+  if (sorted.empty()) return array->size();
+
+  const std::vector<int>& source = *array;
+  std::vector<int> merged;
+  merged.reserve(source.size() + sorted.size());
+
+  std::vector<int>::const_iterator from = source.begin();
+  std::vector<int>::const_iterator to;
+  size_t first = 0;
+  for (size_t i = 0; i < sorted.size(); i++) {
+    to = std::lower_bound(from, source.end(), sorted[i], compare);
+    if (i == 0) first = to - source.begin();
+    merged.insert(merged.end(), from, to);
+    merged.push_back(sorted[i]);
+    from = to;
+  }
+  merged.insert(merged.end(), from, source.end());
+
+  array->swap(merged);
+
+  return first;
+}
+
+struct SortFilterProxyModel::SortCompare
+{
+  const SortFilterProxyModel* model;
+
+  inline bool operator () (int left, int right) const
+  {
+    return model->Before(left, right);
+  }
+};
+
+struct SortFilterProxyModel::SearchCompare
+{
+  const SortFilterProxyModel* model;
+
+  inline const String& text (int row) const
+  {
+    const String* str = model->GetSourceText(row, 0);
+    return str ? *str : kEmptyString;
+  }
+
+  inline bool operator () (int left, int right) const
+  {
+    int result = CompareText(text(left), text(right));
+    return result == 0 ? (left < right) : (result < 0);
+  }
+
+  // for lower_bound with a prefix
+  inline bool operator () (int row, const String& prefix) const
+  {
+    return CompareFolded(text(row), prefix) < 0;
+  }
+};
+
+SortFilterProxyModel::SortFilterProxyModel ()
+: AbstractItemModel(),
+  root_(0),
+  columns_(0),
+  sort_column_(-1),
+  sort_order_(AscendingOrder),
+  filter_mode_(FilterSubstring),
+  filter_column_(0)
+{
+  root_ = new ModelNode;
+}
+
+SortFilterProxyModel::~SortFilterProxyModel ()
+{
+  DestroyAllNodes();
+  delete root_;
+}
+
+void SortFilterProxyModel::SetSourceModel (const RefPtr<AbstractItemModel>& model)
+{
+  source_ = model;
+  Invalidate();
+}
+
+void SortFilterProxyModel::SetSortColumn (int column, SortOrder order)
+{
+  if ((column == sort_column_) && (order == sort_order_)) return;
+
+  sort_column_ = column;
+  sort_order_ = order;
+
+  Sort();
+  LinkRows();
+
+  layout_changed_.Invoke();
+}
+
+void SortFilterProxyModel::SetFilter (const String& pattern,
+                                      FilterMode mode,
+                                      int column)
+{
+  // a longer pattern of the same kind can only hide rows, no need to
+  // test the rows already filtered out
+  bool narrowing = (!filter_.empty()) && (mode == filter_mode_)
+      && (column == filter_column_) && (pattern.length() > filter_.length())
+      && MatchText(pattern, filter_, mode == FilterPrefix);
+
+  filter_ = pattern;
+  filter_mode_ = mode;
+  filter_column_ = column;
+
+  if (narrowing) {
+
+    size_t j = 0;
+    for (size_t i = 0; i < mapping_.size(); i++) {
+      if (Accept(mapping_[i])) {
+        mapping_[j] = mapping_[i];
+        j++;
+      } else {
+        DestroyNode(mapping_[i]);
+      }
+    }
+    mapping_.resize(j);
+
+  } else {
+
+    std::vector<int> rows;
+    for (size_t i = 0; i < source_rows_.size(); i++) {
+      if (nodes_[i] == 0) rows.push_back((int) i);
+    }
+
+    // remove the rows not accepted any more, keep the order
+    size_t j = 0;
+    for (size_t i = 0; i < mapping_.size(); i++) {
+      if (Accept(mapping_[i])) {
+        mapping_[j] = mapping_[i];
+        j++;
+      } else {
+        DestroyNode(mapping_[i]);
+      }
+    }
+    mapping_.resize(j);
+
+    Merge(&rows);
+  }
+
+  LinkRows();
+  layout_changed_.Invoke();
+}
+
+void SortFilterProxyModel::ClearFilter ()
+{
+  if (filter_.empty()) return;
+
+  SetFilter(String(), filter_mode_, filter_column_);
+}
+
+void SortFilterProxyModel::Invalidate ()
+{
+  DestroyAllNodes();
+
+  source_rows_.clear();
+  texts_.clear();
+  mapping_.clear();
+  search_index_.clear();
+  columns_ = 0;
+
+  if (source_) {
+
+    columns_ = source_->GetColumnCount();
+
+    ModelNode* node = get_index_node(source_->GetRootIndex());
+    node = node ? node->child : 0;
+
+    while (node) {
+      source_rows_.push_back(node);
+      texts_.push_back(GetNodeText(node));
+      node = node->down;
+    }
+  }
+
+  const size_t count = source_rows_.size();
+
+  nodes_.assign(count, 0);
+  reverse_.assign(count, -1);
+
+  search_index_.resize(count);
+  mapping_.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    search_index_[i] = (int) i;
+    if (Accept((int) i)) {
+      mapping_.push_back((int) i);
+      CreateNode((int) i);
+    }
+  }
+
+  SearchCompare search = { this };
+  std::sort(search_index_.begin(), search_index_.end(), search);
+
+  Sort();
+  LinkRows();
+
+  layout_changed_.Invoke();
+}
+
+void SortFilterProxyModel::InsertSourceRows (int first, int count)
+{
+  if ((!source_) || (count <= 0)) return;
+
+  first = std::max(std::min(first, (int) source_rows_.size()), 0);
+
+  // find the new nodes in the source model
+  ModelNode* node = 0;
+  if (first > 0) {
+    node = source_rows_[first - 1]->down;
+  } else {
+    node = get_index_node(source_->GetRootIndex());
+    node = node ? node->child : 0;
+  }
+
+  std::vector<ModelNode*> inserted;
+  inserted.reserve(count);
+  for (int i = 0; (i < count) && node; i++) {
+    inserted.push_back(node);
+    node = node->down;
+  }
+  count = (int) inserted.size();
+  if (count == 0) return;
+
+  if (columns_ == 0) columns_ = source_->GetColumnCount();
+
+  source_rows_.insert(source_rows_.begin() + first, inserted.begin(),
+                      inserted.end());
+  texts_.insert(texts_.begin() + first, count, (const String*) 0);
+  for (int i = 0; i < count; i++) {
+    texts_[first + i] = GetNodeText(inserted[i]);
+  }
+  nodes_.insert(nodes_.begin() + first, count, (ModelNode*) 0);
+  reverse_.insert(reverse_.begin() + first, count, -1);
+
+  // the source rows after the position are moved
+  for (size_t i = 0; i < mapping_.size(); i++) {
+    if (mapping_[i] >= first) mapping_[i] += count;
+  }
+  for (size_t i = 0; i < search_index_.size(); i++) {
+    if (search_index_[i] >= first) search_index_[i] += count;
+  }
+
+  std::vector<int> rows(count);
+  for (int i = 0; i < count; i++) {
+    rows[i] = first + i;
+  }
+
+  SearchCompare search = { this };
+  std::vector<int> sorted(rows);
+  std::sort(sorted.begin(), sorted.end(), search);
+
+  MergeSorted(&search_index_, sorted, search);
+
+  LinkRows(Merge(&rows));
+  layout_changed_.Invoke();
+}
+
+void SortFilterProxyModel::RemoveSourceRows (int first, int count)
+{
+  if (first < 0 || first >= (int) source_rows_.size()) return;
+
+  count = std::min(count, (int) source_rows_.size() - first);
+  if (count <= 0) return;
+
+  const int last = first + count;
+
+  // the rows before the first removed one are not moved
+  size_t from = mapping_.size();
+  for (int i = first; i < last; i++) {
+    if (reverse_[i] >= 0) from = std::min(from, (size_t) reverse_[i]);
+    DestroyNode(i);
+  }
+
+  source_rows_.erase(source_rows_.begin() + first,
+                     source_rows_.begin() + last);
+  texts_.erase(texts_.begin() + first, texts_.begin() + last);
+  nodes_.erase(nodes_.begin() + first, nodes_.begin() + last);
+  reverse_.erase(reverse_.begin() + first, reverse_.begin() + last);
+
+  // drop the removed rows and move the rows after them, in one pass
+  std::vector<int>* arrays[] = { &mapping_, &search_index_ };
+
+  for (int k = 0; k < 2; k++) {
+    std::vector<int>& array = *arrays[k];
+    size_t j = 0;
+    for (size_t i = 0; i < array.size(); i++) {
+      if (array[i] < first) {
+        array[j++] = array[i];
+      } else if (array[i] >= last) {
+        array[j++] = array[i] - count;
+      }
+    }
+    array.resize(j);
+  }
+
+  LinkRows(from);
+  layout_changed_.Invoke();
+}
+
+void SortFilterProxyModel::UpdateSourceRow (int source_row)
+{
+  if (source_row < 0 || source_row >= (int) source_rows_.size()) return;
+
+  texts_[source_row] = GetNodeText(source_rows_[source_row]);
+
+  // take the row out, the keys may have changed
+  size_t from = mapping_.size();
+  if (reverse_[source_row] >= 0) {
+    from = (size_t) reverse_[source_row];
+    mapping_.erase(mapping_.begin() + from);
+    reverse_[source_row] = -1;
+    DestroyNode(source_row);
+  }
+
+  search_index_.erase(std::find(search_index_.begin(), search_index_.end(),
+                                source_row));
+
+  SearchCompare search = { this };
+  search_index_.insert(std::lower_bound(search_index_.begin(),
+                                        search_index_.end(),
+                                        source_row,
+                                        search),
+                       source_row);
+
+  if (Accept(source_row)) {
+    SortCompare sort = { this };
+    std::vector<int>::iterator it = std::lower_bound(mapping_.begin(),
+                                                     mapping_.end(),
+                                                     source_row, sort);
+    from = std::min(from, (size_t) (it - mapping_.begin()));
+    mapping_.insert(it, source_row);
+    CreateNode(source_row);
+  }
+
+  LinkRows(from);
+  layout_changed_.Invoke();
+}
+
+int SortFilterProxyModel::MapToSource (int row) const
+{
+  if (row < 0 || row >= (int) mapping_.size()) return -1;
+  return mapping_[row];
+}
+
+int SortFilterProxyModel::MapFromSource (int source_row) const
+{
+  if (source_row < 0 || source_row >= (int) reverse_.size()) return -1;
+  return reverse_[source_row];
+}
+
+int SortFilterProxyModel::FindPrefix (const String& prefix) const
+{
+  if (prefix.empty()) return -1;
+
+  SearchCompare search = { this };
+  std::vector<int>::const_iterator it = std::lower_bound(
+      search_index_.begin(), search_index_.end(), prefix, search);
+
+  for (; it != search_index_.end(); it++) {
+    if (!MatchText(search.text(*it), prefix, true)) break;
+    if (reverse_[*it] >= 0) return reverse_[*it];
+  }
+
+  return -1;
+}
+
+int SortFilterProxyModel::FindSubstring (const String& text, int from) const
+{
+  const int count = (int) mapping_.size();
+  if (count == 0) return -1;
+
+  from = std::max(std::min(from, count - 1), 0);
+
+  int row = 0;
+  const String* str = 0;
+  for (int i = 0; i < count; i++) {
+    row = (from + i) % count;
+    str = GetSourceText(mapping_[row], 0);
+    if (str && MatchText(*str, text, false)) return row;
+  }
+
+  return -1;
+}
+
+int SortFilterProxyModel::GetRowCount (const ModelIndex& parent) const
+{
+  return (int) mapping_.size();
+}
+
+int SortFilterProxyModel::GetColumnCount (const ModelIndex& parent) const
+{
+  return mapping_.empty() ? 0 : columns_;
+}
+
+int SortFilterProxyModel::GetPreferredColumnWidth (int index,
+                                                   const ModelIndex& parent) const
+{
+  return source_ ? source_->GetPreferredColumnWidth(index) : 0;
+}
+
+int SortFilterProxyModel::GetPreferredRowHeight (int index,
+                                                 const ModelIndex& parent) const
+{
+  return source_ ?
+      source_->GetPreferredRowHeight(MapToSource(index)) :
+      Font::default_height();
+}
+
+bool SortFilterProxyModel::InsertColumns (int column,
+                                          int count,
+                                          const ModelIndex& parent)
+{
+  // change the source model instead
+  return false;
+}
+
+bool SortFilterProxyModel::RemoveColumns (int column,
+                                          int count,
+                                          const ModelIndex& parent)
+{
+  return false;
+}
+
+bool SortFilterProxyModel::InsertRows (int row,
+                                       int count,
+                                       const ModelIndex& parent)
+{
+  return false;
+}
+
+bool SortFilterProxyModel::RemoveRows (int row,
+                                       int count,
+                                       const ModelIndex& parent)
+{
+  return false;
+}
+
+ModelIndex SortFilterProxyModel::GetRootIndex () const
+{
+  ModelIndex index;
+  set_index_node(index, root_);
+
+  return index;
+}
+
+ModelIndex SortFilterProxyModel::GetIndex (int row,
+                                           int column,
+                                           const ModelIndex& parent) const
+{
+  ModelIndex index;
+
+  if (get_index_node(parent) != root_) return index;
+  if (row < 0 || row >= (int) mapping_.size()) return index;
+
+  ModelNode* node = nodes_[mapping_[row]];
+  while (node && (column > 0)) {
+    node = node->right;
+    column--;
+  }
+
+  if (node) set_index_node(index, node);
+  return index;
+}
+
+bool SortFilterProxyModel::LessThan (int source_left, int source_right) const
+{
+  const String* left = GetSourceText(source_left, sort_column_);
+  const String* right = GetSourceText(source_right, sort_column_);
+
+  if (left && right) return CompareText(*left, *right) < 0;
+
+  // cells without text go first
+  return (left == 0) && (right != 0);
+}
+
+bool SortFilterProxyModel::Accept (int source_row) const
+{
+  if (filter_.empty()) return true;
+
+  const String* text = GetSourceText(source_row, filter_column_);
+  if (text == 0) return false;
+
+  return MatchText(*text, filter_, filter_mode_ == FilterPrefix);
+}
+
+const String* SortFilterProxyModel::GetSourceText (int source_row,
+                                                   int column) const
+{
+  if (source_row < 0 || source_row >= (int) source_rows_.size()) return 0;
+  if (column < 0) return 0;
+  if (column == 0) return texts_[source_row];
+
+  const ModelNode* node = source_rows_[source_row];
+  while (node && (column > 0)) {
+    node = node->right;
+    column--;
+  }
+
+  return GetNodeText(node);
+}
+
+int SortFilterProxyModel::CompareText (const String& a, const String& b)
+{
+  int result = CompareFolded(a, b);
+  if (result != 0) return result;
+
+  return a.compare(b);
+}
+
+bool SortFilterProxyModel::MatchText (const String& str,
+                                      const String& pattern,
+                                      bool prefix)
+{
+  if (pattern.empty()) return true;
+  if (pattern.length() > str.length()) return false;
+
+  const size_t last = prefix ? 0 : (str.length() - pattern.length());
+  size_t j = 0;
+
+  for (size_t i = 0; i <= last; i++) {
+    for (j = 0; j < pattern.length(); j++) {
+      if (FoldCase(str[i + j]) != FoldCase(pattern[j])) break;
+    }
+    if (j == pattern.length()) return true;
+  }
+
+  return false;
+}
+
+int SortFilterProxyModel::GetSortGroup (int source_row) const
+{
+  return 0;
+}
+
+bool SortFilterProxyModel::Before (int source_left, int source_right) const
+{
+  if (sort_column_ >= 0) {
+    int left_group = GetSortGroup(source_left);
+    int right_group = GetSortGroup(source_right);
+    if (left_group != right_group) return left_group < right_group;
+
+    if (LessThan(source_left, source_right))
+      return sort_order_ == AscendingOrder;
+    if (LessThan(source_right, source_left))
+      return sort_order_ == DescendingOrder;
+  }
+
+  // keep the source order of equal rows
+  return source_left < source_right;
+}
+
+void SortFilterProxyModel::Sort ()
+{
+  SortCompare sort = { this };
+  std::sort(mapping_.begin(), mapping_.end(), sort);
+}
+
+size_t SortFilterProxyModel::Merge (std::vector<int>* source_rows)
+{
+  size_t j = 0;
+  for (size_t i = 0; i < source_rows->size(); i++) {
+    if (Accept((*source_rows)[i])) {
+      (*source_rows)[j] = (*source_rows)[i];
+      CreateNode((*source_rows)[j]);
+      j++;
+    }
+  }
+  source_rows->resize(j);
+
+  if (j == 0) return mapping_.size();
+
+  SortCompare sort = { this };
+  std::sort(source_rows->begin(), source_rows->end(), sort);
+
+  return MergeSorted(&mapping_, *source_rows, sort);
+}
+
+ModelNode* SortFilterProxyModel::CreateNode (int source_row)
+{
+  DBG_ASSERT(nodes_[source_row] == 0);
+
+  const ModelNode* source = source_rows_[source_row];
+
+  ModelNode* first = new ModelNode;
+  ModelNode* last = first;
+  first->data = source->data;
+  first->column = 0;
+
+  int column = 1;
+  for (source = source->right; source; source = source->right) {
+    last->right = new ModelNode;
+    last->right->left = last;
+    last = last->right;
+    last->data = source->data;
+    last->column = column++;
+  }
+
+  nodes_[source_row] = first;
+  return first;
+}
+
+void SortFilterProxyModel::DestroyNode (int source_row)
+{
+  ModelNode* node = nodes_[source_row];
+  ModelNode* right = 0;
+
+  while (node) {
+    right = node->right;
+    delete node;
+    node = right;
+  }
+
+  nodes_[source_row] = 0;
+}
+
+void SortFilterProxyModel::LinkRows (size_t from)
+{
+  const int size = (int) mapping_.size();
+
+  // the row before the first changed one links to a new row below it
+  if (from > 0) {
+    from--;
+  } else {
+    std::fill(reverse_.begin(), reverse_.end(), -1);
+  }
+
+  ModelNode* node = 0;
+  for (int i = (int) from; i < size; i++) {
+    node = nodes_[mapping_[i]];
+    node->up = i > 0 ? nodes_[mapping_[i - 1]] : 0;
+    node->down = (i + 1) < size ? nodes_[mapping_[i + 1]] : 0;
+    node->parent = 0;
+    node->row = i;
+    reverse_[mapping_[i]] = i;
+  }
+
+  if (size > 0) {
+    root_->child = nodes_[mapping_[0]];
+    root_->child->parent = root_;
+  } else {
+    root_->child = 0;
+  }
+}
+
+void SortFilterProxyModel::DestroyAllNodes ()
+{
+  for (size_t i = 0; i < nodes_.size(); i++) {
+    DestroyNode((int) i);
+  }
+
+  root_->child = 0;
+}
+
+}
@@ -21,6 +21,8 @@
  * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
  */
 
+#include <algorithm>
+
 #include <boost/smart_ptr.hpp>
 
 #include <blendint/opengl/opengl.hpp>
@@ -34,7 +36,10 @@ SplitterHandle::SplitterHandle (Orientation orientation)
     :
       AbstractWidget(),
       orientation_(orientation),
-      vao_(0),
+      lines_first_(0),
+      lines_capacity_(0),
+      dark_lines_(0),
+      light_lines_(0),
       highlight_(false),
       pressed_(false),
       prev_size_(0),
@@ -47,49 +52,16 @@ SplitterHandle::SplitterHandle (Orientation orientation)
     set_size(kHandlwWidth, kHandleLength);
   }
 
-  glGenVertexArrays(1, &vao_);
-
-  glBindVertexArray(vao_);
-
-  vbo_.generate();
-  vbo_.bind();
-
-  std::vector<GLfloat> vertices(8, 0.f);
-
-  if (orientation == Horizontal) {
-    vertices[2] = kHandleLength;
-    //vertices[3] = 0.f;
-
-    //vertices[4] = 0.f;
-    vertices[5] = 1.f;
-
-    vertices[6] = kHandleLength;
-    vertices[7] = 1.f;
-  } else {
-    vertices[2] = 1.f;
-    //vertices[3] = 0.f;
-
-    //vertices[4] = 0.f;
-    vertices[5] = kHandleLength;
-
-    vertices[6] = 1.f;
-    vertices[7] = kHandleLength;
-  }
-
-  vbo_.set_data(sizeof(GLfloat) * vertices.size(), &vertices[0]);
-
-  glEnableVertexAttribArray(AttributeCoord);
-  glVertexAttribPointer(AttributeCoord, 2,
-  GL_FLOAT,
-                        GL_FALSE, 0, BUFFER_OFFSET(0));
-
-  glBindVertexArray(0);
-  vbo_.reset();
+  UpdateLines();
 }
 
 SplitterHandle::~SplitterHandle ()
 {
-  glDeleteVertexArrays(1, &vao_);
+  // the arena is gone if the context was released before this
+  GLVertexArena* arena = AbstractWindow::vertex_arena(2);
+  if (arena && lines_capacity_ > 0) {
+    arena->Free(lines_first_, lines_capacity_);
+  }
 }
 
 Size SplitterHandle::GetPreferredSize () const
@@ -145,56 +117,9 @@ void SplitterHandle::PerformSizeUpdate (const AbstractView* source,
                                         int height)
 {
   if (target == this) {
-
     set_size(width, height);
-
-    if (orientation_ == Horizontal) {
-
-      if (size().width() <= kHandleLength) {
-
-        std::vector<GLfloat> vertices(8, 0.f);
-
-        vertices[2] = (GLfloat) size().width();
-        //vertices[3] = 0.f;
-
-        //vertices[4] = 0.f;
-        vertices[5] = 1.f;
-
-        vertices[6] = (GLfloat) size().width();
-        vertices[7] = 1.f;
-
-        vbo_.bind();
-        vbo_.set_data(sizeof(GLfloat) * vertices.size(), &vertices[0]);
-        vbo_.reset();
-
-        RequestRedraw();
-
-      }
-
-    } else {
-
-      if (size().height() <= kHandleLength) {
-
-        std::vector<GLfloat> vertices(8, 0.f);
-
-        vertices[2] = 1.f;
-        //vertices[3] = 0.f;
-
-        //vertices[4] = 0.f;
-        vertices[5] = (GLfloat) size().height();
-
-        vertices[6] = 1.f;
-        vertices[7] = (GLfloat) size().height();
-
-        vbo_.bind();
-        vbo_.set_data(sizeof(GLfloat) * vertices.size(), &vertices[0]);
-        vbo_.reset();
-
-        RequestRedraw();
-
-      }
-
-    }
+    UpdateLines();
+    RequestRedraw();
   }
 
   if (source == this) {
@@ -219,74 +144,24 @@ Response SplitterHandle::Draw (AbstractWindow* context)
         AbstractWindow::shaders()->location(Shaders::WIDGET_TRIANGLE_GAMMA), 0);
   }
 
-  float x = 0.f;
-  float y = 0.f;
+  glUniform2f(
+      AbstractWindow::shaders()->location(Shaders::WIDGET_TRIANGLE_POSITION),
+      0.f, 0.f);
 
-  glBindVertexArray(vao_);
-
-  if (orientation_ == Horizontal) {
+  // the lines of one color are drawn in one call
+  GLVertexArena* arena = AbstractWindow::vertex_arena(2);
 
-    if (size().width() > kHandleLength)
-      x = (size().width() - kHandleLength) / 2.f;
-
-    y = size().height() - 2.f;
-    glVertexAttrib4f(AttributeColor, 0.16f, 0.16f, 0.16f, 1.f);
-    while (y > 0.f) {
-
-      glUniform2f(
-          AbstractWindow::shaders()->location(
-              Shaders::WIDGET_TRIANGLE_POSITION),
-          x, y);
-      glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-
-      y -= 3.f;
-    }
-
-    y = size().height() - 3.f;
-    glVertexAttrib4f(AttributeColor, 1.f, 1.f, 1.f, 0.16f);
-    while (y > 0.f) {
-
-      glUniform2f(
-          AbstractWindow::shaders()->location(
-              Shaders::WIDGET_TRIANGLE_POSITION),
-          x, y);
-      glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-
-      y -= 3.f;
-    }
-
-  } else {
-
-    if (size().height() > kHandleLength)
-      y = (size().height() - kHandleLength) / 2.f;
-
-    x = 1.f;
-    glVertexAttrib4f(AttributeColor, 0.16f, 0.16f, 0.16f, 1.f);
-    while (x < (size().width())) {
-
-      glUniform2f(
-          AbstractWindow::shaders()->location(
-              Shaders::WIDGET_TRIANGLE_POSITION),
-          x, y);
-      glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-
-      x += 3.f;
-    }
-
-    x = 2.f;
-    glVertexAttrib4f(AttributeColor, 1.f, 1.f, 1.f, 0.16f);
-    while (x < (size().width())) {
-
-      glUniform2f(
-          AbstractWindow::shaders()->location(
-              Shaders::WIDGET_TRIANGLE_POSITION),
-          x, y);
-      glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-
-      x += 3.f;
-    }
+  glVertexAttrib4f(AttributeColor, 0.16f, 0.16f, 0.16f, 1.f);
+  for (GLsizei i = 0; i < dark_lines_; i++) {
+    arena->Submit(GL_TRIANGLE_STRIP, lines_first_ + i * 4, 4);
+  }
+  arena->Flush();
 
+  glVertexAttrib4f(AttributeColor, 1.f, 1.f, 1.f, 0.16f);
+  for (GLsizei i = dark_lines_; i < (dark_lines_ + light_lines_); i++) {
+    arena->Submit(GL_TRIANGLE_STRIP, lines_first_ + i * 4, 4);
   }
+  arena->Flush();
 
   return Finish;
 }
@@ -384,6 +259,64 @@ Response SplitterHandle::PerformMouseMove (AbstractWindow* context)
   return Finish;
 }
 
+void SplitterHandle::UpdateLines ()
+{
+  std::vector<GLfloat> vertices;
+
+  if (orientation_ == Horizontal) {
+
+    // lines of 1 pixel, at most kHandleLength long and centered
+    GLfloat length = (GLfloat) std::min(size().width(), kHandleLength);
+    GLfloat x = (size().width() - length) / 2.f;
+
+    dark_lines_ = 0;
+    for (GLfloat y = size().height() - 2.f; y > 0.f; y -= 3.f) {
+      GLfloat line[] = { x, y, x + length, y, x, y + 1.f, x + length, y + 1.f };
+      vertices.insert(vertices.end(), line, line + 8);
+      dark_lines_++;
+    }
+
+    light_lines_ = 0;
+    for (GLfloat y = size().height() - 3.f; y > 0.f; y -= 3.f) {
+      GLfloat line[] = { x, y, x + length, y, x, y + 1.f, x + length, y + 1.f };
+      vertices.insert(vertices.end(), line, line + 8);
+      light_lines_++;
+    }
+
+  } else {
+
+    GLfloat length = (GLfloat) std::min(size().height(), kHandleLength);
+    GLfloat y = (size().height() - length) / 2.f;
+
+    dark_lines_ = 0;
+    for (GLfloat x = 1.f; x < size().width(); x += 3.f) {
+      GLfloat line[] = { x, y, x + 1.f, y, x, y + length, x + 1.f, y + length };
+      vertices.insert(vertices.end(), line, line + 8);
+      dark_lines_++;
+    }
+
+    light_lines_ = 0;
+    for (GLfloat x = 2.f; x < size().width(); x += 3.f) {
+      GLfloat line[] = { x, y, x + 1.f, y, x, y + length, x + 1.f, y + length };
+      vertices.insert(vertices.end(), line, line + 8);
+      light_lines_++;
+    }
+
+  }
+
+  GLsizei count = (dark_lines_ + light_lines_) * 4;
+  if (count == 0) return;
+
+  GLVertexArena* arena = AbstractWindow::vertex_arena(2);
+  if (lines_capacity_ < count) {
+    if (lines_capacity_ > 0) arena->Free(lines_first_, lines_capacity_);
+    lines_first_ = arena->Allocate(count);
+    lines_capacity_ = GLVertexArena::allocated_size(count);
+  }
+
+  arena->Upload(lines_first_, count, &vertices[0]);
+}
+
 Splitter::Splitter (Orientation orientation)
     : AbstractWidget(), orientation_(orientation)
 {
@@ -27,23 +27,21 @@
 namespace BlendInt {
 
 StringListModel::StringListModel()
-    : AbstractListModel(),
-      rows_(0)
+    : AbstractArrayListModel()
 {
 
 }
 
 StringListModel::~StringListModel()
 {
-  rows_ = 0;
 }
 
 void StringListModel::AddString (const String& string)
 {
   ModelIndex root = GetRootIndex();
-  if(InsertRow(rows_, root)) {
+  if(InsertRow(row_count(), root)) {
     RefPtr<Text> data(new Text(string));
-    ModelIndex index = GetIndex(rows_ - 1, 0, root);
+    ModelIndex index = GetIndex(row_count() - 1, 0, root);
     set_index_data(index, data);
   }
 }
@@ -53,7 +51,7 @@ void StringListModel::InsertString (int row, const String& string)
   ModelIndex root = GetRootIndex();
   if(InsertRow(row, root)) {
     RefPtr<Text> data(new Text(string));
-    int valid_row = std::min(row, rows_ - 1);
+    int valid_row = std::min(row, row_count() - 1);
     ModelIndex index = GetIndex(valid_row, 0, root);
     set_index_data(index, data);
   }
@@ -61,7 +59,7 @@ void StringListModel::InsertString (int row, const String& string)
 
 int StringListModel::GetRowCount (const ModelIndex& parent) const
 {
-  return rows_;
+  return row_count();
 }
 
 int StringListModel::GetColumnCount (const ModelIndex& parent) const
@@ -84,14 +82,7 @@ bool StringListModel::RemoveColumns (int column, int count,
 bool StringListModel::InsertRows (int row, int count,
                                   const ModelIndex& parent)
 {
-  bool retval = false;
-
-  retval = AbstractListModel::InsertRows(row, count, parent);
-  if (retval) {
-    rows_ += count;
-  }
-
-  return retval;
+  return AbstractArrayListModel::InsertRows(row, count, parent);
 }
 
 int StringListModel::GetPreferredColumnWidth (int index,
@@ -110,18 +101,7 @@ int StringListModel::GetPreferredRowHeight (int index,
 bool StringListModel::RemoveRows (int row, int count,
                                   const ModelIndex& parent)
 {
-  bool retval = false;
-
-  retval = AbstractListModel::RemoveRows(row, count, parent);
-  if(retval) {
-
-    if((row + count) > rows_) {	// if count too large
-      count = rows_ - row;
-    }
-    rows_ -= count;
-  }
-
-  return retval;
+  return AbstractArrayListModel::RemoveRows(row, count, parent);
 }
 
 #ifdef DEBUG
@@ -0,0 +1,627 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free software:
+ * you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is distributed in
+ * the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+#include <algorithm>
+
+#include <blendint/opengl/opengl.hpp>
+
+#include <blendint/gui/text-editor.hpp>
+#include <blendint/gui/abstract-window.hpp>
+
+namespace BlendInt {
+
+Margin TextEditor::kPadding = Margin(2, 2, 2, 2);
+
+TextEditor::TextEditor ()
+: AbstractRoundWidget(),
+  cursor_(2),
+  first_line_(0),
+  cursor_line_(0),
+  cursor_column_(0),
+  x_offset_(0),
+  focused_(false),
+  hovered_(false)
+{
+  set_size(320, 240);
+
+  InitializeTextEditor();
+}
+
+TextEditor::TextEditor (const String& text)
+: AbstractRoundWidget(),
+  cursor_(2),
+  document_(text),
+  first_line_(0),
+  cursor_line_(0),
+  cursor_column_(0),
+  x_offset_(0),
+  focused_(false),
+  hovered_(false)
+{
+  set_size(320, 240);
+
+  InitializeTextEditor();
+}
+
+TextEditor::~TextEditor ()
+{
+}
+
+void TextEditor::SetText (const String& text)
+{
+  document_.SetText(text);
+
+  first_line_ = 0;
+  cursor_line_ = 0;
+  cursor_column_ = 0;
+  x_offset_ = 0;
+
+  RequestRedraw();
+}
+
+String TextEditor::GetText () const
+{
+  return document_.GetText();
+}
+
+void TextEditor::ClearText ()
+{
+  document_.Clear();
+  lines_.clear();
+
+  first_line_ = 0;
+  cursor_line_ = 0;
+  cursor_column_ = 0;
+  x_offset_ = 0;
+
+  RequestRedraw();
+}
+
+void TextEditor::SetFont (const Font& font)
+{
+  if (font_ == font) return;
+
+  font_ = font;
+
+  // the visible line count may change
+  lines_.clear();
+  UpdateGeometries();
+  EnsureCursorVisible();
+
+  RequestRedraw();
+}
+
+void TextEditor::SetCursor (size_t line, size_t column)
+{
+  cursor_line_ = std::min(line, document_.line_count() - 1);
+  cursor_column_ = std::min(column, document_.line_length(cursor_line_));
+
+  EnsureCursorVisible();
+  RequestRedraw();
+}
+
+Size TextEditor::GetPreferredSize () const
+{
+  int w = 320;
+  int h = font_.height() * 10;
+
+  w += pixel_size(kPadding.hsum());
+  h += pixel_size(kPadding.vsum());
+
+  return Size(w, h);
+}
+
+bool TextEditor::IsExpandX () const
+{
+  return true;
+}
+
+bool TextEditor::IsExpandY () const
+{
+  return true;
+}
+
+void TextEditor::PerformSizeUpdate (const AbstractView* source,
+                                    const AbstractView* target,
+                                    int width,
+                                    int height)
+{
+  if (target == this) {
+
+    set_size(width, height);
+    UpdateGeometries();
+
+    if (lines_.size() > (size_t) GetVisibleLineCount()) {
+      lines_.resize(GetVisibleLineCount());
+    }
+    EnsureCursorVisible();
+
+    RequestRedraw();
+  }
+
+  if (source == this) {
+    report_size_update(source, target, width, height);
+  }
+}
+
+void TextEditor::PerformRoundTypeUpdate (int round_type)
+{
+  set_round_type(round_type);
+  UpdateGeometries();
+  RequestRedraw();
+}
+
+void TextEditor::PerformRoundRadiusUpdate (float radius)
+{
+  set_round_radius(radius);
+  UpdateGeometries();
+  RequestRedraw();
+}
+
+void TextEditor::PerformFocusOn (AbstractWindow* context)
+{
+  focused_ = true;
+  RequestRedraw();
+}
+
+void TextEditor::PerformFocusOff (AbstractWindow* context)
+{
+  focused_ = false;
+  RequestRedraw();
+}
+
+void TextEditor::PerformHoverIn (AbstractWindow* context)
+{
+  hovered_ = true;
+  context->PushCursor();
+  context->SetCursor(IBeamCursor);
+}
+
+void TextEditor::PerformHoverOut (AbstractWindow* context)
+{
+  hovered_ = false;
+  context->PopCursor();
+}
+
+Response TextEditor::PerformKeyPress (AbstractWindow* context)
+{
+  if (!context->GetTextInput().empty()) {
+    InsertText(context->GetTextInput());
+    RequestRedraw();
+    return Finish;
+  }
+
+  size_t page = (size_t) std::max(GetVisibleLineCount() - 1, 1);
+
+  switch (context->GetKeyInput()) {
+
+    case Key_Enter:
+    case Key_KP_Enter: {
+      InsertText(String("\n"));
+      break;
+    }
+
+    case Key_Backspace: {
+      DisposeBackspacePress();
+      break;
+    }
+
+    case Key_Delete: {
+      DisposeDeletePress();
+      break;
+    }
+
+    case Key_Left: {
+      if (cursor_column_ > 0) {
+        cursor_column_--;
+      } else if (cursor_line_ > 0) {
+        cursor_line_--;
+        cursor_column_ = document_.line_length(cursor_line_);
+      }
+      break;
+    }
+
+    case Key_Right: {
+      if (cursor_column_ < document_.line_length(cursor_line_)) {
+        cursor_column_++;
+      } else if ((cursor_line_ + 1) < document_.line_count()) {
+        cursor_line_++;
+        cursor_column_ = 0;
+      }
+      break;
+    }
+
+    case Key_Up: {
+      if (cursor_line_ > 0) MoveCursorToLine(cursor_line_ - 1);
+      break;
+    }
+
+    case Key_Down: {
+      MoveCursorToLine(cursor_line_ + 1);
+      break;
+    }
+
+    case Key_PageUp: {
+      MoveCursorToLine(cursor_line_ > page ? (cursor_line_ - page) : 0);
+      break;
+    }
+
+    case Key_PageDown: {
+      MoveCursorToLine(cursor_line_ + page);
+      break;
+    }
+
+    case Key_Home: {
+      cursor_column_ = 0;
+      break;
+    }
+
+    case Key_End: {
+      cursor_column_ = document_.line_length(cursor_line_);
+      break;
+    }
+
+    default:
+      return Finish;
+  }
+
+  EnsureCursorVisible();
+  RequestRedraw();
+
+  return Finish;
+}
+
+Response TextEditor::PerformMousePress (AbstractWindow* context)
+{
+  int line_height = std::max(font_.height(), 1);
+  int y = size().height() - pixel_size(kPadding.top())
+      - context->local_cursor_position().y();
+  int x = context->local_cursor_position().x() - pixel_size(kPadding.left())
+      + x_offset_;
+
+  size_t line = first_line_ + (size_t) (std::max(y, 0) / line_height);
+  line = std::min(line, document_.line_count() - 1);
+
+  size_t column = 0;
+  Text* text = GetLineText(line);
+  if (text && x > 0) {
+    column = text->layout().GetIndex(x);
+    // the closer edge of the glyph
+    if ((column < text->length())
+        && ((x - text->layout().GetX(column))
+            > (text->layout().GetX(column + 1) - x))) {
+      column++;
+    }
+  }
+
+  if ((line != cursor_line_) || (column != cursor_column_)) {
+    cursor_line_ = line;
+    cursor_column_ = column;
+    EnsureCursorVisible();
+    RequestRedraw();
+  }
+
+  return Finish;
+}
+
+Response TextEditor::Draw (AbstractWindow* context)
+{
+  AbstractWindow::shaders()->widget_inner_program()->use();
+
+  glUniform4fv(AbstractWindow::shaders()->location(Shaders::WIDGET_INNER_COLOR),
+               1, AbstractWindow::theme()->text().inner.data());
+  glUniform1i(AbstractWindow::shaders()->location(Shaders::WIDGET_INNER_GAMMA),
+              0);
+  glUniform1i(
+      AbstractWindow::shaders()->location(Shaders::WIDGET_INNER_SHADED),
+      context->theme()->text().shaded);
+
+  geometry_.DrawInner(GL_TRIANGLE_FAN, outline_vertex_count(round_type()) + 2);
+
+  AbstractWindow::shaders()->widget_outer_program()->use();
+
+  glUniform4fv(AbstractWindow::shaders()->location(Shaders::WIDGET_OUTER_COLOR),
+               1, AbstractWindow::theme()->text().outline.data());
+  glUniform2f(
+      AbstractWindow::shaders()->location(Shaders::WIDGET_OUTER_OFFSET), 0.f,
+      0.f);
+
+  geometry_.DrawOuter(GL_TRIANGLE_STRIP,
+                      outline_vertex_count(round_type()) * 2 + 2);
+
+  if (emboss()) {
+    glUniform4f(
+        AbstractWindow::shaders()->location(Shaders::WIDGET_OUTER_COLOR), 1.0f,
+        1.0f, 1.0f, 0.16f);
+    glUniform2f(
+        AbstractWindow::shaders()->location(Shaders::WIDGET_OUTER_OFFSET),
+        0.f, -1.f);
+    geometry_.DrawOuter(GL_TRIANGLE_STRIP,
+                        emboss_vertex_count(round_type()) * 2);
+  }
+
+  const int line_height = font_.height();
+  const int top = size().height() - pixel_size(kPadding.top());
+  const int left = pixel_size(kPadding.left());
+  const int w = size().width() - pixel_size(kPadding.hsum());
+  const int count = GetVisibleLineCount();
+
+  int cursor_x = -1;
+  int cursor_y = 0;
+
+  Text* text = 0;
+  size_t line = 0;
+  size_t start = 0;
+  int x = 0;
+  int y = 0;
+
+  for (int i = 0; i < count; i++) {
+
+    line = first_line_ + i;
+    if (line >= document_.line_count()) break;
+
+    text = GetLineText(line);
+    y = top - (i + 1) * line_height;
+
+    // the first glyph not scrolled out on the left
+    start = text->layout().GetIndex(x_offset_);
+    if ((start < text->length()) && (text->layout().GetX(start) < x_offset_)) {
+      start++;
+    }
+    x = left + text->layout().GetX(start) - x_offset_;
+
+    if (start < text->length()) {
+      text->DrawWithCursor(x, y - font_.descender(), start, start,
+                           w - (x - left),
+                           AbstractWindow::theme()->text().text);
+    }
+
+    if (line == cursor_line_) {
+      cursor_x = left + text->layout().GetX(cursor_column_) - x_offset_;
+      cursor_y = y;
+    }
+  }
+
+  if (focused_ && (cursor_x >= left)) {
+
+    AbstractWindow::shaders()->widget_triangle_program()->use();
+    glUniform2f(
+        AbstractWindow::shaders()->location(Shaders::WIDGET_TRIANGLE_POSITION),
+        cursor_x, cursor_y);
+    glUniform1i(
+        AbstractWindow::shaders()->location(Shaders::WIDGET_TRIANGLE_GAMMA), 0);
+    glUniform1i(
+        AbstractWindow::shaders()->location(
+            Shaders::WIDGET_TRIANGLE_ANTI_ALIAS), 0);
+    glVertexAttrib4f(AttributeColor, 0.f, 0.f, 0.f, 1.f);
+
+    cursor_.DrawInner(GL_TRIANGLE_STRIP, 4);
+  }
+
+  return Finish;
+}
+
+void TextEditor::InitializeTextEditor ()
+{
+  UpdateGeometries();
+}
+
+void TextEditor::UpdateGeometries ()
+{
+  std::vector<GLfloat> inner_verts;
+  std::vector<GLfloat> outer_verts;
+
+  if (AbstractWindow::theme()->text().shaded) {
+    GenerateRoundedVertices(Vertical, AbstractWindow::theme()->text().shadetop,
+                            AbstractWindow::theme()->text().shadedown,
+                            &inner_verts, &outer_verts);
+  } else {
+    GenerateRoundedVertices(&inner_verts, &outer_verts);
+  }
+
+  geometry_.Update(inner_verts, outer_verts);
+
+  std::vector<GLfloat> cursor_verts(8, 0.f);
+
+  cursor_verts[2] = 1.f;
+  cursor_verts[5] = (GLfloat) font_.height();
+  cursor_verts[6] = 1.f;
+  cursor_verts[7] = (GLfloat) font_.height();
+
+  cursor_.Update(cursor_verts, std::vector<GLfloat>());
+}
+
+void TextEditor::InsertText (const String& text)
+{
+  size_t line = cursor_line_;
+  size_t column = cursor_column_;
+
+  Text* cached = FindLineText(line);
+
+  document_.Insert(&cursor_line_, &cursor_column_, text);
+
+  if (cached && (cursor_line_ == line)) {
+    // keep the Text in sync, only the inserted glyphs are measured
+    cached->Insert(column, text);
+  }
+
+  EnsureCursorVisible();
+}
+
+void TextEditor::DisposeBackspacePress ()
+{
+  if (cursor_column_ > 0) {
+
+    Text* cached = FindLineText(cursor_line_);
+
+    document_.Erase(cursor_line_, cursor_column_ - 1, cursor_line_,
+                    cursor_column_);
+    cursor_column_--;
+
+    if (cached) cached->Erase(cursor_column_, 1);
+
+  } else if (cursor_line_ > 0) {
+
+    // join with the previous line
+    size_t column = document_.line_length(cursor_line_ - 1);
+    Text* cached = FindLineText(cursor_line_ - 1);
+
+    document_.Erase(cursor_line_ - 1, column, cursor_line_, 0);
+    cursor_line_--;
+    cursor_column_ = column;
+
+    if (cached) {
+      String tail;
+      tail.assign(document_.line(cursor_line_), column, String::npos);
+      cached->Add(tail);
+    }
+  }
+}
+
+void TextEditor::DisposeDeletePress ()
+{
+  size_t length = document_.line_length(cursor_line_);
+  Text* cached = FindLineText(cursor_line_);
+
+  if (cursor_column_ < length) {
+
+    document_.Erase(cursor_line_, cursor_column_, cursor_line_,
+                    cursor_column_ + 1);
+
+    if (cached) cached->Erase(cursor_column_, 1);
+
+  } else if ((cursor_line_ + 1) < document_.line_count()) {
+
+    document_.Erase(cursor_line_, cursor_column_, cursor_line_ + 1, 0);
+
+    if (cached) {
+      String tail;
+      tail.assign(document_.line(cursor_line_), length, String::npos);
+      cached->Add(tail);
+    }
+  }
+}
+
+void TextEditor::MoveCursorToLine (size_t line)
+{
+  line = std::min(line, document_.line_count() - 1);
+  if (line == cursor_line_) return;
+
+  int x = 0;
+  Text* text = GetLineText(cursor_line_);
+  if (text) x = text->layout().GetX(cursor_column_);
+
+  cursor_line_ = line;
+  cursor_column_ = 0;
+  EnsureCursorVisible();
+
+  text = GetLineText(cursor_line_);
+  if (text) cursor_column_ = text->layout().GetIndex(x);
+}
+
+void TextEditor::EnsureCursorVisible ()
+{
+  size_t count = (size_t) std::max(GetVisibleLineCount(), 1);
+
+  if (cursor_line_ < first_line_) {
+    SetFirstVisibleLine(cursor_line_);
+  } else if (cursor_line_ >= (first_line_ + count)) {
+    SetFirstVisibleLine(cursor_line_ + 1 - count);
+  }
+
+  Text* text = GetLineText(cursor_line_);
+  if (!text) return;
+
+  int w = size().width() - pixel_size(kPadding.hsum());
+  int x = text->layout().GetX(cursor_column_);
+
+  if (x < x_offset_) {
+    x_offset_ = std::max(x - w / 4, 0);
+  } else if (x >= (x_offset_ + w)) {
+    x_offset_ = x - w + w / 4;
+  }
+}
+
+void TextEditor::SetFirstVisibleLine (size_t line)
+{
+  if (line == first_line_) return;
+
+  if (line > first_line_) {
+    size_t diff = line - first_line_;
+    if (diff < lines_.size()) {
+      std::rotate(lines_.begin(), lines_.begin() + diff, lines_.end());
+    }
+  } else {
+    size_t diff = first_line_ - line;
+    if (diff < lines_.size()) {
+      std::rotate(lines_.begin(), lines_.end() - diff, lines_.end());
+    }
+  }
+
+  // the rotated Text objects are reused for the new lines
+  first_line_ = line;
+}
+
+Text* TextEditor::GetLineText (size_t line)
+{
+  if ((line < first_line_) || (line >= document_.line_count())) return 0;
+
+  size_t index = line - first_line_;
+  if (index >= (size_t) std::max(GetVisibleLineCount(), 1)) return 0;
+
+  if (index >= lines_.size()) {
+    lines_.resize(index + 1);
+  }
+
+  RefPtr<Text>& text = lines_[index];
+  const String& content = document_.line(line);
+
+  if (!text) {
+    text.reset(new Text(content));
+    text->SetFont(font_);
+  } else if (text->text() != content) {
+    text->SetText(content);
+  }
+
+  return text.get();
+}
+
+Text* TextEditor::FindLineText (size_t line) const
+{
+  if (line < first_line_) return 0;
+
+  size_t index = line - first_line_;
+  if ((index >= lines_.size()) || !lines_[index]) return 0;
+
+  if (lines_[index]->text() != document_.line(line)) return 0;
+
+  return lines_[index].get();
+}
+
+int TextEditor::GetVisibleLineCount () const
+{
+  int h = size().height() - pixel_size(kPadding.vsum());
+  return h / std::max(font_.height(), 1);
+}
+
+}
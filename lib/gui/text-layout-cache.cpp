@@ -0,0 +1,107 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free software:
+ * you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is distributed in
+ * the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+
+#include <functional>
+
+#include <blendint/gui/text-layout-cache.hpp>
+
+namespace BlendInt {
+
+TextLayoutCache::EntryList TextLayoutCache::kEntries;
+
+std::map<TextLayoutCache::Key, TextLayoutCache::EntryList::iterator> TextLayoutCache::kIndex;
+
+size_t TextLayoutCache::kCapacity = TextLayoutCache::kDefaultCapacity;
+
+unsigned long TextLayoutCache::kHits = 0;
+
+unsigned long TextLayoutCache::kMisses = 0;
+
+RefPtr<TextLayout> TextLayoutCache::Get (const Font& font, const String& text)
+{
+  Key key(font.hash(), std::hash<std::u32string>()(text));
+
+  std::map<Key, EntryList::iterator>::iterator it = kIndex.find(key);
+
+  if (it != kIndex.end()) {
+
+    EntryList::iterator entry = it->second;
+
+    if (entry->text == text) {
+
+      kHits++;
+      kEntries.splice(kEntries.begin(), kEntries, entry);
+
+      if (entry->layout->pending()
+          && (entry->layout->generation() != font.glyph_generation())) {
+        // a new layout, the old one may be still in use
+        entry->layout.reset(new TextLayout(font, text));
+      }
+
+      return entry->layout;
+    }
+
+    // another string with the same hash, replace it
+    kEntries.erase(entry);
+    kIndex.erase(it);
+  }
+
+  kMisses++;
+
+  Entry entry;
+  entry.key = key;
+  entry.text = text;
+  entry.layout.reset(new TextLayout(font, text));
+
+  kEntries.push_front(entry);
+  kIndex[key] = kEntries.begin();
+
+  Trim();
+
+  return entry.layout;
+}
+
+void TextLayoutCache::SetCapacity (size_t capacity)
+{
+  kCapacity = capacity;
+  Trim();
+}
+
+void TextLayoutCache::Clear ()
+{
+  kIndex.clear();
+  kEntries.clear();
+  kHits = 0;
+  kMisses = 0;
+}
+
+void TextLayoutCache::Trim ()
+{
+  while (kEntries.size() > kCapacity) {
+    kIndex.erase(kEntries.back().key);
+    kEntries.pop_back();
+  }
+}
+
+}
@@ -0,0 +1,159 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free software:
+ * you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is distributed in
+ * the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+
+#include <algorithm>
+
+#include <blendint/core/types.hpp>
+
+#include <blendint/gui/text-layout.hpp>
+
+namespace BlendInt {
+
+TextLayout::TextLayout ()
+: Object(),
+  offsets_(1, 0),
+  pending_(false),
+  generation_(0)
+{
+}
+
+TextLayout::TextLayout (const Font& font, const String& text)
+: Object(),
+  pending_(false),
+  generation_(0)
+{
+  Generate(font, text);
+}
+
+TextLayout::~TextLayout ()
+{
+}
+
+void TextLayout::Generate (const Font& font, const String& text)
+{
+  const size_t length = text.length();
+  const bool has_kerning = font.has_kerning();
+  const Glyph* fallback = font.fallback_glyph();
+  const Glyph* g = 0;
+  int x = 0;
+
+  offsets_.resize(length + 1);
+  kernings_.assign(length, 0);
+
+  pending_ = false;
+  generation_ = font.glyph_generation();
+
+  for (size_t i = 0; i < length; i++) {
+
+    g = font.glyph(text[i]);
+    if (g == fallback) pending_ = true;
+
+    if (has_kerning && ((i + 1) < length)) {
+      kernings_[i] = font.GetKerning(text[i], text[i + 1],
+                                     Font::KerningDefault).x;
+    }
+
+    offsets_[i] = x;
+    x += g->advance_x + kernings_[i];
+  }
+
+  offsets_[length] = x;
+}
+
+void TextLayout::Update (const Font& font,
+                         const String& text,
+                         size_t start,
+                         size_t removed,
+                         size_t inserted)
+{
+  DBG_ASSERT((start + removed) <= kernings_.size());
+  DBG_ASSERT((kernings_.size() - removed + inserted) == text.length());
+
+  const size_t length = text.length();
+  const bool has_kerning = font.has_kerning();
+  const Glyph* fallback = font.fallback_glyph();
+  const Glyph* g = 0;
+
+  offsets_.erase(offsets_.begin() + start,
+                 offsets_.begin() + start + removed);
+  kernings_.erase(kernings_.begin() + start,
+                  kernings_.begin() + start + removed);
+  offsets_.insert(offsets_.begin() + start, inserted, 0);
+  kernings_.insert(kernings_.begin() + start, inserted, 0);
+
+  // the kerning of the character before start may change
+  size_t first = (start > 0) ? (start - 1) : 0;
+  size_t last = start + inserted;
+  int x = (start > 0) ? offsets_[first] : 0;
+
+  for (size_t i = first; i < last; i++) {
+
+    g = font.glyph(text[i]);
+    if (g == fallback) pending_ = true;
+
+    kernings_[i] = 0;
+    if (has_kerning && ((i + 1) < length)) {
+      kernings_[i] = font.GetKerning(text[i], text[i + 1],
+                                     Font::KerningDefault).x;
+    }
+
+    offsets_[i] = x;
+    x += g->advance_x + kernings_[i];
+  }
+
+  // shift the characters after the edit
+  int delta = x - offsets_[last];
+  if (delta != 0) {
+    for (size_t i = last; i <= length; i++) {
+      offsets_[i] += delta;
+    }
+  }
+}
+
+int TextLayout::GetWidth (size_t length, size_t start) const
+{
+  const size_t n = kernings_.size();
+
+  if (start >= n) return 0;
+
+  size_t last = (length > (n - start)) ? n : (start + length);
+  if (last == start) return 0;
+
+  return offsets_[last] - offsets_[start] - kernings_[last - 1];
+}
+
+size_t TextLayout::GetIndex (int x, size_t start) const
+{
+  const size_t n = kernings_.size();
+
+  if (start >= n) return n;
+
+  // the first glyph which ends at or after x
+  std::vector<int>::const_iterator it = std::lower_bound(
+      offsets_.begin() + start + 1, offsets_.end(), offsets_[start] + x);
+
+  return (it - offsets_.begin()) - 1;
+}
+
+}
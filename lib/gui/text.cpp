@@ -29,81 +29,68 @@
 
 namespace BlendInt {
 
+GLuint Text::kQuadIndexBuffer = 0;
+
+size_t Text::kQuadIndexCapacity = 0;
+
 Text::Text (const String& text)
     : AbstractForm(),
       ascender_(0),
       descender_(0),
-      vao_(0),
+      pending_(false),
+      generation_(0),
+      evictions_(0),
+      dirty_from_(0),
+      first_(0),
+      capacity_(0),
       text_(text)
 {
-  int width;
-  std::vector<GLfloat> verts;
-  GenerateTextVertices(verts, &width, &ascender_, &descender_);
-
-  set_size(width, ascender_ - descender_);
-
-  glGenVertexArrays(1, &vao_);
-  glBindVertexArray(vao_);
-
-  vbo_.generate();
-  vbo_.bind();
-  vbo_.set_data(sizeof(GLfloat) * verts.size(), &verts[0]);
-
-  glEnableVertexAttribArray (AttributeCoord);
-  glVertexAttribPointer (AttributeCoord, 4, GL_FLOAT, GL_FALSE, 0, 0);
-
-  glBindVertexArray(0);
-  vbo_.reset();
+  ReloadBuffer();
 }
 
 Text::Text (const Text& text)
     : AbstractForm(),
       ascender_(0),
       descender_(0),
-      vao_(0),
-      text_(text.text_)
+      pending_(false),
+      generation_(0),
+      evictions_(0),
+      dirty_from_(0),
+      first_(0),
+      capacity_(0),
+      text_(text.text_),
+      font_(text.font_)
 {
-  int width;
-  std::vector<GLfloat> verts;
-  GenerateTextVertices(verts, &width, &ascender_, &descender_);
-
-  set_size(width, ascender_ - descender_);
-
-  glGenVertexArrays(1, &vao_);
-  glBindVertexArray(vao_);
-
-  vbo_.generate();
-  vbo_.bind();
-  vbo_.set_data(sizeof(GLfloat) * verts.size(), &verts[0]);
-
-  glEnableVertexAttribArray (AttributeCoord);
-  glVertexAttribPointer (AttributeCoord, 4, GL_FLOAT, GL_FALSE, 0, 0);
-
-  glBindVertexArray(0);
-  vbo_.reset();
+  ReloadBuffer();
 }
 
 Text::~Text ()
 {
-  glDeleteVertexArrays(1, &vao_);
+  // the arena is gone if the context was released before this
+  GLVertexArena* arena = AbstractWindow::vertex_arena(4);
+  if (arena && capacity_ > 0) {
+    arena->Free(first_, capacity_);
+  }
 }
 
 void Text::Add (const String& text)
 {
+  size_t start = text_.length();
   text_.append(text);
 
-  ReloadBuffer();
+  UpdateBuffer(start, 0, text.length());
 }
 
 void Text::Insert (size_t index, const String& text)
 {
   if(text.empty() || (index > text_.length())) {
+    index = text_.length();
     text_.append(text);
   } else {
     text_.insert(index, text);
   }
 
-  ReloadBuffer();
+  UpdateBuffer(index, 0, text.length());
 }
 
 void Text::SetText (const String& text)
@@ -114,9 +101,12 @@ void Text::SetText (const String& text)
 
 void Text::Erase(size_t index, size_t count)
 {
+  if(index >= text_.length()) return;
+
+  count = std::min(count, text_.length() - index);
   text_.erase(index, count);
 
-  ReloadBuffer();
+  UpdateBuffer(index, count, 0);
 }
     
 void Text::SetFont(const Font& font)
@@ -129,7 +119,7 @@ void Text::SetFont(const Font& font)
 
 size_t Text::GetTextWidth (size_t length, size_t start, bool count_kerning) const
 {
-  size_t width = font_.GetTextWidth(text_, length, start);
+  size_t width = layout_.GetWidth(length, start);
 
   if(count_kerning && font_.has_kerning()) {
 
@@ -137,12 +127,12 @@ size_t Text::GetTextWidth (size_t length, size_t start, bool count_kerning) cons
     int right_kerning = 0;
 
     if(start > 0) {
-      left_kerning = font_.GetKerning(text_[start - 1], text_[start]).x;
+      left_kerning = layout_.kerning(start - 1);
     }
 
     size_t last = start + length;
     if(last < (text_.length() - 1)) {
-      right_kerning = font_.GetKerning(text_[last], text_[last + 1]).x;
+      right_kerning = layout_.kerning(last);
     }
 
     width = width + left_kerning + right_kerning;
@@ -176,6 +166,8 @@ void Text::PerformSizeUpdate (int width, int height)
 void Text::Draw (int x, int y, const float* color_ptr, short gamma,
                  float rotate, float scale_x, float scale_y) const
 {
+  UpdatePendingGlyphs();
+
   AbstractWindow::shaders()->widget_text_program()->use();
 
   glActiveTexture(GL_TEXTURE0);
@@ -186,11 +178,7 @@ void Text::Draw (int x, int y, const float* color_ptr, short gamma,
   glUniform4fv(AbstractWindow::shaders()->location(Shaders::WIDGET_TEXT_COLOR), 1, color_ptr);
   glUniform1i(AbstractWindow::shaders()->location(Shaders::WIDGET_TEXT_TEXTURE), 0);
 
-  glBindVertexArray(vao_);
-  size_t str_len = text_.length();
-  for(size_t i = 0; i < str_len; i++) {
-    glDrawArrays(GL_TRIANGLE_STRIP, i * 4, 4);
-  }
+  DrawGlyphs(0, text_.length());
 }
 
 void Text::DrawInRect (const Rect& rect,
@@ -202,6 +190,8 @@ void Text::DrawInRect (const Rect& rect,
 {
   if(rect.zero()) return;
 
+  UpdatePendingGlyphs();
+
   int x = rect.left();
   int y = rect.bottom();
 
@@ -245,37 +235,10 @@ void Text::DrawInRect (const Rect& rect,
   glUniform4fv(AbstractWindow::shaders()->location(Shaders::WIDGET_TEXT_COLOR), 1, color_ptr);
   glUniform1i(AbstractWindow::shaders()->location(Shaders::WIDGET_TEXT_TEXTURE), 0);
 
-  glBindVertexArray(vao_);
-
-  const Glyph* g = 0;
-  int max = 0;
-  int count = 0;
-  String::const_iterator next_it;
-  Kerning kerning;
-
-  for(String::const_iterator it = text_.begin(); it != text_.end(); it++)
-  {
-    g = font_.glyph(*it);
-
-    if(font_.has_kerning()) {
-
-      next_it = it + 1;
-      if(next_it != text_.end()) {
-        kerning = font_.GetKerning(*it, *next_it, Font::KerningDefault);
-        max += (g->advance_x + kerning.x);
-      } else {
-        max += g->advance_x;
-      }
-
-    } else {
-      max += g->advance_x;
-    }
-
-    if ((align & AlignJustify) && (max > rect.width())) break;
-
-    glDrawArrays(GL_TRIANGLE_STRIP, count * 4, 4);
-
-    count++;
+  if (align & AlignJustify) {
+    DrawGlyphs(0, GetFittingLength(0, rect.width()));
+  } else {
+    DrawGlyphs(0, text_.length());
   }
 }
 
@@ -289,6 +252,8 @@ void Text::Draw (int x, int y, size_t length, size_t start,
 void Text::Draw (int x, int y, size_t length, size_t start,
                  const Color& color, short gamma) const
 {
+  UpdatePendingGlyphs();
+
   AbstractWindow::shaders()->widget_text_program()->use();
 
   glActiveTexture(GL_TEXTURE0);
@@ -299,12 +264,9 @@ void Text::Draw (int x, int y, size_t length, size_t start,
   glUniform4fv(AbstractWindow::shaders()->location(Shaders::WIDGET_TEXT_COLOR), 1, color.data());
   glUniform1i(AbstractWindow::shaders()->location(Shaders::WIDGET_TEXT_TEXTURE), 0);
 
-  glBindVertexArray(vao_);
   size_t str_len = text_.length();
-  size_t last = std::min(start + length, str_len);
-  for(size_t i = start; i < last; i++) {
-    glDrawArrays(GL_TRIANGLE_STRIP, i * 4, 4);
-  }
+  start = std::min(start, str_len);
+  DrawGlyphs(start, std::min(length, str_len - start));
 }
 
 void Text::DrawWithin (int x, int y, int width, short gamma) const
@@ -318,6 +280,8 @@ void Text::DrawWithin (int x, int y, int width, const Color& color,
 {
   if(width <= 0) return;
 
+  UpdatePendingGlyphs();
+
   AbstractWindow::shaders()->widget_text_program()->use();
 
   glActiveTexture(GL_TEXTURE0);
@@ -328,235 +292,238 @@ void Text::DrawWithin (int x, int y, int width, const Color& color,
   glUniform4fv(AbstractWindow::shaders()->location(Shaders::WIDGET_TEXT_COLOR), 1, color.data());
   glUniform1i(AbstractWindow::shaders()->location(Shaders::WIDGET_TEXT_TEXTURE), 0);
 
-  glBindVertexArray(vao_);
+  DrawGlyphs(0, GetFittingLength(0, width));
+}
 
-  const Glyph* g = 0;
-  int max = 0;
-  int count = 0;
-  String::const_iterator next_it;
-  Kerning kerning;
+int Text::DrawWithCursor(int x, int y, size_t index, size_t start, int width, const Color &color, short gamma) const
+{
+  if(width <= 0) return 0;
 
-  for(String::const_iterator it = text_.begin(); it != text_.end(); it++)
-  {
-    g = font_.glyph(*it);
+  UpdatePendingGlyphs();
 
-    if(font_.has_kerning()) {
+  start = std::min(start, text_.length());
+  size_t length = GetFittingLength(start, width);
 
-      next_it = it + 1;
-      if(next_it != text_.end()) {
-        kerning = font_.GetKerning(*it, *next_it, Font::KerningDefault);
-        max += (g->advance_x + kerning.x);
-      } else {
-        max += g->advance_x;
-      }
+  AbstractWindow::shaders()->widget_text_program()->use();
 
-    } else {
-      max += g->advance_x;
-    }
+  glActiveTexture(GL_TEXTURE0);
 
-    if (max > width) break;
+  font_.bind_texture();
 
-    glDrawArrays(GL_TRIANGLE_STRIP, count * 4, 4);
+  glUniform2f(AbstractWindow::shaders()->location(Shaders::WIDGET_TEXT_POSITION), x - layout_.GetX(start), y);
+  glUniform4fv(AbstractWindow::shaders()->location(Shaders::WIDGET_TEXT_COLOR), 1, color.data());
+  glUniform1i(AbstractWindow::shaders()->location(Shaders::WIDGET_TEXT_TEXTURE), 0);
 
-    count++;
-  }
+  DrawGlyphs(start, length);
+
+  // the cursor position relative to x
+  if(index < start) return 0;
+  return layout_.GetX(std::min(index, start + length)) - layout_.GetX(start);
 }
 
-int Text::DrawWithCursor(int x, int y, size_t index, size_t start, int width, const Color &color, short gamma) const
+int Text::DrawWithCursor(int x, int y, size_t index, size_t start, int width, short gamma) const
 {
-  int retval = 0;
-        
-  if(width <= 0) return retval;
+  Color color(0x000000FF);
 
+  return DrawWithCursor(x, y, index, start, width, color, gamma);
+}
+    
+void Text::GenerateTextVertices(size_t first, std::vector<GLfloat>* verts)
+{
+  const size_t count = text_.length() - first;
+  verts->resize(count * 16);
+
+  GLfloat* buf = verts->data();
+  int w = 0;	// pen position
   const Glyph* g = 0;
-  int max = 0;
-  size_t count = start;
-  Kerning kerning;
-  size_t i = 0;
-  size_t n = 0;
-  int ox = 0;
-
-  for(; (i < start) && (i < text_.length()); i++) {
-    g = font_.glyph(text_[i]);
+  const Glyph* fallback = font_.fallback_glyph();
+  const int page_height = font_.atlas_page_height();
+  int v = 0;	// v with the atlas page
 
-    if(font_.has_kerning()) {
+  for(size_t i = 0; i < count; i++)
+  {
+    g = font_.glyph(text_[first + i]);
+    if (g == fallback) pending_ = true;
+    v = g->offset_v + g->page * page_height;
+    w = layout_.GetX(first + i);
+
+    buf[i * 16 + 0] = w + g->bitmap_left;
+    buf[i * 16 + 1] = g->bitmap_top - g->bitmap_height;
+    buf[i * 16 + 2] = g->offset_u;
+    buf[i * 16 + 3] = v + g->bitmap_height;
+
+    buf[i * 16 + 4] = w + g->bitmap_left + g->bitmap_width;
+    buf[i * 16 + 5] = g->bitmap_top - g->bitmap_height;
+    buf[i * 16 + 6] = g->offset_u + g->bitmap_width;
+    buf[i * 16 + 7] = v + g->bitmap_height;
+
+    buf[i * 16 + 8] = w + g->bitmap_left;
+    buf[i * 16 + 9] = g->bitmap_top;
+    buf[i * 16 + 10] = g->offset_u;
+    buf[i * 16 + 11] = v;
+
+    buf[i * 16 + 12] = w + g->bitmap_left + g->bitmap_width;
+    buf[i * 16 + 13] = g->bitmap_top;
+    buf[i * 16 + 14] = g->offset_u + g->bitmap_width;
+    buf[i * 16 + 15] = v;
+  }
+}
 
-      n = i + 1;
-      if(n != text_.length()) {
-        kerning = font_.GetKerning(text_[i], text_[n], Font::KerningDefault);
-        ox -= (g->advance_x + kerning.x);
-      } else {
-        ox -= g->advance_x;
-      }
+void Text::MergeExtents (size_t start, size_t count)
+{
+  const Glyph* g = 0;
+  size_t last = std::min(start + count, text_.length());
 
-    } else {
-      ox -= g->advance_x;
-    }
+  for(size_t i = start; i < last; i++) {
+    g = font_.glyph(text_[i]);
+    ascender_ = std::max(g->bitmap_top, ascender_);
+    descender_ = std::min(g->bitmap_top - g->bitmap_height, descender_);
   }
+}
+    
+void Text::ReloadBuffer()
+{
+  // advances and kerning are queried once here
+  layout_.Generate(font_, text_);
+
+  pending_ = layout_.pending();
+  generation_ = layout_.generation();
+  evictions_ = font_.atlas_evictions();
+
+  ascender_ = 0;
+  descender_ = 0;
+  MergeExtents(0, text_.length());
+
+  // vertices are generated in the next draw
+  dirty_from_ = 0;
         
-  AbstractWindow::shaders()->widget_text_program()->use();
-        
-  glActiveTexture(GL_TEXTURE0);
-        
-  font_.bind_texture();
-        
-  glUniform2f(AbstractWindow::shaders()->location(Shaders::WIDGET_TEXT_POSITION), x + ox, y);
-  glUniform4fv(AbstractWindow::shaders()->location(Shaders::WIDGET_TEXT_COLOR), 1, color.data());
-  glUniform1i(AbstractWindow::shaders()->location(Shaders::WIDGET_TEXT_TEXTURE), 0);
-        
-  glBindVertexArray(vao_);
+  set_size(layout_.width(), ascender_ - descender_);
+}
 
-  int tmp = 0;
-  while(i < text_.length()) {
+void Text::UpdateBuffer (size_t start, size_t removed, size_t inserted)
+{
+  layout_.Update(font_, text_, start, removed, inserted);
+  if (layout_.pending()) pending_ = true;
 
-    g = font_.glyph(text_[i]);
+  if (removed > 0) {
+    ascender_ = 0;
+    descender_ = 0;
+    MergeExtents(0, text_.length());
+  } else {
+    MergeExtents(start, inserted);
+  }
 
-    if(count <= index) retval = tmp;
+  // the glyphs before start do not move
+  dirty_from_ = std::min(dirty_from_, start);
 
-    if(font_.has_kerning()) {
+  set_size(layout_.width(), ascender_ - descender_);
+}
 
-      n = i + 1;
-      if(n != text_.length()) {
-        kerning = font_.GetKerning(text_[i], text_[n], Font::KerningDefault);
-        tmp += (g->advance_x + kerning.x);
-      } else {
-        tmp += g->advance_x;
-      }
+void Text::UploadVertices ()
+{
+  GLVertexArena* arena = AbstractWindow::vertex_arena(4);
+  GLsizei count = (GLsizei) (text_.length() * 4);
+  size_t first = dirty_from_;
 
-    } else {
-      tmp += g->advance_x;
-    }
+  if (capacity_ < count) {
 
-    if (tmp > width) {
-      break;
-    } else {
-      max = tmp;
+    GLsizei size = count;
+    if (capacity_ > 0) {
+      // the text is being edited, leave room for the next edits
+      size = std::max(count, capacity_ * 2);
+      arena->Free(first_, capacity_);
     }
 
-    glDrawArrays(GL_TRIANGLE_STRIP, count * 4, 4);
+    first_ = arena->Allocate(size);
+    capacity_ = GLVertexArena::allocated_size(size);
+    first = 0;
+  }
 
-    i++;
-    count++;
+  if (first < text_.length()) {
+    std::vector<GLfloat> verts;
+    GenerateTextVertices(first, &verts);
+    arena->Upload(first_ + first * 4, count - first * 4, &verts[0]);
   }
-        
-  if(count <= index) retval = max;
 
-  return retval;
+  ReserveQuadIndices(text_.length());
+
+  dirty_from_ = kClean;
 }
 
-int Text::DrawWithCursor(int x, int y, size_t index, size_t start, int width, short gamma) const
+size_t Text::GetFittingLength (size_t start, int width) const
 {
-  Color color(0x000000FF);
+  size_t last = start;
+  size_t str_len = text_.length();
 
-  return DrawWithCursor(x, y, index, start, width, color, gamma);
-}
-    
-void Text::GenerateTextVertices(std::vector<GLfloat> &verts, int* ptr_width, int* ptr_ascender, int* ptr_descender)
-{
-  size_t buf_size = text_.length() * 4 * 4;
-  if(verts.size() != buf_size) {
-    verts.resize(buf_size, 0.f);
+  while ((last < str_len) && ((layout_.GetX(last + 1) - layout_.GetX(start)) <= width)) {
+    last++;
   }
-        
-  int w = 0;	// width
-  int a = 0;	// ascender
-  int d = 0;	// descender
-  const Glyph* g = 0;
 
-  String::const_iterator next_it;
-
-  int count = 0;
-  if(font_.has_kerning()) {
-
-    Kerning kerning;
-    for(String::const_iterator it = text_.begin(); it != text_.end(); it++)
-    {
-      g = font_.glyph(*it);
-
-      verts[count * 16 + 0] = w + g->bitmap_left;
-      verts[count * 16 + 1] = g->bitmap_top - g->bitmap_height;
-      verts[count * 16 + 2] = g->offset_u;
-      verts[count * 16 + 3] = g->offset_v + g->bitmap_height;
-
-      verts[count * 16 + 4] = w + g->bitmap_left + g->bitmap_width;
-      verts[count * 16 + 5] = g->bitmap_top - g->bitmap_height;
-      verts[count * 16 + 6] = g->offset_u + g->bitmap_width;
-      verts[count * 16 + 7] = g->offset_v + g->bitmap_height;
-
-      verts[count * 16 + 8] = w + g->bitmap_left;
-      verts[count * 16 + 9] = g->bitmap_top;
-      verts[count * 16 + 10] = g->offset_u;
-      verts[count * 16 + 11] = g->offset_v;
-
-      verts[count * 16 + 12] = w + g->bitmap_left + g->bitmap_width;
-      verts[count * 16 + 13] = g->bitmap_top;
-      verts[count * 16 + 14] = g->offset_u + g->bitmap_width;
-      verts[count * 16 + 15] = g->offset_v;
-
-      next_it = it + 1;
-      if(next_it != text_.end()) {
-        kerning = font_.GetKerning(*it, *next_it, Font::KerningDefault);
-        w += (g->advance_x + kerning.x);
-      } else {
-        w += g->advance_x;
-      }
-      a = std::max(g->bitmap_top, a);
-      d = std::min(g->bitmap_top - g->bitmap_height, d);
-
-      count++;
-    }
+  return last - start;
+}
 
-  } else {
+void Text::DrawGlyphs (size_t start, size_t count) const
+{
+  if (count == 0) return;
 
-    for(String::const_iterator it = text_.begin(); it != text_.end(); it++)
-    {
-      g = font_.glyph(*it);
+  if (dirty_from_ != kClean) {
+    const_cast<Text*>(this)->UploadVertices();
+  }
 
-      verts[count * 16 + 0] = w + g->bitmap_left;
-      verts[count * 16 + 1] = g->bitmap_top - g->bitmap_height;
-      verts[count * 16 + 2] = g->offset_u;
-      verts[count * 16 + 3] = g->offset_v + g->bitmap_height;
+  AbstractWindow::vertex_arena(4)->bind();
+  glDrawElementsBaseVertex(GL_TRIANGLES, count * 6, GL_UNSIGNED_INT,
+                           BUFFER_OFFSET(start * 6 * sizeof(GLuint)),
+                           first_);
+}
 
-      verts[count * 16 + 4] = w + g->bitmap_left + g->bitmap_width;
-      verts[count * 16 + 5] = g->bitmap_top - g->bitmap_height;
-      verts[count * 16 + 6] = g->offset_u + g->bitmap_width;
-      verts[count * 16 + 7] = g->offset_v + g->bitmap_height;
+void Text::ReserveQuadIndices (size_t count)
+{
+  if (count <= kQuadIndexCapacity) return;
+
+  size_t capacity = std::max(std::max(count, kQuadIndexCapacity * 2),
+                             (size_t) 256);
+
+  // two triangles of a glyph quad: bottom-left, bottom-right, top-left
+  // and top-right vertices, relative to the first vertex of a text
+  std::vector<GLuint> indices(capacity * 6);
+  for (size_t i = 0; i < capacity; i++) {
+    indices[i * 6 + 0] = i * 4 + 0;
+    indices[i * 6 + 1] = i * 4 + 1;
+    indices[i * 6 + 2] = i * 4 + 2;
+    indices[i * 6 + 3] = i * 4 + 2;
+    indices[i * 6 + 4] = i * 4 + 1;
+    indices[i * 6 + 5] = i * 4 + 3;
+  }
 
-      verts[count * 16 + 8] = w + g->bitmap_left;
-      verts[count * 16 + 9] = g->bitmap_top;
-      verts[count * 16 + 10] = g->offset_u;
-      verts[count * 16 + 11] = g->offset_v;
+  if (kQuadIndexBuffer == 0) {
+    glGenBuffers(1, &kQuadIndexBuffer);
+    // the arena attaches it to its vertex array in every context, the
+    // element array binding is a vertex array state
+    AbstractWindow::vertex_arena(4)->SetElementBuffer(kQuadIndexBuffer);
+  }
 
-      verts[count * 16 + 12] = w + g->bitmap_left + g->bitmap_width;
-      verts[count * 16 + 13] = g->bitmap_top;
-      verts[count * 16 + 14] = g->offset_u + g->bitmap_width;
-      verts[count * 16 + 15] = g->offset_v;
+  // re-specify the storage of the same buffer object so the vertex
+  // array referring to it stays valid, and not touch the element array
+  // binding of the vertex array currently bound
+  glBindBuffer(GL_COPY_WRITE_BUFFER, kQuadIndexBuffer);
+  glBufferData(GL_COPY_WRITE_BUFFER, sizeof(GLuint) * indices.size(),
+               &indices[0], GL_STATIC_DRAW);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
 
-      w += (g->advance_x);
-      a = std::max(g->bitmap_top, a);
-      d = std::min(g->bitmap_top - g->bitmap_height, d);
+  kQuadIndexCapacity = capacity;
+}
 
-      count++;
+void Text::ReleaseQuadIndices ()
+{
+  if (kQuadIndexBuffer) {
+    // not attach the deleted name to vertex arrays created later
+    if (AbstractWindow::vertex_arena(4)) {
+      AbstractWindow::vertex_arena(4)->SetElementBuffer(0);
     }
-
+    glDeleteBuffers(1, &kQuadIndexBuffer);
+    kQuadIndexBuffer = 0;
   }
-
-  if(ptr_width) *ptr_width = w;
-  if(ptr_ascender) *ptr_ascender = a;
-  if(ptr_descender) *ptr_descender = d;
-}
-    
-void Text::ReloadBuffer()
-{
-  int width;
-  std::vector<GLfloat> verts;
-  GenerateTextVertices(verts, &width, &ascender_, &descender_);
-        
-  vbo_.bind();
-  vbo_.set_data(sizeof(GLfloat) * verts.size(), &verts[0]);
-  vbo_.reset();
-        
-  set_size(width, ascender_ - descender_);
+  kQuadIndexCapacity = 0;
 }
     
 }
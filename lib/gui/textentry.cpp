@@ -79,7 +79,7 @@ TextEntry::TextEntry (const String& text)
 
 TextEntry::~TextEntry ()
 {
-  glDeleteVertexArrays(3, vao_);
+  glDeleteVertexArrays(1, &vao_);
 }
 
 void TextEntry::SetText (const String& text)
@@ -166,14 +166,9 @@ void TextEntry::PerformSizeUpdate (const AbstractView* source, const AbstractVie
       GenerateRoundedVertices(&inner_verts, &outer_verts);
     }
 
-    vbo_.bind(0);
-    vbo_.set_sub_data(0, sizeof(GLfloat) * inner_verts.size(),
-                      &inner_verts[0]);
-    vbo_.bind(1);
-    vbo_.set_sub_data(0, sizeof(GLfloat) * outer_verts.size(),
-                      &outer_verts[0]);
+    geometry_.Update(inner_verts, outer_verts);
 
-    vbo_.bind(2);
+    vbo_.bind();
     GLfloat* buf_p = (GLfloat*) vbo_.map(GL_READ_WRITE);
     *(buf_p + 5) = (GLfloat) (height
                               - vertical_space * 2 * AbstractWindow::theme()->pixel());
@@ -204,10 +199,7 @@ void TextEntry::PerformRoundTypeUpdate (int round_type)
     GenerateRoundedVertices(&inner_verts, &outer_verts);
   }
 
-  vbo_.bind(0);
-  vbo_.set_data(sizeof(GLfloat) * inner_verts.size(), &inner_verts[0]);
-  vbo_.bind(1);
-  vbo_.set_data(sizeof(GLfloat) * outer_verts.size(), &outer_verts[0]);
+  geometry_.Update(inner_verts, outer_verts);
 
   RequestRedraw();
 }
@@ -226,10 +218,7 @@ void TextEntry::PerformRoundRadiusUpdate (float radius)
     GenerateRoundedVertices(&inner_verts, &outer_verts);
   }
 
-  vbo_.bind(0);
-  vbo_.set_data(sizeof(GLfloat) * inner_verts.size(), &inner_verts[0]);
-  vbo_.bind(1);
-  vbo_.set_data(sizeof(GLfloat) * outer_verts.size(), &outer_verts[0]);
+  geometry_.Update(inner_verts, outer_verts);
 
   RequestRedraw();
 }
@@ -378,8 +367,7 @@ Response TextEntry::Draw (AbstractWindow* context)
       AbstractWindow::shaders()->location(Shaders::WIDGET_INNER_SHADED),
       context->theme()->text().shaded);
 
-  glBindVertexArray(vao_[0]);
-  glDrawArrays(GL_TRIANGLE_FAN, 0, outline_vertex_count(round_type()) + 2);
+  geometry_.DrawInner(GL_TRIANGLE_FAN, outline_vertex_count(round_type()) + 2);
 
   AbstractWindow::shaders()->widget_outer_program()->use();
 
@@ -389,9 +377,8 @@ Response TextEntry::Draw (AbstractWindow* context)
       AbstractWindow::shaders()->location(Shaders::WIDGET_OUTER_OFFSET), 0.f,
       0.f);
 
-  glBindVertexArray(vao_[1]);
-  glDrawArrays(GL_TRIANGLE_STRIP, 0,
-               outline_vertex_count(round_type()) * 2 + 2);
+  geometry_.DrawOuter(GL_TRIANGLE_STRIP,
+                      outline_vertex_count(round_type()) * 2 + 2);
 
   if (emboss()) {
     glUniform4f(
@@ -400,8 +387,8 @@ Response TextEntry::Draw (AbstractWindow* context)
     glUniform2f(
         AbstractWindow::shaders()->location(Shaders::WIDGET_OUTER_OFFSET),
         0.f, -1.f);
-    glDrawArrays(GL_TRIANGLE_STRIP, 0,
-                 emboss_vertex_count(round_type()) * 2);
+    geometry_.DrawOuter(GL_TRIANGLE_STRIP,
+                        emboss_vertex_count(round_type()) * 2);
   }
 
   int cursor_pos = 0;
@@ -451,7 +438,7 @@ Response TextEntry::Draw (AbstractWindow* context)
     glVertexAttrib4f(AttributeColor, 0.f, 0.f, 0.f, 1.f);
     // glVertexAttrib4f(AttributeColor, 0.f, 0.215f, 1.f, 0.75f);
 
-    glBindVertexArray(vao_[2]);
+    glBindVertexArray(vao_);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
   }
 
@@ -470,22 +457,7 @@ void TextEntry::InitializeTextEntry ()
     GenerateRoundedVertices(&inner_verts, &outer_verts);
   }
 
-  glGenVertexArrays(3, vao_);
-  vbo_.generate();
-
-  glBindVertexArray(vao_[0]);
-  vbo_.bind(0);
-  vbo_.set_data(sizeof(GLfloat) * inner_verts.size(), &inner_verts[0]);
-
-  glEnableVertexAttribArray(AttributeCoord);
-  glVertexAttribPointer(AttributeCoord, 3, GL_FLOAT, GL_FALSE, 0, 0);
-
-  glBindVertexArray(vao_[1]);
-  vbo_.bind(1);
-  vbo_.set_data(sizeof(GLfloat) * outer_verts.size(), &outer_verts[0]);
-
-  glEnableVertexAttribArray(AttributeCoord);
-  glVertexAttribPointer(AttributeCoord, 2, GL_FLOAT, GL_FALSE, 0, 0);
+  geometry_.Update(inner_verts, outer_verts);
 
   std::vector<GLfloat> cursor_vertices(8, 0.f);
 
@@ -505,8 +477,11 @@ void TextEntry::InitializeTextEntry ()
   cursor_vertices[7] = (GLfloat) (size().height()
                                   - vertical_space * 2 * AbstractWindow::theme()->pixel());
 
-  glBindVertexArray(vao_[2]);
-  vbo_.bind(2);
+  glGenVertexArrays(1, &vao_);
+  vbo_.generate();
+
+  glBindVertexArray(vao_);
+  vbo_.bind();
   vbo_.set_data(sizeof(GLfloat) * cursor_vertices.size(),
                 &cursor_vertices[0]);
 
@@ -596,15 +571,8 @@ size_t TextEntry::GetTextCursorIndex (AbstractWindow* context)
   if (x >= text_->size().width())
     return text_->length();
 
-  size_t n = 0;
-
-  size_t dist = 0;
-  while ((dist < (size_t) x) && (n < text_->length())) {
-    n++;
-    dist = text_->GetTextWidth(n, text_start_, true);
-  }
-
-  return text_start_ + n - 1;
+  return std::min(text_->layout().GetIndex(x, text_start_),
+                  text_->length() - 1);
 }
 
 }
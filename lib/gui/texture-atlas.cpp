@@ -22,164 +22,298 @@
  */
 
 #include <blendint/core/types.hpp>
+#include <algorithm>
+#include <climits>
+#include <cstring>
 #include <vector>
 
 #include <blendint/gui/texture-atlas.hpp>
 
 namespace BlendInt {
 
-void TextureAtlas::Generate(GLsizei width, GLsizei height)
+TextureAtlas::TextureAtlas ()
+: Object(),
+  id_(0),
+  page_width_(0),
+  page_height_(0),
+  texture_layers_(0),
+  max_pages_(0),
+  clock_(0),
+  evictions_(0)
 {
-  if(id_) clear ();
+}
 
-  width_ = width;
-  height_ = height;
+TextureAtlas::~TextureAtlas ()
+{
+  if (id_) glDeleteTextures(1, &id_);
+}
 
-  glGenTextures(1, &id_);
-  glBindTexture(GL_TEXTURE_2D, id_);
+void TextureAtlas::Generate (GLsizei page_width,
+                             GLsizei page_height,
+                             size_t memory_budget)
+{
+  if(id_) glDeleteTextures(1, &id_);
+
+  page_width_ = page_width;
+  page_height_ = page_height;
+  max_pages_ = std::max(memory_budget / ((size_t) page_width * page_height), (size_t) 2);
+  pages_.clear();
+  clock_ = 0;
+  evictions_ = 0;
 
-#ifdef __APPLE__
-  // The Texture showed in testTextureAtlas is not clear in Mac OS, try to initialize this
-  // TODO: these 2 lines just for test, remove later
-  std::vector<unsigned char> blank(width * height, 0);
-  glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, &blank[0]);
-#else
-  glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, 0);
-#endif
+  glGenTextures(1, &id_);
+  glBindTexture(GL_TEXTURE_2D_ARRAY, id_);
 
   // Clamping to edges is important to prevent artifacts when scaling
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
   // Linear filtering usually looks best for text
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-  glBindTexture(GL_TEXTURE_2D, 0);
+  pages_.resize(1);
+  ResetPage(pages_[0]);
+
+  // The first page is uploaded blank, an undefined texture was not
+  // clear in Mac OS
+  texture_layers_ = 0;
+  Commit();
+
+  glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
 }
 
-bool TextureAtlas::Upload (int bitmap_width,
-                           int bitmap_rows,
-                           const unsigned char* bitmap, int* ox, int* oy)
+bool TextureAtlas::Allocate (int bitmap_width,
+                             int bitmap_rows,
+                             int* ox,
+                             int* oy,
+                             int* opage)
 {
-  int new_width = 0;
-  int new_height = 0;
-  bool expand = false;
-  int reference_max_height = 0;
+  int width = bitmap_width + kPadding;
+  int height = bitmap_rows + kPadding;
+
+  if(width > page_width_ || height > page_height_) {
+    DBG_PRINT_MSG("glyph bitmap (%d, %d) is larger than the atlas page",
+                  bitmap_width, bitmap_rows);
+    return false;
+  }
 
-  if(bitmap_width > width_) {
+  int page = -1;
+
+  // newer pages are more likely to have space
+  for(int i = (int) pages_.size() - 1; i >= 0; i--) {
+    if(Pack(pages_[i], width, height, ox, oy)) {
+      page = i;
+      break;
+    }
+  }
 
-    DBG_PRINT_MSG("%s", "big width");
+  if(page < 0) {
 
-    if(bitmap_rows > height_) {
+    if(pages_.size() < max_pages_) {
 
-      DBG_PRINT_MSG("%s", "big height");
-      // expand texture both horizontally and vertically
-      new_width = width_ + bitmap_width - (width_ - last_x_);
-      new_height = height_ + bitmap_rows - (height_ - last_y_);
+      pages_.push_back(Page());
+      page = (int) pages_.size() - 1;
 
     } else {
 
-      DBG_PRINT_MSG("%s", "big width only");
-      // expand texture horizontally
-      new_width = width_ + bitmap_width - (width_ - last_x_);
-      new_height = height_;
+      page = 0;
+      for(size_t i = 1; i < pages_.size(); i++) {
+        if(pages_[i].last_used < pages_[page].last_used) page = (int) i;
+      }
+
+      DBG_PRINT_MSG("evict atlas page %d", page);
+      evictions_++;
 
     }
 
-    expand = true;
+    ResetPage(pages_[page]);
+    Pack(pages_[page], width, height, ox, oy);
+  }
 
-  } else if (bitmap_rows > height_) {
+  if(opage) *opage = page;
+  Touch(page);
 
-    DBG_PRINT_MSG("%s", "big height");
-    // expand texture vertically
+  return true;
+}
 
-    new_width = width_;
-    new_height = height_ + bitmap_rows - (height_ - last_y_);
+void TextureAtlas::Blit (int page,
+                         int x,
+                         int y,
+                         int bitmap_width,
+                         int bitmap_rows,
+                         const unsigned char* bitmap,
+                         int pitch)
+{
+  if(bitmap_width <= 0 || bitmap_rows <= 0 || bitmap == 0) return;
+  if(pitch <= 0) pitch = bitmap_width;
+
+  DBG_ASSERT((x + bitmap_width) <= page_width_ && (y + bitmap_rows) <= page_height_);
 
-    expand = true;
+  Page& p = pages_[page];
 
+  for(int row = 0; row < bitmap_rows; row++) {
+    memcpy(&p.pixels[(y + row) * page_width_ + x],
+           bitmap + row * pitch,
+           bitmap_width);
   }
 
-  int x = last_x_;
-  int y = last_y_;
-  last_row_height_ = std::max(last_row_height_, bitmap_rows);
-  reference_max_height = last_row_height_;
+  // include the padding, it may hold pixels of an evicted glyph on GPU
+  MarkDirty(p, x, y,
+            std::min(x + bitmap_width + kPadding, (int) page_width_),
+            std::min(y + bitmap_rows + kPadding, (int) page_height_));
+}
+
+void TextureAtlas::Commit ()
+{
+  glBindTexture(GL_TEXTURE_2D_ARRAY, id_);
+  glPixelStorei (GL_UNPACK_ALIGNMENT, 1);
+
+  if(texture_layers_ < (GLsizei) pages_.size()) {
 
-  if((x + bitmap_width) > width_) {
-    x = 0;
-    y = last_y_ + last_row_height_;
-    last_row_height_ = bitmap_rows;
+    // layers are doubled so the texture is re-specified only a few
+    // times before the budget is reached
+    GLsizei layers = std::max(texture_layers_, 1);
+    while(layers < (GLsizei) pages_.size()) layers *= 2;
+    layers = std::min(layers, (GLsizei) max_pages_);
+
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_R8, page_width_, page_height_, layers, 0, GL_RED, GL_UNSIGNED_BYTE, 0);
+    texture_layers_ = layers;
+
+    for(size_t i = 0; i < pages_.size(); i++) {
+      MarkDirty(pages_[i], 0, 0, page_width_, page_height_);
+    }
   }
 
-  if((y + bitmap_rows) > height_) {
-    new_width = width_;
-    new_height = height_ + std::max(reference_max_height, bitmap_rows) - (height_ - y);
-    expand = true;
+  glPixelStorei (GL_UNPACK_ROW_LENGTH, page_width_);
+
+  for(size_t i = 0; i < pages_.size(); i++) {
+
+    Page& p = pages_[i];
+    if(p.dirty_right <= p.dirty_left) continue;
+
+    glTexSubImage3D(GL_TEXTURE_2D_ARRAY,
+                    0,	// level
+                    p.dirty_left,
+                    p.dirty_top,
+                    (GLint) i,
+                    p.dirty_right - p.dirty_left,
+                    p.dirty_bottom - p.dirty_top,
+                    1,
+                    GL_RED,	// format
+                    GL_UNSIGNED_BYTE,
+                    &p.pixels[p.dirty_top * page_width_ + p.dirty_left]);
+
+    p.dirty_left = p.dirty_top = p.dirty_right = p.dirty_bottom = 0;
   }
 
-  if(expand) {
+  glPixelStorei (GL_UNPACK_ROW_LENGTH, 0);
+}
 
-    // FIXME: the following code is not tested and may fail.
+void TextureAtlas::ResetPage (Page& page)
+{
+  page.pixels.assign((size_t) page_width_ * page_height_, 0);
 
-    DBG_PRINT_MSG("expand texture: from (%d, %d) to (%d, %d)", width_, height_, new_width, new_height);
+  SkylineNode node = { 0, 0, page_width_ };
+  page.skyline.assign(1, node);
 
-    // Generate pixel buffer object for unpack and copy texture data to it.
-    GLuint pbo = 0;
-    glGenBuffers(1, &pbo);
-    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
-    glBufferData(GL_PIXEL_UNPACK_BUFFER, width_ * height_ * sizeof(GLubyte), 0, GL_STREAM_DRAW);
+  page.last_used = 0;
 
-    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  // the blank page replaces the glyphs of an evicted page on GPU
+  page.dirty_left = page.dirty_top = page.dirty_right = page.dirty_bottom = 0;
+  MarkDirty(page, 0, 0, page_width_, page_height_);
+}
 
-    GLuint new_tex_id = 0;
-    glGenTextures(1, &new_tex_id);
-    glBindTexture(GL_TEXTURE_2D, new_tex_id);
+bool TextureAtlas::Pack (Page& page, int width, int height, int* ox, int* oy)
+{
+  int best_index = -1;
+  int best_bottom = INT_MAX;
+  int best_width = INT_MAX;
+  int y = 0;
+
+  // bottom-left rule: the lowest position, then the narrowest node
+  for(size_t i = 0; i < page.skyline.size(); i++) {
+
+    y = Fit(page, i, width, height);
+    if(y < 0) continue;
+
+    if((y + height) < best_bottom ||
+       ((y + height) == best_bottom && page.skyline[i].width < best_width)) {
+      best_index = (int) i;
+      best_bottom = y + height;
+      best_width = page.skyline[i].width;
+    }
+  }
 
-    // Clamping to edges is important to prevent artifacts when scaling
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  if(best_index < 0) return false;
 
-    // Linear filtering usually looks best for text
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  SkylineNode node = { page.skyline[best_index].x, best_bottom, width };
+  page.skyline.insert(page.skyline.begin() + best_index, node);
 
-    // set image size
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, new_width, new_height, 0, GL_RED, GL_UNSIGNED_BYTE, 0);
+  // shrink or remove the nodes covered by the new one
+  for(size_t i = best_index + 1; i < page.skyline.size();) {
 
-    // Copy pixel buffer data back to new texture
-    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width_, height_, GL_RED, GL_UNSIGNED_BYTE, 0);
+    const SkylineNode& prev = page.skyline[i - 1];
+    SkylineNode& current = page.skyline[i];
 
-    glDeleteBuffers(1, &pbo);
-    glDeleteTextures(1, &id_);
+    if(current.x >= (prev.x + prev.width)) break;
 
-    id_ = new_tex_id;
-    width_ = new_width;
-    height_ = new_height;
+    int shrink = prev.x + prev.width - current.x;
+    current.x += shrink;
+    current.width -= shrink;
 
-    glBindTexture(GL_TEXTURE_2D, id_);
+    if(current.width > 0) break;
 
+    page.skyline.erase(page.skyline.begin() + i);
   }
 
-  glPixelStorei (GL_UNPACK_ALIGNMENT, 1);
-  glTexSubImage2D(GL_TEXTURE_2D,
-                  0,	// level
-                  x,
-                  y,
-                  bitmap_width,
-                  bitmap_rows,
-                  GL_RED,	// format
-                  GL_UNSIGNED_BYTE,
-                  bitmap);
-
-  if(ox) *ox = x;
-  if(oy) *oy = y;
-
-  last_x_ = x + bitmap_width;
-  last_y_ = y;
-		
+  // merge neighbours at the same level
+  for(size_t i = 0; (i + 1) < page.skyline.size();) {
+    if(page.skyline[i].y == page.skyline[i + 1].y) {
+      page.skyline[i].width += page.skyline[i + 1].width;
+      page.skyline.erase(page.skyline.begin() + i + 1);
+    } else {
+      i++;
+    }
+  }
+
+  if(ox) *ox = node.x;
+  if(oy) *oy = best_bottom - height;
+
   return true;
 }
-	
+
+int TextureAtlas::Fit (const Page& page, size_t index, int width, int height) const
+{
+  int x = page.skyline[index].x;
+  if((x + width) > page_width_) return -1;
+
+  int y = 0;
+  int remaining = width;
+
+  // the nodes always cover the full page width
+  for(size_t i = index; remaining > 0; i++) {
+    y = std::max(y, page.skyline[i].y);
+    if((y + height) > page_height_) return -1;
+    remaining -= page.skyline[i].width;
+  }
+
+  return y;
+}
+
+void TextureAtlas::MarkDirty (Page& page, int left, int top, int right, int bottom)
+{
+  if(page.dirty_right <= page.dirty_left) {
+    page.dirty_left = left;
+    page.dirty_top = top;
+    page.dirty_right = right;
+    page.dirty_bottom = bottom;
+  } else {
+    page.dirty_left = std::min(page.dirty_left, left);
+    page.dirty_top = std::min(page.dirty_top, top);
+    page.dirty_right = std::max(page.dirty_right, right);
+    page.dirty_bottom = std::max(page.dirty_bottom, bottom);
+  }
+}
+
 }
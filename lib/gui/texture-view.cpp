@@ -244,9 +244,7 @@ bool TextureView::PreDraw (AbstractWindow* context)
   glBindVertexArray(vao_[0]);
   glDrawArrays(GL_TRIANGLE_FAN, 0, 6);
 
-  context->BeginPushStencil();	// inner stencil
-  glDrawArrays(GL_TRIANGLE_FAN, 0, 6);
-  context->EndPushStencil();
+  context->PushClipRect(Rect(0, 0, size().width(), size().height()));
 
   return true;
 }
@@ -287,14 +285,7 @@ Response TextureView::Draw (AbstractWindow* context)
 
 void TextureView::PostDraw (AbstractWindow* context)
 {
-  // draw background again to unmask stencil
-  AbstractWindow::shaders()->widget_inner_program()->use();
-
-  glBindVertexArray(vao_[0]);
-
-  context->BeginPopStencil();	// pop inner stencil
-  glDrawArrays(GL_TRIANGLE_FAN, 0, 6);
-  context->EndPopStencil();
+  context->PopClipRect();
 
   AbstractWindow::shaders()->PopWidgetModelMatrix();
 }
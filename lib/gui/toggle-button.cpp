@@ -102,7 +102,6 @@ ToggleButton::ToggleButton (const RefPtr<AbstractIcon>& icon,
 
 ToggleButton::~ToggleButton ()
 {
-  glDeleteVertexArrays(2, vao_);
 }
 
 bool ToggleButton::IsExpandX () const
@@ -144,11 +143,7 @@ void ToggleButton::PerformSizeUpdate (const AbstractView* source,
       GenerateRoundedVertices(&inner_verts, &outer_verts);
     }
 
-    vbo_.bind(0);
-    vbo_.set_sub_data(0, sizeof(GLfloat) * inner_verts.size(), &inner_verts[0]);
-    vbo_.bind(1);
-    vbo_.set_sub_data(0, sizeof(GLfloat) * outer_verts.size(), &outer_verts[0]);
-    vbo_.reset();
+    geometry_.Update(inner_verts, outer_verts);
 
     RequestRedraw();
   }
@@ -174,11 +169,7 @@ void ToggleButton::PerformRoundTypeUpdate (int round_type)
     GenerateRoundedVertices(&inner_verts, &outer_verts);
   }
 
-  vbo_.bind(0);
-  vbo_.set_data(sizeof(GLfloat) * inner_verts.size(), &inner_verts[0]);
-  vbo_.bind(1);
-  vbo_.set_data(sizeof(GLfloat) * outer_verts.size(), &outer_verts[0]);
-  vbo_.reset();
+  geometry_.Update(inner_verts, outer_verts);
 
   RequestRedraw();
 }
@@ -199,11 +190,7 @@ void ToggleButton::PerformRoundRadiusUpdate (float radius)
     GenerateRoundedVertices(&inner_verts, &outer_verts);
   }
 
-  vbo_.bind(0);
-  vbo_.set_data(sizeof(GLfloat) * inner_verts.size(), &inner_verts[0]);
-  vbo_.bind(1);
-  vbo_.set_data(sizeof(GLfloat) * outer_verts.size(), &outer_verts[0]);
-  vbo_.reset();
+  geometry_.Update(inner_verts, outer_verts);
 
   RequestRedraw();
 }
@@ -245,8 +232,7 @@ Response ToggleButton::Draw (AbstractWindow* context)
         AbstractWindow::theme()->toggle().inner.data());
   }
 
-  glBindVertexArray(vao_[0]);
-  glDrawArrays(GL_TRIANGLE_FAN, 0, outline_vertex_count(round_type()) + 2);
+  geometry_.DrawInner(GL_TRIANGLE_FAN, outline_vertex_count(round_type()) + 2);
 
   AbstractWindow::shaders()->widget_outer_program()->use();
 
@@ -255,9 +241,8 @@ Response ToggleButton::Draw (AbstractWindow* context)
   glUniform4fv(AbstractWindow::shaders()->location(Shaders::WIDGET_OUTER_COLOR),
                1, AbstractWindow::theme()->toggle().outline.data());
 
-  glBindVertexArray(vao_[1]);
-  glDrawArrays(GL_TRIANGLE_STRIP, 0,
-               outline_vertex_count(round_type()) * 2 + 2);
+  geometry_.DrawOuter(GL_TRIANGLE_STRIP,
+                      outline_vertex_count(round_type()) * 2 + 2);
 
   if (emboss()) {
     glUniform4f(
@@ -266,7 +251,8 @@ Response ToggleButton::Draw (AbstractWindow* context)
     glUniform2f(
         AbstractWindow::shaders()->location(Shaders::WIDGET_OUTER_OFFSET), 0.f,
         0.f - 1.f);
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, emboss_vertex_count(round_type()) * 2);
+    geometry_.DrawOuter(GL_TRIANGLE_STRIP,
+                        emboss_vertex_count(round_type()) * 2);
   }
 
   DrawIconText();
@@ -288,28 +274,7 @@ void ToggleButton::InitializeToggleButtonOnce ()
     GenerateRoundedVertices(&inner_verts, &outer_verts);
   }
 
-  glGenVertexArrays(2, vao_);
-  vbo_.generate();
-
-  glBindVertexArray(vao_[0]);
-
-  vbo_.bind(0);
-  vbo_.set_data(sizeof(GLfloat) * inner_verts.size(), &inner_verts[0]);
-  glEnableVertexAttribArray(AttributeCoord);
-  glVertexAttribPointer(AttributeCoord, 3,
-  GL_FLOAT,
-                        GL_FALSE, 0, 0);
-
-  glBindVertexArray(vao_[1]);
-  vbo_.bind(1);
-  vbo_.set_data(sizeof(GLfloat) * outer_verts.size(), &outer_verts[0]);
-  glEnableVertexAttribArray(AttributeCoord);
-  glVertexAttribPointer(AttributeCoord, 2,
-  GL_FLOAT,
-                        GL_FALSE, 0, 0);
-
-  glBindVertexArray(0);
-  vbo_.reset();
+  geometry_.Update(inner_verts, outer_verts);
 }
 
 }
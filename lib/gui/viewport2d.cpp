@@ -91,11 +91,9 @@ void Viewport2D::PerformSizeUpdate(const AbstractView* source, const AbstractVie
 Response Viewport2D::Draw (AbstractWindow* context)
 {
   AbstractWindow* c = context;
-  GLint vp[4];	// Original viewport
+  Rect vp = context->viewport();	// Original viewport
   int n = outline_vertex_count(round_type()) + 2;
 
-  glGetIntegerv(GL_VIEWPORT, vp);
-
   RefPtr<GLSLProgram> program =
       AbstractWindow::shaders()->widget_inner_program();
   program->use();
@@ -111,9 +109,7 @@ Response Viewport2D::Draw (AbstractWindow* context)
   glBindVertexArray(vao_);
   glDrawArrays(GL_TRIANGLE_FAN, 0, n);
 
-  c->BeginPushStencil();	// inner stencil
-  glDrawArrays(GL_TRIANGLE_FAN, 0, n);
-  c->EndPushStencil();
+  c->PushClipRect(Rect(0, 0, size().width(), size().height()));
 
   glBindVertexArray(0);
   program->reset();
@@ -122,9 +118,9 @@ Response Viewport2D::Draw (AbstractWindow* context)
 
   Point pos = GetGlobalPosition();
 
-  glViewport(pos.x() - context->viewport_origin().x(),
-             pos.y() - context->viewport_origin().y(), size().width(),
-             size().height());
+  c->SetViewport(pos.x() - context->viewport_origin().x(),
+                 pos.y() - context->viewport_origin().y(), size().width(),
+                 size().height());
 
   // --------------------------------------------------------------------------------
 
@@ -134,20 +130,9 @@ Response Viewport2D::Draw (AbstractWindow* context)
   // --------------------------------------------------------------------------------
 
   glDisable(GL_DEPTH_TEST);
-  glViewport(vp[0], vp[1], vp[2], vp[3]);
-
-  program->use();
-  glUniform1i(
-      AbstractWindow::shaders()->location(Shaders::WIDGET_INNER_GAMMA), 0);
-  glUniform1i(
-      AbstractWindow::shaders()->location(Shaders::WIDGET_INNER_SHADED), 0);
+  c->SetViewport(vp.x(), vp.y(), vp.width(), vp.height());
 
-  c->BeginPopStencil();	// pop inner stencil
-  glBindVertexArray(vao_);
-  glDrawArrays(GL_TRIANGLE_FAN, 0, n);
-  glBindVertexArray(0);
-  c->EndPopStencil();
-  program->reset();
+  c->PopClipRect();
 
   return Finish;
 }
@@ -243,12 +243,11 @@ void Viewport3D::Render ()
 Response Viewport3D::Draw (AbstractWindow* context)
 {
   AbstractWindow* c = context;
-  GLint vp[4];	// Original viewport
+  Rect vp = context->viewport();	// Original viewport
   //GLint sci[4];
   //GLboolean scissor_status;
   int n = outline_vertex_count(round_type()) + 2;
 
-  glGetIntegerv(GL_VIEWPORT, vp);
   //glGetBooleanv(GL_SCISSOR_TEST, &scissor_status);
 
   //if(scissor_status == GL_TRUE) {
@@ -270,9 +269,7 @@ Response Viewport3D::Draw (AbstractWindow* context)
   glBindVertexArray(vao_);
   glDrawArrays(GL_TRIANGLE_FAN, 0, n);
 
-  c->BeginPushStencil();	// inner stencil
-  glDrawArrays(GL_TRIANGLE_FAN, 0, n);
-  c->EndPushStencil();
+  c->PushClipRect(Rect(0, 0, size().width(), size().height()));
 
   glBindVertexArray(0);
   program->reset();
@@ -284,9 +281,9 @@ Response Viewport3D::Draw (AbstractWindow* context)
 
   Point pos = GetGlobalPosition();
 
-  glViewport(pos.x() - context->viewport_origin().x(),
-             pos.y() - context->viewport_origin().y(), size().width(),
-             size().height());
+  c->SetViewport(pos.x() - context->viewport_origin().x(),
+                 pos.y() - context->viewport_origin().y(), size().width(),
+                 size().height());
 
   // --------------------------------------------------------------------------------
   Render();
@@ -300,20 +297,9 @@ Response Viewport3D::Draw (AbstractWindow* context)
 
   glDisable(GL_DEPTH_TEST);
 
-  glViewport(vp[0], vp[1], vp[2], vp[3]);
+  c->SetViewport(vp.x(), vp.y(), vp.width(), vp.height());
 
-  program->use();
-  glUniform1i(
-      AbstractWindow::shaders()->location(Shaders::WIDGET_INNER_GAMMA), 0);
-  glUniform1i(
-      AbstractWindow::shaders()->location(Shaders::WIDGET_INNER_SHADED), 0);
-
-  c->BeginPopStencil();	// pop inner stencil
-  glBindVertexArray(vao_);
-  glDrawArrays(GL_TRIANGLE_FAN, 0, n);
-  glBindVertexArray(0);
-  c->EndPopStencil();
-  program->reset();
+  c->PopClipRect();
 
   return Finish;
 }
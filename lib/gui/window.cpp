@@ -32,8 +32,12 @@
 #include <blendint/core/image.hpp>
 #include <blendint/core/timer.hpp>
 
+#include <blendint/opengl/render-stats.hpp>
+
 #include <blendint/font/fc-config.hpp>
 
+#include <blendint/gui/font-cache.hpp>
+#include <blendint/gui/directory-watcher.hpp>
 #include <blendint/gui/window.hpp>
 
 #include <blendint/config.hpp>
@@ -94,6 +98,7 @@ Window::Window (int width, int height, const char* title, int flags)
 
     /* Make the window's context current */
     glfwMakeContextCurrent(window_);
+    GLVertexArena::set_current_context(window_);
 
     if (!InitializeGLContext()) {
       DBG_PRINT_MSG("Critical: %s", "Cannot initialize GL Context");
@@ -111,6 +116,12 @@ Window::Window (int width, int height, const char* title, int flags)
 
     Timer::SaveProgramTime();
 
+    // pace frames to the refresh rate of the primary monitor
+    const GLFWvidmode* mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+    if (mode && mode->refreshRate > 0) {
+      frame_scheduler_.SetRefreshRate(mode->refreshRate);
+    }
+
   } else {
 
     kSharedWindowMap[window_] = this;
@@ -133,7 +144,17 @@ Window::Window (int width, int height, const char* title, int flags)
 
 Window::~Window ()
 {
-  if (main_window() != this) kSharedWindowMap.erase(window_);
+  if (main_window() != this) {
+    kSharedWindowMap.erase(window_);
+
+    // vertex arrays are not shared between contexts, delete the ones
+    // the arenas created in this one
+    glfwMakeContextCurrent(window_);
+    GLVertexArena::set_current_context(window_);
+    ReleaseVertexArrays(window_);
+
+    if (main_window()) main_window()->MakeCurrent();
+  }
 
   //glfwDestroyWindow(window_);
   window_ = NULL;
@@ -149,6 +170,8 @@ AbstractWindow* Window::CreateSharedContext (int width, int height, int flags)
 void Window::MakeCurrent ()
 {
   glfwMakeContextCurrent(window_);
+  GLSLProgram::invalidate_current();
+  GLVertexArena::set_current_context(window_);
 }
 
 void Window::SwapBuffer ()
@@ -158,7 +181,11 @@ void Window::SwapBuffer ()
 
 void Window::Synchronize ()
 {
-  glfwPostEmptyEvent();
+  // the event loop checks the refresh status before it sleeps, only
+  // wake it up for requests from other threads
+  if (std::this_thread::get_id() != kMainThreadID) {
+    glfwPostEmptyEvent();
+  }
 }
 
 void Window::Exec ()
@@ -167,52 +194,125 @@ void Window::Exec ()
   // bool main_visiable = dynamic_cast<Window*>(main_window())->visible_;
 
   std::map<GLFWwindow*, Window*>::iterator it;
+  double delay = 0.0;
+  int timeout = 0;
 
   while (running_) {
 
-    if (main_window()->refresh()) {
-      main_window()->MakeCurrent();
-#ifdef DEBUG
-      // Timer::SaveCurrentTime();
-#endif
-      reset_refresh_status(main_window());
-      if(predraw_window(main_window())) {
-        draw_window(main_window());
-        postdraw_window(main_window());
+    // fire timers in this thread before drawing, they usually request
+    // a redraw
+    Timer::ProcessTimeouts();
+
+    // directory changes read in background threads, applied to the
+    // models watching them
+    DirectoryWatcher::ProcessChanges();
+
+    // glyphs rasterized in background threads, the text using fallback
+    // glyphs need to be redrawn
+    main_window()->MakeCurrent();
+    if (FontCache::UploadPendingGlyphs()) {
+      refresh_all(main_window());
+      for (it = kSharedWindowMap.begin(); it != kSharedWindowMap.end(); it++) {
+        refresh_all(it->second);
       }
+    }
 
-      // DBG_PRINT_MSG("Time of one render cycle: %g (ms)", Timer::GetIntervalOfMilliseconds());
+    // redraw requests before the next frame slot are drawn together
+    if (IsRefreshRequested() && (frame_scheduler_.GetPacingDelay() <= 0.0)) {
+
+      frame_scheduler_.BeginFrame();
+      RenderStats::BeginFrame();
+
+      if (main_window()->refresh()) {
+        main_window()->MakeCurrent();
+        reset_refresh_status(main_window());
+        size_t passes = begin_partial_redraw(main_window());
+        for (size_t i = 0; i < passes; i++) {
+          begin_redraw_pass(main_window(), i);
+          bool visible = predraw_window(main_window());
+          frame_scheduler_.Mark(FrameScheduler::FramePredraw);
+          if(visible) {
+            draw_window(main_window());
+            postdraw_window(main_window());
+            frame_scheduler_.Mark(FrameScheduler::FrameDraw);
+          }
+        }
+        end_partial_redraw(main_window());
 
-      main_window()->SwapBuffer();
-    }
+        main_window()->SwapBuffer();
+        frame_scheduler_.Mark(FrameScheduler::FrameSwap);
+      }
+
+      for (it = kSharedWindowMap.begin(); it != kSharedWindowMap.end(); it++) {
+
+        if (it->second->visible_ && it->second->refresh()) {
 
-    for (it = kSharedWindowMap.begin(); it != kSharedWindowMap.end(); it++) {
+          glfwMakeContextCurrent(it->first);
+          GLSLProgram::invalidate_current();
+          GLVertexArena::set_current_context(it->first);
 
-      if (it->second->visible_ && it->second->refresh()) {
+          reset_refresh_status(it->second);
+          size_t passes = begin_partial_redraw(it->second);
 
-        glfwMakeContextCurrent(it->first);
+          for (size_t i = 0; i < passes; i++) {
+            begin_redraw_pass(it->second, i);
+            bool visible = predraw_window(it->second);
+            frame_scheduler_.Mark(FrameScheduler::FramePredraw);
+            if (visible) {
+              draw_window(it->second);
+              postdraw_window(it->second);
+              frame_scheduler_.Mark(FrameScheduler::FrameDraw);
+            }
+          }
 
-        reset_refresh_status(it->second);
+          end_partial_redraw(it->second);
 
-        if (predraw_window(it->second)) {
-          draw_window(it->second);
-          postdraw_window(it->second);
+          glfwSwapBuffers(it->first);
+          frame_scheduler_.Mark(FrameScheduler::FrameSwap);
         }
 
-        glfwSwapBuffers(it->first);
       }
 
+      RenderStats::EndFrame();
+      frame_scheduler_.EndFrame();
     }
 
     if (glfwWindowShouldClose(main)) running_ = false;
 
-    // TODO: fire event then go idle
+    // sleep until an event arrives, the next timer is due or the next
+    // frame slot of a pending redraw
+    timeout = Timer::GetTimeout();
+    delay = IsRefreshRequested() ? frame_scheduler_.GetPacingDelay() : -1.0;
 
-    glfwWaitEvents();
+    if ((delay >= 0.0) && ((timeout < 0) || (delay < timeout / 1000.0))) {
+      if (delay > 0.0) {
+        glfwWaitEventsTimeout(delay);
+      } else {
+        glfwPollEvents();
+      }
+    } else if (timeout < 0) {
+      glfwWaitEvents();
+    } else if (timeout > 0) {
+      glfwWaitEventsTimeout(timeout / 1000.0);
+    } else {
+      glfwPollEvents();
+    }
 
   }
 }
 
+bool Window::IsRefreshRequested () const
+{
+  if (main_window()->refresh()) return true;
+
+  std::map<GLFWwindow*, Window*>::const_iterator it;
+  for (it = kSharedWindowMap.begin(); it != kSharedWindowMap.end(); it++) {
+    if (it->second->visible_ && it->second->refresh()) return true;
+  }
+
+  return false;
+}
+
 void Window::SetCursor (CursorShape cursor_type)
 {
   switch (cursor_type) {
@@ -413,7 +513,7 @@ bool Window::PreDraw (AbstractWindow* context)
   }
   set_stencil_count(0);
 
-  glViewport(0, 0, size().width(), size().height());
+  SetViewport(0, 0, size().width(), size().height());
 
   return true;
 }
@@ -0,0 +1,139 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free
+ * software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is
+ * distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+#include <algorithm>
+
+#include <blendint/opengl/gl-framebuffer-pool.hpp>
+
+namespace BlendInt {
+
+GLFramebufferPool::GLFramebufferPool ()
+: hits_(0), misses_(0), clock_(0)
+{
+}
+
+GLFramebufferPool::~GLFramebufferPool ()
+{
+  for (size_t i = 0; i < targets_.size(); i++) {
+    Destroy(targets_[i]);
+  }
+  targets_.clear();
+}
+
+GLOffscreenTarget* GLFramebufferPool::Acquire (int width, int height)
+{
+  const int w = bucket(width);
+  const int h = bucket(height);
+
+  clock_++;
+
+  GLOffscreenTarget* target = 0;
+  for (size_t i = 0; i < targets_.size(); i++) {
+    if ((!targets_[i]->in_use) && (targets_[i]->width == w)
+        && (targets_[i]->height == h)) {
+      target = targets_[i];
+      break;
+    }
+  }
+
+  if (target) {
+
+    hits_++;
+    glBindFramebuffer(GL_FRAMEBUFFER, target->framebuffer);
+
+  } else {
+
+    misses_++;
+
+    target = new GLOffscreenTarget;
+    target->width = w;
+    target->height = h;
+
+    glGenFramebuffers(1, &target->framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, target->framebuffer);
+
+    glGenRenderbuffers(1, &target->renderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, target->renderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_STENCIL, w, h);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                              GL_RENDERBUFFER, target->renderbuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT,
+                              GL_RENDERBUFFER, target->renderbuffer);
+
+    targets_.push_back(target);
+  }
+
+  target->in_use = true;
+  target->last_used = clock_;
+
+  return target;
+}
+
+void GLFramebufferPool::Release (GLOffscreenTarget* target)
+{
+  DBG_ASSERT(target && target->in_use);
+
+  target->in_use = false;
+
+  int idle = 0;
+  std::vector<GLOffscreenTarget*>::iterator lru = targets_.end();
+
+  for (std::vector<GLOffscreenTarget*>::iterator it = targets_.begin();
+      it != targets_.end(); it++) {
+    if (!(*it)->in_use) {
+      idle++;
+      if (lru == targets_.end() || (*it)->last_used < (*lru)->last_used) {
+        lru = it;
+      }
+    }
+  }
+
+  if (idle > kMaxIdleTargets) {
+    Destroy(*lru);
+    targets_.erase(lru);
+  }
+}
+
+void GLFramebufferPool::Clear ()
+{
+  std::vector<GLOffscreenTarget*>::iterator it = targets_.begin();
+  while (it != targets_.end()) {
+    if ((*it)->in_use) {
+      it++;
+    } else {
+      Destroy(*it);
+      it = targets_.erase(it);
+    }
+  }
+}
+
+void GLFramebufferPool::Destroy (GLOffscreenTarget* target)
+{
+  glDeleteRenderbuffers(1, &target->renderbuffer);
+  glDeleteFramebuffers(1, &target->framebuffer);
+  delete target;
+}
+
+}
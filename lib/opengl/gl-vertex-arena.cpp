@@ -0,0 +1,274 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free
+ * software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is
+ * distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+
+#include <blendint/opengl/gl-vertex-arena.hpp>
+
+namespace BlendInt {
+
+const void* GLVertexArena::kCurrentContext = 0;
+
+GLVertexArena::GLVertexArena (GLuint attribute,
+                              GLint components,
+                              GLsizei capacity)
+: attribute_(attribute),
+  components_(components),
+  vbo_(0),
+  element_buffer_(0),
+  revision_(0),
+  context_(0),
+  current_(0),
+  capacity_(allocated_size(capacity)),
+  used_(0),
+  batch_mode_(GL_TRIANGLES)
+{
+  glGenBuffers(1, &vbo_);
+
+  glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+  glBufferData(GL_ARRAY_BUFFER,
+               capacity_ * components_ * sizeof(GLfloat),
+               0,
+               GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  SwitchContext();
+
+  free_blocks_[0] = capacity_;
+}
+
+GLVertexArena::~GLVertexArena ()
+{
+  ReleaseContext(kCurrentContext);
+  glDeleteBuffers(1, &vbo_);
+}
+
+GLint GLVertexArena::Allocate (GLsizei count)
+{
+  count = allocated_size(count);
+
+  std::map<GLint, GLsizei>::iterator it = free_blocks_.begin();
+  while (it != free_blocks_.end() && it->second < count) {
+    it++;
+  }
+
+  if (it == free_blocks_.end()) {
+
+    // free space at the end of the buffer is extended by the growth
+    GLsizei tail = 0;
+    if (!free_blocks_.empty()) {
+      std::map<GLint, GLsizei>::reverse_iterator last = free_blocks_.rbegin();
+      if ((last->first + last->second) == capacity_) tail = last->second;
+    }
+
+    Grow(capacity_ + count - tail);
+
+    // the new space is merged into the last free range
+    it = free_blocks_.end();
+    it--;
+    DBG_ASSERT(it->second >= count);
+  }
+
+  GLint first = it->first;
+  GLsizei remain = it->second - count;
+
+  free_blocks_.erase(it);
+  if (remain > 0) {
+    free_blocks_[first + count] = remain;
+  }
+
+  used_ += count;
+
+  return first;
+}
+
+void GLVertexArena::Free (GLint first, GLsizei count)
+{
+  count = allocated_size(count);
+
+  DBG_ASSERT((first >= 0) && ((first + count) <= capacity_));
+
+  InsertFreeBlock(first, count);
+  used_ -= count;
+}
+
+void GLVertexArena::Upload (GLint first, GLsizei count, const GLfloat* data)
+{
+  DBG_ASSERT((first >= 0) && ((first + count) <= capacity_));
+
+  glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+  glBufferSubData(GL_ARRAY_BUFFER,
+                  first * components_ * sizeof(GLfloat),
+                  count * components_ * sizeof(GLfloat),
+                  data);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void GLVertexArena::Submit (GLenum mode, GLint first, GLsizei count)
+{
+  DBG_ASSERT((first >= 0) && ((first + count) <= capacity_));
+
+  if (!batch_first_.empty() && (mode != batch_mode_)) Flush();
+
+  batch_mode_ = mode;
+  batch_first_.push_back(first);
+  batch_count_.push_back(count);
+}
+
+void GLVertexArena::Flush ()
+{
+  if (batch_first_.empty()) return;
+
+  bind();
+
+  if (batch_first_.size() == 1) {
+    glDrawArrays(batch_mode_, batch_first_[0], batch_count_[0]);
+  } else {
+    glMultiDrawArrays(batch_mode_, &batch_first_[0], &batch_count_[0],
+                      (GLsizei) batch_first_.size());
+  }
+
+  batch_first_.clear();
+  batch_count_.clear();
+}
+
+void GLVertexArena::SetElementBuffer (GLuint buffer)
+{
+  if ((current_ == 0) || (context_ != kCurrentContext)) SwitchContext();
+
+  element_buffer_ = buffer;
+  revision_++;
+
+  SetupVertexArray();
+}
+
+void GLVertexArena::ReleaseContext (const void* context)
+{
+  std::map<const void*, VertexArray>::iterator it =
+      vertex_arrays_.find(context);
+  if (it == vertex_arrays_.end()) return;
+
+  DBG_ASSERT(context == kCurrentContext);
+
+  glDeleteVertexArrays(1, &(it->second.vao));
+  if (current_ == &(it->second)) {
+    context_ = 0;
+    current_ = 0;
+  }
+  vertex_arrays_.erase(it);
+}
+
+void GLVertexArena::SwitchContext ()
+{
+  VertexArray& vertex_array = vertex_arrays_[kCurrentContext];
+
+  context_ = kCurrentContext;
+  current_ = &vertex_array;
+
+  if (vertex_array.vao == 0) {
+    glGenVertexArrays(1, &vertex_array.vao);
+  } else if (vertex_array.revision == revision_) {
+    return;
+  }
+
+  SetupVertexArray();
+}
+
+void GLVertexArena::Grow (GLsizei min_capacity)
+{
+  GLsizei capacity = capacity_;
+  while (capacity < min_capacity) {
+    capacity *= 2;
+  }
+
+  GLuint vbo = 0;
+  glGenBuffers(1, &vbo);
+
+  glBindBuffer(GL_COPY_WRITE_BUFFER, vbo);
+  glBufferData(GL_COPY_WRITE_BUFFER,
+               capacity * components_ * sizeof(GLfloat),
+               0,
+               GL_DYNAMIC_DRAW);
+
+  glBindBuffer(GL_COPY_READ_BUFFER, vbo_);
+  glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0,
+                      capacity_ * components_ * sizeof(GLfloat));
+
+  glBindBuffer(GL_COPY_READ_BUFFER, 0);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+  glDeleteBuffers(1, &vbo_);
+  vbo_ = vbo;
+  revision_++;
+
+  // the vertex arrays keep the deleted buffer until re-pointed, the ones
+  // of other contexts are re-pointed when bound there
+  if ((current_ == 0) || (context_ != kCurrentContext)) {
+    SwitchContext();
+  } else {
+    SetupVertexArray();
+  }
+
+  InsertFreeBlock(capacity_, capacity - capacity_);
+  capacity_ = capacity;
+}
+
+void GLVertexArena::InsertFreeBlock (GLint first, GLsizei count)
+{
+  std::map<GLint, GLsizei>::iterator next = free_blocks_.lower_bound(first);
+
+  // merge with the previous range
+  if (next != free_blocks_.begin()) {
+    std::map<GLint, GLsizei>::iterator prev = next;
+    prev--;
+    if ((prev->first + prev->second) == first) {
+      first = prev->first;
+      count += prev->second;
+      free_blocks_.erase(prev);
+    }
+  }
+
+  // merge with the next range
+  if (next != free_blocks_.end() && (first + count) == next->first) {
+    count += next->second;
+    free_blocks_.erase(next);
+  }
+
+  free_blocks_[first] = count;
+}
+
+void GLVertexArena::SetupVertexArray ()
+{
+  glBindVertexArray(current_->vao);
+
+  glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+  glEnableVertexAttribArray(attribute_);
+  glVertexAttribPointer(attribute_, components_, GL_FLOAT, GL_FALSE, 0, 0);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, element_buffer_);
+
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  current_->revision = revision_;
+}
+
+}
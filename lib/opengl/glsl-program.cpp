@@ -22,8 +22,13 @@
  */
 
 #include <iostream>
+#include <fstream>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <boost/filesystem.hpp>
 
 #include <blendint/core/types.hpp>
 
@@ -32,8 +37,54 @@
 
 namespace BlendInt {
 
+	GLuint GLSLProgram::kCurrentProgram = 0;
+
+	std::string GLSLProgram::kBinaryCacheDirectory;
+
+	int GLSLProgram::kBinarySupport = -1;
+
+	uint64_t GLSLProgram::kDriverHash = 0;
+
+	unsigned int GLSLProgram::kBinaryCacheHits = 0;
+
+	unsigned int GLSLProgram::kLinkedPrograms = 0;
+
+	// the header of a cached program binary
+	struct ProgramBinaryHeader
+	{
+		char magic[4];
+		uint32_t format;
+		uint64_t key;
+		uint32_t length;
+	};
+
+	static const char kProgramBinaryMagic[4] = {'B', 'I', 'P', 'B'};
+
+	// 64-bit FNV-1a
+	static uint64_t HashBytes (const void* data, size_t size, uint64_t hash = 14695981039346656037ULL)
+	{
+		const unsigned char* p = static_cast<const unsigned char*>(data);
+
+		for (size_t i = 0; i < size; i++) {
+			hash ^= p[i];
+			hash *= 1099511628211ULL;
+		}
+
+		return hash;
+	}
+
+	static uint64_t HashString (const GLubyte* str, uint64_t hash)
+	{
+		if (str) {
+			hash = HashBytes(str, strlen(reinterpret_cast<const char*>(str)), hash);
+		}
+
+		// separate the strings
+		return HashBytes("\n", 1, hash);
+	}
+
 	GLSLProgram::GLSLProgram ()
-			: Object(), m_id(0)
+			: Object(), m_id(0), m_cacheable(true), m_cached(false)
 	{
 	}
 
@@ -71,14 +122,25 @@ namespace BlendInt {
 		if (glIsProgram(m_id)) {
 			GLuint shader = GLSLShader::Create(filename, type);
 			glAttachShader(m_id, shader);
+			m_cacheable = false;
 		}
 	}
 
 	void GLSLProgram::AttachShader (const char* buf, GLenum type)
 	{
 		if (glIsProgram(m_id)) {
+
+			if (IsBinaryCacheEnabled()) {
+				ShaderSource source;
+				source.type = type;
+				source.source = buf;
+				m_sources.push_back(source);
+				return;
+			}
+
 			GLuint shader = GLSLShader::Create(buf, type);
 			glAttachShader(m_id, shader);
+			m_cacheable = false;
 		}
 	}
 
@@ -86,6 +148,7 @@ namespace BlendInt {
 	{
 		if (glIsProgram(m_id)) {
 			glAttachShader(m_id, shader.id());
+			m_cacheable = false;
 		}
 	}
 
@@ -98,17 +161,202 @@ namespace BlendInt {
 	{
 		GLint link_ok = GL_FALSE;
 
+		m_cached = false;
+
 		if (glIsProgram(m_id)) {
+
+			bool cache = m_cacheable && (!m_sources.empty());
+			uint64_t key = 0;
+
+			if (cache) {
+				key = GetBinaryKey();
+
+				if (LoadBinary(key)) {
+					m_sources.clear();
+					m_cached = true;
+					kBinaryCacheHits++;
+					return true;
+				}
+
+				glProgramParameteri(m_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+			}
+
+			CompileSources();
+
 			glLinkProgram(m_id);
 			glGetProgramiv(m_id, GL_LINK_STATUS, &link_ok);
 			if (!link_ok) {
 				std::cerr << "Fail to glLinkProgram" << std::endl;
+			} else {
+				kLinkedPrograms++;
+				if (cache) SaveBinary(key);
 			}
 		}
 
 		return link_ok == GL_TRUE ? true : false;
 	}
 
+	void GLSLProgram::SetBinaryCacheDirectory (const std::string& path)
+	{
+		namespace fs = boost::filesystem;
+
+		kBinaryCacheDirectory.clear();
+
+		if (path.empty()) return;
+
+		boost::system::error_code ec;
+		fs::create_directories(fs::path(path), ec);
+
+		if (fs::is_directory(fs::path(path), ec)) {
+			kBinaryCacheDirectory = path;
+		} else {
+			DBG_PRINT_MSG("Cannot create the program cache directory %s", path.c_str());
+		}
+	}
+
+	bool GLSLProgram::IsBinaryCacheEnabled ()
+	{
+		if (kBinaryCacheDirectory.empty()) return false;
+
+		if (kBinarySupport < 0) {
+
+			GLint major = 0;
+			GLint minor = 0;
+			glGetIntegerv(GL_MAJOR_VERSION, &major);
+			glGetIntegerv(GL_MINOR_VERSION, &minor);
+
+			bool supported = (major > 4) || (major == 4 && minor >= 1);
+
+			if (!supported) {
+				GLint num = 0;
+				glGetIntegerv(GL_NUM_EXTENSIONS, &num);
+				for (GLint i = 0; i < num; i++) {
+					const GLubyte* ext = glGetStringi(GL_EXTENSIONS, i);
+					if (ext && (strcmp(reinterpret_cast<const char*>(ext), "GL_ARB_get_program_binary") == 0)) {
+						supported = true;
+						break;
+					}
+				}
+			}
+
+			// some drivers support the call but no binary format
+			GLint formats = 0;
+			if (supported) glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+
+			kBinarySupport = formats > 0 ? 1 : 0;
+
+			uint64_t hash = HashBytes(0, 0);
+			hash = HashString(glGetString(GL_VENDOR), hash);
+			hash = HashString(glGetString(GL_RENDERER), hash);
+			hash = HashString(glGetString(GL_VERSION), hash);
+			hash = HashString(glGetString(GL_SHADING_LANGUAGE_VERSION), hash);
+			kDriverHash = hash;
+		}
+
+		return kBinarySupport == 1;
+	}
+
+	uint64_t GLSLProgram::GetBinaryKey () const
+	{
+		uint64_t key = kDriverHash;
+
+		for (size_t i = 0; i < m_sources.size(); i++) {
+			key = HashBytes(&m_sources[i].type, sizeof(GLenum), key);
+			key = HashBytes(m_sources[i].source.c_str(), m_sources[i].source.size() + 1, key);
+		}
+
+		return key;
+	}
+
+	std::string GLSLProgram::GetBinaryCacheFile (uint64_t key)
+	{
+		char name[32];
+		snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+
+		return kBinaryCacheDirectory + "/" + name;
+	}
+
+	bool GLSLProgram::LoadBinary (uint64_t key)
+	{
+		std::string filename = GetBinaryCacheFile(key);
+		std::ifstream in(filename.c_str(), std::ios::in | std::ios::binary);
+		if (!in) return false;
+
+		ProgramBinaryHeader header;
+		if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+
+		// the key in the header guards against a renamed file
+		if ((memcmp(header.magic, kProgramBinaryMagic, 4) != 0) ||
+				(header.key != key) || (header.length == 0)) {
+			return false;
+		}
+
+		std::vector<char> binary(header.length);
+		if (!in.read(&binary[0], header.length)) return false;
+
+		glProgramBinary(m_id, header.format, &binary[0], header.length);
+
+		GLint link_ok = GL_FALSE;
+		glGetProgramiv(m_id, GL_LINK_STATUS, &link_ok);
+
+		// rejected after a driver update, linked again and replaced
+		return link_ok == GL_TRUE;
+	}
+
+	void GLSLProgram::SaveBinary (uint64_t key)
+	{
+		GLint length = 0;
+		glGetProgramiv(m_id, GL_PROGRAM_BINARY_LENGTH, &length);
+		if (length <= 0) return;
+
+		ProgramBinaryHeader header;
+		memcpy(header.magic, kProgramBinaryMagic, 4);
+		header.key = key;
+
+		std::vector<char> binary(length);
+		GLenum format = 0;
+		GLsizei written = 0;
+		glGetProgramBinary(m_id, length, &written, &format, &binary[0]);
+		if (written <= 0) return;
+
+		header.format = format;
+		header.length = static_cast<uint32_t>(written);
+
+		// write a temporary file and rename it, other processes may use
+		// the cache at the same time
+		std::string filename = GetBinaryCacheFile(key);
+		char suffix[32];
+		snprintf(suffix, sizeof(suffix), ".%d.tmp", static_cast<int>(getpid()));
+		std::string tmp = filename + suffix;
+		{
+			std::ofstream out(tmp.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!out) return;
+
+			out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			out.write(&binary[0], written);
+
+			if (!out) {
+				out.close();
+				remove(tmp.c_str());
+				return;
+			}
+		}
+
+		if (rename(tmp.c_str(), filename.c_str()) != 0) {
+			remove(tmp.c_str());
+		}
+	}
+
+	void GLSLProgram::CompileSources ()
+	{
+		for (size_t i = 0; i < m_sources.size(); i++) {
+			GLuint shader = GLSLShader::Create(m_sources[i].source.c_str(), m_sources[i].type);
+			glAttachShader(m_id, shader);
+		}
+
+		m_sources.clear();
+	}
+
 	bool GLSLProgram::DetachShader(GLuint shader)
 	{
 		bool ret = false;
@@ -159,10 +407,18 @@ namespace BlendInt {
 				} while (count);
 			}
 
+			if (kCurrentProgram == m_id) {
+				glUseProgram(0);
+				kCurrentProgram = 0;
+			}
+
 			glDeleteProgram(m_id);
 		}
 
 		m_id = 0;
+		m_sources.clear();
+		m_cacheable = true;
+		m_cached = false;
 
 		/* old code
 		std::vector<GLSLShader*>::iterator it;
@@ -0,0 +1,377 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free
+ * software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is
+ * distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+
+#ifdef __GNUC__
+#include <cxxabi.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <blendint/core/types.hpp>
+
+#include <blendint/core/timer.hpp>
+
+#include <blendint/opengl/render-stats.hpp>
+
+namespace BlendInt {
+
+bool RenderStats::kEnabled = false;
+
+RenderCounters RenderStats::kFrame;
+
+RenderCounters RenderStats::kLastFrame;
+
+RenderCounters RenderStats::kTotal;
+
+unsigned long RenderStats::kFrameCount = 0;
+
+ProgramRenderStats* RenderStats::kProgram = 0;
+
+ViewRenderStats* RenderStats::kView = 0;
+
+std::vector<ViewRenderStats> RenderStats::kViews;
+
+std::vector<ViewRenderStats> RenderStats::kLastViews;
+
+std::vector<RenderStats::ViewRecord> RenderStats::kViewStack;
+
+std::map<GLuint, ProgramRenderStats> RenderStats::kPrograms;
+
+RenderCounters& RenderCounters::operator += (const RenderCounters& other)
+{
+  draw_calls += other.draw_calls;
+  vertices += other.vertices;
+  program_switches += other.program_switches;
+  vao_binds += other.vao_binds;
+  uniform_uploads += other.uniform_uploads;
+  buffer_uploads += other.buffer_uploads;
+  stencil_pushes += other.stencil_pushes;
+  clip_pushes += other.clip_pushes;
+
+  return *this;
+}
+
+RenderCounters RenderCounters::operator - (const RenderCounters& other) const
+{
+  RenderCounters result;
+
+  result.draw_calls = draw_calls - other.draw_calls;
+  result.vertices = vertices - other.vertices;
+  result.program_switches = program_switches - other.program_switches;
+  result.vao_binds = vao_binds - other.vao_binds;
+  result.uniform_uploads = uniform_uploads - other.uniform_uploads;
+  result.buffer_uploads = buffer_uploads - other.buffer_uploads;
+  result.stencil_pushes = stencil_pushes - other.stencil_pushes;
+  result.clip_pushes = clip_pushes - other.clip_pushes;
+
+  return result;
+}
+
+// print counters as the members of a JSON object, or as a text line
+static void PrintCounters (std::string* out,
+                           const RenderCounters& counters,
+                           bool json)
+{
+  char buf[256];
+
+  if (json) {
+    snprintf(buf, sizeof(buf),
+             "\"draw_calls\": %lu, \"vertices\": %lu, "
+             "\"program_switches\": %lu, \"vao_binds\": %lu, "
+             "\"uniform_uploads\": %lu, \"buffer_uploads\": %lu, "
+             "\"stencil_pushes\": %lu, \"clip_pushes\": %lu",
+             counters.draw_calls, counters.vertices,
+             counters.program_switches, counters.vao_binds,
+             counters.uniform_uploads, counters.buffer_uploads,
+             counters.stencil_pushes, counters.clip_pushes);
+  } else {
+    snprintf(buf, sizeof(buf),
+             "draws: %lu, vertices: %lu, programs: %lu, vaos: %lu, "
+             "uniforms: %lu, buffers: %lu, stencils: %lu, clips: %lu",
+             counters.draw_calls, counters.vertices,
+             counters.program_switches, counters.vao_binds,
+             counters.uniform_uploads, counters.buffer_uploads,
+             counters.stencil_pushes, counters.clip_pushes);
+  }
+
+  out->append(buf);
+}
+
+static std::string GetTypeName (const char* type)
+{
+  if (type == 0) return std::string();
+
+  std::string name(type);
+
+#ifdef __GNUC__
+  int status = 0;
+  char* demangled = abi::__cxa_demangle(type, 0, 0, &status);
+  if (demangled) {
+    if (status == 0) name = demangled;
+    free(demangled);
+  }
+#endif
+
+  return name;
+}
+
+static std::string EscapeJSON (const std::string& str)
+{
+  std::string result;
+  char buf[8];
+
+  for (size_t i = 0; i < str.size(); i++) {
+    unsigned char c = str[i];
+    if (c == '"' || c == '\\') {
+      result.push_back('\\');
+      result.push_back(c);
+    } else if (c < 0x20) {
+      snprintf(buf, sizeof(buf), "\\u%04x", c);
+      result.append(buf);
+    } else {
+      result.push_back(c);
+    }
+  }
+
+  return result;
+}
+
+void RenderStats::SetEnabled (bool enabled)
+{
+  if (kEnabled == enabled) return;
+
+  kEnabled = enabled;
+
+  // the program in use is unknown after calls not counted
+  kProgram = 0;
+  kView = 0;
+  kFrame = RenderCounters();
+  kViews.clear();
+  kViewStack.clear();
+}
+
+void RenderStats::BeginFrame ()
+{
+  if (!kEnabled) return;
+
+  kFrame = RenderCounters();
+  kViews.clear();
+  kViewStack.clear();
+  kView = 0;
+}
+
+void RenderStats::EndFrame ()
+{
+  if (!kEnabled) return;
+
+  DBG_ASSERT(kViewStack.empty());
+
+  kLastFrame = kFrame;
+  kTotal += kFrame;
+  kFrameCount++;
+
+  kLastViews.swap(kViews);
+  kViews.clear();
+  kViewStack.clear();
+  kView = 0;
+}
+
+void RenderStats::BeginView (const void* view,
+                             const std::string& name,
+                             const char* type)
+{
+  if (!kEnabled) return;
+
+  ViewRecord record;
+  record.index = kViews.size();
+  record.start = kFrame;
+  record.start_time = Timer::GetMonotonicMicroSeconds();
+
+  kViews.push_back(ViewRenderStats());
+  kViews.back().view = view;
+  kViews.back().name = name;
+  kViews.back().type = type;
+  kViews.back().depth = static_cast<int>(kViewStack.size());
+
+  kViewStack.push_back(record);
+
+  // push_back() may reallocate the vector
+  kView = &kViews.back();
+}
+
+void RenderStats::EndView ()
+{
+  if (!kEnabled || kViewStack.empty()) return;
+
+  const ViewRecord& record = kViewStack.back();
+  ViewRenderStats& stats = kViews[record.index];
+
+  stats.total = kFrame - record.start;
+  stats.time = Timer::GetMonotonicMicroSeconds() - record.start_time;
+
+  kViewStack.pop_back();
+  kView = kViewStack.empty() ? 0 : &kViews[kViewStack.back().index];
+}
+
+void RenderStats::SetProgramName (GLuint program, const char* name)
+{
+  ProgramRenderStats& stats = kPrograms[program];
+
+  stats.program = program;
+  stats.name = name;
+}
+
+void RenderStats::Reset ()
+{
+  kFrame = RenderCounters();
+  kLastFrame = RenderCounters();
+  kTotal = RenderCounters();
+  kFrameCount = 0;
+
+  // keep the program names
+  std::map<GLuint, ProgramRenderStats>::iterator it;
+  for (it = kPrograms.begin(); it != kPrograms.end(); it++) {
+    it->second.counters = RenderCounters();
+  }
+
+  kViews.clear();
+  kLastViews.clear();
+  kViewStack.clear();
+  kView = 0;
+}
+
+void RenderStats::CountProgram (GLuint program)
+{
+  if (program == 0) {
+    kProgram = 0;
+    return;
+  }
+
+  if (kProgram && (kProgram->program == program)) return;
+
+  kProgram = &kPrograms[program];
+  kProgram->program = program;
+
+  kFrame.program_switches++;
+  kProgram->counters.program_switches++;
+  if (kView) kView->self.program_switches++;
+}
+
+std::string RenderStats::Dump (DumpFormat format)
+{
+  std::string out;
+  char buf[256];
+  std::map<GLuint, ProgramRenderStats>::const_iterator it;
+
+  if (format == DumpJSON) {
+
+    snprintf(buf, sizeof(buf), "{\n  \"frame_count\": %lu,\n", kFrameCount);
+    out.append(buf);
+
+    out.append("  \"last_frame\": { ");
+    PrintCounters(&out, kLastFrame, true);
+    out.append(" },\n  \"total\": { ");
+    PrintCounters(&out, kTotal, true);
+    out.append(" },\n  \"programs\": [");
+
+    for (it = kPrograms.begin(); it != kPrograms.end(); it++) {
+      if (it != kPrograms.begin()) out.append(",");
+      snprintf(buf, sizeof(buf), "\n    { \"program\": %u, \"name\": \"",
+               it->first);
+      out.append(buf);
+      out.append(EscapeJSON(it->second.name));
+      out.append("\", ");
+      PrintCounters(&out, it->second.counters, true);
+      out.append(" }");
+    }
+
+    out.append("\n  ],\n  \"views\": [");
+
+    for (size_t i = 0; i < kLastViews.size(); i++) {
+      const ViewRenderStats& view = kLastViews[i];
+
+      if (i > 0) out.append(",");
+      out.append("\n    { \"name\": \"");
+      out.append(EscapeJSON(view.name));
+      out.append("\", \"type\": \"");
+      out.append(EscapeJSON(GetTypeName(view.type)));
+      snprintf(buf, sizeof(buf),
+               "\", \"depth\": %d, \"time\": %lu,\n      \"self\": { ",
+               view.depth, static_cast<unsigned long>(view.time));
+      out.append(buf);
+      PrintCounters(&out, view.self, true);
+      out.append(" },\n      \"total\": { ");
+      PrintCounters(&out, view.total, true);
+      out.append(" } }");
+    }
+
+    out.append("\n  ]\n}\n");
+
+  } else {
+
+    snprintf(buf, sizeof(buf), "frames: %lu\nlast frame: ", kFrameCount);
+    out.append(buf);
+    PrintCounters(&out, kLastFrame, false);
+    out.append("\ntotal: ");
+    PrintCounters(&out, kTotal, false);
+    out.append("\n\nprograms:\n");
+
+    for (it = kPrograms.begin(); it != kPrograms.end(); it++) {
+      snprintf(buf, sizeof(buf), "  %u %s: ", it->first,
+               it->second.name.c_str());
+      out.append(buf);
+      PrintCounters(&out, it->second.counters, false);
+      out.append("\n");
+    }
+
+    out.append("\nviews (self / total, time in us):\n");
+
+    for (size_t i = 0; i < kLastViews.size(); i++) {
+      const ViewRenderStats& view = kLastViews[i];
+
+      out.append(2 + view.depth * 2, ' ');
+      out.append(GetTypeName(view.type));
+      if (!view.name.empty()) {
+        out.append(" \"");
+        out.append(view.name);
+        out.append("\"");
+      }
+      snprintf(buf, sizeof(buf), " %lu us\n", static_cast<unsigned long>(view.time));
+      out.append(buf);
+
+      out.append(4 + view.depth * 2, ' ');
+      PrintCounters(&out, view.self, false);
+      out.append("\n");
+      out.append(4 + view.depth * 2, ' ');
+      PrintCounters(&out, view.total, false);
+      out.append("\n");
+    }
+
+  }
+
+  return out;
+}
+
+}
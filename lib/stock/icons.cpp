@@ -43,18 +43,53 @@ namespace BlendInt {
 
 Icons::Icons ()
 {
-  CreateIcons();
+  Image icons16;
+  Image icons32;
+  ReadImages(&icons16, &icons32);
+
+  CreateIcons(icons16, icons32);
+}
+
+Icons::Icons (const Image& icons16, const Image& icons32)
+{
+  CreateIcons(icons16, icons32);
 }
 
 Icons::~Icons ()
 {
 }
 
-void Icons::CreateIcons ()
+bool Icons::ReadImages (Image* icons16, Image* icons32)
+{
+  namespace fs = boost::filesystem;
+
+  fs::path icon16_path(
+      BLENDINT_INSTALL_PREFIX"/share/blendint/blender_icons16.png");
+
+  if (!fs::exists(icon16_path)) {
+    icon16_path = fs::path(
+        BLENDINT_PROJECT_SOURCE_DIR"/data/blender_icons16.png");
+  }
+
+  fs::path icon32_path(
+      BLENDINT_INSTALL_PREFIX"/share/blendint/blender_icons32.png");
+
+  if (!fs::exists(icon32_path)) {
+    icon32_path = fs::path(
+        BLENDINT_PROJECT_SOURCE_DIR"/data/blender_icons32.png");
+  }
+
+  bool retval = icons16->Read(icon16_path.native().c_str());
+  retval = icons32->Read(icon32_path.native().c_str()) && retval;
+
+  return retval;
+}
+
+void Icons::CreateIcons (const Image& icons16, const Image& icons32)
 {
   CreateVectorIcons();
-  CreatePixelIcons16x16();
-  CreatePixelIcons32x32();
+  CreatePixelIcons16x16(icons16);
+  CreatePixelIcons32x32(icons32);
 
   end_point_.reset(new EndPointIcon);
   check_.reset(new CheckIcon);
@@ -102,21 +137,8 @@ void Icons::CreateVectorIcons ()
 
 }
 
-void Icons::CreatePixelIcons16x16 ()
+void Icons::CreatePixelIcons16x16 (const Image& image)
 {
-  namespace fs = boost::filesystem;
-
-  fs::path icon16_path(
-      BLENDINT_INSTALL_PREFIX"/share/blendint/blender_icons16.png");
-
-  if (!fs::exists(icon16_path)) {
-    icon16_path = fs::path(
-        BLENDINT_PROJECT_SOURCE_DIR"/data/blender_icons16.png");
-  }
-
-  Image image;
-  image.Read(icon16_path.native());
-
   RefPtr<IconTexture> texture(new IconTexture);
   texture->Generate(image.width(), image.height(), 16, 16, 5, 10, 5, 5);
   texture->bind();
@@ -178,21 +200,8 @@ void Icons::CreatePixelIcons16x16 ()
 
 }
 
-void Icons::CreatePixelIcons32x32 ()
+void Icons::CreatePixelIcons32x32 (const Image& image)
 {
-  namespace fs = boost::filesystem;
-
-  fs::path icon32_path(
-      BLENDINT_INSTALL_PREFIX"/share/blendint/blender_icons32.png");
-
-  if (!fs::exists(icon32_path)) {
-    icon32_path = fs::path(
-        BLENDINT_PROJECT_SOURCE_DIR"/data/blender_icons32.png");
-  }
-
-  Image image;
-  image.Read(icon32_path.native());
-
   RefPtr<IconTexture> texture(new IconTexture);
   texture->Generate(image.width(), image.height(), 32, 32, 10, 20, 10, 10);
   texture->bind();
@@ -29,6 +29,7 @@
 
 #include <blendint/core/types.hpp>
 #include <blendint/opengl/opengl.hpp>
+#include <blendint/opengl/render-stats.hpp>
 #include <blendint/stock/shaders.hpp>
 
 namespace BlendInt {
@@ -75,14 +76,15 @@ const char* Shaders::widget_text_vertex_shader =
 const char* Shaders::widget_text_fragment_shader =
     "#version 330\n"
     "in vec2 uv;"
-    "uniform sampler2D u_tex;"
+    "uniform sampler2DArray u_tex;"
     "uniform vec4 uColor;"
     "out vec4 FragmentColor;"
     ""
     "void main(void) {"
     ""
-    "	ivec2 size = textureSize(u_tex, 0);"
-    "	vec2 normalized_uv = vec2(uv.x / size.x, uv.y / size.y);"
+    "	ivec3 size = textureSize(u_tex, 0);"
+    "	float layer = floor(uv.y / size.y);" // the atlas page is encoded in v
+    "	vec3 normalized_uv = vec3(uv.x / size.x, (uv.y - layer * size.y) / size.y, layer);"
     "	float alpha = texture(u_tex, normalized_uv).r;" // GL 3.2 only support GL_R8 in glTexImage2D internalFormat
     "	FragmentColor = vec4(uColor.rgb, uColor.a * alpha);"
     "}";
@@ -1005,8 +1007,15 @@ const char* Shaders::frame_shadow_fragment_shader =
 
 Shaders::Shaders ()
     : widget_matrices_ubo_total_size_(0),
-      frame_matrices_ubo_total_size_(0)
+      frame_matrices_ubo_total_size_(0),
+      widget_model_depth_(0),
+      uploaded_widget_model_matrix_(1.f),
+      widget_model_matrix_changed_(false)
 {
+  // deep enough for most widget trees, no allocation while drawing
+  widget_model_matrices_.reserve(32);
+  widget_model_matrices_.push_back(glm::mat3(1.f));
+
   widget_text_program_.reset(new GLSLProgram);
   primitive_program_.reset(new GLSLProgram);
   widget_triangle_program_.reset(new GLSLProgram);
@@ -1104,45 +1113,56 @@ void Shaders::PopWidgetViewMatrix ()
 
 void Shaders::SetWidgetModelMatrix (const glm::mat3& matrix)
 {
-  //    fprintf(stdout, " widget model matrix: -------------------------------------\n");
-  //    for (int i = 0; i < 3; i++) {
-  //      for (int j = 0; j < 3; j++) {
-  //        if (matrix[i][j] < 0) {
-  //          fprintf(stdout, "%f ", matrix[i][j]);
-  //        } else {
-  //          fprintf(stdout, " %f ", matrix[i][j]);
-  //        }
-  //      }
-  //      fprintf(stdout, "\n");
-  //    }
-
-  widget_matrices_ubo_->bind();
-
-  int stride = 4 * sizeof(GLfloat);
-  int size = sizeof(glm::vec3);
-  for (int i = 0; i < 3; i++) {
-    widget_matrices_ubo_->set_sub_data(
-        widget_matrices_ubo_offset_[ModelIndex] + i * stride, size,
-        glm::value_ptr(matrix[i]));
-  }
-
-  widget_matrices_ubo_->reset();
-  current_widget_model_matrix_ = matrix;
+  widget_model_matrices_[widget_model_depth_] = matrix;
+  widget_model_matrix_changed_ = true;
 }
 
 void Shaders::PushWidgetModelMatrix ()
 {
-  widget_model_matrix_stack.push(current_widget_model_matrix_);
+  widget_model_depth_++;
+
+  if (widget_model_depth_ == widget_model_matrices_.size()) {
+    widget_model_matrices_.push_back(
+        widget_model_matrices_[widget_model_depth_ - 1]);
+  } else {
+    widget_model_matrices_[widget_model_depth_] =
+        widget_model_matrices_[widget_model_depth_ - 1];
+  }
 }
 
 void Shaders::PopWidgetModelMatrix ()
 {
-  if (widget_model_matrix_stack.size()) {
-    SetWidgetModelMatrix(widget_model_matrix_stack.top());
-    widget_model_matrix_stack.pop();
+  if (widget_model_depth_ > 0) {
+    widget_model_depth_--;
+    widget_model_matrix_changed_ = true;
   }
 }
 
+void Shaders::UploadWidgetModelMatrix ()
+{
+  widget_model_matrix_changed_ = false;
+
+  const glm::mat3& matrix = widget_model_matrices_[widget_model_depth_];
+
+  // a pop restores the matrix of the parent, which is often still the
+  // one in the uniform block
+  if (matrix == uploaded_widget_model_matrix_) return;
+
+  // a mat3 is packed to 3 columns of vec4 in the uniform block, write
+  // them in one call
+  glm::vec4 columns[3] = {
+      glm::vec4(matrix[0], 0.f),
+      glm::vec4(matrix[1], 0.f),
+      glm::vec4(matrix[2], 0.f) };
+
+  widget_matrices_ubo_->bind();
+  widget_matrices_ubo_->set_sub_data(widget_matrices_ubo_offset_[ModelIndex],
+                                     sizeof(columns), columns);
+  widget_matrices_ubo_->reset();
+
+  uploaded_widget_model_matrix_ = matrix;
+}
+
 void Shaders::SetFrameProjectionMatrix (const glm::mat4& matrix)
 {
   frame_matrices_ubo_->bind();
@@ -1196,6 +1216,25 @@ bool Shaders::Setup ()
   if (!SetupFrameImageProgram()) return false;
   if (!SetupFrameShadowProgram()) return false;
 
+  RenderStats::SetProgramName(widget_inner_program_->id(), "widget_inner");
+  RenderStats::SetProgramName(widget_split_inner_program_->id(),
+                              "widget_split_inner");
+  RenderStats::SetProgramName(widget_outer_program_->id(), "widget_outer");
+  RenderStats::SetProgramName(widget_text_program_->id(), "widget_text");
+  RenderStats::SetProgramName(widget_triangle_program_->id(),
+                              "widget_triangle");
+  RenderStats::SetProgramName(widget_simple_triangle_program_->id(),
+                              "widget_simple_triangle");
+  RenderStats::SetProgramName(widget_image_program_->id(), "widget_image");
+  RenderStats::SetProgramName(widget_line_program_->id(), "widget_line");
+  RenderStats::SetProgramName(widget_shadow_program_->id(), "widget_shadow");
+  RenderStats::SetProgramName(widget_debug_program_->id(), "widget_debug");
+  RenderStats::SetProgramName(primitive_program_->id(), "primitive");
+  RenderStats::SetProgramName(frame_inner_program_->id(), "frame_inner");
+  RenderStats::SetProgramName(frame_outer_program_->id(), "frame_outer");
+  RenderStats::SetProgramName(frame_image_program_->id(), "frame_image");
+  RenderStats::SetProgramName(frame_shadow_program_->id(), "frame_shadow");
+
   // setup uniform block
 
   const GLchar* names[] = { "projection", "view", "model" };
@@ -0,0 +1,105 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free software:
+ * you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is distributed in
+ * the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <blendint/gui/damage-region.hpp>
+
+using namespace BlendInt;
+
+TEST(DamageRegion, KeepsSeparateRects)
+{
+  DamageRegion region;
+  region.Add(Rect(0, 0, 20, 20));
+  region.Add(Rect(500, 0, 20, 20));
+
+  EXPECT_EQ(2u, region.rects().size());
+  EXPECT_EQ(0, region.bounds().x());
+  EXPECT_EQ(520, region.bounds().width());
+}
+
+// Far apart damaged rectangles are redrawn in separate passes, a view
+// between them is not redrawn
+TEST(DamageRegion, RedrawsSeparateRects)
+{
+  DamageRegion region;
+  region.Add(Rect(0, 0, 20, 20));
+  region.Add(Rect(500, 0, 20, 20));
+
+  std::vector<Rect> rects;
+  region.GetRedrawRects(&rects);
+  ASSERT_EQ(2u, rects.size());
+  EXPECT_EQ(0, rects[0].x());
+  EXPECT_EQ(20, rects[0].width());
+  EXPECT_EQ(500, rects[1].x());
+  EXPECT_EQ(20, rects[1].width());
+
+  EXPECT_FALSE(region.Intersects(Rect(250, 0, 20, 20)));
+  EXPECT_TRUE(region.Intersects(Rect(510, 10, 20, 20)));
+}
+
+// Rectangles covering most of their bounding box are redrawn in one pass
+TEST(DamageRegion, RedrawsBoundsOfCloseRects)
+{
+  DamageRegion region;
+  region.Add(Rect(0, 0, 100, 50));
+  region.Add(Rect(0, 50, 90, 50));
+
+  std::vector<Rect> rects;
+  region.GetRedrawRects(&rects);
+  ASSERT_EQ(1u, rects.size());
+  EXPECT_EQ(100, rects[0].width());
+  EXPECT_EQ(100, rects[0].height());
+}
+
+TEST(DamageRegion, RedrawsBoundsAtMaxRects)
+{
+  DamageRegion region;
+  const int count = (int) DamageRegion::kMaxRects + 1;
+  for (int i = 0; i < count; i++) {
+    region.Add(Rect(i * 100, 0, 10, 10));
+  }
+
+  std::vector<Rect> rects;
+  region.GetRedrawRects(&rects);
+  ASSERT_EQ(1u, rects.size());
+  EXPECT_EQ(0, rects[0].x());
+  EXPECT_EQ((count - 1) * 100 + 10, rects[0].width());
+}
+
+TEST(DamageRegion, Full)
+{
+  DamageRegion region;
+  region.AddAll();
+
+  // one pass without scissor
+  std::vector<Rect> rects;
+  region.GetRedrawRects(&rects);
+  EXPECT_TRUE(rects.empty());
+  EXPECT_TRUE(region.Intersects(Rect(1000, 1000, 1, 1)));
+
+  region.Clear();
+  EXPECT_TRUE(region.empty());
+  EXPECT_FALSE(region.Intersects(Rect(0, 0, 10, 10)));
+}
@@ -0,0 +1,151 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free software:
+ * you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is distributed in
+ * the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+
+#include <stdio.h>
+
+#include <gtest/gtest.h>
+
+#include <blendint/gui/window.hpp>
+#include <blendint/gui/filesystem-model.hpp>
+
+using namespace BlendInt;
+
+// the return code CTest reports as skipped, see test/CMakeLists.txt
+static const int kSkipped = 77;
+
+/**
+ * @brief Apply a batch of changes without watching a directory
+ */
+class TestFileSystemModel: public FileSystemModel
+{
+ public:
+
+  TestFileSystemModel ()
+  : FileSystemModel()
+  {
+  }
+
+  virtual ~TestFileSystemModel ()
+  {
+  }
+
+  void Apply (const std::vector<DirectoryChange>& changes)
+  {
+    ApplyChanges(changes, false);
+  }
+};
+
+static DirectoryChange MakeChange (DirectoryChange::Type type,
+                                   const std::string& name,
+                                   const std::string& new_name,
+                                   uintmax_t size = 0)
+{
+  DirectoryChange change;
+  change.type = type;
+  change.name = name;
+  change.entry.name = new_name;
+  change.entry.regular = true;
+  change.entry.size = size;
+  return change;
+}
+
+TEST(FileSystemModel, RenameListedFile)
+{
+  RefPtr<TestFileSystemModel> model(new TestFileSystemModel);
+  std::vector<DirectoryChange> changes;
+
+  changes.push_back(MakeChange(DirectoryChange::Created, "a.txt", "a.txt"));
+  model->Apply(changes);
+  ASSERT_EQ(1, model->GetRowCount());
+
+  changes.clear();
+  changes.push_back(MakeChange(DirectoryChange::Renamed, "a.txt", "b.txt"));
+  model->Apply(changes);
+
+  ASSERT_EQ(1, model->GetRowCount());
+  EXPECT_EQ("b.txt", model->GetEntry(0).name);
+}
+
+// an editor saves a file by creating a temporary file and renaming it,
+// the watcher coalesces both into one change from a name not listed
+TEST(FileSystemModel, RenameTemporaryFile)
+{
+  RefPtr<TestFileSystemModel> model(new TestFileSystemModel);
+  std::vector<DirectoryChange> changes;
+
+  changes.push_back(MakeChange(DirectoryChange::Created, "a.txt", "a.txt"));
+  model->Apply(changes);
+
+  changes.clear();
+  changes.push_back(MakeChange(DirectoryChange::Renamed, ".new.txt.swp",
+                               "new.txt"));
+  model->Apply(changes);
+
+  ASSERT_EQ(2, model->GetRowCount());
+  EXPECT_EQ("a.txt", model->GetEntry(0).name);
+  EXPECT_EQ("new.txt", model->GetEntry(1).name);
+}
+
+TEST(FileSystemModel, RenameTemporaryFileOverListedFile)
+{
+  RefPtr<TestFileSystemModel> model(new TestFileSystemModel);
+  std::vector<DirectoryChange> changes;
+
+  changes.push_back(MakeChange(DirectoryChange::Created, "a.txt", "a.txt", 1));
+  changes.push_back(MakeChange(DirectoryChange::Created, "b.txt", "b.txt", 1));
+  model->Apply(changes);
+
+  changes.clear();
+  changes.push_back(MakeChange(DirectoryChange::Renamed, ".a.txt.swp",
+                               "a.txt", 2));
+  model->Apply(changes);
+
+  ASSERT_EQ(2, model->GetRowCount());
+  EXPECT_EQ("a.txt", model->GetEntry(0).name);
+  EXPECT_EQ(2u, model->GetEntry(0).size);
+  EXPECT_EQ("b.txt", model->GetEntry(1).name);
+}
+
+int main (int argc, char* argv[])
+{
+  testing::InitGoogleTest(&argc, argv);
+
+  // rows create texts, which need an OpenGL context, skip the tests
+  // where no display is available, e.g. on a headless build machine
+  if (!Window::Initialize()) {
+    fprintf(stderr, "Cannot initialize GLFW, FileSystemModel tests skipped\n");
+    return kSkipped;
+  }
+
+  int retval = EXIT_SUCCESS;
+
+  {
+    Window win(320, 240, "FileSystemModel Test", WindowInvisible);
+    retval = RUN_ALL_TESTS();
+  }
+
+  Window::Terminate();
+
+  return retval;
+}
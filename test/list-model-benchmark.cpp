@@ -0,0 +1,138 @@
+/*
+ * This file is part of BlendInt (a Blender-like Interface Library in
+ * OpenGL).
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is free software:
+ * you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * BlendInt (a Blender-like Interface Library in OpenGL) is distributed in
+ * the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with BlendInt.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * Contributor(s): Freeman Zhang <zhanggyb@gmail.com>
+ */
+
+
+// Compares the linked-node AbstractListModel with the block-backed
+// AbstractArrayListModel at 1k, 100k and 1M rows: filling the model,
+// random GetIndex() + GetRow() lookups, and inserts in the middle.
+
+#include <chrono>
+#include <cstdio>
+
+#include <blendint/gui/abstract-list-model.hpp>
+#include <blendint/gui/abstract-array-list-model.hpp>
+
+using namespace BlendInt;
+
+template<typename ModelType>
+class BenchmarkModel: public ModelType
+{
+ public:
+
+  BenchmarkModel ()
+  : ModelType()
+  {
+  }
+
+  virtual ~BenchmarkModel ()
+  {
+  }
+
+  virtual int GetRowCount (const ModelIndex& parent = ModelIndex()) const
+  {
+    return 0;
+  }
+
+  virtual int GetColumnCount (const ModelIndex& parent = ModelIndex()) const
+  {
+    return 1;
+  }
+
+  virtual int GetPreferredColumnWidth (int index,
+                                       const ModelIndex& parent =
+                                           ModelIndex()) const
+  {
+    return 0;
+  }
+
+  virtual int GetPreferredRowHeight (int index,
+                                     const ModelIndex& parent =
+                                         ModelIndex()) const
+  {
+    return 0;
+  }
+
+};
+
+static double GetMicroseconds (std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration<double, std::micro>(
+      std::chrono::steady_clock::now() - start).count();
+}
+
+template<typename ModelType>
+static void Run (const char* backend, int rows)
+{
+  const int lookups = 200;
+  const int inserts = 100;
+
+  BenchmarkModel<ModelType> model;
+  ModelIndex root = model.GetRootIndex();
+
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  model.InsertRows(0, rows, root);
+  model.InsertColumns(1, 2, root);
+  double fill = GetMicroseconds(start);
+
+  int errors = 0;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < lookups; i++) {
+    int row = (int) ((i * 7919L) % rows);
+    ModelIndex index = model.GetIndex(row, 1, root);
+    if ((index.GetRow() != row) || (index.GetColumn() != 1)) errors++;
+  }
+  double lookup = GetMicroseconds(start);
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < inserts; i++) {
+    model.InsertRow(rows / 2, root);
+  }
+  double insert = GetMicroseconds(start);
+
+  // the rows after the inserts are renumbered
+  for (int i = 0; i < lookups; i++) {
+    int row = (int) ((i * 7919L) % (rows + inserts));
+    if (model.GetIndex(row, 0, root).GetRow() != row) errors++;
+  }
+
+  printf("%8d  %-7s %12.0f %12.0f %12.0f %s\n", rows, backend, fill, lookup,
+         insert, errors ? "wrong rows" : "");
+  fflush(stdout);
+}
+
+int main (int argc, char* argv[])
+{
+  const int rows[] = { 1000, 100000, 1000000 };
+
+  printf("times in microseconds\n");
+  printf("%8s  %-7s %12s %12s %12s\n", "rows", "backend", "fill",
+         "200 lookups", "100 inserts");
+
+  for (size_t i = 0; i < sizeof(rows) / sizeof(rows[0]); i++) {
+    Run<AbstractListModel>("linked", rows[i]);
+    Run<AbstractArrayListModel>("array", rows[i]);
+  }
+
+  return 0;
+}